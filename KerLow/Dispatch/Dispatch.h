@@ -0,0 +1,211 @@
+/*
+ *
+ * Dispatch.h (v1.0)
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Runtime ISA selection of the kernels (HEADER).
+ * Every kernel family is compiled for each ISA level inside a target region (no -m flag is
+ * needed by the consumers), the level is read once from CPUID and every entry point resolves
+ * its function pointer once, on first use, through select_kernel().
+ *
+ *   level     instructions                         kernels
+ *   scalar    x86-64 baseline (SSE2)               portable loops
+ *   sse4.2    SSE4.1, SSE4.2, POPCNT               128-bit kernels
+ *   avx2      AVX2, FMA, BMI1, BMI2                256-bit kernels
+ *   avx512    AVX-512 F, BW, DQ + avx2             512-bit kernels, tails through mask registers
+ *
+ * Environment :
+ *   VECTRA_ISA   scalar | sse4.2 | avx2 | avx512 : run at this level at most (testing the
+ *                narrower kernels on a wide machine). A level above the CPU is ignored.
+ *
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#pragma once
+#ifndef DISPATCH_H
+#define DISPATCH_H
+
+#ifdef __cplusplus
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+/*
+ *
+ * Target regions : functions defined between BEGIN and END may use the instructions of the
+ * level, whatever the flags of the translation unit. Keep them in their own namespace and
+ * call them through a dispatched entry point only.
+ *
+*/
+
+#define VECTRA_PRAGMA(x) _Pragma(#x)
+
+#define VECTRA_ISA_SSE42  "sse4.1,sse4.2,popcnt"
+#define VECTRA_ISA_AVX2   "sse4.1,sse4.2,popcnt,avx,avx2,fma,bmi,bmi2"
+#define VECTRA_ISA_AVX512 "sse4.1,sse4.2,popcnt,avx,avx2,fma,bmi,bmi2,avx512f,avx512bw,avx512dq"
+
+#if defined(__clang__)
+#define VECTRA_TARGET_BEGIN(isa) VECTRA_PRAGMA(clang attribute push(__attribute__((target(isa))), apply_to = function))
+#define VECTRA_TARGET_END        VECTRA_PRAGMA(clang attribute pop)
+#elif defined(__GNUC__)
+// the AVX-512 intrinsics of GCC 12 seed their undefined operand from itself (-Wmaybe-uninitialized)
+#define VECTRA_TARGET_BEGIN(isa) VECTRA_PRAGMA(GCC push_options) VECTRA_PRAGMA(GCC target(isa)) \
+                                 VECTRA_PRAGMA(GCC diagnostic push) VECTRA_PRAGMA(GCC diagnostic ignored "-Wmaybe-uninitialized")
+#define VECTRA_TARGET_END        VECTRA_PRAGMA(GCC diagnostic pop) VECTRA_PRAGMA(GCC pop_options)
+#else
+// MSVC : every intrinsic is available without a target
+#define VECTRA_TARGET_BEGIN(isa)
+#define VECTRA_TARGET_END
+#endif
+
+namespace vectra {
+namespace kernel {
+
+enum class Isa {
+    Scalar = 0,
+    SSE42  = 1,
+    AVX2   = 2,
+    AVX512 = 3
+};
+
+inline const char* isa_name(Isa isa)
+{
+    switch (isa) {
+        case Isa::SSE42:  return "sse4.2";
+        case Isa::AVX2:   return "avx2";
+        case Isa::AVX512: return "avx512";
+        default:          return "scalar";
+    }
+}
+
+namespace cpu {
+
+inline void cpuid(uint32_t leaf, uint32_t sub, uint32_t r[4])
+{
+#if defined(_MSC_VER)
+    int v[4];
+    __cpuidex(v, int(leaf), int(sub));
+    for (int i = 0; i < 4; ++i) r[i] = uint32_t(v[i]);
+#else
+    __cpuid_count(leaf, sub, r[0], r[1], r[2], r[3]);
+#endif
+}
+
+// register state enabled by the OS (XCR0)
+inline uint64_t xgetbv()
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return (uint64_t(hi) << 32) | lo;
+#endif
+}
+
+// widest level supported by the CPU and enabled by the OS
+inline Isa detect()
+{
+    uint32_t r[4];
+    cpuid(0, 0, r);
+    const uint32_t max_leaf = r[0];
+    if (max_leaf < 1) return Isa::Scalar;
+
+    cpuid(1, 0, r);
+    const uint32_t ecx1 = r[2];
+    const bool sse41   = ecx1 & (1u << 19);
+    const bool sse42   = ecx1 & (1u << 20);
+    const bool popcnt  = ecx1 & (1u << 23);
+    const bool osxsave = ecx1 & (1u << 27);
+    const bool avx     = ecx1 & (1u << 28);
+    const bool fma     = ecx1 & (1u << 12);
+
+    if (!(sse41 && sse42 && popcnt)) return Isa::Scalar;
+    if (!(osxsave && avx && fma) || max_leaf < 7) return Isa::SSE42;
+
+    // XMM + YMM state (bits 1, 2), opmask + ZMM state (bits 5, 6, 7)
+    const uint64_t xcr0 = xgetbv();
+    if ((xcr0 & 0x6) != 0x6) return Isa::SSE42;
+
+    cpuid(7, 0, r);
+    const uint32_t ebx7 = r[1];
+    const bool bmi1     = ebx7 & (1u << 3);
+    const bool avx2     = ebx7 & (1u << 5);
+    const bool bmi2     = ebx7 & (1u << 8);
+    const bool avx512f  = ebx7 & (1u << 16);
+    const bool avx512dq = ebx7 & (1u << 17);
+    const bool avx512bw = ebx7 & (1u << 30);
+
+    if (!(avx2 && bmi1 && bmi2)) return Isa::SSE42;
+    if (!(avx512f && avx512bw && avx512dq) || (xcr0 & 0xE6) != 0xE6) return Isa::AVX2;
+    return Isa::AVX512;
+}
+
+} // namespace cpu
+
+// level of the CPU, detected once
+inline Isa cpu_isa()
+{
+    static const Isa isa = cpu::detect();
+    return isa;
+}
+
+// level the kernels run at : cpu_isa(), lowered by VECTRA_ISA
+inline Isa active_isa()
+{
+    static const Isa isa = [] {
+        const Isa cpu = cpu_isa();
+        const char* env = std::getenv("VECTRA_ISA");
+        if (!env || !*env) return cpu;
+
+        Isa req;
+        if (!std::strcmp(env, "scalar"))                                    req = Isa::Scalar;
+        else if (!std::strcmp(env, "sse4.2") || !std::strcmp(env, "sse42")) req = Isa::SSE42;
+        else if (!std::strcmp(env, "avx2"))                                 req = Isa::AVX2;
+        else if (!std::strcmp(env, "avx512"))                               req = Isa::AVX512;
+        else {
+            fprintf(stderr, "vectra : unknown VECTRA_ISA \"%s\" (scalar, sse4.2, avx2, avx512), using %s\n", env, isa_name(cpu));
+            return cpu;
+        }
+
+        if (req > cpu) {
+            fprintf(stderr, "vectra : VECTRA_ISA=%s is not supported by this CPU, using %s\n", env, isa_name(cpu));
+            return cpu;
+        }
+        return req;
+    }();
+    return isa;
+}
+
+// kernel of the active level, from the widest to the portable one
+template<typename F>
+F select_kernel(F avx512, F avx2, F sse42, F scalar)
+{
+    switch (active_isa()) {
+        case Isa::AVX512: return avx512;
+        case Isa::AVX2:   return avx2;
+        case Isa::SSE42:  return sse42;
+        default:          return scalar;
+    }
+}
+
+} // namespace kernel
+} // namespace vectra
+
+#endif // __cplusplus
+#endif // DISPATCH_H
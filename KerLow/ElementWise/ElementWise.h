@@ -0,0 +1,905 @@
+/*
+ *
+ * ElementWise.h (v1.3)
+ *
+ * v1.3 updated : * every ISA level is compiled in its target region and picked at runtime (Dispatch.h)
+ *                * SSE4.2 kernels
+ *
+ * v1.2 updated : * max, min and eq_mask lane operations of vec<T> (used by the Reduce kernels)
+ *
+ * v1.1 updated : * binary_scalar kernels : one operand is a single value broadcast over the
+ *                  other one (zero-stride operand of a broadcast Tensor operation)
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Strip-mined SIMD element-wise kernels (add, sub, mul, div) over packed buffers.
+ * AVX-512 kernels load 64 bytes per step, AVX2 kernels 32 bytes, SSE4.2 kernels 16 bytes,
+ * the tail is handled with masked loads/stores (or a padded register image) instead of a
+ * scalar epilogue.
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#pragma once
+#ifndef ELEMENTWISE_H
+#define ELEMENTWISE_H
+
+#ifdef __cplusplus
+
+#include <ScalarType/ScalarType.h>
+#include <Dispatch/Dispatch.h>
+#include <immintrin.h>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace vectra {
+namespace kernel {
+
+enum class BinaryOp {
+    Add,
+    Sub,
+    Mul,
+    Div
+};
+
+/*
+ *
+ * Scalar kernel (portable level : CPUs without SSE4.2, VECTRA_ISA=scalar)
+ *
+*/
+
+namespace scalar {
+
+// return false when a divisor is zero (only BinaryOp::Div)
+template<BinaryOp Op, typename T>
+bool binary(const T* a, const T* b, T* out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        if constexpr (Op == BinaryOp::Add) out[i] = static_cast<T>(a[i] + b[i]);
+        if constexpr (Op == BinaryOp::Sub) out[i] = static_cast<T>(a[i] - b[i]);
+        if constexpr (Op == BinaryOp::Mul) out[i] = static_cast<T>(a[i] * b[i]);
+        if constexpr (Op == BinaryOp::Div) {
+            if (b[i] == T{0}) return false;
+            out[i] = static_cast<T>(a[i] / b[i]);
+        }
+    }
+    return true;
+}
+
+// strided operands : sa, sb, so are element strides
+template<BinaryOp Op, typename T>
+bool binary_strided(const T* a, size_t sa, const T* b, size_t sb, T* out, size_t so, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        const T x = a[i * sa];
+        const T y = b[i * sb];
+        if constexpr (Op == BinaryOp::Add) out[i * so] = static_cast<T>(x + y);
+        if constexpr (Op == BinaryOp::Sub) out[i * so] = static_cast<T>(x - y);
+        if constexpr (Op == BinaryOp::Mul) out[i * so] = static_cast<T>(x * y);
+        if constexpr (Op == BinaryOp::Div) {
+            if (y == T{0}) return false;
+            out[i * so] = static_cast<T>(x / y);
+        }
+    }
+    return true;
+}
+
+// one operand is a single value : *b when RhsScalar, *a otherwise
+template<BinaryOp Op, bool RhsScalar, typename T>
+bool binary_scalar(const T* a, const T* b, T* out, size_t n)
+{
+    return RhsScalar ? binary_strided<Op>(a, 1, b, 0, out, 1, n)
+                     : binary_strided<Op>(a, 0, b, 1, out, 1, n);
+}
+
+} // namespace scalar
+
+/*
+ *
+ * SSE4.2 kernel (16 bytes per step)
+ *
+*/
+
+VECTRA_TARGET_BEGIN(VECTRA_ISA_SSE42)
+namespace sse42 {
+
+template<typename T>
+struct vec {
+    using reg = typename m128::Scalar<T>::type;
+    static constexpr size_t lanes = 16 / sizeof(T);
+
+    static reg load(const T* p) {
+        if constexpr (std::is_same_v<T, vectra::float32>)      return _mm_loadu_ps(p);
+        else if constexpr (std::is_same_v<T, vectra::float64>) return _mm_loadu_pd(p);
+        else                                                   return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+
+    static void store(T* p, reg v) {
+        if constexpr (std::is_same_v<T, vectra::float32>)      _mm_storeu_ps(p, v);
+        else if constexpr (std::is_same_v<T, vectra::float64>) _mm_storeu_pd(p, v);
+        else                                                   _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+    }
+
+    static reg set1(T x) {
+        if constexpr (std::is_same_v<T, vectra::int8>)         return _mm_set1_epi8(x);
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return _mm_set1_epi16(x);
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return _mm_set1_epi32(x);
+        else if constexpr (std::is_same_v<T, vectra::float32>) return _mm_set1_ps(x);
+        else                                                   return _mm_set1_pd(x);
+    }
+
+    static reg add(reg a, reg b) {
+        if constexpr (std::is_same_v<T, vectra::int8>)         return _mm_add_epi8(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return _mm_add_epi16(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return _mm_add_epi32(a, b);
+        else if constexpr (std::is_same_v<T, vectra::float32>) return _mm_add_ps(a, b);
+        else                                                   return _mm_add_pd(a, b);
+    }
+
+    static reg sub(reg a, reg b) {
+        if constexpr (std::is_same_v<T, vectra::int8>)         return _mm_sub_epi8(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return _mm_sub_epi16(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return _mm_sub_epi32(a, b);
+        else if constexpr (std::is_same_v<T, vectra::float32>) return _mm_sub_ps(a, b);
+        else                                                   return _mm_sub_pd(a, b);
+    }
+
+    static reg mul(reg a, reg b) {
+        if constexpr (std::is_same_v<T, vectra::int8>) {
+            // no 8-bit multiply : multiply even and odd bytes as 16-bit lanes and keep the low bytes
+            const __m128i even = _mm_mullo_epi16(a, b);
+            const __m128i odd  = _mm_mullo_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+            return _mm_or_si128(_mm_and_si128(even, _mm_set1_epi16(0x00FF)), _mm_slli_epi16(odd, 8));
+        }
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return _mm_mullo_epi16(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return _mm_mullo_epi32(a, b);
+        else if constexpr (std::is_same_v<T, vectra::float32>) return _mm_mul_ps(a, b);
+        else                                                   return _mm_mul_pd(a, b);
+    }
+
+    // lanes of b equal to zero, as a bitmask
+    static unsigned zero_mask(reg b) {
+        if constexpr (std::is_same_v<T, vectra::int8>)         return unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(b, _mm_setzero_si128())));
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return unsigned(_mm_movemask_epi8(_mm_cmpeq_epi16(b, _mm_setzero_si128())));
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return unsigned(_mm_movemask_epi8(_mm_cmpeq_epi32(b, _mm_setzero_si128())));
+        else if constexpr (std::is_same_v<T, vectra::float32>) return unsigned(_mm_movemask_ps(_mm_cmpeq_ps(b, _mm_setzero_ps())));
+        else                                                   return unsigned(_mm_movemask_pd(_mm_cmpeq_pd(b, _mm_setzero_pd())));
+    }
+
+    static reg max(reg a, reg b) {
+        if constexpr (std::is_same_v<T, vectra::int8>)         return _mm_max_epi8(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return _mm_max_epi16(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return _mm_max_epi32(a, b);
+        else if constexpr (std::is_same_v<T, vectra::float32>) return _mm_max_ps(a, b);
+        else                                                   return _mm_max_pd(a, b);
+    }
+
+    static reg min(reg a, reg b) {
+        if constexpr (std::is_same_v<T, vectra::int8>)         return _mm_min_epi8(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return _mm_min_epi16(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return _mm_min_epi32(a, b);
+        else if constexpr (std::is_same_v<T, vectra::float32>) return _mm_min_ps(a, b);
+        else                                                   return _mm_min_pd(a, b);
+    }
+
+    // lanes where a == b, one bit per byte (sizeof(T) bits per lane)
+    static unsigned eq_mask(reg a, reg b) {
+        if constexpr (std::is_same_v<T, vectra::int8>)         return unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return unsigned(_mm_movemask_epi8(_mm_cmpeq_epi16(a, b)));
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return unsigned(_mm_movemask_epi8(_mm_cmpeq_epi32(a, b)));
+        else if constexpr (std::is_same_v<T, vectra::float32>) return unsigned(_mm_movemask_epi8(_mm_castps_si128(_mm_cmpeq_ps(a, b))));
+        else                                                   return unsigned(_mm_movemask_epi8(_mm_castpd_si128(_mm_cmpeq_pd(a, b))));
+    }
+
+    // integer lanes are divided through float32 (int8, int16) or float64 (int32), the
+    // quotient is exact after truncation for every representable operand
+    static reg div(reg a, reg b) {
+        if constexpr (std::is_same_v<T, vectra::float32>)      return _mm_div_ps(a, b);
+        else if constexpr (std::is_same_v<T, vectra::float64>) return _mm_div_pd(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int32>) {
+            const __m128i lo = _mm_cvttpd_epi32(_mm_div_pd(_mm_cvtepi32_pd(a), _mm_cvtepi32_pd(b)));
+            const __m128i hi = _mm_cvttpd_epi32(_mm_div_pd(_mm_cvtepi32_pd(_mm_srli_si128(a, 8)),
+                                                           _mm_cvtepi32_pd(_mm_srli_si128(b, 8))));
+            return _mm_unpacklo_epi64(lo, hi);
+        }
+        else if constexpr (std::is_same_v<T, vectra::int16>) {
+            const __m128i lo = div4_epi16(a, b);
+            const __m128i hi = div4_epi16(_mm_srli_si128(a, 8), _mm_srli_si128(b, 8));
+            return _mm_packus_epi32(lo, hi);
+        }
+        else {
+            const __m128i q0 = div4_epi8(a, b);
+            const __m128i q1 = div4_epi8(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+            const __m128i q2 = div4_epi8(_mm_srli_si128(a, 8), _mm_srli_si128(b, 8));
+            const __m128i q3 = div4_epi8(_mm_srli_si128(a, 12), _mm_srli_si128(b, 12));
+            return _mm_packus_epi16(_mm_packus_epi32(q0, q1), _mm_packus_epi32(q2, q3));
+        }
+    }
+
+private:
+    // 4 low int16 lanes divided, the quotient truncated into the low 16 bits of int32 lanes
+    static __m128i div4_epi16(__m128i a, __m128i b) {
+        const __m128 q = _mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepi16_epi32(a)), _mm_cvtepi32_ps(_mm_cvtepi16_epi32(b)));
+        return _mm_and_si128(_mm_cvttps_epi32(q), _mm_set1_epi32(0xFFFF));
+    }
+
+    // 4 low int8 lanes divided, the quotient truncated into the low 8 bits of int32 lanes
+    static __m128i div4_epi8(__m128i a, __m128i b) {
+        const __m128 q = _mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepi8_epi32(a)), _mm_cvtepi32_ps(_mm_cvtepi8_epi32(b)));
+        return _mm_and_si128(_mm_cvttps_epi32(q), _mm_set1_epi32(0xFF));
+    }
+};
+
+template<BinaryOp Op, typename T>
+inline typename vec<T>::reg apply(typename vec<T>::reg a, typename vec<T>::reg b)
+{
+    if constexpr (Op == BinaryOp::Add) return vec<T>::add(a, b);
+    if constexpr (Op == BinaryOp::Sub) return vec<T>::sub(a, b);
+    if constexpr (Op == BinaryOp::Mul) return vec<T>::mul(a, b);
+    if constexpr (Op == BinaryOp::Div) return vec<T>::div(a, b);
+}
+
+// n < vec<T>::lanes remaining elements, through a padded register image (no masked load)
+template<BinaryOp Op, typename T>
+inline unsigned binary_tail(const T* a, const T* b, T* out, size_t n)
+{
+    using V = vec<T>;
+
+    alignas(16) T ta[V::lanes] = {};
+    alignas(16) T tb[V::lanes];
+    for (size_t i = 0; i < V::lanes; ++i) tb[i] = T{1};
+    std::memcpy(ta, a, n * sizeof(T));
+    std::memcpy(tb, b, n * sizeof(T));
+
+    const typename V::reg vb = V::load(tb);
+    unsigned zero = 0;
+    if constexpr (Op == BinaryOp::Div) zero = V::zero_mask(vb);
+
+    alignas(16) T tr[V::lanes];
+    V::store(tr, apply<Op, T>(V::load(ta), vb));
+    std::memcpy(out, tr, n * sizeof(T));
+
+    return zero;
+}
+
+template<BinaryOp Op, typename T>
+bool binary(const T* a, const T* b, T* out, size_t n)
+{
+    using V = vec<T>;
+    constexpr size_t L = V::lanes;
+
+    unsigned zero = 0;
+    size_t i = 0;
+
+    for (; i + 2 * L <= n; i += 2 * L) {
+        const typename V::reg b0 = V::load(b + i);
+        const typename V::reg b1 = V::load(b + i + L);
+        if constexpr (Op == BinaryOp::Div) zero |= V::zero_mask(b0) | V::zero_mask(b1);
+        V::store(out + i,     apply<Op, T>(V::load(a + i),     b0));
+        V::store(out + i + L, apply<Op, T>(V::load(a + i + L), b1));
+    }
+    for (; i + L <= n; i += L) {
+        const typename V::reg b0 = V::load(b + i);
+        if constexpr (Op == BinaryOp::Div) zero |= V::zero_mask(b0);
+        V::store(out + i, apply<Op, T>(V::load(a + i), b0));
+    }
+    if (i < n) {
+        zero |= binary_tail<Op, T>(a + i, b + i, out + i, n - i);
+    }
+
+    return zero == 0;
+}
+
+// one operand is a single value : *b when RhsScalar, *a otherwise
+template<BinaryOp Op, bool RhsScalar, typename T>
+bool binary_scalar(const T* a, const T* b, T* out, size_t n)
+{
+    using V = vec<T>;
+    constexpr size_t L = V::lanes;
+
+    const T s = RhsScalar ? *b : *a;
+    const T* v = RhsScalar ? a : b;
+    if constexpr (Op == BinaryOp::Div && RhsScalar) {
+        if (s == T{0}) return false;
+    }
+
+    const typename V::reg vs = V::set1(s);
+    const auto op = [&](typename V::reg x) {
+        if constexpr (RhsScalar) return apply<Op, T>(x, vs);
+        else                     return apply<Op, T>(vs, x);
+    };
+
+    unsigned zero = 0;
+    size_t i = 0;
+
+    for (; i + 2 * L <= n; i += 2 * L) {
+        const typename V::reg x0 = V::load(v + i);
+        const typename V::reg x1 = V::load(v + i + L);
+        if constexpr (Op == BinaryOp::Div && !RhsScalar) zero |= V::zero_mask(x0) | V::zero_mask(x1);
+        V::store(out + i,     op(x0));
+        V::store(out + i + L, op(x1));
+    }
+    for (; i + L <= n; i += L) {
+        const typename V::reg x0 = V::load(v + i);
+        if constexpr (Op == BinaryOp::Div && !RhsScalar) zero |= V::zero_mask(x0);
+        V::store(out + i, op(x0));
+    }
+    if (i < n) {
+        alignas(16) T image[L];
+        for (size_t k = 0; k < L; ++k) image[k] = s;
+        zero |= RhsScalar ? binary_tail<Op, T>(a + i, image, out + i, n - i)
+                          : binary_tail<Op, T>(image, b + i, out + i, n - i);
+    }
+
+    return zero == 0;
+}
+
+} // namespace sse42
+VECTRA_TARGET_END
+
+/*
+ *
+ * AVX2 kernel (32 bytes per step)
+ *
+*/
+
+VECTRA_TARGET_BEGIN(VECTRA_ISA_AVX2)
+namespace avx2 {
+
+template<typename T>
+struct vec {
+    using reg = typename m256::Scalar<T>::type;
+    static constexpr size_t lanes = 32 / sizeof(T);
+
+    static reg load(const T* p) {
+        if constexpr (std::is_same_v<T, vectra::float32>)      return _mm256_loadu_ps(p);
+        else if constexpr (std::is_same_v<T, vectra::float64>) return _mm256_loadu_pd(p);
+        else                                                   return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+
+    static void store(T* p, reg v) {
+        if constexpr (std::is_same_v<T, vectra::float32>)      _mm256_storeu_ps(p, v);
+        else if constexpr (std::is_same_v<T, vectra::float64>) _mm256_storeu_pd(p, v);
+        else                                                   _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+    }
+
+    static reg set1(T x) {
+        if constexpr (std::is_same_v<T, vectra::int8>)         return _mm256_set1_epi8(x);
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return _mm256_set1_epi16(x);
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return _mm256_set1_epi32(x);
+        else if constexpr (std::is_same_v<T, vectra::float32>) return _mm256_set1_ps(x);
+        else                                                   return _mm256_set1_pd(x);
+    }
+
+    static reg add(reg a, reg b) {
+        if constexpr (std::is_same_v<T, vectra::int8>)         return _mm256_add_epi8(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return _mm256_add_epi16(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return _mm256_add_epi32(a, b);
+        else if constexpr (std::is_same_v<T, vectra::float32>) return _mm256_add_ps(a, b);
+        else                                                   return _mm256_add_pd(a, b);
+    }
+
+    static reg sub(reg a, reg b) {
+        if constexpr (std::is_same_v<T, vectra::int8>)         return _mm256_sub_epi8(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return _mm256_sub_epi16(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return _mm256_sub_epi32(a, b);
+        else if constexpr (std::is_same_v<T, vectra::float32>) return _mm256_sub_ps(a, b);
+        else                                                   return _mm256_sub_pd(a, b);
+    }
+
+    static reg mul(reg a, reg b) {
+        if constexpr (std::is_same_v<T, vectra::int8>) {
+            // no 8-bit multiply : multiply even and odd bytes as 16-bit lanes and keep the low bytes
+            const __m256i even = _mm256_mullo_epi16(a, b);
+            const __m256i odd  = _mm256_mullo_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+            return _mm256_or_si256(_mm256_and_si256(even, _mm256_set1_epi16(0x00FF)), _mm256_slli_epi16(odd, 8));
+        }
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return _mm256_mullo_epi16(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return _mm256_mullo_epi32(a, b);
+        else if constexpr (std::is_same_v<T, vectra::float32>) return _mm256_mul_ps(a, b);
+        else                                                   return _mm256_mul_pd(a, b);
+    }
+
+    // lanes of b equal to zero, as a bitmask
+    static unsigned zero_mask(reg b) {
+        if constexpr (std::is_same_v<T, vectra::int8>)         return unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(b, _mm256_setzero_si256())));
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi16(b, _mm256_setzero_si256())));
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi32(b, _mm256_setzero_si256())));
+        else if constexpr (std::is_same_v<T, vectra::float32>) return unsigned(_mm256_movemask_ps(_mm256_cmp_ps(b, _mm256_setzero_ps(), _CMP_EQ_OQ)));
+        else                                                   return unsigned(_mm256_movemask_pd(_mm256_cmp_pd(b, _mm256_setzero_pd(), _CMP_EQ_OQ)));
+    }
+
+    static reg max(reg a, reg b) {
+        if constexpr (std::is_same_v<T, vectra::int8>)         return _mm256_max_epi8(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return _mm256_max_epi16(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return _mm256_max_epi32(a, b);
+        else if constexpr (std::is_same_v<T, vectra::float32>) return _mm256_max_ps(a, b);
+        else                                                   return _mm256_max_pd(a, b);
+    }
+
+    static reg min(reg a, reg b) {
+        if constexpr (std::is_same_v<T, vectra::int8>)         return _mm256_min_epi8(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return _mm256_min_epi16(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return _mm256_min_epi32(a, b);
+        else if constexpr (std::is_same_v<T, vectra::float32>) return _mm256_min_ps(a, b);
+        else                                                   return _mm256_min_pd(a, b);
+    }
+
+    // lanes where a == b, one bit per byte (sizeof(T) bits per lane)
+    static unsigned eq_mask(reg a, reg b) {
+        if constexpr (std::is_same_v<T, vectra::int8>)         return unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi16(a, b)));
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi32(a, b)));
+        else if constexpr (std::is_same_v<T, vectra::float32>) return unsigned(_mm256_movemask_epi8(_mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_EQ_OQ))));
+        else                                                   return unsigned(_mm256_movemask_epi8(_mm256_castpd_si256(_mm256_cmp_pd(a, b, _CMP_EQ_OQ))));
+    }
+
+    // integer lanes are divided through float32 (int8, int16) or float64 (int32), the
+    // quotient is exact after truncation for every representable operand
+    static reg div(reg a, reg b) {
+        if constexpr (std::is_same_v<T, vectra::float32>)      return _mm256_div_ps(a, b);
+        else if constexpr (std::is_same_v<T, vectra::float64>) return _mm256_div_pd(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int32>) {
+            const __m128i lo = _mm256_cvttpd_epi32(_mm256_div_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(a)),
+                                                                 _mm256_cvtepi32_pd(_mm256_castsi256_si128(b))));
+            const __m128i hi = _mm256_cvttpd_epi32(_mm256_div_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(a, 1)),
+                                                                 _mm256_cvtepi32_pd(_mm256_extracti128_si256(b, 1))));
+            return _mm256_set_m128i(hi, lo);
+        }
+        else if constexpr (std::is_same_v<T, vectra::int16>) {
+            const __m128i lo = div8_epi16(_mm256_castsi256_si128(a), _mm256_castsi256_si128(b));
+            const __m128i hi = div8_epi16(_mm256_extracti128_si256(a, 1), _mm256_extracti128_si256(b, 1));
+            return _mm256_set_m128i(hi, lo);
+        }
+        else {
+            alignas(32) int64_t qa[4], qb[4], qr[4];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(qa), a);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(qb), b);
+            for (int q = 0; q < 4; ++q) {
+                qr[q] = div8_epi8(qa[q], qb[q]);
+            }
+            return _mm256_load_si256(reinterpret_cast<const __m256i*>(qr));
+        }
+    }
+
+private:
+    // truncate 8 int32 lanes into the low 16 bits of each lane (no saturation)
+    static __m128i narrow_epi32_epi16(__m256i v) {
+        v = _mm256_and_si256(v, _mm256_set1_epi32(0xFFFF));
+        return _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    }
+
+    static __m256 cvt_epi32_ps_div(__m256i a, __m256i b) {
+        return _mm256_div_ps(_mm256_cvtepi32_ps(a), _mm256_cvtepi32_ps(b));
+    }
+
+    static __m128i div8_epi16(__m128i a, __m128i b) {
+        const __m256 q = cvt_epi32_ps_div(_mm256_cvtepi16_epi32(a), _mm256_cvtepi16_epi32(b));
+        return narrow_epi32_epi16(_mm256_cvttps_epi32(q));
+    }
+
+    static int64_t div8_epi8(int64_t a, int64_t b) {
+        const __m256 q = cvt_epi32_ps_div(_mm256_cvtepi8_epi32(_mm_cvtsi64_si128(a)),
+                                          _mm256_cvtepi8_epi32(_mm_cvtsi64_si128(b)));
+        __m128i r = narrow_epi32_epi16(_mm256_cvttps_epi32(q));
+        r = _mm_and_si128(r, _mm_set1_epi16(0x00FF));
+        return _mm_cvtsi128_si64(_mm_packus_epi16(r, r));
+    }
+};
+
+// lane mask of the first n lanes for maskload/maskstore (32 and 64 bit lanes only)
+template<typename T>
+inline __m256i tail_mask(size_t n)
+{
+    if constexpr (sizeof(T) == 4) return _mm256_cmpgt_epi32(_mm256_set1_epi32(int(n)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    else                          return _mm256_cmpgt_epi64(_mm256_set1_epi64x(int64_t(n)), _mm256_setr_epi64x(0, 1, 2, 3));
+}
+
+template<BinaryOp Op, typename T>
+inline typename vec<T>::reg apply(typename vec<T>::reg a, typename vec<T>::reg b)
+{
+    if constexpr (Op == BinaryOp::Add) return vec<T>::add(a, b);
+    if constexpr (Op == BinaryOp::Sub) return vec<T>::sub(a, b);
+    if constexpr (Op == BinaryOp::Mul) return vec<T>::mul(a, b);
+    if constexpr (Op == BinaryOp::Div) return vec<T>::div(a, b);
+}
+
+// n < vec<T>::lanes remaining elements
+template<BinaryOp Op, typename T>
+inline unsigned binary_tail(const T* a, const T* b, T* out, size_t n)
+{
+    using V = vec<T>;
+    typename V::reg va, vb;
+
+    if constexpr (std::is_same_v<T, vectra::float32>) {
+        const __m256i m = tail_mask<T>(n);
+        va = _mm256_maskload_ps(a, m);
+        vb = _mm256_blendv_ps(_mm256_set1_ps(1.0f), _mm256_maskload_ps(b, m), _mm256_castsi256_ps(m));
+    }
+    else if constexpr (std::is_same_v<T, vectra::float64>) {
+        const __m256i m = tail_mask<T>(n);
+        va = _mm256_maskload_pd(a, m);
+        vb = _mm256_blendv_pd(_mm256_set1_pd(1.0), _mm256_maskload_pd(b, m), _mm256_castsi256_pd(m));
+    }
+    else if constexpr (std::is_same_v<T, vectra::int32>) {
+        const __m256i m = tail_mask<T>(n);
+        va = _mm256_maskload_epi32(a, m);
+        vb = _mm256_blendv_epi8(_mm256_set1_epi32(1), _mm256_maskload_epi32(b, m), m);
+    }
+    else {
+        // AVX2 has no byte/word masked load : go through a padded register image
+        alignas(32) T ta[V::lanes] = {};
+        alignas(32) T tb[V::lanes];
+        for (size_t i = 0; i < V::lanes; ++i) tb[i] = T{1};
+        std::memcpy(ta, a, n * sizeof(T));
+        std::memcpy(tb, b, n * sizeof(T));
+        va = V::load(ta);
+        vb = V::load(tb);
+    }
+
+    unsigned zero = 0;
+    if constexpr (Op == BinaryOp::Div) zero = V::zero_mask(vb);
+
+    const typename V::reg r = apply<Op, T>(va, vb);
+
+    if constexpr (std::is_same_v<T, vectra::float32>)      _mm256_maskstore_ps(out, tail_mask<T>(n), r);
+    else if constexpr (std::is_same_v<T, vectra::float64>) _mm256_maskstore_pd(out, tail_mask<T>(n), r);
+    else if constexpr (std::is_same_v<T, vectra::int32>)   _mm256_maskstore_epi32(out, tail_mask<T>(n), r);
+    else {
+        alignas(32) T tr[V::lanes];
+        V::store(tr, r);
+        std::memcpy(out, tr, n * sizeof(T));
+    }
+
+    return zero;
+}
+
+template<BinaryOp Op, typename T>
+bool binary(const T* a, const T* b, T* out, size_t n)
+{
+    using V = vec<T>;
+    constexpr size_t L = V::lanes;
+
+    unsigned zero = 0;
+    size_t i = 0;
+
+    for (; i + 2 * L <= n; i += 2 * L) {
+        const typename V::reg b0 = V::load(b + i);
+        const typename V::reg b1 = V::load(b + i + L);
+        if constexpr (Op == BinaryOp::Div) zero |= V::zero_mask(b0) | V::zero_mask(b1);
+        V::store(out + i,     apply<Op, T>(V::load(a + i),     b0));
+        V::store(out + i + L, apply<Op, T>(V::load(a + i + L), b1));
+    }
+    for (; i + L <= n; i += L) {
+        const typename V::reg b0 = V::load(b + i);
+        if constexpr (Op == BinaryOp::Div) zero |= V::zero_mask(b0);
+        V::store(out + i, apply<Op, T>(V::load(a + i), b0));
+    }
+    if (i < n) {
+        zero |= binary_tail<Op, T>(a + i, b + i, out + i, n - i);
+    }
+
+    return zero == 0;
+}
+
+// one operand is a single value : *b when RhsScalar, *a otherwise
+template<BinaryOp Op, bool RhsScalar, typename T>
+bool binary_scalar(const T* a, const T* b, T* out, size_t n)
+{
+    using V = vec<T>;
+    constexpr size_t L = V::lanes;
+
+    const T s = RhsScalar ? *b : *a;
+    const T* v = RhsScalar ? a : b;
+    if constexpr (Op == BinaryOp::Div && RhsScalar) {
+        if (s == T{0}) return false;
+    }
+
+    const typename V::reg vs = V::set1(s);
+    const auto op = [&](typename V::reg x) {
+        if constexpr (RhsScalar) return apply<Op, T>(x, vs);
+        else                     return apply<Op, T>(vs, x);
+    };
+
+    unsigned zero = 0;
+    size_t i = 0;
+
+    for (; i + 2 * L <= n; i += 2 * L) {
+        const typename V::reg x0 = V::load(v + i);
+        const typename V::reg x1 = V::load(v + i + L);
+        if constexpr (Op == BinaryOp::Div && !RhsScalar) zero |= V::zero_mask(x0) | V::zero_mask(x1);
+        V::store(out + i,     op(x0));
+        V::store(out + i + L, op(x1));
+    }
+    for (; i + L <= n; i += L) {
+        const typename V::reg x0 = V::load(v + i);
+        if constexpr (Op == BinaryOp::Div && !RhsScalar) zero |= V::zero_mask(x0);
+        V::store(out + i, op(x0));
+    }
+    if (i < n) {
+        alignas(32) T image[L];
+        for (size_t k = 0; k < L; ++k) image[k] = s;
+        zero |= RhsScalar ? binary_tail<Op, T>(a + i, image, out + i, n - i)
+                          : binary_tail<Op, T>(image, b + i, out + i, n - i);
+    }
+
+    return zero == 0;
+}
+
+} // namespace avx2
+VECTRA_TARGET_END
+
+/*
+ *
+ * AVX-512 kernel (64 bytes per step, tail through mask registers)
+ *
+*/
+
+VECTRA_TARGET_BEGIN(VECTRA_ISA_AVX512)
+namespace avx512 {
+
+template<typename T>
+struct vec {
+    using reg = typename m512::Scalar<T>::type;
+    using mask = std::conditional_t<sizeof(T) == 1, __mmask64,
+                 std::conditional_t<sizeof(T) == 2, __mmask32,
+                 std::conditional_t<sizeof(T) == 4, __mmask16, __mmask8>>>;
+    static constexpr size_t lanes = 64 / sizeof(T);
+
+    static mask first(size_t n) {
+        return n >= lanes ? mask(~uint64_t(0)) : mask((uint64_t(1) << n) - 1);
+    }
+
+    static reg load(const T* p) {
+        if constexpr (std::is_same_v<T, vectra::float32>)      return _mm512_loadu_ps(p);
+        else if constexpr (std::is_same_v<T, vectra::float64>) return _mm512_loadu_pd(p);
+        else                                                   return _mm512_loadu_si512(p);
+    }
+
+    // masked-off lanes are set to `fill`
+    static reg load(const T* p, mask m, T fill) {
+        if constexpr (std::is_same_v<T, vectra::int8>)         return _mm512_mask_loadu_epi8(_mm512_set1_epi8(fill), m, p);
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return _mm512_mask_loadu_epi16(_mm512_set1_epi16(fill), m, p);
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return _mm512_mask_loadu_epi32(_mm512_set1_epi32(fill), m, p);
+        else if constexpr (std::is_same_v<T, vectra::float32>) return _mm512_mask_loadu_ps(_mm512_set1_ps(fill), m, p);
+        else                                                   return _mm512_mask_loadu_pd(_mm512_set1_pd(fill), m, p);
+    }
+
+    static void store(T* p, reg v) {
+        if constexpr (std::is_same_v<T, vectra::float32>)      _mm512_storeu_ps(p, v);
+        else if constexpr (std::is_same_v<T, vectra::float64>) _mm512_storeu_pd(p, v);
+        else                                                   _mm512_storeu_si512(p, v);
+    }
+
+    static reg set1(T x) {
+        if constexpr (std::is_same_v<T, vectra::int8>)         return _mm512_set1_epi8(x);
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return _mm512_set1_epi16(x);
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return _mm512_set1_epi32(x);
+        else if constexpr (std::is_same_v<T, vectra::float32>) return _mm512_set1_ps(x);
+        else                                                   return _mm512_set1_pd(x);
+    }
+
+    static void store(T* p, mask m, reg v) {
+        if constexpr (std::is_same_v<T, vectra::int8>)         _mm512_mask_storeu_epi8(p, m, v);
+        else if constexpr (std::is_same_v<T, vectra::int16>)   _mm512_mask_storeu_epi16(p, m, v);
+        else if constexpr (std::is_same_v<T, vectra::int32>)   _mm512_mask_storeu_epi32(p, m, v);
+        else if constexpr (std::is_same_v<T, vectra::float32>) _mm512_mask_storeu_ps(p, m, v);
+        else                                                   _mm512_mask_storeu_pd(p, m, v);
+    }
+
+    static reg add(reg a, reg b) {
+        if constexpr (std::is_same_v<T, vectra::int8>)         return _mm512_add_epi8(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return _mm512_add_epi16(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return _mm512_add_epi32(a, b);
+        else if constexpr (std::is_same_v<T, vectra::float32>) return _mm512_add_ps(a, b);
+        else                                                   return _mm512_add_pd(a, b);
+    }
+
+    static reg sub(reg a, reg b) {
+        if constexpr (std::is_same_v<T, vectra::int8>)         return _mm512_sub_epi8(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return _mm512_sub_epi16(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return _mm512_sub_epi32(a, b);
+        else if constexpr (std::is_same_v<T, vectra::float32>) return _mm512_sub_ps(a, b);
+        else                                                   return _mm512_sub_pd(a, b);
+    }
+
+    static reg mul(reg a, reg b) {
+        if constexpr (std::is_same_v<T, vectra::int8>) {
+            const __m512i even = _mm512_mullo_epi16(a, b);
+            const __m512i odd  = _mm512_mullo_epi16(_mm512_srli_epi16(a, 8), _mm512_srli_epi16(b, 8));
+            return _mm512_mask_blend_epi8(__mmask64(0xAAAAAAAAAAAAAAAAull), even, _mm512_slli_epi16(odd, 8));
+        }
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return _mm512_mullo_epi16(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return _mm512_mullo_epi32(a, b);
+        else if constexpr (std::is_same_v<T, vectra::float32>) return _mm512_mul_ps(a, b);
+        else                                                   return _mm512_mul_pd(a, b);
+    }
+
+    static mask zero_mask(reg b) {
+        if constexpr (std::is_same_v<T, vectra::int8>)         return _mm512_testn_epi8_mask(b, b);
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return _mm512_testn_epi16_mask(b, b);
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return _mm512_testn_epi32_mask(b, b);
+        else if constexpr (std::is_same_v<T, vectra::float32>) return _mm512_cmp_ps_mask(b, _mm512_setzero_ps(), _CMP_EQ_OQ);
+        else                                                   return _mm512_cmp_pd_mask(b, _mm512_setzero_pd(), _CMP_EQ_OQ);
+    }
+
+    static reg max(reg a, reg b) {
+        if constexpr (std::is_same_v<T, vectra::int8>)         return _mm512_max_epi8(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return _mm512_max_epi16(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return _mm512_max_epi32(a, b);
+        else if constexpr (std::is_same_v<T, vectra::float32>) return _mm512_max_ps(a, b);
+        else                                                   return _mm512_max_pd(a, b);
+    }
+
+    static reg min(reg a, reg b) {
+        if constexpr (std::is_same_v<T, vectra::int8>)         return _mm512_min_epi8(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return _mm512_min_epi16(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return _mm512_min_epi32(a, b);
+        else if constexpr (std::is_same_v<T, vectra::float32>) return _mm512_min_ps(a, b);
+        else                                                   return _mm512_min_pd(a, b);
+    }
+
+    // lanes where a == b, one bit per lane
+    static mask eq_mask(reg a, reg b) {
+        if constexpr (std::is_same_v<T, vectra::int8>)         return _mm512_cmpeq_epi8_mask(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int16>)   return _mm512_cmpeq_epi16_mask(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int32>)   return _mm512_cmpeq_epi32_mask(a, b);
+        else if constexpr (std::is_same_v<T, vectra::float32>) return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ);
+        else                                                   return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ);
+    }
+
+    static reg div(reg a, reg b) {
+        if constexpr (std::is_same_v<T, vectra::float32>)      return _mm512_div_ps(a, b);
+        else if constexpr (std::is_same_v<T, vectra::float64>) return _mm512_div_pd(a, b);
+        else if constexpr (std::is_same_v<T, vectra::int32>) {
+            const __m256i lo = _mm512_cvttpd_epi32(_mm512_div_pd(_mm512_cvtepi32_pd(_mm512_castsi512_si256(a)),
+                                                                 _mm512_cvtepi32_pd(_mm512_castsi512_si256(b))));
+            const __m256i hi = _mm512_cvttpd_epi32(_mm512_div_pd(_mm512_cvtepi32_pd(_mm512_extracti64x4_epi64(a, 1)),
+                                                                 _mm512_cvtepi32_pd(_mm512_extracti64x4_epi64(b, 1))));
+            return _mm512_inserti64x4(_mm512_zextsi256_si512(lo), hi, 1);
+        }
+        else if constexpr (std::is_same_v<T, vectra::int16>) {
+            const __m256i lo = div16_epi16(_mm512_castsi512_si256(a), _mm512_castsi512_si256(b));
+            const __m256i hi = div16_epi16(_mm512_extracti64x4_epi64(a, 1), _mm512_extracti64x4_epi64(b, 1));
+            return _mm512_inserti64x4(_mm512_zextsi256_si512(lo), hi, 1);
+        }
+        else {
+            const __m128i q0 = div16_epi8(_mm512_extracti32x4_epi32(a, 0), _mm512_extracti32x4_epi32(b, 0));
+            const __m128i q1 = div16_epi8(_mm512_extracti32x4_epi32(a, 1), _mm512_extracti32x4_epi32(b, 1));
+            const __m128i q2 = div16_epi8(_mm512_extracti32x4_epi32(a, 2), _mm512_extracti32x4_epi32(b, 2));
+            const __m128i q3 = div16_epi8(_mm512_extracti32x4_epi32(a, 3), _mm512_extracti32x4_epi32(b, 3));
+            __m512i r = _mm512_zextsi128_si512(q0);
+            r = _mm512_inserti32x4(r, q1, 1);
+            r = _mm512_inserti32x4(r, q2, 2);
+            return _mm512_inserti32x4(r, q3, 3);
+        }
+    }
+
+private:
+    static __m256i div16_epi16(__m256i a, __m256i b) {
+        const __m512 q = _mm512_div_ps(_mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(a)), _mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(b)));
+        return _mm512_cvtepi32_epi16(_mm512_cvttps_epi32(q));
+    }
+
+    static __m128i div16_epi8(__m128i a, __m128i b) {
+        const __m512 q = _mm512_div_ps(_mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(a)), _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(b)));
+        return _mm512_cvtepi32_epi8(_mm512_cvttps_epi32(q));
+    }
+};
+
+template<BinaryOp Op, typename T>
+inline typename vec<T>::reg apply(typename vec<T>::reg a, typename vec<T>::reg b)
+{
+    if constexpr (Op == BinaryOp::Add) return vec<T>::add(a, b);
+    if constexpr (Op == BinaryOp::Sub) return vec<T>::sub(a, b);
+    if constexpr (Op == BinaryOp::Mul) return vec<T>::mul(a, b);
+    if constexpr (Op == BinaryOp::Div) return vec<T>::div(a, b);
+}
+
+template<BinaryOp Op, typename T>
+bool binary(const T* a, const T* b, T* out, size_t n)
+{
+    using V = vec<T>;
+    constexpr size_t L = V::lanes;
+
+    uint64_t zero = 0;
+    size_t i = 0;
+
+    for (; i + 2 * L <= n; i += 2 * L) {
+        const typename V::reg b0 = V::load(b + i);
+        const typename V::reg b1 = V::load(b + i + L);
+        if constexpr (Op == BinaryOp::Div) zero |= uint64_t(V::zero_mask(b0)) | uint64_t(V::zero_mask(b1));
+        V::store(out + i,     apply<Op, T>(V::load(a + i),     b0));
+        V::store(out + i + L, apply<Op, T>(V::load(a + i + L), b1));
+    }
+    for (; i < n; i += L) {
+        // last step runs masked : lanes past n are never read nor written
+        const typename V::mask m = V::first(n - i);
+        const typename V::reg b0 = V::load(b + i, m, T{1});
+        if constexpr (Op == BinaryOp::Div) zero |= uint64_t(V::zero_mask(b0));
+        V::store(out + i, m, apply<Op, T>(V::load(a + i, m, T{0}), b0));
+    }
+
+    return zero == 0;
+}
+
+// one operand is a single value : *b when RhsScalar, *a otherwise
+template<BinaryOp Op, bool RhsScalar, typename T>
+bool binary_scalar(const T* a, const T* b, T* out, size_t n)
+{
+    using V = vec<T>;
+    constexpr size_t L = V::lanes;
+
+    const T s = RhsScalar ? *b : *a;
+    const T* v = RhsScalar ? a : b;
+    if constexpr (Op == BinaryOp::Div && RhsScalar) {
+        if (s == T{0}) return false;
+    }
+
+    const typename V::reg vs = V::set1(s);
+    const auto op = [&](typename V::reg x) {
+        if constexpr (RhsScalar) return apply<Op, T>(x, vs);
+        else                     return apply<Op, T>(vs, x);
+    };
+
+    // masked-off divisor lanes read as 1
+    const T fill = RhsScalar ? T{0} : T{1};
+    uint64_t zero = 0;
+    size_t i = 0;
+
+    for (; i + 2 * L <= n; i += 2 * L) {
+        const typename V::reg x0 = V::load(v + i);
+        const typename V::reg x1 = V::load(v + i + L);
+        if constexpr (Op == BinaryOp::Div && !RhsScalar) zero |= uint64_t(V::zero_mask(x0)) | uint64_t(V::zero_mask(x1));
+        V::store(out + i,     op(x0));
+        V::store(out + i + L, op(x1));
+    }
+    for (; i < n; i += L) {
+        const typename V::mask m = V::first(n - i);
+        const typename V::reg x0 = V::load(v + i, m, fill);
+        if constexpr (Op == BinaryOp::Div && !RhsScalar) zero |= uint64_t(V::zero_mask(x0));
+        V::store(out + i, m, op(x0));
+    }
+
+    return zero == 0;
+}
+
+} // namespace avx512
+VECTRA_TARGET_END
+
+/*
+ *
+ * Entry point : kernel of the active ISA level (Dispatch.h), resolved on first use
+ * Return false when BinaryOp::Div meets a zero divisor.
+ *
+*/
+
+template<BinaryOp Op, typename T>
+bool binary(const T* a, const T* b, T* out, size_t n)
+{
+    static const auto fn = select_kernel(&avx512::binary<Op, T>, &avx2::binary<Op, T>,
+                                         &sse42::binary<Op, T>, &scalar::binary<Op, T>);
+    return fn(a, b, out, n);
+}
+
+// out[i] = a[i] op *b when RhsScalar, *a op b[i] otherwise
+template<BinaryOp Op, bool RhsScalar, typename T>
+bool binary_scalar(const T* a, const T* b, T* out, size_t n)
+{
+    static const auto fn = select_kernel(&avx512::binary_scalar<Op, RhsScalar, T>, &avx2::binary_scalar<Op, RhsScalar, T>,
+                                         &sse42::binary_scalar<Op, RhsScalar, T>, &scalar::binary_scalar<Op, RhsScalar, T>);
+    return fn(a, b, out, n);
+}
+
+} // namespace kernel
+} // namespace vectra
+
+#endif // __cplusplus
+#endif // ELEMENTWISE_H
@@ -0,0 +1,663 @@
+/*
+ *
+ * Gemm.h (v1.2)
+ *
+ * v1.2 updated : * AVX-512 micro-kernels (12 x 32 float32, 12 x 16 float64), partial tiles are
+ *                  stored in place through mask registers (micro_edge)
+ *
+ * v1.1 updated : * SSE4.2 micro-kernel, the micro-kernel of the active ISA level is picked at
+ *                  runtime (Dispatch.h)
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Cache-blocked, register-tiled matrix multiplication (float32, float64).
+ * C = A * B with row-major operands. The loops follow the usual GotoBLAS layering :
+ *   jc (NC, L3) -> pc (KC, packed B panel) -> ic (MC, L2 packed A block) -> jr/ir micro-tiles (L1)
+ * Every MR x NR micro-tile of C is computed in registers by the micro-kernel.
+ * The ic loop (blocks of rows of C) is shared by the threads of the pool.
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#pragma once
+#ifndef GEMM_H
+#define GEMM_H
+
+#ifdef __cplusplus
+
+#include <ScalarType/ScalarType.h>
+#include <Dispatch/Dispatch.h>
+#include <ThreadPool/ThreadPool.h>
+#include <VectorUtility/vector.h>
+#include <immintrin.h>
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+namespace vectra {
+namespace kernel {
+namespace gemm {
+
+/*
+ *
+ * Micro-kernels
+ * micro(kc, a, b, c, ldc, accumulate) : c[MR x NR] (+)= a_panel[kc x MR]^T * b_panel[kc x NR]
+ *
+*/
+
+// Portable micro-kernel (vectorized by the compiler for the x86-64 baseline)
+template<typename T>
+struct ScalarKernel {
+    static constexpr size_t MR = 4;
+    static constexpr size_t NR = 8;
+    static constexpr size_t MC = 128;
+    static constexpr size_t KC = 256;
+    static constexpr size_t NC = 2048;
+
+    static void micro(size_t kc, const T* a, const T* b, T* c, size_t ldc, bool accumulate)
+    {
+        T acc[MR][NR] = {};
+
+        for (size_t k = 0; k < kc; ++k) {
+            for (size_t i = 0; i < MR; ++i) {
+                const T ai = a[k * MR + i];
+                for (size_t j = 0; j < NR; ++j) acc[i][j] += ai * b[k * NR + j];
+            }
+        }
+
+        for (size_t i = 0; i < MR; ++i) {
+            for (size_t j = 0; j < NR; ++j) {
+                c[i * ldc + j] = accumulate ? c[i * ldc + j] + acc[i][j] : acc[i][j];
+            }
+        }
+    }
+};
+
+VECTRA_TARGET_BEGIN(VECTRA_ISA_SSE42)
+template<typename T> struct Sse42Kernel;
+
+// 4 x 8 float32 tile : 8 xmm accumulators, 2 B loads and 4 A broadcasts per k
+template<>
+struct Sse42Kernel<vectra::float32> {
+    static constexpr size_t MR = 4;
+    static constexpr size_t NR = 8;
+    static constexpr size_t MC = 128;
+    static constexpr size_t KC = 256;
+    static constexpr size_t NC = 2048;
+
+    static void micro(size_t kc, const float* a, const float* b, float* c, size_t ldc, bool accumulate)
+    {
+        __m128 c00 = _mm_setzero_ps(), c01 = _mm_setzero_ps();
+        __m128 c10 = _mm_setzero_ps(), c11 = _mm_setzero_ps();
+        __m128 c20 = _mm_setzero_ps(), c21 = _mm_setzero_ps();
+        __m128 c30 = _mm_setzero_ps(), c31 = _mm_setzero_ps();
+
+        for (size_t k = 0; k < kc; ++k) {
+            const __m128 b0 = _mm_load_ps(b);
+            const __m128 b1 = _mm_load_ps(b + 4);
+            __m128 ai;
+
+            ai = _mm_set1_ps(a[0]); c00 = _mm_add_ps(c00, _mm_mul_ps(ai, b0)); c01 = _mm_add_ps(c01, _mm_mul_ps(ai, b1));
+            ai = _mm_set1_ps(a[1]); c10 = _mm_add_ps(c10, _mm_mul_ps(ai, b0)); c11 = _mm_add_ps(c11, _mm_mul_ps(ai, b1));
+            ai = _mm_set1_ps(a[2]); c20 = _mm_add_ps(c20, _mm_mul_ps(ai, b0)); c21 = _mm_add_ps(c21, _mm_mul_ps(ai, b1));
+            ai = _mm_set1_ps(a[3]); c30 = _mm_add_ps(c30, _mm_mul_ps(ai, b0)); c31 = _mm_add_ps(c31, _mm_mul_ps(ai, b1));
+
+            a += MR;
+            b += NR;
+        }
+
+        store_row(c + 0 * ldc, c00, c01, accumulate);
+        store_row(c + 1 * ldc, c10, c11, accumulate);
+        store_row(c + 2 * ldc, c20, c21, accumulate);
+        store_row(c + 3 * ldc, c30, c31, accumulate);
+    }
+
+private:
+    static void store_row(float* c, __m128 r0, __m128 r1, bool accumulate)
+    {
+        if (accumulate) {
+            r0 = _mm_add_ps(r0, _mm_loadu_ps(c));
+            r1 = _mm_add_ps(r1, _mm_loadu_ps(c + 4));
+        }
+        _mm_storeu_ps(c, r0);
+        _mm_storeu_ps(c + 4, r1);
+    }
+};
+
+// 4 x 4 float64 tile : 8 xmm accumulators, 2 B loads and 4 A broadcasts per k
+template<>
+struct Sse42Kernel<vectra::float64> {
+    static constexpr size_t MR = 4;
+    static constexpr size_t NR = 4;
+    static constexpr size_t MC = 64;
+    static constexpr size_t KC = 256;
+    static constexpr size_t NC = 2048;
+
+    static void micro(size_t kc, const double* a, const double* b, double* c, size_t ldc, bool accumulate)
+    {
+        __m128d c00 = _mm_setzero_pd(), c01 = _mm_setzero_pd();
+        __m128d c10 = _mm_setzero_pd(), c11 = _mm_setzero_pd();
+        __m128d c20 = _mm_setzero_pd(), c21 = _mm_setzero_pd();
+        __m128d c30 = _mm_setzero_pd(), c31 = _mm_setzero_pd();
+
+        for (size_t k = 0; k < kc; ++k) {
+            const __m128d b0 = _mm_load_pd(b);
+            const __m128d b1 = _mm_load_pd(b + 2);
+            __m128d ai;
+
+            ai = _mm_set1_pd(a[0]); c00 = _mm_add_pd(c00, _mm_mul_pd(ai, b0)); c01 = _mm_add_pd(c01, _mm_mul_pd(ai, b1));
+            ai = _mm_set1_pd(a[1]); c10 = _mm_add_pd(c10, _mm_mul_pd(ai, b0)); c11 = _mm_add_pd(c11, _mm_mul_pd(ai, b1));
+            ai = _mm_set1_pd(a[2]); c20 = _mm_add_pd(c20, _mm_mul_pd(ai, b0)); c21 = _mm_add_pd(c21, _mm_mul_pd(ai, b1));
+            ai = _mm_set1_pd(a[3]); c30 = _mm_add_pd(c30, _mm_mul_pd(ai, b0)); c31 = _mm_add_pd(c31, _mm_mul_pd(ai, b1));
+
+            a += MR;
+            b += NR;
+        }
+
+        store_row(c + 0 * ldc, c00, c01, accumulate);
+        store_row(c + 1 * ldc, c10, c11, accumulate);
+        store_row(c + 2 * ldc, c20, c21, accumulate);
+        store_row(c + 3 * ldc, c30, c31, accumulate);
+    }
+
+private:
+    static void store_row(double* c, __m128d r0, __m128d r1, bool accumulate)
+    {
+        if (accumulate) {
+            r0 = _mm_add_pd(r0, _mm_loadu_pd(c));
+            r1 = _mm_add_pd(r1, _mm_loadu_pd(c + 2));
+        }
+        _mm_storeu_pd(c, r0);
+        _mm_storeu_pd(c + 2, r1);
+    }
+};
+VECTRA_TARGET_END
+
+VECTRA_TARGET_BEGIN(VECTRA_ISA_AVX2)
+template<typename T> struct Avx2Kernel;
+
+// 6 x 16 float32 tile : 12 ymm accumulators, 2 B loads and 6 A broadcasts per k
+template<>
+struct Avx2Kernel<vectra::float32> {
+    static constexpr size_t MR = 6;
+    static constexpr size_t NR = 16;
+    static constexpr size_t MC = 144;
+    static constexpr size_t KC = 256;
+    static constexpr size_t NC = 4080;
+
+    static void micro(size_t kc, const float* a, const float* b, float* c, size_t ldc, bool accumulate)
+    {
+        __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+        __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+        __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+        __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+        __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+        __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+
+        for (size_t k = 0; k < kc; ++k) {
+            const __m256 b0 = _mm256_load_ps(b);
+            const __m256 b1 = _mm256_load_ps(b + 8);
+            __m256 ai;
+
+            ai = _mm256_broadcast_ss(a + 0); c00 = _mm256_fmadd_ps(ai, b0, c00); c01 = _mm256_fmadd_ps(ai, b1, c01);
+            ai = _mm256_broadcast_ss(a + 1); c10 = _mm256_fmadd_ps(ai, b0, c10); c11 = _mm256_fmadd_ps(ai, b1, c11);
+            ai = _mm256_broadcast_ss(a + 2); c20 = _mm256_fmadd_ps(ai, b0, c20); c21 = _mm256_fmadd_ps(ai, b1, c21);
+            ai = _mm256_broadcast_ss(a + 3); c30 = _mm256_fmadd_ps(ai, b0, c30); c31 = _mm256_fmadd_ps(ai, b1, c31);
+            ai = _mm256_broadcast_ss(a + 4); c40 = _mm256_fmadd_ps(ai, b0, c40); c41 = _mm256_fmadd_ps(ai, b1, c41);
+            ai = _mm256_broadcast_ss(a + 5); c50 = _mm256_fmadd_ps(ai, b0, c50); c51 = _mm256_fmadd_ps(ai, b1, c51);
+
+            a += MR;
+            b += NR;
+        }
+
+        store_row(c + 0 * ldc, c00, c01, accumulate);
+        store_row(c + 1 * ldc, c10, c11, accumulate);
+        store_row(c + 2 * ldc, c20, c21, accumulate);
+        store_row(c + 3 * ldc, c30, c31, accumulate);
+        store_row(c + 4 * ldc, c40, c41, accumulate);
+        store_row(c + 5 * ldc, c50, c51, accumulate);
+    }
+
+private:
+    static void store_row(float* c, __m256 r0, __m256 r1, bool accumulate)
+    {
+        if (accumulate) {
+            r0 = _mm256_add_ps(r0, _mm256_loadu_ps(c));
+            r1 = _mm256_add_ps(r1, _mm256_loadu_ps(c + 8));
+        }
+        _mm256_storeu_ps(c, r0);
+        _mm256_storeu_ps(c + 8, r1);
+    }
+};
+
+// 6 x 8 float64 tile : 12 ymm accumulators, 2 B loads and 6 A broadcasts per k
+template<>
+struct Avx2Kernel<vectra::float64> {
+    static constexpr size_t MR = 6;
+    static constexpr size_t NR = 8;
+    static constexpr size_t MC = 72;
+    static constexpr size_t KC = 256;
+    static constexpr size_t NC = 4080;
+
+    static void micro(size_t kc, const double* a, const double* b, double* c, size_t ldc, bool accumulate)
+    {
+        __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+        __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+        __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+        __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+        __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+        __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+
+        for (size_t k = 0; k < kc; ++k) {
+            const __m256d b0 = _mm256_load_pd(b);
+            const __m256d b1 = _mm256_load_pd(b + 4);
+            __m256d ai;
+
+            ai = _mm256_broadcast_sd(a + 0); c00 = _mm256_fmadd_pd(ai, b0, c00); c01 = _mm256_fmadd_pd(ai, b1, c01);
+            ai = _mm256_broadcast_sd(a + 1); c10 = _mm256_fmadd_pd(ai, b0, c10); c11 = _mm256_fmadd_pd(ai, b1, c11);
+            ai = _mm256_broadcast_sd(a + 2); c20 = _mm256_fmadd_pd(ai, b0, c20); c21 = _mm256_fmadd_pd(ai, b1, c21);
+            ai = _mm256_broadcast_sd(a + 3); c30 = _mm256_fmadd_pd(ai, b0, c30); c31 = _mm256_fmadd_pd(ai, b1, c31);
+            ai = _mm256_broadcast_sd(a + 4); c40 = _mm256_fmadd_pd(ai, b0, c40); c41 = _mm256_fmadd_pd(ai, b1, c41);
+            ai = _mm256_broadcast_sd(a + 5); c50 = _mm256_fmadd_pd(ai, b0, c50); c51 = _mm256_fmadd_pd(ai, b1, c51);
+
+            a += MR;
+            b += NR;
+        }
+
+        store_row(c + 0 * ldc, c00, c01, accumulate);
+        store_row(c + 1 * ldc, c10, c11, accumulate);
+        store_row(c + 2 * ldc, c20, c21, accumulate);
+        store_row(c + 3 * ldc, c30, c31, accumulate);
+        store_row(c + 4 * ldc, c40, c41, accumulate);
+        store_row(c + 5 * ldc, c50, c51, accumulate);
+    }
+
+private:
+    static void store_row(double* c, __m256d r0, __m256d r1, bool accumulate)
+    {
+        if (accumulate) {
+            r0 = _mm256_add_pd(r0, _mm256_loadu_pd(c));
+            r1 = _mm256_add_pd(r1, _mm256_loadu_pd(c + 4));
+        }
+        _mm256_storeu_pd(c, r0);
+        _mm256_storeu_pd(c + 4, r1);
+    }
+};
+VECTRA_TARGET_END
+
+VECTRA_TARGET_BEGIN(VECTRA_ISA_AVX512)
+template<typename T> struct Avx512Kernel;
+
+// 12 x 32 float32 tile : 24 zmm accumulators, 2 B loads and 12 A broadcasts per k.
+// Partial tiles are stored in place : the columns through mask registers, the rows by count
+template<>
+struct Avx512Kernel<vectra::float32> {
+    static constexpr size_t MR = 12;
+    static constexpr size_t NR = 32;
+    static constexpr size_t MC = 144;
+    static constexpr size_t KC = 192;
+    static constexpr size_t NC = 4096;
+
+    static void micro(size_t kc, const float* a, const float* b, float* c, size_t ldc, bool accumulate)
+    {
+        micro_edge(kc, a, b, c, ldc, accumulate, MR, NR);
+    }
+
+    static void micro_edge(size_t kc, const float* a, const float* b, float* c, size_t ldc, bool accumulate,
+                           size_t mr, size_t nr)
+    {
+        __m512 c00 = _mm512_setzero_ps(), c01 = _mm512_setzero_ps();
+        __m512 c10 = _mm512_setzero_ps(), c11 = _mm512_setzero_ps();
+        __m512 c20 = _mm512_setzero_ps(), c21 = _mm512_setzero_ps();
+        __m512 c30 = _mm512_setzero_ps(), c31 = _mm512_setzero_ps();
+        __m512 c40 = _mm512_setzero_ps(), c41 = _mm512_setzero_ps();
+        __m512 c50 = _mm512_setzero_ps(), c51 = _mm512_setzero_ps();
+        __m512 c60 = _mm512_setzero_ps(), c61 = _mm512_setzero_ps();
+        __m512 c70 = _mm512_setzero_ps(), c71 = _mm512_setzero_ps();
+        __m512 c80 = _mm512_setzero_ps(), c81 = _mm512_setzero_ps();
+        __m512 c90 = _mm512_setzero_ps(), c91 = _mm512_setzero_ps();
+        __m512 ca0 = _mm512_setzero_ps(), ca1 = _mm512_setzero_ps();
+        __m512 cb0 = _mm512_setzero_ps(), cb1 = _mm512_setzero_ps();
+
+        for (size_t k = 0; k < kc; ++k) {
+            const __m512 b0 = _mm512_load_ps(b);
+            const __m512 b1 = _mm512_load_ps(b + 16);
+            __m512 ai;
+
+            ai = _mm512_set1_ps(a[0]);  c00 = _mm512_fmadd_ps(ai, b0, c00); c01 = _mm512_fmadd_ps(ai, b1, c01);
+            ai = _mm512_set1_ps(a[1]);  c10 = _mm512_fmadd_ps(ai, b0, c10); c11 = _mm512_fmadd_ps(ai, b1, c11);
+            ai = _mm512_set1_ps(a[2]);  c20 = _mm512_fmadd_ps(ai, b0, c20); c21 = _mm512_fmadd_ps(ai, b1, c21);
+            ai = _mm512_set1_ps(a[3]);  c30 = _mm512_fmadd_ps(ai, b0, c30); c31 = _mm512_fmadd_ps(ai, b1, c31);
+            ai = _mm512_set1_ps(a[4]);  c40 = _mm512_fmadd_ps(ai, b0, c40); c41 = _mm512_fmadd_ps(ai, b1, c41);
+            ai = _mm512_set1_ps(a[5]);  c50 = _mm512_fmadd_ps(ai, b0, c50); c51 = _mm512_fmadd_ps(ai, b1, c51);
+            ai = _mm512_set1_ps(a[6]);  c60 = _mm512_fmadd_ps(ai, b0, c60); c61 = _mm512_fmadd_ps(ai, b1, c61);
+            ai = _mm512_set1_ps(a[7]);  c70 = _mm512_fmadd_ps(ai, b0, c70); c71 = _mm512_fmadd_ps(ai, b1, c71);
+            ai = _mm512_set1_ps(a[8]);  c80 = _mm512_fmadd_ps(ai, b0, c80); c81 = _mm512_fmadd_ps(ai, b1, c81);
+            ai = _mm512_set1_ps(a[9]);  c90 = _mm512_fmadd_ps(ai, b0, c90); c91 = _mm512_fmadd_ps(ai, b1, c91);
+            ai = _mm512_set1_ps(a[10]); ca0 = _mm512_fmadd_ps(ai, b0, ca0); ca1 = _mm512_fmadd_ps(ai, b1, ca1);
+            ai = _mm512_set1_ps(a[11]); cb0 = _mm512_fmadd_ps(ai, b0, cb0); cb1 = _mm512_fmadd_ps(ai, b1, cb1);
+
+            a += MR;
+            b += NR;
+        }
+
+        const __mmask16 m0 = first(nr);
+        const __mmask16 m1 = first(nr > 16 ? nr - 16 : 0);
+
+        store_row(c + 0 * ldc,  c00, c01, m0, m1, accumulate);
+        if (mr > 1)  store_row(c + 1 * ldc,  c10, c11, m0, m1, accumulate);
+        if (mr > 2)  store_row(c + 2 * ldc,  c20, c21, m0, m1, accumulate);
+        if (mr > 3)  store_row(c + 3 * ldc,  c30, c31, m0, m1, accumulate);
+        if (mr > 4)  store_row(c + 4 * ldc,  c40, c41, m0, m1, accumulate);
+        if (mr > 5)  store_row(c + 5 * ldc,  c50, c51, m0, m1, accumulate);
+        if (mr > 6)  store_row(c + 6 * ldc,  c60, c61, m0, m1, accumulate);
+        if (mr > 7)  store_row(c + 7 * ldc,  c70, c71, m0, m1, accumulate);
+        if (mr > 8)  store_row(c + 8 * ldc,  c80, c81, m0, m1, accumulate);
+        if (mr > 9)  store_row(c + 9 * ldc,  c90, c91, m0, m1, accumulate);
+        if (mr > 10) store_row(c + 10 * ldc, ca0, ca1, m0, m1, accumulate);
+        if (mr > 11) store_row(c + 11 * ldc, cb0, cb1, m0, m1, accumulate);
+    }
+
+private:
+    // first n lanes (n >= 16 : all of them)
+    static __mmask16 first(size_t n) { return n >= 16 ? __mmask16(0xFFFF) : __mmask16((1u << n) - 1); }
+
+    static void store_row(float* c, __m512 r0, __m512 r1, __mmask16 m0, __mmask16 m1, bool accumulate)
+    {
+        if (accumulate) {
+            r0 = _mm512_add_ps(r0, _mm512_maskz_loadu_ps(m0, c));
+            r1 = _mm512_add_ps(r1, _mm512_maskz_loadu_ps(m1, c + 16));
+        }
+        _mm512_mask_storeu_ps(c, m0, r0);
+        _mm512_mask_storeu_ps(c + 16, m1, r1);
+    }
+};
+
+// 12 x 16 float64 tile : 24 zmm accumulators, 2 B loads and 12 A broadcasts per k
+template<>
+struct Avx512Kernel<vectra::float64> {
+    static constexpr size_t MR = 12;
+    static constexpr size_t NR = 16;
+    static constexpr size_t MC = 96;
+    static constexpr size_t KC = 192;
+    static constexpr size_t NC = 4096;
+
+    static void micro(size_t kc, const double* a, const double* b, double* c, size_t ldc, bool accumulate)
+    {
+        micro_edge(kc, a, b, c, ldc, accumulate, MR, NR);
+    }
+
+    static void micro_edge(size_t kc, const double* a, const double* b, double* c, size_t ldc, bool accumulate,
+                           size_t mr, size_t nr)
+    {
+        __m512d c00 = _mm512_setzero_pd(), c01 = _mm512_setzero_pd();
+        __m512d c10 = _mm512_setzero_pd(), c11 = _mm512_setzero_pd();
+        __m512d c20 = _mm512_setzero_pd(), c21 = _mm512_setzero_pd();
+        __m512d c30 = _mm512_setzero_pd(), c31 = _mm512_setzero_pd();
+        __m512d c40 = _mm512_setzero_pd(), c41 = _mm512_setzero_pd();
+        __m512d c50 = _mm512_setzero_pd(), c51 = _mm512_setzero_pd();
+        __m512d c60 = _mm512_setzero_pd(), c61 = _mm512_setzero_pd();
+        __m512d c70 = _mm512_setzero_pd(), c71 = _mm512_setzero_pd();
+        __m512d c80 = _mm512_setzero_pd(), c81 = _mm512_setzero_pd();
+        __m512d c90 = _mm512_setzero_pd(), c91 = _mm512_setzero_pd();
+        __m512d ca0 = _mm512_setzero_pd(), ca1 = _mm512_setzero_pd();
+        __m512d cb0 = _mm512_setzero_pd(), cb1 = _mm512_setzero_pd();
+
+        for (size_t k = 0; k < kc; ++k) {
+            const __m512d b0 = _mm512_load_pd(b);
+            const __m512d b1 = _mm512_load_pd(b + 8);
+            __m512d ai;
+
+            ai = _mm512_set1_pd(a[0]);  c00 = _mm512_fmadd_pd(ai, b0, c00); c01 = _mm512_fmadd_pd(ai, b1, c01);
+            ai = _mm512_set1_pd(a[1]);  c10 = _mm512_fmadd_pd(ai, b0, c10); c11 = _mm512_fmadd_pd(ai, b1, c11);
+            ai = _mm512_set1_pd(a[2]);  c20 = _mm512_fmadd_pd(ai, b0, c20); c21 = _mm512_fmadd_pd(ai, b1, c21);
+            ai = _mm512_set1_pd(a[3]);  c30 = _mm512_fmadd_pd(ai, b0, c30); c31 = _mm512_fmadd_pd(ai, b1, c31);
+            ai = _mm512_set1_pd(a[4]);  c40 = _mm512_fmadd_pd(ai, b0, c40); c41 = _mm512_fmadd_pd(ai, b1, c41);
+            ai = _mm512_set1_pd(a[5]);  c50 = _mm512_fmadd_pd(ai, b0, c50); c51 = _mm512_fmadd_pd(ai, b1, c51);
+            ai = _mm512_set1_pd(a[6]);  c60 = _mm512_fmadd_pd(ai, b0, c60); c61 = _mm512_fmadd_pd(ai, b1, c61);
+            ai = _mm512_set1_pd(a[7]);  c70 = _mm512_fmadd_pd(ai, b0, c70); c71 = _mm512_fmadd_pd(ai, b1, c71);
+            ai = _mm512_set1_pd(a[8]);  c80 = _mm512_fmadd_pd(ai, b0, c80); c81 = _mm512_fmadd_pd(ai, b1, c81);
+            ai = _mm512_set1_pd(a[9]);  c90 = _mm512_fmadd_pd(ai, b0, c90); c91 = _mm512_fmadd_pd(ai, b1, c91);
+            ai = _mm512_set1_pd(a[10]); ca0 = _mm512_fmadd_pd(ai, b0, ca0); ca1 = _mm512_fmadd_pd(ai, b1, ca1);
+            ai = _mm512_set1_pd(a[11]); cb0 = _mm512_fmadd_pd(ai, b0, cb0); cb1 = _mm512_fmadd_pd(ai, b1, cb1);
+
+            a += MR;
+            b += NR;
+        }
+
+        const __mmask8 m0 = first(nr);
+        const __mmask8 m1 = first(nr > 8 ? nr - 8 : 0);
+
+        store_row(c + 0 * ldc,  c00, c01, m0, m1, accumulate);
+        if (mr > 1)  store_row(c + 1 * ldc,  c10, c11, m0, m1, accumulate);
+        if (mr > 2)  store_row(c + 2 * ldc,  c20, c21, m0, m1, accumulate);
+        if (mr > 3)  store_row(c + 3 * ldc,  c30, c31, m0, m1, accumulate);
+        if (mr > 4)  store_row(c + 4 * ldc,  c40, c41, m0, m1, accumulate);
+        if (mr > 5)  store_row(c + 5 * ldc,  c50, c51, m0, m1, accumulate);
+        if (mr > 6)  store_row(c + 6 * ldc,  c60, c61, m0, m1, accumulate);
+        if (mr > 7)  store_row(c + 7 * ldc,  c70, c71, m0, m1, accumulate);
+        if (mr > 8)  store_row(c + 8 * ldc,  c80, c81, m0, m1, accumulate);
+        if (mr > 9)  store_row(c + 9 * ldc,  c90, c91, m0, m1, accumulate);
+        if (mr > 10) store_row(c + 10 * ldc, ca0, ca1, m0, m1, accumulate);
+        if (mr > 11) store_row(c + 11 * ldc, cb0, cb1, m0, m1, accumulate);
+    }
+
+private:
+    static __mmask8 first(size_t n) { return n >= 8 ? __mmask8(0xFF) : __mmask8((1u << n) - 1); }
+
+    static void store_row(double* c, __m512d r0, __m512d r1, __mmask8 m0, __mmask8 m1, bool accumulate)
+    {
+        if (accumulate) {
+            r0 = _mm512_add_pd(r0, _mm512_maskz_loadu_pd(m0, c));
+            r1 = _mm512_add_pd(r1, _mm512_maskz_loadu_pd(m1, c + 8));
+        }
+        _mm512_mask_storeu_pd(c, m0, r0);
+        _mm512_mask_storeu_pd(c + 8, m1, r1);
+    }
+};
+VECTRA_TARGET_END
+
+/*
+ *
+ * Packing
+ *
+*/
+
+// A block (mc x kc) -> MR-row micro-panels, each stored k-major : panel[k * MR + i]
+// rs, cs are the row and column strides of A (transposed views pack without a copy)
+template<size_t MR, typename T>
+void pack_a(size_t mc, size_t kc, const T* A, size_t rs, size_t cs, T* dst)
+{
+    for (size_t ir = 0; ir < mc; ir += MR) {
+        const size_t mr = std::min(MR, mc - ir);
+        const T* src = A + ir * rs;
+
+        for (size_t k = 0; k < kc; ++k) {
+            size_t i = 0;
+            for (; i < mr; ++i) dst[i] = src[i * rs + k * cs];
+            for (; i < MR; ++i) dst[i] = T{0};
+            dst += MR;
+        }
+    }
+}
+
+// B panel (kc x nc) -> NR-column micro-panels, each stored k-major : panel[k * NR + j]
+// rs, cs are the row and column strides of B
+template<size_t NR, typename T>
+void pack_b(size_t kc, size_t nc, const T* B, size_t rs, size_t cs, T* dst)
+{
+    for (size_t jr = 0; jr < nc; jr += NR) {
+        const size_t nr = std::min(NR, nc - jr);
+        const T* src = B + jr * cs;
+
+        for (size_t k = 0; k < kc; ++k) {
+            size_t j = 0;
+            if (cs == 1) {
+                for (; j < nr; ++j) dst[j] = src[k * rs + j];
+            }
+            else {
+                for (; j < nr; ++j) dst[j] = src[k * rs + j * cs];
+            }
+            for (; j < NR; ++j) dst[j] = T{0};
+            dst += NR;
+        }
+    }
+}
+
+/*
+ *
+ * Blocked driver
+ *
+*/
+
+// packed A block of the calling thread, kept between calls and grown on demand
+template<typename T>
+T* thread_pack_buffer(size_t count)
+{
+    static thread_local utils::vector<T> buffer;
+
+    buffer.resize(count);
+    return buffer.data;
+}
+
+// Below this amount of work (flops) the whole product runs on the calling thread
+static constexpr size_t GEMM_PARALLEL_MIN_FLOPS = size_t(1) << 21;
+
+// kernels that store a partial mr x nr tile in place (masked stores) provide micro_edge()
+template<typename Kernel, typename = void>
+struct has_micro_edge : std::false_type {};
+
+template<typename Kernel>
+struct has_micro_edge<Kernel, std::void_t<decltype(&Kernel::micro_edge)>> : std::true_type {};
+
+// C[mc x nc] (+)= packed A block * packed B panel
+template<typename Kernel, typename T>
+void macro_kernel(size_t mc, size_t nc, size_t kc, const T* packA, const T* packB, T* C, size_t ldc, bool accumulate)
+{
+    constexpr size_t MR = Kernel::MR;
+    constexpr size_t NR = Kernel::NR;
+
+    alignas(64) T edge[MR * NR];
+
+    for (size_t jr = 0; jr < nc; jr += NR) {
+        const size_t nr = std::min(NR, nc - jr);
+        const T* b_panel = packB + jr * kc;
+
+        for (size_t ir = 0; ir < mc; ir += MR) {
+            const size_t mr = std::min(MR, mc - ir);
+            const T* a_panel = packA + ir * kc;
+            T* c_tile = C + ir * ldc + jr;
+
+            if (mr == MR && nr == NR) {
+                Kernel::micro(kc, a_panel, b_panel, c_tile, ldc, accumulate);
+            }
+            else if constexpr (has_micro_edge<Kernel>::value) {
+                Kernel::micro_edge(kc, a_panel, b_panel, c_tile, ldc, accumulate, mr, nr);
+            }
+            else {
+                // partial tile : compute the full tile aside and copy the valid part
+                Kernel::micro(kc, a_panel, b_panel, edge, NR, false);
+                for (size_t i = 0; i < mr; ++i) {
+                    for (size_t j = 0; j < nr; ++j) {
+                        c_tile[i * ldc + j] = accumulate ? c_tile[i * ldc + j] + edge[i * NR + j]
+                                                         : edge[i * NR + j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+template<typename Kernel, typename T>
+void gemm_blocked(size_t M, size_t N, size_t K,
+                  const T* A, size_t rsa, size_t csa,
+                  const T* B, size_t rsb, size_t csb,
+                  T* C, size_t ldc)
+{
+    constexpr size_t MR = Kernel::MR;
+    constexpr size_t NR = Kernel::NR;
+    constexpr size_t MC = Kernel::MC;
+    constexpr size_t KC = Kernel::KC;
+    constexpr size_t NC = Kernel::NC;
+
+    if (M == 0 || N == 0) return;
+
+    if (K == 0) {
+        for (size_t i = 0; i < M; ++i) std::fill(C + i * ldc, C + i * ldc + N, T{0});
+        return;
+    }
+
+    const bool parallel = 2 * M * N * K >= GEMM_PARALLEL_MIN_FLOPS;
+    const size_t threads = parallel ? utils::get_num_threads() : 1;
+
+    // rows per task : MC, shrunk (to a multiple of MR) so every thread gets a block of C
+    size_t mc_task = MC;
+    if (threads > 1) {
+        const size_t rows = (M + threads - 1) / threads;
+        mc_task = std::min(MC, std::max(MR, (rows + MR - 1) / MR * MR));
+    }
+    const size_t blocks = (M + mc_task - 1) / mc_task;
+
+    utils::vector<T> packB(KC * ((std::min(NC, N) + NR - 1) / NR * NR));   // 64 byte aligned
+
+    for (size_t jc = 0; jc < N; jc += NC) {
+        const size_t nc = std::min(NC, N - jc);
+        const size_t panels = (nc + NR - 1) / NR;
+
+        for (size_t pc = 0; pc < K; pc += KC) {
+            const size_t kc = std::min(KC, K - pc);
+            const bool accumulate = pc != 0;
+
+            // B panel is shared by every block of rows : pack it cooperatively
+            utils::parallel_for(0, panels, parallel ? 1 : panels, [&](size_t lo, size_t hi) {
+                const size_t cols = std::min(nc, hi * NR) - lo * NR;
+                pack_b<NR>(kc, cols, B + pc * rsb + (jc + lo * NR) * csb, rsb, csb, packB.data + lo * NR * kc);
+            });
+
+            utils::parallel_for(0, blocks, parallel ? 1 : blocks, [&](size_t lo, size_t hi) {
+                T* packA = thread_pack_buffer<T>(MC * KC);
+
+                for (size_t blk = lo; blk < hi; ++blk) {
+                    const size_t ic = blk * mc_task;
+                    const size_t mc = std::min(mc_task, M - ic);
+
+                    pack_a<MR>(mc, kc, A + ic * rsa + pc * csa, rsa, csa, packA);
+                    macro_kernel<Kernel>(mc, nc, kc, packA, packB.data, C + ic * ldc + jc, ldc, accumulate);
+                }
+            });
+        }
+    }
+}
+
+/*
+ *
+ * Entry point : C[M x N] = A[M x K] * B[K x N]
+ * A and B are addressed through row/column strides (rs, cs), C is row-major with leading dimension ldc
+ *
+*/
+
+template<typename T>
+void gemm(size_t M, size_t N, size_t K,
+          const T* A, size_t rsa, size_t csa,
+          const T* B, size_t rsb, size_t csb,
+          T* C, size_t ldc)
+{
+    static_assert(std::is_same_v<T, vectra::float32> || std::is_same_v<T, vectra::float64>,
+                  "gemm() only supports float32 and float64");
+
+    static const auto fn = select_kernel(&gemm_blocked<Avx512Kernel<T>, T>, &gemm_blocked<Avx2Kernel<T>, T>,
+                                         &gemm_blocked<Sse42Kernel<T>, T>, &gemm_blocked<ScalarKernel<T>, T>);
+    fn(M, N, K, A, rsa, csa, B, rsb, csb, C, ldc);
+}
+
+} // namespace gemm
+} // namespace kernel
+} // namespace vectra
+
+#endif // __cplusplus
+#endif // GEMM_H
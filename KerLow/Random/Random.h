@@ -0,0 +1,371 @@
+/*
+ *
+ * Random.h (v1.0)
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Counter-based random numbers for float32 and float64 buffers (HEADER).
+ * The generator is Philox4x32-10 (Salmon et al., "Parallel random numbers : as easy as
+ * 1, 2, 3", SC11) : block b of a stream is the encryption of the counter (b, 0) under the
+ * 64-bit key, four 32-bit words with no state carried from one block to the next. Any range of
+ * the stream is generated on its own, so a tensor filled by several threads holds the same
+ * values as one filled by a single thread.
+ *
+ * Stream layout (the same at every ISA level) :
+ *   float32   value i = word i % 4 of block i / 4 : (w >> 8) 2^-24 in [0, 1)
+ *   float64   value i = words 2 (i % 2), 2 (i % 2) + 1 of block i / 2 (low word first) as u,
+ *             (u >> 12) 2^-52 in [0, 1)
+ *   normal    Box-Muller over the pairs (2k, 2k + 1) of the uniform stream
+ *
+ * Uniform values are bit-identical at every level. Normal values use the polynomial log and
+ * sin / cos of the SIMD levels (identical between avx2 and avx512) and the libm at the scalar
+ * and sse4.2 levels, which may differ in the last bits.
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#pragma once
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#ifdef __cplusplus
+
+#include <VecMath/VecMath.h>
+#include <Dispatch/Dispatch.h>
+#include <immintrin.h>
+#include <algorithm>
+#include <type_traits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace vectra {
+namespace kernel {
+
+// Philox4x32 multipliers and Weyl key increments
+constexpr uint32_t PHILOX_M0 = 0xD2511F53u;
+constexpr uint32_t PHILOX_M1 = 0xCD9E8D57u;
+constexpr uint32_t PHILOX_W0 = 0x9E3779B9u;
+constexpr uint32_t PHILOX_W1 = 0xBB67AE85u;
+constexpr int PHILOX_ROUNDS = 10;
+
+// values of T drawn from one Philox block
+template<typename T>
+constexpr size_t random_per_block() { return 16 / sizeof(T); }
+
+/*
+ *
+ * Scalar kernel (scalar and sse4.2 levels)
+ *
+*/
+
+namespace scalar {
+
+// one Philox4x32-10 block : counter `c` (4 words) encrypted in place under `key`
+inline void philox4x32(uint32_t c[4], uint64_t key)
+{
+    uint32_t k0 = uint32_t(key);
+    uint32_t k1 = uint32_t(key >> 32);
+
+    for (int r = 0; r < PHILOX_ROUNDS; ++r) {
+        const uint64_t p0 = uint64_t(PHILOX_M0) * c[0];
+        const uint64_t p1 = uint64_t(PHILOX_M1) * c[2];
+        const uint32_t n0 = uint32_t(p1 >> 32) ^ c[1] ^ k0;
+        const uint32_t n2 = uint32_t(p0 >> 32) ^ c[3] ^ k1;
+        c[1] = uint32_t(p1);
+        c[3] = uint32_t(p0);
+        c[0] = n0;
+        c[2] = n2;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+}
+
+// uniform values of one block, in stream order
+template<typename T>
+inline void philox_unit(uint64_t key, uint64_t block, T (&u)[random_per_block<T>()])
+{
+    uint32_t w[4] = { uint32_t(block), uint32_t(block >> 32), 0, 0 };
+    philox4x32(w, key);
+
+    if constexpr (std::is_same_v<T, float>) {
+        for (int j = 0; j < 4; ++j) u[j] = float(w[j] >> 8) * 0x1p-24f;
+    }
+    else {
+        for (int j = 0; j < 2; ++j) {
+            const uint64_t bits = ((uint64_t(w[2 * j + 1]) << 32 | w[2 * j]) >> 12) | 0x3FF0000000000000ull;
+            double d;
+            std::memcpy(&d, &bits, sizeof(d));
+            u[j] = d - 1.0;
+        }
+    }
+}
+
+template<typename T>
+void random_uniform(uint64_t key, uint64_t block, T* out, size_t n)
+{
+    constexpr size_t PB = random_per_block<T>();
+    T u[PB];
+
+    for (size_t i = 0; i < n; i += PB, ++block) {
+        philox_unit<T>(key, block, u);
+        for (size_t j = 0; j < PB && i + j < n; ++j) out[i + j] = u[j];
+    }
+}
+
+template<typename T>
+void random_normal(uint64_t key, uint64_t block, T* out, size_t n)
+{
+    constexpr size_t PB = random_per_block<T>();
+    constexpr T two_pi = T(6.28318530717958647692);
+    T u[PB];
+
+    for (size_t i = 0; i < n; i += PB, ++block) {
+        philox_unit<T>(key, block, u);
+        for (size_t j = 0; j < PB && i + j < n; j += 2) {
+            const T r = std::sqrt(T(-2) * std::log(T(1) - u[j]));
+            out[i + j] = r * std::cos(two_pi * u[j + 1]);
+            if (i + j + 1 < n) out[i + j + 1] = r * std::sin(two_pi * u[j + 1]);
+        }
+    }
+}
+
+} // namespace scalar
+
+/*
+ *
+ * AVX2 : 8 blocks per step
+ *
+*/
+
+VECTRA_TARGET_BEGIN(VECTRA_ISA_AVX2)
+namespace avx2 {
+
+struct philox_vec {
+    using reg = __m256i;
+    static constexpr size_t lanes = 8;
+
+    static reg zero() { return _mm256_setzero_si256(); }
+
+    // counters block .. block + 7, the lanes past a 2^32 boundary carry into the high word
+    static void counter(uint64_t block, reg& c0, reg& c1) {
+        const reg idx = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const reg bias = _mm256_set1_epi32(int(0x80000000u));
+        c0 = _mm256_add_epi32(_mm256_set1_epi32(int(uint32_t(block))), idx);
+        const reg carry = _mm256_cmpgt_epi32(_mm256_xor_si256(idx, bias), _mm256_xor_si256(c0, bias));
+        c1 = _mm256_sub_epi32(_mm256_set1_epi32(int(uint32_t(block >> 32))), carry);
+    }
+
+    // 32 x 32 -> 64-bit products : even lanes, then odd lanes shifted down
+    static void mulhilo(reg x, uint32_t m, reg& hi, reg& lo) {
+        const reg vm = _mm256_set1_epi32(int(m));
+        const reg even = _mm256_mul_epu32(x, vm);
+        const reg odd = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), vm);
+        hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+        lo = _mm256_mullo_epi32(x, vm);
+    }
+
+    static reg bxor(reg a, reg b, uint32_t k) {
+        return _mm256_xor_si256(_mm256_xor_si256(a, b), _mm256_set1_epi32(int(k)));
+    }
+
+    // word-major registers (lane = block) to block order : 4 x 8 transpose
+    static void store_blocks(uint32_t* out, reg c0, reg c1, reg c2, reg c3) {
+        const reg t0 = _mm256_unpacklo_epi32(c0, c1);
+        const reg t1 = _mm256_unpackhi_epi32(c0, c1);
+        const reg t2 = _mm256_unpacklo_epi32(c2, c3);
+        const reg t3 = _mm256_unpackhi_epi32(c2, c3);
+        const reg u0 = _mm256_unpacklo_epi64(t0, t2);    // blocks 0 | 4
+        const reg u1 = _mm256_unpackhi_epi64(t0, t2);    // blocks 1 | 5
+        const reg u2 = _mm256_unpacklo_epi64(t1, t3);    // blocks 2 | 6
+        const reg u3 = _mm256_unpackhi_epi64(t1, t3);    // blocks 3 | 7
+        _mm256_storeu_si256(reinterpret_cast<reg*>(out),      _mm256_permute2x128_si256(u0, u1, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<reg*>(out + 8),  _mm256_permute2x128_si256(u2, u3, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<reg*>(out + 16), _mm256_permute2x128_si256(u0, u1, 0x31));
+        _mm256_storeu_si256(reinterpret_cast<reg*>(out + 24), _mm256_permute2x128_si256(u2, u3, 0x31));
+    }
+};
+
+template<typename T>
+struct rng_vec;
+
+template<>
+struct rng_vec<vectra::float32> {
+    using reg = __m256;
+
+    static reg unit(const uint32_t* w) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w));
+        return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(x, 8)), _mm256_set1_ps(0x1p-24f));
+    }
+    static void split(reg a, reg b, reg& even, reg& odd) {
+        even = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        odd  = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    }
+    static void merge(reg even, reg odd, reg& a, reg& b) {
+        a = _mm256_unpacklo_ps(even, odd);
+        b = _mm256_unpackhi_ps(even, odd);
+    }
+};
+
+template<>
+struct rng_vec<vectra::float64> {
+    using reg = __m256d;
+
+    // 52 random bits under the exponent of 1.0 : [1, 2) - 1
+    static reg unit(const uint32_t* w) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w));
+        const __m256i one = _mm256_set1_epi64x(0x3FF0000000000000ll);
+        return _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(x, 12), one)), _mm256_set1_pd(1.0));
+    }
+    static void split(reg a, reg b, reg& even, reg& odd) {
+        even = _mm256_unpacklo_pd(a, b);
+        odd  = _mm256_unpackhi_pd(a, b);
+    }
+    static void merge(reg even, reg odd, reg& a, reg& b) {
+        a = _mm256_unpacklo_pd(even, odd);
+        b = _mm256_unpackhi_pd(even, odd);
+    }
+};
+
+#include <Random/RandomImpl.h>
+
+} // namespace avx2
+VECTRA_TARGET_END
+
+/*
+ *
+ * AVX-512 : 16 blocks per step
+ *
+*/
+
+VECTRA_TARGET_BEGIN(VECTRA_ISA_AVX512)
+namespace avx512 {
+
+struct philox_vec {
+    using reg = __m512i;
+    static constexpr size_t lanes = 16;
+
+    static reg zero() { return _mm512_setzero_si512(); }
+
+    static void counter(uint64_t block, reg& c0, reg& c1) {
+        const reg idx = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        const reg hi = _mm512_set1_epi32(int(uint32_t(block >> 32)));
+        c0 = _mm512_add_epi32(_mm512_set1_epi32(int(uint32_t(block))), idx);
+        c1 = _mm512_mask_add_epi32(hi, _mm512_cmplt_epu32_mask(c0, idx), hi, _mm512_set1_epi32(1));
+    }
+
+    static void mulhilo(reg x, uint32_t m, reg& hi, reg& lo) {
+        const reg vm = _mm512_set1_epi32(int(m));
+        const reg even = _mm512_mul_epu32(x, vm);
+        const reg odd = _mm512_mul_epu32(_mm512_srli_epi64(x, 32), vm);
+        hi = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(even, 32), odd);
+        lo = _mm512_mullo_epi32(x, vm);
+    }
+
+    static reg bxor(reg a, reg b, uint32_t k) {
+        return _mm512_ternarylogic_epi32(a, b, _mm512_set1_epi32(int(k)), 0x96);
+    }
+
+    // 4 x 16 transpose : within the 128-bit lanes first, then across them
+    static void store_blocks(uint32_t* out, reg c0, reg c1, reg c2, reg c3) {
+        const reg t0 = _mm512_unpacklo_epi32(c0, c1);
+        const reg t1 = _mm512_unpackhi_epi32(c0, c1);
+        const reg t2 = _mm512_unpacklo_epi32(c2, c3);
+        const reg t3 = _mm512_unpackhi_epi32(c2, c3);
+        const reg u0 = _mm512_unpacklo_epi64(t0, t2);    // blocks 0 | 4 | 8 | 12
+        const reg u1 = _mm512_unpackhi_epi64(t0, t2);    // blocks 1 | 5 | 9 | 13
+        const reg u2 = _mm512_unpacklo_epi64(t1, t3);    // blocks 2 | 6 | 10 | 14
+        const reg u3 = _mm512_unpackhi_epi64(t1, t3);    // blocks 3 | 7 | 11 | 15
+        const reg v0 = _mm512_shuffle_i32x4(u0, u1, 0x44);    // 0 4 1 5
+        const reg v1 = _mm512_shuffle_i32x4(u0, u1, 0xEE);    // 8 12 9 13
+        const reg v2 = _mm512_shuffle_i32x4(u2, u3, 0x44);    // 2 6 3 7
+        const reg v3 = _mm512_shuffle_i32x4(u2, u3, 0xEE);    // 10 14 11 15
+        _mm512_storeu_si512(out,      _mm512_shuffle_i32x4(v0, v2, 0x88));
+        _mm512_storeu_si512(out + 16, _mm512_shuffle_i32x4(v0, v2, 0xDD));
+        _mm512_storeu_si512(out + 32, _mm512_shuffle_i32x4(v1, v3, 0x88));
+        _mm512_storeu_si512(out + 48, _mm512_shuffle_i32x4(v1, v3, 0xDD));
+    }
+};
+
+template<typename T>
+struct rng_vec;
+
+template<>
+struct rng_vec<vectra::float32> {
+    using reg = __m512;
+
+    static reg unit(const uint32_t* w) {
+        const __m512i x = _mm512_loadu_si512(w);
+        return _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_srli_epi32(x, 8)), _mm512_set1_ps(0x1p-24f));
+    }
+    static void split(reg a, reg b, reg& even, reg& odd) {
+        even = _mm512_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        odd  = _mm512_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    }
+    static void merge(reg even, reg odd, reg& a, reg& b) {
+        a = _mm512_unpacklo_ps(even, odd);
+        b = _mm512_unpackhi_ps(even, odd);
+    }
+};
+
+template<>
+struct rng_vec<vectra::float64> {
+    using reg = __m512d;
+
+    static reg unit(const uint32_t* w) {
+        const __m512i x = _mm512_loadu_si512(w);
+        const __m512i one = _mm512_set1_epi64(0x3FF0000000000000ll);
+        return _mm512_sub_pd(_mm512_castsi512_pd(_mm512_or_si512(_mm512_srli_epi64(x, 12), one)), _mm512_set1_pd(1.0));
+    }
+    static void split(reg a, reg b, reg& even, reg& odd) {
+        even = _mm512_unpacklo_pd(a, b);
+        odd  = _mm512_unpackhi_pd(a, b);
+    }
+    static void merge(reg even, reg odd, reg& a, reg& b) {
+        a = _mm512_unpacklo_pd(even, odd);
+        b = _mm512_unpackhi_pd(even, odd);
+    }
+};
+
+#include <Random/RandomImpl.h>
+
+} // namespace avx512
+VECTRA_TARGET_END
+
+/*
+ *
+ * Entry points : kernel of the active ISA level (Dispatch.h), resolved on first use.
+ * `block` is the first Philox block of `out` : the values depend only on (key, block, n),
+ * never on how a range is split between calls.
+ *
+*/
+
+template<typename T>
+void random_uniform(uint64_t key, uint64_t block, T* out, size_t n)
+{
+    static_assert(std::is_floating_point_v<T>, "random_uniform() only supports floating-point types");
+    static const auto fn = select_kernel(&avx512::rng::uniform<T>, &avx2::rng::uniform<T>,
+                                         &scalar::random_uniform<T>, &scalar::random_uniform<T>);
+    fn(key, block, out, n);
+}
+
+template<typename T>
+void random_normal(uint64_t key, uint64_t block, T* out, size_t n)
+{
+    static_assert(std::is_floating_point_v<T>, "random_normal() only supports floating-point types");
+    static const auto fn = select_kernel(&avx512::rng::normal<T>, &avx2::rng::normal<T>,
+                                         &scalar::random_normal<T>, &scalar::random_normal<T>);
+    fn(key, block, out, n);
+}
+
+} // namespace kernel
+} // namespace vectra
+
+#endif // __cplusplus
+#endif // RANDOM_H
@@ -0,0 +1,169 @@
+/*
+ *
+ * RandomImpl.h (v1.0)
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Generic algorithms of Random.h (HEADER, no include guard).
+ * Included by Random.h inside the namespace of every SIMD level, within its target region,
+ * after the register interfaces of the level :
+ *   math_vec<T>   arithmetic (VecMath.h)
+ *   philox_vec    reg (P::lanes uint32), counter(block, c0, c1), zero(), mulhilo(x, m, hi, lo),
+ *                 bxor(a, b, k) = a ^ b ^ k, store_blocks(out, c0, c1, c2, c3) in block order
+ *   rng_vec<T>    unit(words) = lanes of [0, 1) in stream order, split(a, b, even, odd) and its
+ *                 inverse merge(even, odd, a, b) over adjacent pairs
+ * Do not include it anywhere else.
+ * This file is a part of VECTRA framework
+ *
+*/
+
+namespace rng {
+
+// Philox4x32-10 of the blocks [block, block + nblocks), nblocks a multiple of philox_vec::lanes
+inline void philox_blocks(uint64_t key, uint64_t block, uint32_t* out, size_t nblocks)
+{
+    using P = philox_vec;
+    using I = typename P::reg;
+
+    for (size_t b = 0; b < nblocks; b += P::lanes) {
+        I c0, c1;
+        P::counter(block + b, c0, c1);
+        I c2 = P::zero();
+        I c3 = P::zero();
+        uint32_t k0 = uint32_t(key);
+        uint32_t k1 = uint32_t(key >> 32);
+
+        for (int r = 0; r < PHILOX_ROUNDS; ++r) {
+            I hi0, lo0, hi1, lo1;
+            P::mulhilo(c0, PHILOX_M0, hi0, lo0);
+            P::mulhilo(c2, PHILOX_M1, hi1, lo1);
+            c0 = P::bxor(hi1, c1, k0);
+            c1 = lo1;
+            c2 = P::bxor(hi0, c3, k1);
+            c3 = lo0;
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+        P::store_blocks(out + 4 * b, c0, c1, c2, c3);
+    }
+}
+
+// (sin, cos) of 2 pi t, t in [0, 1) : the quarter turns q = round(4 t) come off exactly, the
+// Taylor polynomials run on |x| <= pi / 4 and the result is rotated back by q
+template<typename V>
+inline void sincos_turn(typename V::reg t, typename V::reg& s, typename V::reg& c)
+{
+    using T = typename V::scalar;
+    using R = typename V::reg;
+
+    const R q = V::round(V::mul(t, V::set1(T(4))));
+    const R x = V::mul(V::fnma(q, V::set1(T(0.25)), t), V::set1(T(6.28318530717958647692)));
+    const R x2 = V::mul(x, x);
+
+    R sn, cs;
+    if constexpr (std::is_same_v<T, float>) {
+        static const T sc[] = { 2.7557319224e-6f, -1.9841269841e-4f, 8.3333333333e-3f, -1.6666666667e-1f };
+        static const T cc[] = { -2.7557319224e-7f, 2.4801587302e-5f, -1.3888888889e-3f, 4.1666666667e-2f, -0.5f };
+        sn = V::fma(V::mul(x, x2), vecmath::polevl<V>(x2, sc), x);
+        cs = V::fma(x2, vecmath::polevl<V>(x2, cc), V::set1(T(1)));
+    }
+    else {
+        static const T sc[] = { 2.8114572543455207632e-15, -7.6471637318198164759e-13, 1.6059043836821614599e-10,
+                                -2.5052108385441718775e-8, 2.7557319223985890653e-6, -1.9841269841269841270e-4,
+                                8.3333333333333333333e-3, -1.6666666666666666667e-1 };
+        static const T cc[] = { -1.5619206968586225796e-16, 4.7794773323873852974e-14, -1.1470745597729724714e-11,
+                                2.0876756987868098979e-9, -2.7557319223985890653e-7, 2.4801587301587301587e-5,
+                                -1.3888888888888888889e-3, 4.1666666666666666667e-2, -0.5 };
+        sn = V::fma(V::mul(x, x2), vecmath::polevl<V>(x2, sc), x);
+        cs = V::fma(x2, vecmath::polevl<V>(x2, cc), V::set1(T(1)));
+    }
+
+    // q mod 4 (q is 0 .. 4) : 1 -> (cos, -sin), 2 -> (-sin, -cos), 3 -> (-cos, sin) as (sin, cos)
+    const R qm = V::select(V::eq(q, V::set1(T(4))), V::set1(T(0)), q);
+    const typename V::mask odd = V::lor(V::eq(qm, V::set1(T(1))), V::eq(qm, V::set1(T(3))));
+    const typename V::mask neg_s = V::gt(qm, V::set1(T(1.5)));
+    const typename V::mask neg_c = V::land(V::gt(qm, V::set1(T(0.5))), V::lt(qm, V::set1(T(2.5))));
+    const R zero = V::set1(T(0));
+
+    s = V::select(odd, cs, sn);
+    c = V::select(odd, sn, cs);
+    s = V::select(neg_s, V::sub(zero, s), s);
+    c = V::select(neg_c, V::sub(zero, c), c);
+}
+
+// stream positions [block * per_block, ... + n) : one pass generates up to CHUNK blocks on the stack
+template<typename T, typename F>
+inline void for_each_chunk(uint64_t key, uint64_t block, T* out, size_t n, F&& fn)
+{
+    constexpr size_t per_block = 16 / sizeof(T);
+    constexpr size_t CHUNK = 64;
+    alignas(64) uint32_t words[4 * CHUNK];
+
+    while (n) {
+        const size_t count = std::min(n, CHUNK * per_block);
+        size_t nblocks = (count + per_block - 1) / per_block;
+        nblocks = (nblocks + philox_vec::lanes - 1) / philox_vec::lanes * philox_vec::lanes;
+
+        philox_blocks(key, block, words, nblocks);
+        fn(words, out, count);
+
+        out += count;
+        n -= count;
+        block += CHUNK;
+    }
+}
+
+template<typename T>
+void uniform(uint64_t key, uint64_t block, T* out, size_t n)
+{
+    using V = math_vec<T>;
+    constexpr size_t L = V::lanes;
+    constexpr size_t W = sizeof(T) / 4;    // words per value
+
+    for_each_chunk(key, block, out, n, [](const uint32_t* words, T* dst, size_t count) {
+        size_t i = 0;
+        for (; i + L <= count; i += L) V::store(dst + i, rng_vec<T>::unit(words + i * W));
+        if (i < count) V::store(dst + i, count - i, rng_vec<T>::unit(words + i * W));
+    });
+}
+
+// Box-Muller over the adjacent pairs (u1, u2) of the uniform stream :
+// z1 = sqrt(-2 log(1 - u1)) cos(2 pi u2), z2 = sqrt(-2 log(1 - u1)) sin(2 pi u2)
+template<typename T>
+void normal(uint64_t key, uint64_t block, T* out, size_t n)
+{
+    using V = math_vec<T>;
+    using R = typename V::reg;
+    constexpr size_t L = V::lanes;
+    constexpr size_t W = sizeof(T) / 4;
+
+    for_each_chunk(key, block, out, n, [](const uint32_t* words, T* dst, size_t count) {
+        for (size_t i = 0; i < count; i += 2 * L) {
+            R u1, u2;
+            rng_vec<T>::split(rng_vec<T>::unit(words + i * W), rng_vec<T>::unit(words + (i + L) * W), u1, u2);
+
+            // 1 - u1 is exact and in (0, 1]
+            const R r = V::sqrt(V::mul(V::set1(T(-2)), vecmath::log<V>(V::sub(V::set1(T(1)), u1))));
+            R s, c;
+            sincos_turn<V>(u2, s, c);
+
+            R a, b;
+            rng_vec<T>::merge(V::mul(r, c), V::mul(r, s), a, b);
+            if (i + 2 * L <= count) {
+                V::store(dst + i, a);
+                V::store(dst + i + L, b);
+            }
+            else {
+                V::store(dst + i, count - i < L ? count - i : L, a);
+                if (count - i > L) V::store(dst + i + L, count - i - L, b);
+            }
+        }
+    });
+}
+
+} // namespace rng
@@ -0,0 +1,484 @@
+/*
+ *
+ * Reduce.h (v1.2)
+ *
+ * v1.2 updated : * the AVX-512 reduce() no longer hands short runs to the scalar loop
+ *
+ * v1.1 updated : * SSE4.2 kernels, every ISA level is picked at runtime (Dispatch.h)
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * SIMD reduction kernels (sum, prod, max, min, argmax, argmin) over packed buffers.
+ * reduce()      folds a contiguous run (inner axis) with 4 independent accumulators so the
+ *               latency of the add / mul / max chain is hidden, then a register tree.
+ * reduce_rows() folds `rows` rows of a strided block column-wise (outer axis) : rows are
+ *               streamed 4 at a time into the output block, which stays in L1.
+ * arg_reduce()  first index of the max / min of a contiguous run.
+ * Float max / min follow the SIMD max / min instructions : NaN is not propagated.
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#pragma once
+#ifndef REDUCE_H
+#define REDUCE_H
+
+#ifdef __cplusplus
+
+#include <ScalarType/ScalarType.h>
+#include <ElementWise/ElementWise.h>
+#include <immintrin.h>
+#include <limits>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace vectra {
+namespace kernel {
+
+enum class ReduceOp {
+    Sum,
+    Prod,
+    Max,
+    Min
+};
+
+// neutral element of the reduction
+template<ReduceOp Op, typename T>
+inline T reduce_identity()
+{
+    if constexpr (Op == ReduceOp::Sum)  return T{0};
+    if constexpr (Op == ReduceOp::Prod) return T{1};
+    if constexpr (Op == ReduceOp::Max)
+        return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+    if constexpr (Op == ReduceOp::Min)
+        return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+}
+
+template<ReduceOp Op, typename T>
+inline T reduce_combine(T a, T b)
+{
+    if constexpr (Op == ReduceOp::Sum)  return static_cast<T>(a + b);
+    if constexpr (Op == ReduceOp::Prod) return static_cast<T>(a * b);
+    if constexpr (Op == ReduceOp::Max)  return b > a ? b : a;
+    if constexpr (Op == ReduceOp::Min)  return b < a ? b : a;
+}
+
+/*
+ *
+ * Scalar kernel (portable level : CPUs without SSE4.2, VECTRA_ISA=scalar)
+ *
+*/
+
+namespace scalar {
+
+template<ReduceOp Op, typename T>
+T reduce(const T* a, size_t n)
+{
+    T acc[4] = { reduce_identity<Op, T>(), reduce_identity<Op, T>(), reduce_identity<Op, T>(), reduce_identity<Op, T>() };
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        for (size_t k = 0; k < 4; ++k) acc[k] = reduce_combine<Op>(acc[k], a[i + k]);
+    }
+    for (; i < n; ++i) acc[0] = reduce_combine<Op>(acc[0], a[i]);
+
+    return reduce_combine<Op>(reduce_combine<Op>(acc[0], acc[1]), reduce_combine<Op>(acc[2], acc[3]));
+}
+
+// out[j] = fold of a[r * stride + j] over r < rows, j < n
+template<ReduceOp Op, typename T>
+void reduce_rows(const T* a, size_t rows, size_t stride, T* out, size_t n)
+{
+    for (size_t j = 0; j < n; ++j) out[j] = reduce_identity<Op, T>();
+
+    for (size_t r = 0; r < rows; ++r) {
+        const T* row = a + r * stride;
+        for (size_t j = 0; j < n; ++j) out[j] = reduce_combine<Op>(out[j], row[j]);
+    }
+}
+
+// first index of `value` in a[0, n), n when absent
+template<typename T>
+size_t find_first(const T* a, size_t n, T value)
+{
+    for (size_t i = 0; i < n; ++i) {
+        if (a[i] == value) return i;
+    }
+    return n;
+}
+
+} // namespace scalar
+
+/*
+ *
+ * SSE4.2 kernel (16 bytes per register)
+ *
+*/
+
+VECTRA_TARGET_BEGIN(VECTRA_ISA_SSE42)
+namespace sse42 {
+
+template<ReduceOp Op, typename T>
+inline typename vec<T>::reg fold(typename vec<T>::reg a, typename vec<T>::reg b)
+{
+    if constexpr (Op == ReduceOp::Sum)  return vec<T>::add(a, b);
+    if constexpr (Op == ReduceOp::Prod) return vec<T>::mul(a, b);
+    if constexpr (Op == ReduceOp::Max)  return vec<T>::max(a, b);
+    if constexpr (Op == ReduceOp::Min)  return vec<T>::min(a, b);
+}
+
+template<ReduceOp Op, typename T>
+T reduce(const T* a, size_t n)
+{
+    using V = vec<T>;
+    constexpr size_t L = V::lanes;
+
+    if (n < 4 * L) return scalar::reduce<Op>(a, n);
+
+    const typename V::reg id = V::set1(reduce_identity<Op, T>());
+    typename V::reg acc0 = id, acc1 = id, acc2 = id, acc3 = id;
+
+    size_t i = 0;
+    for (; i + 4 * L <= n; i += 4 * L) {
+        acc0 = fold<Op, T>(acc0, V::load(a + i));
+        acc1 = fold<Op, T>(acc1, V::load(a + i + L));
+        acc2 = fold<Op, T>(acc2, V::load(a + i + 2 * L));
+        acc3 = fold<Op, T>(acc3, V::load(a + i + 3 * L));
+    }
+    for (; i + L <= n; i += L) acc0 = fold<Op, T>(acc0, V::load(a + i));
+
+    alignas(16) T lanes[L];
+    V::store(lanes, fold<Op, T>(fold<Op, T>(acc0, acc1), fold<Op, T>(acc2, acc3)));
+
+    T result = scalar::reduce<Op>(lanes, L);
+    for (; i < n; ++i) result = reduce_combine<Op>(result, a[i]);
+    return result;
+}
+
+template<ReduceOp Op, typename T>
+void reduce_rows(const T* a, size_t rows, size_t stride, T* out, size_t n)
+{
+    using V = vec<T>;
+    constexpr size_t L = V::lanes;
+
+    if (rows == 0) return scalar::reduce_rows<Op>(a, rows, stride, out, n);
+
+    std::memcpy(out, a, n * sizeof(T));
+
+    size_t r = 1;
+    for (; r + 4 <= rows; r += 4) {
+        const T* r0 = a + r * stride;
+        const T* r1 = r0 + stride;
+        const T* r2 = r1 + stride;
+        const T* r3 = r2 + stride;
+
+        size_t j = 0;
+        for (; j + L <= n; j += L) {
+            const typename V::reg x = fold<Op, T>(fold<Op, T>(V::load(r0 + j), V::load(r1 + j)),
+                                                  fold<Op, T>(V::load(r2 + j), V::load(r3 + j)));
+            V::store(out + j, fold<Op, T>(V::load(out + j), x));
+        }
+        for (; j < n; ++j) {
+            out[j] = reduce_combine<Op>(out[j], reduce_combine<Op>(reduce_combine<Op>(r0[j], r1[j]),
+                                                                   reduce_combine<Op>(r2[j], r3[j])));
+        }
+    }
+    for (; r < rows; ++r) {
+        const T* row = a + r * stride;
+
+        size_t j = 0;
+        for (; j + L <= n; j += L) V::store(out + j, fold<Op, T>(V::load(out + j), V::load(row + j)));
+        for (; j < n; ++j) out[j] = reduce_combine<Op>(out[j], row[j]);
+    }
+}
+
+template<typename T>
+size_t find_first(const T* a, size_t n, T value)
+{
+    using V = vec<T>;
+    constexpr size_t L = V::lanes;
+
+    const typename V::reg v = V::set1(value);
+    size_t i = 0;
+    for (; i + L <= n; i += L) {
+        const unsigned m = V::eq_mask(V::load(a + i), v);
+        if (m) return i + size_t(__builtin_ctz(m)) / sizeof(T);
+    }
+    return i + scalar::find_first(a + i, n - i, value);
+}
+
+} // namespace sse42
+VECTRA_TARGET_END
+
+/*
+ *
+ * AVX2 kernel (32 bytes per register)
+ *
+*/
+
+VECTRA_TARGET_BEGIN(VECTRA_ISA_AVX2)
+namespace avx2 {
+
+template<ReduceOp Op, typename T>
+inline typename vec<T>::reg fold(typename vec<T>::reg a, typename vec<T>::reg b)
+{
+    if constexpr (Op == ReduceOp::Sum)  return vec<T>::add(a, b);
+    if constexpr (Op == ReduceOp::Prod) return vec<T>::mul(a, b);
+    if constexpr (Op == ReduceOp::Max)  return vec<T>::max(a, b);
+    if constexpr (Op == ReduceOp::Min)  return vec<T>::min(a, b);
+}
+
+template<ReduceOp Op, typename T>
+T reduce(const T* a, size_t n)
+{
+    using V = vec<T>;
+    constexpr size_t L = V::lanes;
+
+    if (n < 4 * L) return scalar::reduce<Op>(a, n);
+
+    const typename V::reg id = V::set1(reduce_identity<Op, T>());
+    typename V::reg acc0 = id, acc1 = id, acc2 = id, acc3 = id;
+
+    size_t i = 0;
+    for (; i + 4 * L <= n; i += 4 * L) {
+        acc0 = fold<Op, T>(acc0, V::load(a + i));
+        acc1 = fold<Op, T>(acc1, V::load(a + i + L));
+        acc2 = fold<Op, T>(acc2, V::load(a + i + 2 * L));
+        acc3 = fold<Op, T>(acc3, V::load(a + i + 3 * L));
+    }
+    for (; i + L <= n; i += L) acc0 = fold<Op, T>(acc0, V::load(a + i));
+
+    alignas(32) T lanes[L];
+    V::store(lanes, fold<Op, T>(fold<Op, T>(acc0, acc1), fold<Op, T>(acc2, acc3)));
+
+    T result = scalar::reduce<Op>(lanes, L);
+    for (; i < n; ++i) result = reduce_combine<Op>(result, a[i]);
+    return result;
+}
+
+template<ReduceOp Op, typename T>
+void reduce_rows(const T* a, size_t rows, size_t stride, T* out, size_t n)
+{
+    using V = vec<T>;
+    constexpr size_t L = V::lanes;
+
+    if (rows == 0) return scalar::reduce_rows<Op>(a, rows, stride, out, n);
+
+    std::memcpy(out, a, n * sizeof(T));
+
+    size_t r = 1;
+    for (; r + 4 <= rows; r += 4) {
+        const T* r0 = a + r * stride;
+        const T* r1 = r0 + stride;
+        const T* r2 = r1 + stride;
+        const T* r3 = r2 + stride;
+
+        size_t j = 0;
+        for (; j + L <= n; j += L) {
+            const typename V::reg x = fold<Op, T>(fold<Op, T>(V::load(r0 + j), V::load(r1 + j)),
+                                                  fold<Op, T>(V::load(r2 + j), V::load(r3 + j)));
+            V::store(out + j, fold<Op, T>(V::load(out + j), x));
+        }
+        for (; j < n; ++j) {
+            out[j] = reduce_combine<Op>(out[j], reduce_combine<Op>(reduce_combine<Op>(r0[j], r1[j]),
+                                                                   reduce_combine<Op>(r2[j], r3[j])));
+        }
+    }
+    for (; r < rows; ++r) {
+        const T* row = a + r * stride;
+
+        size_t j = 0;
+        for (; j + L <= n; j += L) V::store(out + j, fold<Op, T>(V::load(out + j), V::load(row + j)));
+        for (; j < n; ++j) out[j] = reduce_combine<Op>(out[j], row[j]);
+    }
+}
+
+template<typename T>
+size_t find_first(const T* a, size_t n, T value)
+{
+    using V = vec<T>;
+    constexpr size_t L = V::lanes;
+
+    const typename V::reg v = V::set1(value);
+    size_t i = 0;
+    for (; i + L <= n; i += L) {
+        const unsigned m = V::eq_mask(V::load(a + i), v);
+        if (m) return i + size_t(__builtin_ctz(m)) / sizeof(T);
+    }
+    return i + scalar::find_first(a + i, n - i, value);
+}
+
+} // namespace avx2
+VECTRA_TARGET_END
+
+/*
+ *
+ * AVX-512 kernel (64 bytes per register, tail through mask registers)
+ *
+*/
+
+VECTRA_TARGET_BEGIN(VECTRA_ISA_AVX512)
+namespace avx512 {
+
+template<ReduceOp Op, typename T>
+inline typename vec<T>::reg fold(typename vec<T>::reg a, typename vec<T>::reg b)
+{
+    if constexpr (Op == ReduceOp::Sum)  return vec<T>::add(a, b);
+    if constexpr (Op == ReduceOp::Prod) return vec<T>::mul(a, b);
+    if constexpr (Op == ReduceOp::Max)  return vec<T>::max(a, b);
+    if constexpr (Op == ReduceOp::Min)  return vec<T>::min(a, b);
+}
+
+template<ReduceOp Op, typename T>
+T reduce(const T* a, size_t n)
+{
+    using V = vec<T>;
+    constexpr size_t L = V::lanes;
+
+    // short runs go through the masked tail loop alone
+    if (n == 0) return scalar::reduce<Op>(a, n);
+
+    const T idv = reduce_identity<Op, T>();
+    const typename V::reg id = V::set1(idv);
+    typename V::reg acc0 = id, acc1 = id, acc2 = id, acc3 = id;
+
+    size_t i = 0;
+    for (; i + 4 * L <= n; i += 4 * L) {
+        acc0 = fold<Op, T>(acc0, V::load(a + i));
+        acc1 = fold<Op, T>(acc1, V::load(a + i + L));
+        acc2 = fold<Op, T>(acc2, V::load(a + i + 2 * L));
+        acc3 = fold<Op, T>(acc3, V::load(a + i + 3 * L));
+    }
+    // masked-off lanes read as the identity
+    for (; i < n; i += L) acc0 = fold<Op, T>(acc0, V::load(a + i, V::first(n - i), idv));
+
+    alignas(64) T lanes[L];
+    V::store(lanes, fold<Op, T>(fold<Op, T>(acc0, acc1), fold<Op, T>(acc2, acc3)));
+    return scalar::reduce<Op>(lanes, L);
+}
+
+template<ReduceOp Op, typename T>
+void reduce_rows(const T* a, size_t rows, size_t stride, T* out, size_t n)
+{
+    using V = vec<T>;
+    constexpr size_t L = V::lanes;
+
+    if (rows == 0) return scalar::reduce_rows<Op>(a, rows, stride, out, n);
+
+    std::memcpy(out, a, n * sizeof(T));
+
+    size_t r = 1;
+    for (; r + 4 <= rows; r += 4) {
+        const T* r0 = a + r * stride;
+        const T* r1 = r0 + stride;
+        const T* r2 = r1 + stride;
+        const T* r3 = r2 + stride;
+
+        for (size_t j = 0; j < n; j += L) {
+            const typename V::mask m = V::first(n - j);
+            const typename V::reg x = fold<Op, T>(fold<Op, T>(V::load(r0 + j, m, T{0}), V::load(r1 + j, m, T{0})),
+                                                  fold<Op, T>(V::load(r2 + j, m, T{0}), V::load(r3 + j, m, T{0})));
+            V::store(out + j, m, fold<Op, T>(V::load(out + j, m, T{0}), x));
+        }
+    }
+    for (; r < rows; ++r) {
+        const T* row = a + r * stride;
+
+        for (size_t j = 0; j < n; j += L) {
+            const typename V::mask m = V::first(n - j);
+            V::store(out + j, m, fold<Op, T>(V::load(out + j, m, T{0}), V::load(row + j, m, T{0})));
+        }
+    }
+}
+
+template<typename T>
+size_t find_first(const T* a, size_t n, T value)
+{
+    using V = vec<T>;
+    constexpr size_t L = V::lanes;
+
+    const typename V::reg v = V::set1(value);
+    for (size_t i = 0; i < n; i += L) {
+        const typename V::mask live = V::first(n - i);
+        const uint64_t m = uint64_t(V::eq_mask(V::load(a + i, live, T{0}), v)) & uint64_t(live);
+        if (m) return i + size_t(__builtin_ctzll(m));
+    }
+    return n;
+}
+
+} // namespace avx512
+VECTRA_TARGET_END
+
+/*
+ *
+ * Entry points : kernel of the active ISA level (Dispatch.h), resolved on first use
+ *
+*/
+
+template<ReduceOp Op, typename T>
+T reduce(const T* a, size_t n)
+{
+    static const auto fn = select_kernel(&avx512::reduce<Op, T>, &avx2::reduce<Op, T>,
+                                         &sse42::reduce<Op, T>, &scalar::reduce<Op, T>);
+    return fn(a, n);
+}
+
+template<ReduceOp Op, typename T>
+void reduce_rows(const T* a, size_t rows, size_t stride, T* out, size_t n)
+{
+    static const auto fn = select_kernel(&avx512::reduce_rows<Op, T>, &avx2::reduce_rows<Op, T>,
+                                         &sse42::reduce_rows<Op, T>, &scalar::reduce_rows<Op, T>);
+    fn(a, rows, stride, out, n);
+}
+
+template<typename T>
+size_t find_first(const T* a, size_t n, T value)
+{
+    static const auto fn = select_kernel(&avx512::find_first<T>, &avx2::find_first<T>,
+                                         &sse42::find_first<T>, &scalar::find_first<T>);
+    return fn(a, n, value);
+}
+
+// first index of the max (ReduceOp::Max) or min (ReduceOp::Min) of a[0, n), n > 0 :
+// the extremum is reduced first, then located with a vector compare (the run is still in cache)
+template<ReduceOp Op, typename T>
+size_t arg_reduce(const T* a, size_t n)
+{
+    static_assert(Op == ReduceOp::Max || Op == ReduceOp::Min, "arg_reduce : Max or Min only");
+
+    const size_t i = find_first(a, n, reduce<Op>(a, n));
+    return i < n ? i : 0;
+}
+
+// idx[j] = first r of the max / min of a[r * stride + j] over r < rows, j < n, rows > 0
+template<ReduceOp Op, typename T, typename I>
+void arg_reduce_rows(const T* a, size_t rows, size_t stride, I* idx, T* best, size_t n)
+{
+    static_assert(Op == ReduceOp::Max || Op == ReduceOp::Min, "arg_reduce_rows : Max or Min only");
+
+    for (size_t j = 0; j < n; ++j) {
+        best[j] = a[j];
+        idx[j] = I{0};
+    }
+    for (size_t r = 1; r < rows; ++r) {
+        const T* row = a + r * stride;
+        for (size_t j = 0; j < n; ++j) {
+            const bool better = Op == ReduceOp::Max ? row[j] > best[j] : row[j] < best[j];
+            best[j] = better ? row[j] : best[j];
+            idx[j] = better ? I(r) : idx[j];
+        }
+    }
+}
+
+} // namespace kernel
+} // namespace vectra
+
+#endif // __cplusplus
+#endif // REDUCE_H
@@ -1,7 +1,12 @@
 
 /*
  *
- * ScalarType.h (v1.1)
+ * ScalarType.h (v1.3)
+ * 
+ * v1.3 updated : m512::simd_set (AVX-512 target region)
+ * 
+ * v1.2 updated : USE_VECTRA_SSE / USE_VECTRA_AVX only configure the ScalarType wrapper,
+ *                the kernels dispatch at runtime
  * 
  * v1.1 updated : added operator(+, -, *, /)
  * 
@@ -29,6 +34,8 @@
 #include <cstdint>
 #include <cmath>
 
+#include <Dispatch/Dispatch.h>
+
 namespace vectra {
     using int8   = char;
     using int16  = short;
@@ -37,6 +44,9 @@ namespace vectra {
     using float64= double;
 }
 
+// Register width of the ScalarType wrapper only. The kernels of KerLow do not depend on it :
+// they select SSE4.2 / AVX2 / AVX-512 at runtime (Dispatch/Dispatch.h). USE_VECTRA_AVX
+// needs the translation unit to be built with -mavx2.
 #ifndef USE_VECTRA_SSE
 #define USE_VECTRA_SSE
 #endif
@@ -82,6 +92,29 @@ auto simd_set(const T value){
 }
 }
 
+namespace m512 {
+template<typename T> struct Scalar { using type = void; };
+
+template<> struct Scalar<vectra::int8>    { using type = __m512i; };
+template<> struct Scalar<vectra::int16>   { using type = __m512i; };
+template<> struct Scalar<vectra::int32>   { using type = __m512i; };
+template<> struct Scalar<vectra::float32> { using type = __m512;  };
+template<> struct Scalar<vectra::float64> { using type = __m512d; };
+
+// compiled for AVX-512 whatever the flags of the translation unit : call it from an AVX-512
+// target region (Dispatch.h) only
+VECTRA_TARGET_BEGIN(VECTRA_ISA_AVX512)
+template<typename T>
+auto simd_set(const T value){
+    if constexpr(std::is_same_v<T, vectra::int8>)     return _mm512_set1_epi8(static_cast<char>(value));
+    if constexpr(std::is_same_v<T, vectra::int16>)    return _mm512_set1_epi16(static_cast<short>(value));
+    if constexpr(std::is_same_v<T, vectra::int32>)    return _mm512_set1_epi32(static_cast<int>(value));
+    if constexpr(std::is_same_v<T, vectra::float32>)  return _mm512_set1_ps(static_cast<float>(value));
+    if constexpr(std::is_same_v<T, vectra::float64>)  return _mm512_set1_pd(static_cast<double>(value));
+}
+VECTRA_TARGET_END
+}
+
 template<typename T>
 class ScalarType {
 private:
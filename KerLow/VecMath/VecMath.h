@@ -0,0 +1,490 @@
+/*
+ *
+ * VecMath.h (v1.3)
+ *
+ * v1.3 updated : * pow(-0, y) is -0 for odd integer y > 0
+ *
+ * v1.2 updated : * tanh(-0) and log1p(-0) are -0, log1p(x) is x when 1 + x rounds to 1
+ *                * float32 errors measured over every finite input
+ *
+ * v1.1 updated : * generic algorithms moved to VecMathImpl.h, instantiated per ISA level
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * SIMD transcendental functions for float32 and float64 buffers (HEADER).
+ * Every function is written once against a small register interface (math_vec<T>) in
+ * VecMathImpl.h and instantiated for AVX2 + FMA (8 / 4 lanes) and AVX-512 (16 / 8 lanes),
+ * the level is picked at runtime (Dispatch.h).
+ *
+ * Method and maximum error, in ULP of the exact result. float32 : every finite input against
+ * the double libm. float64 : dense sweeps of the domain against the long double libm :
+ *
+ *   function  method                                             float32   float64
+ *   exp       x = n ln2 + r, |r| <= ln2/2, polynomial, 2^n scale   1.01      1
+ *   log       x = m 2^e, m in [sqrt(1/2), sqrt(2)), polynomial    0.83      1
+ *   log1p     log(1 + x) with the rounding of 1 + x corrected      1.44      1.5
+ *   tanh      odd polynomial / rational for |x| < 0.625,          1.33      1.5
+ *             1 - 2 / (exp(2|x|) + 1) above
+ *   sigmoid   e = exp(-|x|), 1 / (1 + e) or e / (1 + e)           2.83      3
+ *             (worst near x = -1.95 : e and 1 / (1 + e) are both rounded)
+ *   erf       odd polynomial / rational for |x| < 1,              2.48      3
+ *             1 - exp(-x^2) R(x) above
+ *   sqrt      hardware square root (correctly rounded)            0.5       0.5
+ *   rsqrt     float32 : approximation + one third-order step,     0.99      1.5
+ *             float64 : 1 / sqrt(x)
+ *   pow       exp(y log|x|) with C99 special cases. float32 is    0.5       1 + 2 |y ln x|
+ *             evaluated in float64. The float64 error grows with
+ *             |y ln x| (the rounding of log x is scaled by y)
+
+ * NaN inputs propagate, infinities and signed zeros follow C99. Denormal inputs are handled,
+ * denormal results of exp are produced by gradual underflow of the 2^n scaling.
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#pragma once
+#ifndef VECMATH_H
+#define VECMATH_H
+
+#ifdef __cplusplus
+
+#include <ScalarType/ScalarType.h>
+#include <ElementWise/ElementWise.h>
+#include <Dispatch/Dispatch.h>
+#include <immintrin.h>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace vectra {
+namespace kernel {
+
+enum class UnaryOp {
+    Exp,
+    Log,
+    Log1p,
+    Tanh,
+    Sigmoid,
+    Erf,
+    Sqrt,
+    Rsqrt
+};
+
+/*
+ *
+ * Scalar kernel (scalar and sse4.2 levels, and integer tensors which evaluate in double)
+ *
+*/
+
+namespace scalar {
+
+template<UnaryOp Op, typename T>
+inline T unary_one(T v)
+{
+    using F = std::conditional_t<std::is_floating_point_v<T>, T, double>;
+    const F x = static_cast<F>(v);
+
+    if constexpr (Op == UnaryOp::Exp)     return static_cast<T>(std::exp(x));
+    if constexpr (Op == UnaryOp::Log)     return static_cast<T>(std::log(x));
+    if constexpr (Op == UnaryOp::Log1p)   return static_cast<T>(std::log1p(x));
+    if constexpr (Op == UnaryOp::Tanh)    return static_cast<T>(std::tanh(x));
+    if constexpr (Op == UnaryOp::Sigmoid) return static_cast<T>(F(1) / (F(1) + std::exp(-x)));
+    if constexpr (Op == UnaryOp::Erf)     return static_cast<T>(std::erf(x));
+    if constexpr (Op == UnaryOp::Sqrt)    return static_cast<T>(std::sqrt(x));
+    if constexpr (Op == UnaryOp::Rsqrt)   return static_cast<T>(F(1) / std::sqrt(x));
+}
+
+template<UnaryOp Op, typename T>
+void unary(const T* a, T* out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) out[i] = unary_one<Op>(a[i]);
+}
+
+template<typename T>
+void pow(const T* a, const T* b, T* out, size_t n)
+{
+    using F = std::conditional_t<std::is_floating_point_v<T>, T, double>;
+    for (size_t i = 0; i < n; ++i) out[i] = static_cast<T>(std::pow(F(a[i]), F(b[i])));
+}
+
+} // namespace scalar
+
+/*
+ *
+ * AVX2 + FMA registers
+ *
+*/
+
+VECTRA_TARGET_BEGIN(VECTRA_ISA_AVX2)
+namespace avx2 {
+
+#include <VecMath/VecMathImpl.h>
+
+template<typename T>
+struct math_vec;
+
+template<>
+struct math_vec<vectra::float32> {
+    using scalar = float;
+    using reg = __m256;
+    using mask = __m256;
+    static constexpr size_t lanes = 8;
+
+    static reg set1(float x) { return _mm256_set1_ps(x); }
+    static reg load(const float* p) { return _mm256_loadu_ps(p); }
+    static reg load(const float* p, size_t n) { return _mm256_maskload_ps(p, tail_mask<float>(n)); }
+    static void store(float* p, reg v) { _mm256_storeu_ps(p, v); }
+    static void store(float* p, size_t n, reg v) { _mm256_maskstore_ps(p, tail_mask<float>(n), v); }
+
+    static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+    static reg div(reg a, reg b) { return _mm256_div_ps(a, b); }
+    static reg fma(reg a, reg b, reg c) { return _mm256_fmadd_ps(a, b, c); }
+    static reg fnma(reg a, reg b, reg c) { return _mm256_fnmadd_ps(a, b, c); }
+    static reg sqrt(reg a) { return _mm256_sqrt_ps(a); }
+    static reg rsqrt_approx(reg a) { return _mm256_rsqrt_ps(a); }
+    static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+    static reg abs(reg a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static reg copysign(reg mag, reg sgn) {
+        const reg s = _mm256_set1_ps(-0.0f);
+        return _mm256_or_ps(_mm256_andnot_ps(s, mag), _mm256_and_ps(s, sgn));
+    }
+    static reg round(reg a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static reg floor(reg a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+
+    static mask lt(reg a, reg b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static mask le(reg a, reg b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static mask gt(reg a, reg b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static mask eq(reg a, reg b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    static mask is_nan(reg a) { return _mm256_cmp_ps(a, a, _CMP_UNORD_Q); }
+    static mask land(mask a, mask b) { return _mm256_and_ps(a, b); }
+    static mask lor(mask a, mask b) { return _mm256_or_ps(a, b); }
+    static mask lnot(mask a) { return _mm256_xor_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(-1))); }
+    static reg select(mask m, reg a, reg b) { return _mm256_blendv_ps(b, a, m); }
+
+    // 2^n split in two halves so every factor is a normal number
+    static reg ldexp(reg p, reg n) {
+        const __m256i k = _mm256_cvtps_epi32(n);
+        const __m256i k0 = _mm256_srai_epi32(k, 1);
+        const __m256i k1 = _mm256_sub_epi32(k, k0);
+        const reg s0 = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(k0, _mm256_set1_epi32(127)), 23));
+        const reg s1 = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(k1, _mm256_set1_epi32(127)), 23));
+        return mul(mul(p, s0), s1);
+    }
+
+    static reg frexp(reg x, reg& e) {
+        // denormals are scaled into the normal range first
+        const mask tiny = lt(x, set1(std::numeric_limits<float>::min()));
+        const reg xs = select(tiny, mul(x, set1(33554432.0f)), x);
+        const __m256i bits = _mm256_castps_si256(xs);
+        const __m256i ei = _mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126));
+        e = sub(_mm256_cvtepi32_ps(ei), select(tiny, set1(25.0f), set1(0.0f)));
+        return _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)),
+                                                   _mm256_set1_epi32(0x3F000000)));
+    }
+};
+
+template<>
+struct math_vec<vectra::float64> {
+    using scalar = double;
+    using reg = __m256d;
+    using mask = __m256d;
+    static constexpr size_t lanes = 4;
+
+    static reg set1(double x) { return _mm256_set1_pd(x); }
+    static reg load(const double* p) { return _mm256_loadu_pd(p); }
+    static reg load(const double* p, size_t n) { return _mm256_maskload_pd(p, tail_mask<double>(n)); }
+    static void store(double* p, reg v) { _mm256_storeu_pd(p, v); }
+    static void store(double* p, size_t n, reg v) { _mm256_maskstore_pd(p, tail_mask<double>(n), v); }
+
+    static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+    static reg div(reg a, reg b) { return _mm256_div_pd(a, b); }
+    static reg fma(reg a, reg b, reg c) { return _mm256_fmadd_pd(a, b, c); }
+    static reg fnma(reg a, reg b, reg c) { return _mm256_fnmadd_pd(a, b, c); }
+    static reg sqrt(reg a) { return _mm256_sqrt_pd(a); }
+    static reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+    static reg abs(reg a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+    static reg copysign(reg mag, reg sgn) {
+        const reg s = _mm256_set1_pd(-0.0);
+        return _mm256_or_pd(_mm256_andnot_pd(s, mag), _mm256_and_pd(s, sgn));
+    }
+    static reg round(reg a) { return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static reg floor(reg a) { return _mm256_round_pd(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+
+    static mask lt(reg a, reg b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    static mask le(reg a, reg b) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+    static mask gt(reg a, reg b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+    static mask eq(reg a, reg b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+    static mask is_nan(reg a) { return _mm256_cmp_pd(a, a, _CMP_UNORD_Q); }
+    static mask land(mask a, mask b) { return _mm256_and_pd(a, b); }
+    static mask lor(mask a, mask b) { return _mm256_or_pd(a, b); }
+    static mask lnot(mask a) { return _mm256_xor_pd(a, _mm256_castsi256_pd(_mm256_set1_epi32(-1))); }
+    static reg select(mask m, reg a, reg b) { return _mm256_blendv_pd(b, a, m); }
+
+    // integral double (|k| < 2^51) to int64 lanes through the 1.5 * 2^52 rounding constant
+    static __m256i to_int64(reg k) {
+        const reg magic = set1(6755399441055744.0);
+        return _mm256_sub_epi64(_mm256_castpd_si256(add(k, magic)), _mm256_castpd_si256(magic));
+    }
+
+    static reg ldexp(reg p, reg n) {
+        const reg h = floor(mul(n, set1(0.5)));
+        const __m256i bias = _mm256_set1_epi64x(1023);
+        const reg s0 = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_add_epi64(to_int64(h), bias), 52));
+        const reg s1 = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_add_epi64(to_int64(sub(n, h)), bias), 52));
+        return mul(mul(p, s0), s1);
+    }
+
+    static reg frexp(reg x, reg& e) {
+        const mask tiny = lt(x, set1(std::numeric_limits<double>::min()));
+        const reg xs = select(tiny, mul(x, set1(18014398509481984.0)), x);
+        const __m256i bits = _mm256_castpd_si256(xs);
+
+        // biased exponent (11 bits) to double : or-ed into the mantissa of 2^52
+        const __m256i eb = _mm256_or_si256(_mm256_srli_epi64(bits, 52), _mm256_castpd_si256(set1(4503599627370496.0)));
+        e = sub(sub(_mm256_castsi256_pd(eb), set1(4503599627370496.0 + 1022.0)), select(tiny, set1(54.0), set1(0.0)));
+        return _mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFll)),
+                                                   _mm256_set1_epi64x(0x3FE0000000000000ll)));
+    }
+};
+
+template<UnaryOp Op, typename T>
+void unary(const T* a, T* out, size_t n)
+{
+    vecmath::unary<Op, math_vec<T>>(a, out, n);
+}
+
+// float32 pow evaluated in float64 : 4 lanes per step
+inline __m128 pow_ps(__m128 x, __m128 y)
+{
+    using VD = math_vec<vectra::float64>;
+    return _mm256_cvtpd_ps(vecmath::pow<VD>(_mm256_cvtps_pd(x), _mm256_cvtps_pd(y)));
+}
+
+template<typename T>
+void pow(const T* a, const T* b, T* out, size_t n)
+{
+    using VD = math_vec<vectra::float64>;
+
+    if constexpr (std::is_same_v<T, vectra::float64>) {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) VD::store(out + i, vecmath::pow<VD>(VD::load(a + i), VD::load(b + i)));
+        if (i < n) VD::store(out + i, n - i, vecmath::pow<VD>(VD::load(a + i, n - i), VD::load(b + i, n - i)));
+    }
+    else {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) _mm_storeu_ps(out + i, pow_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        if (i < n) {
+            const __m128i m = _mm256_castsi256_si128(tail_mask<float>(n - i));
+            _mm_maskstore_ps(out + i, m, pow_ps(_mm_maskload_ps(a + i, m), _mm_maskload_ps(b + i, m)));
+        }
+    }
+}
+
+} // namespace avx2
+VECTRA_TARGET_END
+
+/*
+ *
+ * AVX-512 registers (AVX512F only : bit operations go through the integer domain)
+ *
+*/
+
+VECTRA_TARGET_BEGIN(VECTRA_ISA_AVX512)
+namespace avx512 {
+
+#include <VecMath/VecMathImpl.h>
+
+template<typename T>
+struct math_vec;
+
+template<>
+struct math_vec<vectra::float32> {
+    using scalar = float;
+    using reg = __m512;
+    using mask = __mmask16;
+    static constexpr size_t lanes = 16;
+
+    static mask first(size_t n) { return vec<float>::first(n); }
+
+    static reg set1(float x) { return _mm512_set1_ps(x); }
+    static reg load(const float* p) { return _mm512_loadu_ps(p); }
+    static reg load(const float* p, size_t n) { return _mm512_maskz_loadu_ps(first(n), p); }
+    static void store(float* p, reg v) { _mm512_storeu_ps(p, v); }
+    static void store(float* p, size_t n, reg v) { _mm512_mask_storeu_ps(p, first(n), v); }
+
+    static reg add(reg a, reg b) { return _mm512_add_ps(a, b); }
+    static reg sub(reg a, reg b) { return _mm512_sub_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm512_mul_ps(a, b); }
+    static reg div(reg a, reg b) { return _mm512_div_ps(a, b); }
+    static reg fma(reg a, reg b, reg c) { return _mm512_fmadd_ps(a, b, c); }
+    static reg fnma(reg a, reg b, reg c) { return _mm512_fnmadd_ps(a, b, c); }
+    static reg sqrt(reg a) { return _mm512_sqrt_ps(a); }
+    static reg rsqrt_approx(reg a) { return _mm512_rsqrt14_ps(a); }
+    static reg min(reg a, reg b) { return _mm512_min_ps(a, b); }
+    static reg max(reg a, reg b) { return _mm512_max_ps(a, b); }
+    static reg abs(reg a) { return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(a), _mm512_set1_epi32(0x7FFFFFFF))); }
+    static reg copysign(reg mag, reg sgn) {
+        // bit select : sign of sgn, rest of mag
+        return _mm512_castsi512_ps(_mm512_ternarylogic_epi32(_mm512_set1_epi32(0x7FFFFFFF), _mm512_castps_si512(mag),
+                                                             _mm512_castps_si512(sgn), 0xCA));
+    }
+    static reg round(reg a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static reg floor(reg a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+
+    static mask lt(reg a, reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    static mask le(reg a, reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+    static mask gt(reg a, reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+    static mask eq(reg a, reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+    static mask is_nan(reg a) { return _mm512_cmp_ps_mask(a, a, _CMP_UNORD_Q); }
+    static mask land(mask a, mask b) { return mask(a & b); }
+    static mask lor(mask a, mask b) { return mask(a | b); }
+    static mask lnot(mask a) { return mask(~a); }
+    static reg select(mask m, reg a, reg b) { return _mm512_mask_blend_ps(m, b, a); }
+
+    static reg ldexp(reg p, reg n) { return _mm512_scalef_ps(p, n); }
+
+    static reg frexp(reg x, reg& e) {
+        e = add(_mm512_getexp_ps(x), set1(1.0f));
+        return _mm512_getmant_ps(x, _MM_MANT_NORM_p5_1, _MM_MANT_SIGN_zero);
+    }
+};
+
+template<>
+struct math_vec<vectra::float64> {
+    using scalar = double;
+    using reg = __m512d;
+    using mask = __mmask8;
+    static constexpr size_t lanes = 8;
+
+    static mask first(size_t n) { return vec<double>::first(n); }
+
+    static reg set1(double x) { return _mm512_set1_pd(x); }
+    static reg load(const double* p) { return _mm512_loadu_pd(p); }
+    static reg load(const double* p, size_t n) { return _mm512_maskz_loadu_pd(first(n), p); }
+    static void store(double* p, reg v) { _mm512_storeu_pd(p, v); }
+    static void store(double* p, size_t n, reg v) { _mm512_mask_storeu_pd(p, first(n), v); }
+
+    static reg add(reg a, reg b) { return _mm512_add_pd(a, b); }
+    static reg sub(reg a, reg b) { return _mm512_sub_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm512_mul_pd(a, b); }
+    static reg div(reg a, reg b) { return _mm512_div_pd(a, b); }
+    static reg fma(reg a, reg b, reg c) { return _mm512_fmadd_pd(a, b, c); }
+    static reg fnma(reg a, reg b, reg c) { return _mm512_fnmadd_pd(a, b, c); }
+    static reg sqrt(reg a) { return _mm512_sqrt_pd(a); }
+    static reg min(reg a, reg b) { return _mm512_min_pd(a, b); }
+    static reg max(reg a, reg b) { return _mm512_max_pd(a, b); }
+    static reg abs(reg a) { return _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(a), _mm512_set1_epi64(0x7FFFFFFFFFFFFFFFll))); }
+    static reg copysign(reg mag, reg sgn) {
+        return _mm512_castsi512_pd(_mm512_ternarylogic_epi64(_mm512_set1_epi64(0x7FFFFFFFFFFFFFFFll), _mm512_castpd_si512(mag),
+                                                             _mm512_castpd_si512(sgn), 0xCA));
+    }
+    static reg round(reg a) { return _mm512_roundscale_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static reg floor(reg a) { return _mm512_roundscale_pd(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+
+    static mask lt(reg a, reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+    static mask le(reg a, reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+    static mask gt(reg a, reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+    static mask eq(reg a, reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+    static mask is_nan(reg a) { return _mm512_cmp_pd_mask(a, a, _CMP_UNORD_Q); }
+    static mask land(mask a, mask b) { return mask(a & b); }
+    static mask lor(mask a, mask b) { return mask(a | b); }
+    static mask lnot(mask a) { return mask(~a); }
+    static reg select(mask m, reg a, reg b) { return _mm512_mask_blend_pd(m, b, a); }
+
+    static reg ldexp(reg p, reg n) { return _mm512_scalef_pd(p, n); }
+
+    static reg frexp(reg x, reg& e) {
+        e = add(_mm512_getexp_pd(x), set1(1.0));
+        return _mm512_getmant_pd(x, _MM_MANT_NORM_p5_1, _MM_MANT_SIGN_zero);
+    }
+};
+
+template<UnaryOp Op, typename T>
+void unary(const T* a, T* out, size_t n)
+{
+    vecmath::unary<Op, math_vec<T>>(a, out, n);
+}
+
+// float32 pow evaluated in float64 : 8 lanes per step
+inline __m256 pow_ps(__m256 x, __m256 y)
+{
+    using VD = math_vec<vectra::float64>;
+    return _mm512_cvtpd_ps(vecmath::pow<VD>(_mm512_cvtps_pd(x), _mm512_cvtps_pd(y)));
+}
+
+template<typename T>
+void pow(const T* a, const T* b, T* out, size_t n)
+{
+    using VD = math_vec<vectra::float64>;
+
+    if constexpr (std::is_same_v<T, vectra::float64>) {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) VD::store(out + i, vecmath::pow<VD>(VD::load(a + i), VD::load(b + i)));
+        if (i < n) VD::store(out + i, n - i, vecmath::pow<VD>(VD::load(a + i, n - i), VD::load(b + i, n - i)));
+    }
+    else {
+        for (size_t i = 0; i < n; i += 8) {
+            const __mmask16 m = vec<float>::first(std::min<size_t>(n - i, 8));
+            const __m256 x = _mm512_castps512_ps256(_mm512_maskz_loadu_ps(m, a + i));
+            const __m256 y = _mm512_castps512_ps256(_mm512_maskz_loadu_ps(m, b + i));
+            _mm512_mask_storeu_ps(out + i, m, _mm512_castps256_ps512(pow_ps(x, y)));
+        }
+    }
+}
+
+} // namespace avx512
+VECTRA_TARGET_END
+
+/*
+ *
+ * Entry points : kernel of the active ISA level (Dispatch.h), resolved on first use.
+ * The algorithms rely on fused multiply-add : the sse4.2 level, and integer tensors
+ * (evaluated in double), take the scalar path.
+ *
+*/
+
+template<UnaryOp Op, typename T>
+void unary(const T* a, T* out, size_t n)
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        static const auto fn = select_kernel(&avx512::unary<Op, T>, &avx2::unary<Op, T>,
+                                             &scalar::unary<Op, T>, &scalar::unary<Op, T>);
+        fn(a, out, n);
+    }
+    else {
+        scalar::unary<Op, T>(a, out, n);
+    }
+}
+
+template<typename T>
+void pow(const T* a, const T* b, T* out, size_t n)
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        static const auto fn = select_kernel(&avx512::pow<T>, &avx2::pow<T>, &scalar::pow<T>, &scalar::pow<T>);
+        fn(a, b, out, n);
+    }
+    else {
+        scalar::pow<T>(a, b, out, n);
+    }
+}
+
+} // namespace kernel
+} // namespace vectra
+
+#endif // __cplusplus
+#endif // VECMATH_H
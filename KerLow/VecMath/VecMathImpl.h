@@ -0,0 +1,334 @@
+/*
+ *
+ * VecMathImpl.h (v1.2)
+ *
+ * v1.2 updated : * pow of -0 to an odd integer is -0 (the sign was lost negating 0)
+ *
+ * v1.1 updated : * tanh keeps the sign of x (tanh(-0) = -0), log1p(x) is x when 1 + x rounds to 1
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Generic algorithms of VecMath.h (HEADER, no include guard).
+ * Included by VecMath.h inside the namespace of every ISA level, within its target region,
+ * so each level gets its own fully inlined copy. Do not include it anywhere else.
+ * This file is a part of VECTRA framework
+ *
+*/
+
+/*
+ *
+ * Generic algorithms over a register interface V :
+ *   V::scalar, V::reg, V::mask, V::lanes
+ *   set1 load store (full and first-n) add sub mul div fma(a,b,c)=a*b+c fnma(a,b,c)=c-a*b
+ *   sqrt min max abs copysign round floor lt le gt eq is_nan land lor lnot select(m,a,b)
+ *   ldexp(p, n) = p * 2^n (n integral, |n| <= 2 * max exponent)
+ *   frexp(x, e) = m with x = m * 2^e, m in [0.5, 1) (finite x > 0, denormals included)
+ *   rsqrt_approx(x) (float32 only)
+ *
+*/
+
+namespace vecmath {
+
+// Horner steps unrolled at compile time : the coefficients become broadcast constants and the
+// chains of neighbouring registers interleave instead of waiting on a loop branch
+template<typename V, size_t N, size_t... I>
+inline typename V::reg horner(typename V::reg x, typename V::reg p, const typename V::scalar (&c)[N], std::index_sequence<I...>)
+{
+    ((p = V::fma(p, x, V::set1(c[I + 1]))), ...);
+    return p;
+}
+
+template<typename V, size_t N>
+inline typename V::reg polevl(typename V::reg x, const typename V::scalar (&c)[N])
+{
+    // c[0] x^(N-1) + ... + c[N-1]
+    return horner<V>(x, V::set1(c[0]), c, std::make_index_sequence<N - 1>{});
+}
+
+template<typename V, size_t N>
+inline typename V::reg p1evl(typename V::reg x, const typename V::scalar (&c)[N])
+{
+    // x^N + c[0] x^(N-1) + ... + c[N-1]
+    return horner<V>(x, V::add(x, V::set1(c[0])), c, std::make_index_sequence<N - 1>{});
+}
+
+template<typename V>
+inline typename V::reg exp(typename V::reg x)
+{
+    using T = typename V::scalar;
+    using R = typename V::reg;
+    constexpr bool f32 = std::is_same_v<T, float>;
+
+    // beyond the clamp the 2^n scaling over/underflows by itself. min / max return their
+    // second operand when one is NaN, so NaN flows through the clamp into the result
+    const T lo = f32 ? T(-104.0) : T(-746.0);
+    const T hi = f32 ? T(89.0) : T(710.0);
+    const T ln2_hi = f32 ? T(0.693359375) : T(6.93147180369123816490e-01);
+    const T ln2_lo = f32 ? T(-2.12194440e-4) : T(1.90821492927058770002e-10);
+
+    const R xc = V::min(V::set1(hi), V::max(V::set1(lo), x));
+    const R n = V::round(V::mul(xc, V::set1(T(1.44269504088896340736))));
+    R r = V::fnma(n, V::set1(ln2_hi), xc);
+    r = V::fnma(n, V::set1(ln2_lo), r);
+
+    R p;
+    if constexpr (f32) {
+        static const T c[] = { 1.9875691500E-4f, 1.3981999507E-3f, 8.3334519073E-3f,
+                               4.1665795894E-2f, 1.6666665459E-1f, 5.0000001201E-1f };
+        p = polevl<V>(r, c);
+        p = V::fma(p, V::mul(r, r), r);
+        p = V::add(p, V::set1(T(1)));
+    }
+    else {
+        // Taylor series to r^13 : truncation below 2^-60 on |r| <= ln2/2
+        static const T c[] = { 1.0 / 6227020800.0, 1.0 / 479001600.0, 1.0 / 39916800.0, 1.0 / 3628800.0,
+                               1.0 / 362880.0, 1.0 / 40320.0, 1.0 / 5040.0, 1.0 / 720.0, 1.0 / 120.0,
+                               1.0 / 24.0, 1.0 / 6.0, 0.5, 1.0, 1.0 };
+        p = polevl<V>(r, c);
+    }
+
+    return V::ldexp(p, n);
+}
+
+template<typename V>
+inline typename V::reg log(typename V::reg x)
+{
+    using T = typename V::scalar;
+    using R = typename V::reg;
+    constexpr bool f32 = std::is_same_v<T, float>;
+
+    R e;
+    R m = V::frexp(x, e);
+
+    const typename V::mask small = V::lt(m, V::set1(T(0.70710678118654752440)));
+    e = V::select(small, V::sub(e, V::set1(T(1))), e);
+    const R f = V::sub(V::select(small, V::add(m, m), m), V::set1(T(1)));
+
+    R res;
+    if constexpr (f32) {
+        static const T c[] = { 7.0376836292E-2f, -1.1514610310E-1f, 1.1676998740E-1f,
+                               -1.2420140846E-1f, 1.4249322787E-1f, -1.6668057665E-1f,
+                               2.0000714765E-1f, -2.4999993993E-1f, 3.3333331174E-1f };
+        const R z = V::mul(f, f);
+        R y = V::mul(V::mul(polevl<V>(f, c), f), z);
+        y = V::fma(e, V::set1(T(-2.12194440e-4)), y);
+        y = V::fnma(V::set1(T(0.5)), z, y);
+        res = V::add(f, y);
+        res = V::fma(e, V::set1(T(0.693359375)), res);
+    }
+    else {
+        // log(1 + f) = f - (hfsq - s (hfsq + R(s^2))), s = f / (2 + f)
+        static const T c[] = { 1.479819860511658591e-01, 1.531383769920937332e-01, 1.818357216161805012e-01,
+                               2.222219843214978396e-01, 2.857142874366239149e-01, 3.999999999940941908e-01,
+                               6.666666666666735130e-01 };
+        const R s = V::div(f, V::add(V::set1(T(2)), f));
+        const R z = V::mul(s, s);
+        const R poly = V::mul(z, polevl<V>(z, c));
+        const R hfsq = V::mul(V::set1(T(0.5)), V::mul(f, f));
+        R t = V::fma(s, V::add(hfsq, poly), V::mul(e, V::set1(T(1.90821492927058770002e-10))));
+        t = V::sub(V::sub(hfsq, t), f);
+        res = V::fnma(V::set1(T(1)), t, V::mul(e, V::set1(T(6.93147180369123816490e-01))));
+    }
+
+    const T inf = std::numeric_limits<T>::infinity();
+    res = V::select(V::eq(x, V::set1(T(0))), V::set1(-inf), res);
+    res = V::select(V::eq(x, V::set1(inf)), x, res);
+    res = V::select(V::lt(x, V::set1(T(0))), V::set1(std::numeric_limits<T>::quiet_NaN()), res);
+    return V::select(V::is_nan(x), V::add(x, x), res);
+}
+
+template<typename V>
+inline typename V::reg log1p(typename V::reg x)
+{
+    using T = typename V::scalar;
+    using R = typename V::reg;
+
+    // log(u) - ((u - 1) - x) / u : the rounding error of u = 1 + x is put back to first order.
+    // When u rounds to 1, |x| is below half an ulp of 1 and log1p(x) rounds to x (keeps -0)
+    const R one = V::set1(T(1));
+    const R u = V::add(one, x);
+    const R lu = log<V>(u);
+    const R c = V::div(V::sub(V::sub(u, one), x), u);
+
+    const typename V::mask finite = V::land(V::gt(u, V::set1(T(0))), V::lt(u, V::set1(std::numeric_limits<T>::infinity())));
+    return V::select(V::eq(u, one), x, V::select(finite, V::sub(lu, c), lu));
+}
+
+template<typename V>
+inline typename V::reg tanh(typename V::reg x)
+{
+    using T = typename V::scalar;
+    using R = typename V::reg;
+    constexpr bool f32 = std::is_same_v<T, float>;
+
+    const R ax = V::abs(x);
+    const R z = V::mul(x, x);
+
+    R small;
+    if constexpr (f32) {
+        static const T c[] = { -5.70498872745E-3f, 2.06390887954E-2f, -5.37397155531E-2f,
+                               1.33314422036E-1f, -3.33332819422E-1f };
+        small = V::fma(V::mul(polevl<V>(z, c), z), x, x);
+    }
+    else {
+        static const T P[] = { -9.64399179425052238628E-1, -9.92877231001918586564E1, -1.61468768441708447952E3 };
+        static const T Q[] = { 1.12811678491632931402E2, 2.23548839060100448583E3, 4.84406305325125486048E3 };
+        small = V::fma(V::mul(x, z), V::div(polevl<V>(z, P), p1evl<V>(z, Q)), x);
+    }
+
+    // 1 - 2 / (exp(2|x|) + 1), exp overflow gives exactly 1
+    const R e = exp<V>(V::add(ax, ax));
+    const R large = V::copysign(V::sub(V::set1(T(1)), V::div(V::set1(T(2)), V::add(e, V::set1(T(1))))), x);
+
+    // odd : the sign of x (the x + x^3 P sum rounds -0 to +0)
+    return V::copysign(V::select(V::lt(ax, V::set1(T(0.625))), small, large), x);
+}
+
+template<typename V>
+inline typename V::reg sigmoid(typename V::reg x)
+{
+    using T = typename V::scalar;
+
+    // e = exp(-|x|) never overflows : 1 / (1 + e) for x >= 0, e / (1 + e) below
+    const typename V::reg e = exp<V>(V::sub(V::set1(T(0)), V::abs(x)));
+    const typename V::reg s = V::div(V::set1(T(1)), V::add(V::set1(T(1)), e));
+    return V::select(V::lt(x, V::set1(T(0))), V::mul(e, s), s);
+}
+
+template<typename V>
+inline typename V::reg erf(typename V::reg x)
+{
+    using T = typename V::scalar;
+    using R = typename V::reg;
+    constexpr bool f32 = std::is_same_v<T, float>;
+
+    const R ax = V::abs(x);
+    const R z = V::mul(x, x);
+    const R one = V::set1(T(1));
+
+    R small, erfc;
+    if constexpr (f32) {
+        static const T T0[] = { 7.853861353153693E-5f, -8.010193625184903E-4f, 5.188327685732524E-3f,
+                                -2.685381193529856E-2f, 1.128358514861418E-1f, -3.761262582423300E-1f,
+                                1.128379165726710E0f };
+        static const T P[] = { 2.326819970068386E-2f, -1.387039388740657E-1f, 3.687424674597105E-1f,
+                               -5.824733027278666E-1f, 6.210004621745983E-1f, -4.944515323274145E-1f,
+                               3.404879937665872E-1f, -2.741127028184656E-1f, 5.638259427386472E-1f };
+        static const T Rc[] = { -1.047766399936249E1f, 1.297719955372516E1f, -7.495518717768503E0f,
+                                2.921019019210786E0f, -1.015265279202700E0f, 4.218463358204948E-1f,
+                                -2.820767439740514E-1f, 5.641895067754075E-1f };
+        small = V::mul(x, polevl<V>(z, T0));
+
+        // erfc(|x|) = exp(-x^2) / |x| * P(1/x^2) (|x| < 2) or R(1/x^2)
+        const R q = V::div(one, ax);
+        const R y = V::mul(q, q);
+        const R p = V::select(V::lt(ax, V::set1(T(2))), polevl<V>(y, P), polevl<V>(y, Rc));
+        erfc = V::mul(V::mul(exp<V>(V::sub(V::set1(T(0)), z)), q), p);
+    }
+    else {
+        static const T T0[] = { 9.60497373987051638749E0, 9.00260197203842689217E1, 2.23200534594684319226E3,
+                                7.00332514112805075473E3, 5.55923013010394962768E4 };
+        static const T U0[] = { 3.35617141647503099647E1, 5.21357949780152679795E2, 4.59432382970980127987E3,
+                                2.26290000613890934246E4, 4.92673942608635921086E4 };
+        static const T P[] = { 2.46196981473530512524E-10, 5.64189564831068821977E-1, 7.46321056442269912687E0,
+                               4.86371970985681366614E1, 1.96520832956077098242E2, 5.26445194995477358631E2,
+                               9.34528527171957607540E2, 1.02755188689515710272E3, 5.57535335369399327526E2 };
+        static const T Q[] = { 1.32281951154744992508E1, 8.67072140885989742329E1, 3.54937778887819891062E2,
+                               9.75708501743205489753E2, 1.82390916687909736289E3, 2.24633760818710981792E3,
+                               1.65666309194161350182E3, 5.57535340817727675546E2 };
+        small = V::div(V::mul(x, polevl<V>(z, T0)), p1evl<V>(z, U0));
+
+        // erfc(|x|) = exp(-x^2) P(|x|) / Q(|x|), |x| clamped where erf is already 1
+        const R axc = V::min(ax, V::set1(T(6)));
+        erfc = V::mul(exp<V>(V::sub(V::set1(T(0)), V::mul(axc, axc))), V::div(polevl<V>(axc, P), p1evl<V>(axc, Q)));
+    }
+
+    const R large = V::copysign(V::sub(one, erfc), x);
+    const R res = V::select(V::lt(ax, one), small, large);
+    return V::select(V::is_nan(x), V::add(x, x), res);
+}
+
+template<typename V>
+inline typename V::reg rsqrt(typename V::reg x)
+{
+    using T = typename V::scalar;
+    using R = typename V::reg;
+
+    if constexpr (std::is_same_v<T, float>) {
+        // third order refinement of the hardware approximation : with e = 1 - x y^2,
+        // y (1 + e/2 + 3e^2/8) triples its bits. Denormals are scaled by 2^24 first
+        // (the approximation flushes them)
+        const typename V::mask tiny = V::land(V::gt(x, V::set1(T(0))), V::lt(x, V::set1(std::numeric_limits<T>::min())));
+        const R xs = V::select(tiny, V::mul(x, V::set1(T(16777216.0))), x);
+        const R y = V::rsqrt_approx(xs);
+        const R e = V::fnma(V::mul(xs, y), y, V::set1(T(1)));
+        R r = V::fma(V::mul(y, e), V::fma(e, V::set1(T(0.375)), V::set1(T(0.5))), y);
+        r = V::select(tiny, V::mul(r, V::set1(T(4096.0))), r);
+        r = V::select(V::eq(x, V::set1(T(0))), V::div(V::set1(T(1)), x), r);
+        r = V::select(V::eq(x, V::set1(std::numeric_limits<T>::infinity())), V::set1(T(0)), r);
+        return V::select(V::lt(x, V::set1(T(0))), V::set1(std::numeric_limits<T>::quiet_NaN()), r);
+    }
+    else {
+        return V::div(V::set1(T(1)), V::sqrt(x));
+    }
+}
+
+// pow in float64 registers with the C99 special cases
+template<typename V>
+inline typename V::reg pow(typename V::reg x, typename V::reg y)
+{
+    using T = typename V::scalar;
+    using R = typename V::reg;
+    using M = typename V::mask;
+
+    const R one = V::set1(T(1));
+    const R ax = V::abs(x);
+    R r = exp<V>(V::mul(y, log<V>(ax)));
+
+    const M y_int = V::eq(V::floor(y), y);
+    const M y_odd = V::land(y_int, V::lnot(V::eq(V::mul(V::floor(V::mul(y, V::set1(T(0.5)))), V::set1(T(2))), y)));
+    const M x_neg = V::lt(V::copysign(one, x), V::set1(T(0)));
+
+    r = V::select(V::land(x_neg, y_odd), V::copysign(r, V::set1(T(-1))), r);      // pow(-0, 3) is -0
+    r = V::select(V::land(V::land(x_neg, V::lnot(y_int)), V::lnot(V::eq(ax, V::set1(std::numeric_limits<T>::infinity())))),
+                  V::set1(std::numeric_limits<T>::quiet_NaN()), r);
+    r = V::select(V::land(V::eq(ax, one), V::eq(V::abs(y), V::set1(std::numeric_limits<T>::infinity()))), one, r);
+    return V::select(V::lor(V::eq(y, V::set1(T(0))), V::eq(x, one)), one, r);
+}
+
+template<UnaryOp Op, typename V>
+inline typename V::reg apply(typename V::reg x)
+{
+    if constexpr (Op == UnaryOp::Exp)     return exp<V>(x);
+    if constexpr (Op == UnaryOp::Log)     return log<V>(x);
+    if constexpr (Op == UnaryOp::Log1p)   return log1p<V>(x);
+    if constexpr (Op == UnaryOp::Tanh)    return tanh<V>(x);
+    if constexpr (Op == UnaryOp::Sigmoid) return sigmoid<V>(x);
+    if constexpr (Op == UnaryOp::Erf)     return erf<V>(x);
+    if constexpr (Op == UnaryOp::Sqrt)    return V::sqrt(x);
+    if constexpr (Op == UnaryOp::Rsqrt)   return rsqrt<V>(x);
+}
+
+// strip-mined driver (two independent registers per step), the tail runs as one partial register
+template<UnaryOp Op, typename V>
+void unary(const typename V::scalar* a, typename V::scalar* out, size_t n)
+{
+    constexpr size_t L = V::lanes;
+
+    size_t i = 0;
+    for (; i + 2 * L <= n; i += 2 * L) {
+        const typename V::reg x0 = V::load(a + i);
+        const typename V::reg x1 = V::load(a + i + L);
+        V::store(out + i,     apply<Op, V>(x0));
+        V::store(out + i + L, apply<Op, V>(x1));
+    }
+    for (; i + L <= n; i += L) V::store(out + i, apply<Op, V>(V::load(a + i)));
+    if (i < n) V::store(out + i, n - i, apply<Op, V>(V::load(a + i, n - i)));
+}
+
+} // namespace vecmath
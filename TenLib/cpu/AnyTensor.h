@@ -0,0 +1,410 @@
+/*
+ *
+ * AnyTensor.h (v1.0)
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Type-erased Tensor : one class for every data type, the element type is a runtime tag (DType).
+ * Every operation switches once on the tag and calls the templated operation of TensorOps.h, so
+ * callers that only know the type at runtime (the Python binding) need no per-type entry points
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#pragma once
+#ifndef ANYTENSOR_H
+#define ANYTENSOR_H
+
+#ifdef __cplusplus
+
+#include <cpu/TensorOps.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace vectra {
+
+// order of the alternatives of AnyTensor
+enum class DType : uint8_t {
+    Int16,
+    Int32,
+    Float32,
+    Float64
+};
+
+template<typename T> struct dtype_of;
+template<> struct dtype_of<vectra::int16>   { static constexpr DType value = DType::Int16; };
+template<> struct dtype_of<vectra::int32>   { static constexpr DType value = DType::Int32; };
+template<> struct dtype_of<vectra::float32> { static constexpr DType value = DType::Float32; };
+template<> struct dtype_of<vectra::float64> { static constexpr DType value = DType::Float64; };
+
+inline const char* dtype_name(DType dtype)
+{
+    switch (dtype) {
+        case DType::Int16:   return "int16";
+        case DType::Int32:   return "int32";
+        case DType::Float32: return "float32";
+        case DType::Float64: return "float64";
+    }
+    return "unknown";
+}
+
+inline size_t dtype_size(DType dtype)
+{
+    switch (dtype) {
+        case DType::Int16:   return sizeof(vectra::int16);
+        case DType::Int32:   return sizeof(vectra::int32);
+        case DType::Float32: return sizeof(vectra::float32);
+        case DType::Float64: return sizeof(vectra::float64);
+    }
+    return 0;
+}
+
+inline bool is_floating(DType dtype)
+{
+    return dtype == DType::Float32 || dtype == DType::Float64;
+}
+
+// calls fn(T{}) with the element type of the tag
+template<typename F>
+decltype(auto) visit_dtype(DType dtype, F&& fn)
+{
+    switch (dtype) {
+        case DType::Int16:   return fn(vectra::int16{});
+        case DType::Int32:   return fn(vectra::int32{});
+        case DType::Float32: return fn(vectra::float32{});
+        default:             return fn(vectra::float64{});
+    }
+}
+
+class AnyTensor {
+public:
+    using variant_type = std::variant<Tensor<vectra::int16>, Tensor<vectra::int32>,
+                                      Tensor<vectra::float32>, Tensor<vectra::float64>>;
+
+    AnyTensor() = default;
+
+    template<typename T>
+    AnyTensor(Tensor<T> t)
+    : v_(std::move(t))
+    {
+    }
+
+    DType dtype() const { return DType(v_.index()); }
+
+    template<typename T>
+    bool holds() const { return std::holds_alternative<Tensor<T>>(v_); }
+
+    template<typename T>
+    Tensor<T>& get()
+    {
+        check_dtype(dtype_of<T>::value);
+        return *std::get_if<Tensor<T>>(&v_);
+    }
+
+    template<typename T>
+    const Tensor<T>& get() const
+    {
+        check_dtype(dtype_of<T>::value);
+        return *std::get_if<Tensor<T>>(&v_);
+    }
+
+    const variant_type& variant() const { return v_; }
+
+    // fn(Tensor<T>&) with the alternative held
+    template<typename F>
+    decltype(auto) visit(F&& fn) { return std::visit(std::forward<F>(fn), v_); }
+
+    template<typename F>
+    decltype(auto) visit(F&& fn) const { return std::visit(std::forward<F>(fn), v_); }
+
+    const Shape& shape() const { return std::visit([](const auto& t) -> const Shape& { return t.shape; }, v_); }
+    const Shape& strides() const { return std::visit([](const auto& t) -> const Shape& { return t.strides; }, v_); }
+    size_t numel() const { return shape_numel(shape()); }
+    size_t ndim() const { return shape().size(); }
+    size_t itemsize() const { return dtype_size(dtype()); }
+    bool is_contiguous() const { return std::visit([](const auto& t) { return t.is_contiguous(); }, v_); }
+
+private:
+    void check_dtype(DType want) const
+    {
+        if (dtype() != want) {
+            fprintf(stderr, "vectra AnyTensor::get() : tensor holds %s, not %s!\n", dtype_name(dtype()), dtype_name(want));
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    variant_type v_;
+};
+
+} // namespace vectra
+
+/*
+ *
+ * Dispatch : the overloads below take AnyTensor and forward to the templates of TensorOps.h
+ *
+*/
+
+namespace vectra::detail {
+
+inline void same_dtype(const char* name, const AnyTensor& A, const AnyTensor& B)
+{
+    if (A.dtype() != B.dtype()) {
+        fprintf(stderr, "vectra %s() : dtype mismatch (%s and %s)!\n", name, dtype_name(A.dtype()), dtype_name(B.dtype()));
+        exit(EXIT_FAILURE);
+    }
+}
+
+inline void floating_only(const char* name, DType dtype)
+{
+    if (!is_floating(dtype)) {
+        fprintf(stderr, "vectra %s() : only float32 and float64 are supported, got %s!\n", name, dtype_name(dtype));
+        exit(EXIT_FAILURE);
+    }
+}
+
+// element type of a Tensor (unevaluated)
+template<typename T> T element_of(const Tensor<T>&);
+
+// fn(a, b) on two tensors of the same element type
+template<typename F>
+AnyTensor binary(const char* name, const AnyTensor& A, const AnyTensor& B, F&& fn)
+{
+    same_dtype(name, A, B);
+    return A.visit([&](const auto& a) -> AnyTensor {
+        using TensorT = std::decay_t<decltype(a)>;
+        return fn(a, *std::get_if<TensorT>(&B.variant()));
+    });
+}
+
+template<typename F>
+AnyTensor unary(const AnyTensor& A, F&& fn)
+{
+    return A.visit([&](const auto& a) -> AnyTensor { return fn(a); });
+}
+
+} // namespace vectra::detail
+
+// Factories (the element type is the tag, the value is converted to it)
+inline vectra::AnyTensor full(const Shape& shape, double value, vectra::DType dtype)
+{
+    return vectra::visit_dtype(dtype, [&](auto t) -> vectra::AnyTensor {
+        using T = decltype(t);
+        return full<T>(shape, static_cast<T>(value));
+    });
+}
+
+inline vectra::AnyTensor zeros(const Shape& shape, vectra::DType dtype)
+{
+    return vectra::visit_dtype(dtype, [&](auto t) -> vectra::AnyTensor { return zeros<decltype(t)>(shape); });
+}
+
+inline vectra::AnyTensor ones(const Shape& shape, vectra::DType dtype)
+{
+    return vectra::visit_dtype(dtype, [&](auto t) -> vectra::AnyTensor { return ones<decltype(t)>(shape); });
+}
+
+inline vectra::AnyTensor twos(const Shape& shape, vectra::DType dtype)
+{
+    return vectra::visit_dtype(dtype, [&](auto t) -> vectra::AnyTensor { return twos<decltype(t)>(shape); });
+}
+
+inline vectra::AnyTensor rand(const Shape& shape, vectra::DType dtype)
+{
+    vectra::detail::floating_only("rand", dtype);
+    if (dtype == vectra::DType::Float64) return rand<vectra::float64>(shape);
+    return rand<vectra::float32>(shape);
+}
+
+inline vectra::AnyTensor randn(const Shape& shape, vectra::DType dtype)
+{
+    vectra::detail::floating_only("randn", dtype);
+    if (dtype == vectra::DType::Float64) return randn<vectra::float64>(shape);
+    return randn<vectra::float32>(shape);
+}
+
+// Arithmetic (both operands of one dtype, broadcast like the typed ops)
+inline vectra::AnyTensor add(const vectra::AnyTensor& A, const vectra::AnyTensor& B)
+{
+    return vectra::detail::binary("add", A, B, [](const auto& a, const auto& b) { return add(a, b); });
+}
+
+inline vectra::AnyTensor sub(const vectra::AnyTensor& A, const vectra::AnyTensor& B)
+{
+    return vectra::detail::binary("sub", A, B, [](const auto& a, const auto& b) { return sub(a, b); });
+}
+
+inline vectra::AnyTensor mul(const vectra::AnyTensor& A, const vectra::AnyTensor& B)
+{
+    return vectra::detail::binary("mul", A, B, [](const auto& a, const auto& b) { return mul(a, b); });
+}
+
+inline vectra::AnyTensor div(const vectra::AnyTensor& A, const vectra::AnyTensor& B)
+{
+    return vectra::detail::binary("div", A, B, [](const auto& a, const auto& b) { return div(a, b); });
+}
+
+inline vectra::AnyTensor dot(const vectra::AnyTensor& A, const vectra::AnyTensor& B)
+{
+    return vectra::detail::binary("dot", A, B, [](const auto& a, const auto& b) { return dot(a, b); });
+}
+
+inline vectra::AnyTensor pow_tensor(const vectra::AnyTensor& A, const vectra::AnyTensor& B)
+{
+    return vectra::detail::binary("pow_tensor", A, B, [](const auto& a, const auto& b) { return pow_tensor(a, b); });
+}
+
+inline vectra::AnyTensor pow_tensor(const vectra::AnyTensor& A, double exponent)
+{
+    return vectra::detail::unary(A, [&](const auto& a) {
+        using T = decltype(vectra::detail::element_of(a));
+        return pow_tensor(a, static_cast<T>(exponent));
+    });
+}
+
+// Reductions
+#define VECTRA_ANY_REDUCE(op)                                                                          \
+inline vectra::AnyTensor op(const vectra::AnyTensor& A)                                               \
+{                                                                                                      \
+    return vectra::detail::unary(A, [](const auto& a) { return op(a); });                             \
+}                                                                                                      \
+inline vectra::AnyTensor op(const vectra::AnyTensor& A, const std::vector<size_t>& axes, bool keepdims = false) \
+{                                                                                                      \
+    return vectra::detail::unary(A, [&](const auto& a) { return op(a, axes, keepdims); });            \
+}
+
+VECTRA_ANY_REDUCE(sum)
+VECTRA_ANY_REDUCE(prod)
+VECTRA_ANY_REDUCE(max)
+VECTRA_ANY_REDUCE(min)
+VECTRA_ANY_REDUCE(mean)
+
+#undef VECTRA_ANY_REDUCE
+
+inline vectra::AnyTensor argmax(const vectra::AnyTensor& A)
+{
+    return vectra::detail::unary(A, [](const auto& a) { return argmax(a); });
+}
+
+inline vectra::AnyTensor argmin(const vectra::AnyTensor& A)
+{
+    return vectra::detail::unary(A, [](const auto& a) { return argmin(a); });
+}
+
+inline vectra::AnyTensor argmax(const vectra::AnyTensor& A, size_t axis, bool keepdims = false)
+{
+    return vectra::detail::unary(A, [&](const auto& a) { return argmax(a, axis, keepdims); });
+}
+
+inline vectra::AnyTensor argmin(const vectra::AnyTensor& A, size_t axis, bool keepdims = false)
+{
+    return vectra::detail::unary(A, [&](const auto& a) { return argmin(a, axis, keepdims); });
+}
+
+// Math
+#define VECTRA_ANY_UNARY(op)                                                                           \
+inline vectra::AnyTensor op(const vectra::AnyTensor& A)                                               \
+{                                                                                                      \
+    return vectra::detail::unary(A, [](const auto& a) { return op(a); });                             \
+}
+
+VECTRA_ANY_UNARY(exp_tensor)
+VECTRA_ANY_UNARY(log_tensor)
+VECTRA_ANY_UNARY(log1p_tensor)
+VECTRA_ANY_UNARY(tanh_tensor)
+VECTRA_ANY_UNARY(sigmoid_tensor)
+VECTRA_ANY_UNARY(erf_tensor)
+VECTRA_ANY_UNARY(sqrt_tensor)
+VECTRA_ANY_UNARY(rsqrt_tensor)
+
+// Views
+VECTRA_ANY_UNARY(contiguous)
+VECTRA_ANY_UNARY(flatten)
+VECTRA_ANY_UNARY(squeeze)
+
+#undef VECTRA_ANY_UNARY
+
+inline vectra::AnyTensor reshape(const vectra::AnyTensor& A, const Shape& shape)
+{
+    return vectra::detail::unary(A, [&](const auto& a) { return reshape(a, shape); });
+}
+
+inline vectra::AnyTensor permute(const vectra::AnyTensor& A, const std::vector<size_t>& dims)
+{
+    return vectra::detail::unary(A, [&](const auto& a) { return permute(a, dims); });
+}
+
+inline vectra::AnyTensor transpose(const vectra::AnyTensor& A, size_t dim0, size_t dim1)
+{
+    return vectra::detail::unary(A, [&](const auto& a) { return transpose(a, dim0, dim1); });
+}
+
+inline vectra::AnyTensor slice(const vectra::AnyTensor& A, size_t dim, size_t start, size_t end, size_t step = 1)
+{
+    return vectra::detail::unary(A, [&](const auto& a) { return slice(a, dim, start, end, step); });
+}
+
+inline vectra::AnyTensor expand(const vectra::AnyTensor& A, const Shape& shape)
+{
+    return vectra::detail::unary(A, [&](const auto& a) { return expand(a, shape); });
+}
+
+inline vectra::AnyTensor squeeze(const vectra::AnyTensor& A, size_t dim)
+{
+    return vectra::detail::unary(A, [&](const auto& a) { return squeeze(a, dim); });
+}
+
+inline vectra::AnyTensor unsqueeze(const vectra::AnyTensor& A, size_t dim)
+{
+    return vectra::detail::unary(A, [&](const auto& a) { return unsqueeze(a, dim); });
+}
+
+// Tensor files (TensorFile.h) : the dtype comes from the file
+namespace vectra {
+
+// zero-copy view of a tensor file, nullptr on success (the reason otherwise)
+inline const char* load_tensor(const std::string& path, AnyTensor& out)
+{
+    std::shared_ptr<io::MappedFile> file;
+    io::FileInfo info;
+    if (const char* err = io::map_file(path, file, info)) return err;
+
+    if (io::holds_element<vectra::int16>(info))        out = io::file_tensor<vectra::int16>(std::move(file), info);
+    else if (io::holds_element<vectra::int32>(info))   out = io::file_tensor<vectra::int32>(std::move(file), info);
+    else if (io::holds_element<vectra::float32>(info)) out = io::file_tensor<vectra::float32>(std::move(file), info);
+    else if (io::holds_element<vectra::float64>(info)) out = io::file_tensor<vectra::float64>(std::move(file), info);
+    else return "unsupported element type (int16, int32, float32, float64)";
+    return nullptr;
+}
+
+inline AnyTensor load(const std::string& path)
+{
+    AnyTensor t;
+    if (const char* err = load_tensor(path, t)) {
+        fprintf(stderr, "vectra load() : %s : %s!\n", path.c_str(), err);
+        exit(EXIT_FAILURE);
+    }
+    return t;
+}
+
+inline void save(const std::string& path, const AnyTensor& t)
+{
+    t.visit([&](const auto& x) { x.save(path); });
+}
+
+} // namespace vectra
+
+#endif // __cplusplus
+
+#endif // ANYTENSOR_H
@@ -0,0 +1,970 @@
+/*
+ *
+ * Npy.h (v1.2)
+ *
+ * v1.2 updated : * shapes whose byte size does not fit in size_t are refused, the .npz offsets and zip64
+ *                  sizes read from the archive are bounded without sums that can wrap around
+ *
+ * v1.1 updated : * read_header checks the magic and version before trusting the length bytes, and refuses
+ *                  a header too short to hold the dict
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * NumPy .npy / .npz files without NumPy.
+ *
+ *   .npy  npy::load<T>(path)       elements read into a new tensor (byte-swapped if big-endian)
+ *         npy::mmap<T>(path)       zero-copy view of the mapped file (copy-on-write, little-endian)
+ *         npy::Reader<T>           chunked reading in file order, the array is never fully in RAM
+ *         npy::save(path, A)       streamed (npy::Writer<T> takes the elements in pieces)
+ *   .npz  npy::NpzFile             mapped archive : stored members are zero-copy views, deflated
+ *                                  members (np.savez_compressed) are inflated with zlib
+ *                                  (VECTRA_WITH_ZLIB, set by TenLib/CMakeLists.txt when found)
+ *         npy::NpzWriter           stored members, streamed, data aligned to 64 bytes in the archive
+ *
+ * dtypes : int16, int32, float32, float64 ('<i2', '<i4', '<f4', '<f8' and their big-endian forms).
+ * A Fortran-order array becomes a column-major view (strides 1, d0, d0 * d1 ...), never a copy.
+ * The functions returning `const char*` report a failure by its reason (nullptr on success), the
+ * others print it and exit like the rest of the library.
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#pragma once
+#ifndef NPY_H
+#define NPY_H
+
+#ifdef __cplusplus
+
+#include <cpu/TensorOps.h>
+#include <cpu/AnyTensor.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(VECTRA_WITH_ZLIB)
+#include <zlib.h>
+#endif
+
+namespace vectra {
+namespace npy {
+
+constexpr char NPY_MAGIC[6] = { '\x93', 'N', 'U', 'M', 'P', 'Y' };
+constexpr size_t NPY_ALIGNMENT = 64;
+
+// length of the smallest dict a header can hold : {'descr':'<f4','fortran_order':True,'shape':()}
+constexpr size_t NPY_MIN_DICT = 47;
+
+// dtype, order and shape of an array, data_offset is relative to the start of the .npy stream
+struct ArrayInfo {
+    char kind = 0;              // 'i' signed integer, 'f' floating point
+    size_t itemsize = 0;
+    bool big_endian = false;
+    bool fortran_order = false;
+    Shape shape;
+    size_t data_offset = 0;
+
+    size_t numel() const { return shape_numel(shape); }
+    size_t data_bytes() const { return numel() * itemsize; }
+};
+
+template<typename T>
+constexpr char element_kind() { return std::is_floating_point<T>::value ? 'f' : 'i'; }
+
+template<typename T>
+bool holds(const ArrayInfo& info)
+{
+    return info.kind == element_kind<T>() && info.itemsize == sizeof(T);
+}
+
+// fn(T{}) with the element type of the array, the reason for a dtype vectra does not have
+template<typename F>
+const char* visit_dtype_of(const ArrayInfo& info, F&& fn)
+{
+    if (holds<vectra::int16>(info))   return fn(vectra::int16{});
+    if (holds<vectra::int32>(info))   return fn(vectra::int32{});
+    if (holds<vectra::float32>(info)) return fn(vectra::float32{});
+    if (holds<vectra::float64>(info)) return fn(vectra::float64{});
+    return "unsupported dtype (int16, int32, float32, float64)";
+}
+
+// element strides of the array in its file order
+inline Shape array_strides(const ArrayInfo& info)
+{
+    if (!info.fortran_order) return contiguous_strides(info.shape);
+
+    Shape strides(info.shape.size());
+    size_t step = 1;
+    for (size_t d = 0; d < info.shape.size(); ++d) {
+        strides[d] = step;
+        step *= info.shape[d];
+    }
+    return strides;
+}
+
+inline void byteswap(void* data, size_t count, size_t itemsize)
+{
+    unsigned char* p = static_cast<unsigned char*>(data);
+    for (size_t i = 0; i < count; ++i, p += itemsize) std::reverse(p, p + itemsize);
+}
+
+/*
+ *
+ * Header : magic, version, little-endian length, then a Python dict literal
+ *   {'descr': '<f4', 'fortran_order': False, 'shape': (3, 4), }
+ *
+*/
+
+// value of 'key' in the dict (the text after its colon), nullptr when absent
+inline const char* dict_value(const std::string& dict, const char* key)
+{
+    const std::string quoted[2] = { std::string("'") + key + "'", std::string("\"") + key + "\"" };
+    for (const std::string& q : quoted) {
+        const size_t at = dict.find(q);
+        if (at == std::string::npos) continue;
+        const size_t colon = dict.find(':', at + q.size());
+        if (colon == std::string::npos) return nullptr;
+        size_t v = colon + 1;
+        while (v < dict.size() && dict[v] == ' ') ++v;
+        return dict.c_str() + v;
+    }
+    return nullptr;
+}
+
+// parses the header of the `avail` bytes at p, nullptr on success
+inline const char* parse_header(const char* p, size_t avail, ArrayInfo& info)
+{
+    if (avail < 10 || std::memcmp(p, NPY_MAGIC, sizeof(NPY_MAGIC)) != 0) return "not a .npy file";
+
+    const uint8_t major = uint8_t(p[6]);
+    size_t prefix, len;
+    if (major == 1) {
+        prefix = 10;
+        len = size_t(uint8_t(p[8])) | size_t(uint8_t(p[9])) << 8;
+    }
+    else if (major == 2 || major == 3) {
+        if (avail < 12) return "truncated header";
+        prefix = 12;
+        len = size_t(uint8_t(p[8])) | size_t(uint8_t(p[9])) << 8 | size_t(uint8_t(p[10])) << 16 | size_t(uint8_t(p[11])) << 24;
+    }
+    else {
+        return "unsupported .npy version";
+    }
+    if (len < NPY_MIN_DICT) return "header too short";
+    if (avail < prefix + len) return "truncated header";
+
+    const std::string dict(p + prefix, len);
+    info.data_offset = prefix + len;
+
+    // 'descr' : byte order, kind, item size
+    const char* descr = dict_value(dict, "descr");
+    if (!descr || (*descr != '\'' && *descr != '"')) return "structured dtypes are not supported";
+    ++descr;
+    const char order = *descr;
+    if (order == '<' || order == '|' || order == '=') info.big_endian = false;
+    else if (order == '>') info.big_endian = true;
+    else return "bad descr";
+    info.kind = descr[1];
+    info.itemsize = size_t(std::strtoul(descr + 2, nullptr, 10));
+
+    const char* fortran = dict_value(dict, "fortran_order");
+    if (!fortran) return "missing fortran_order";
+    info.fortran_order = std::strncmp(fortran, "True", 4) == 0;
+
+    // 'shape' : (d0, d1, ...) with an optional trailing comma, () for a scalar
+    const char* shape = dict_value(dict, "shape");
+    if (!shape || *shape != '(') return "missing shape";
+    info.shape.clear();
+    for (const char* s = shape + 1; *s && *s != ')';) {
+        if (*s == ' ' || *s == ',' || *s == 'L') {
+            ++s;
+            continue;
+        }
+        char* end = nullptr;
+        const unsigned long long d = std::strtoull(s, &end, 10);
+        if (end == s) return "bad shape";
+        info.shape.push_back(size_t(d));
+        s = end;
+    }
+    size_t bytes = 0;
+    if (!shape_bytes(info.shape, info.itemsize, bytes)) return "shape too large";
+    return nullptr;
+}
+
+// header of a C-order array : version 1.0 unless the dict needs a 32-bit length, padded so that
+// the data starts on a multiple of NPY_ALIGNMENT
+template<typename T>
+std::string make_header(const Shape& shape)
+{
+    std::string dict = "{'descr': '<";
+    dict += element_kind<T>();
+    dict += std::to_string(sizeof(T));
+    dict += "', 'fortran_order': False, 'shape': (";
+    for (size_t d = 0; d < shape.size(); ++d) {
+        dict += std::to_string(shape[d]);
+        if (d + 1 < shape.size() || shape.size() == 1) dict += ",";
+        if (d + 1 < shape.size()) dict += " ";
+    }
+    dict += "), }";
+
+    const bool wide = dict.size() + 1 + 10 + NPY_ALIGNMENT > 65535;
+    const size_t prefix = wide ? 12 : 10;
+    const size_t total = (prefix + dict.size() + 1 + NPY_ALIGNMENT - 1) / NPY_ALIGNMENT * NPY_ALIGNMENT;
+    dict.append(total - prefix - dict.size() - 1, ' ');
+    dict += '\n';
+
+    const size_t len = dict.size();
+    std::string header(NPY_MAGIC, sizeof(NPY_MAGIC));
+    header += char(wide ? 2 : 1);
+    header += char(0);
+    header += char(len & 0xff);
+    header += char((len >> 8) & 0xff);
+    if (wide) {
+        header += char((len >> 16) & 0xff);
+        header += char((len >> 24) & 0xff);
+    }
+    return header + dict;
+}
+
+// npy header at the start of an open file, nullptr on success
+inline const char* read_header(FILE* f, ArrayInfo& info)
+{
+    // magic and version first : they decide how many length bytes follow
+    char prefix[12];
+    if (fread(prefix, 1, 10, f) != 10) return "truncated header";
+    if (std::memcmp(prefix, NPY_MAGIC, sizeof(NPY_MAGIC)) != 0) return "not a .npy file";
+
+    const uint8_t major = uint8_t(prefix[6]);
+    if (major < 1 || major > 3) return "unsupported .npy version";
+    const size_t pre = major == 1 ? 10 : 12;
+    if (pre == 12 && fread(prefix + 10, 1, 2, f) != 2) return "truncated header";
+
+    const size_t len = pre == 10 ? size_t(uint8_t(prefix[8])) | size_t(uint8_t(prefix[9])) << 8
+                                 : size_t(uint8_t(prefix[8])) | size_t(uint8_t(prefix[9])) << 8 |
+                                   size_t(uint8_t(prefix[10])) << 16 | size_t(uint8_t(prefix[11])) << 24;
+    if (len < NPY_MIN_DICT) return "header too short";
+
+    std::vector<char> head(pre + len);
+    std::memcpy(head.data(), prefix, pre);
+    if (fread(head.data() + pre, 1, len, f) != len) return "truncated header";
+    return parse_header(head.data(), head.size(), info);
+}
+
+/*
+ *
+ * .npy reading
+ *
+*/
+
+// elements of an array in file order, read n at a time
+template<typename T>
+class Reader {
+public:
+    Reader() = default;
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    ~Reader()
+    {
+        if (file_) fclose(file_);
+    }
+
+    // nullptr on success
+    const char* open(const std::string& path)
+    {
+        file_ = fopen(path.c_str(), "rb");
+        if (!file_) return "cannot open the file";
+        if (const char* err = read_header(file_, info_)) return err;
+        if (!holds<T>(info_)) return "element type does not match the tensor";
+        remaining_ = info_.numel();
+        return nullptr;
+    }
+
+    const ArrayInfo& info() const { return info_; }
+    const Shape& shape() const { return info_.shape; }
+    size_t remaining() const { return remaining_; }
+
+    // up to n elements (C or Fortran order as stored), the count read
+    size_t read(T* dst, size_t n)
+    {
+        n = std::min(n, remaining_);
+        const size_t got = n ? fread(dst, sizeof(T), n, file_) : 0;
+        if (info_.big_endian) byteswap(dst, got, sizeof(T));
+        remaining_ -= got;
+        if (got != n) remaining_ = 0;    // truncated file
+        return got;
+    }
+
+private:
+    FILE* file_ = nullptr;
+    ArrayInfo info_;
+    size_t remaining_ = 0;
+};
+
+// the whole array in a new tensor (a Fortran-order file keeps its column-major layout)
+template<typename T>
+const char* read_npy(const std::string& path, Tensor<T>& out)
+{
+    Reader<T> reader;
+    if (const char* err = reader.open(path)) return err;
+
+    const ArrayInfo& info = reader.info();
+    Tensor<T> t(info.shape);
+    t.strides = array_strides(info);
+    t.update_layout();
+    if (reader.read(t.data(), t.numel()) != t.numel()) return "truncated data";
+    out = std::move(t);
+    return nullptr;
+}
+
+// view of the array inside a mapping that `owner` keeps alive (nullptr on success)
+template<typename T>
+const char* view_array(const char* stream, size_t avail, std::shared_ptr<void> owner, Tensor<T>& out)
+{
+    ArrayInfo info;
+    if (const char* err = parse_header(stream, avail, info)) return err;
+    if (!holds<T>(info)) return "element type does not match the tensor";
+    if (info.data_bytes() > avail - info.data_offset) return "truncated data";     // parse_header : data_offset <= avail
+
+    const char* data = stream + info.data_offset;
+    if (info.big_endian || reinterpret_cast<uintptr_t>(data) % alignof(T) != 0) {
+        // byte-swapped or misaligned : a packed copy
+        Tensor<T> t(info.shape);
+        t.strides = array_strides(info);
+        t.update_layout();
+        std::memcpy(t.data(), data, info.data_bytes());
+        if (info.big_endian) byteswap(t.data(), t.numel(), sizeof(T));
+        out = std::move(t);
+        return nullptr;
+    }
+    out = from_blob<T>(reinterpret_cast<T*>(const_cast<char*>(data)), info.shape, array_strides(info), std::move(owner));
+    return nullptr;
+}
+
+template<typename T>
+const char* map_npy(const std::string& path, Tensor<T>& out)
+{
+    auto file = std::make_shared<io::MappedFile>();
+    if (const char* err = file->open(path)) return err;
+    return view_array<T>(file->data(), file->size(), file, out);
+}
+
+/*
+ *
+ * .npy writing (C order) : header first, then the elements in any number of pieces
+ *
+*/
+
+template<typename T>
+class Writer {
+public:
+    Writer(const std::string& path, const Shape& shape)
+    : remaining_(shape_numel(shape))
+    {
+        file_ = fopen(path.c_str(), "wb");
+        if (!file_) {
+            fprintf(stderr, "vectra npy::Writer() : cannot create %s!\n", path.c_str());
+            exit(EXIT_FAILURE);
+        }
+        const std::string header = make_header<T>(shape);
+        put(header.data(), header.size());
+    }
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    ~Writer()
+    {
+        if (file_) close();
+    }
+
+    void write(const T* data, size_t n)
+    {
+        if (n > remaining_) {
+            fprintf(stderr, "vectra npy::Writer::write() : %zu elements past the end of the array!\n", n - remaining_);
+            exit(EXIT_FAILURE);
+        }
+        put(data, n * sizeof(T));
+        remaining_ -= n;
+    }
+
+    void close()
+    {
+        if (!file_) return;
+        if (remaining_ != 0) {
+            fprintf(stderr, "vectra npy::Writer::close() : %zu elements were never written!\n", remaining_);
+            exit(EXIT_FAILURE);
+        }
+        if (fclose(file_) != 0) {
+            fprintf(stderr, "vectra npy::Writer::close() : write error!\n");
+            exit(EXIT_FAILURE);
+        }
+        file_ = nullptr;
+    }
+
+private:
+    void put(const void* data, size_t bytes)
+    {
+        if (bytes && fwrite(data, 1, bytes, file_) != bytes) {
+            fprintf(stderr, "vectra npy::Writer::write() : write error!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    size_t remaining_;
+    FILE* file_ = nullptr;
+};
+
+/*
+ *
+ * .npz : a zip archive of .npy members (zip64 for members or offsets past 4 GiB)
+ *
+*/
+
+inline uint32_t crc32_update(uint32_t crc, const void* data, size_t bytes)
+{
+    static const auto table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < bytes; ++i) crc = table[(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+inline uint16_t get16(const char* p) { return uint16_t(uint8_t(p[0]) | uint8_t(p[1]) << 8); }
+inline uint32_t get32(const char* p) { return uint32_t(get16(p)) | uint32_t(get16(p + 2)) << 16; }
+inline uint64_t get64(const char* p) { return uint64_t(get32(p)) | uint64_t(get32(p + 4)) << 32; }
+
+inline void put16(std::string& s, uint16_t v) { s += char(v & 0xff); s += char(v >> 8); }
+inline void put32(std::string& s, uint32_t v) { put16(s, uint16_t(v)); put16(s, uint16_t(v >> 16)); }
+inline void put64(std::string& s, uint64_t v) { put32(s, uint32_t(v)); put32(s, uint32_t(v >> 32)); }
+
+constexpr uint32_t ZIP_LOCAL = 0x04034b50;
+constexpr uint32_t ZIP_CENTRAL = 0x02014b50;
+constexpr uint32_t ZIP_END = 0x06054b50;
+constexpr uint32_t ZIP64_END = 0x06064b50;
+constexpr uint32_t ZIP64_LOCATOR = 0x07064b50;
+constexpr uint16_t ZIP_STORED = 0;
+constexpr uint16_t ZIP_DEFLATED = 8;
+
+struct NpzMember {
+    std::string name;               // without the .npy suffix
+    uint16_t method = 0;
+    uint64_t compressed = 0;
+    uint64_t size = 0;
+    uint64_t local_offset = 0;
+};
+
+class NpzFile {
+public:
+    // nullptr on success
+    const char* open(const std::string& path)
+    {
+        file_ = std::make_shared<io::MappedFile>();
+        if (const char* err = file_->open(path)) return err;
+        const char* base = file_->data();
+        const size_t size = file_->size();
+
+        // end of central directory : last signature within the maximal comment length
+        if (size < 22) return "not a zip archive";
+        size_t end = size - 22;
+        const size_t stop = size > 22 + 65535 ? size - 22 - 65535 : 0;
+        while (get32(base + end) != ZIP_END) {
+            if (end == stop) return "not a zip archive";
+            --end;
+        }
+
+        uint64_t entries = get16(base + end + 10);
+        uint64_t cd_offset = get32(base + end + 16);
+        if ((entries == 0xffff || cd_offset == 0xffffffffu) && end >= 20 && get32(base + end - 20) == ZIP64_LOCATOR) {
+            const uint64_t z64 = get64(base + end - 20 + 8);
+            if (z64 > size || size - z64 < 56 || get32(base + z64) != ZIP64_END) return "bad zip64 directory";
+            entries = get64(base + z64 + 32);
+            cd_offset = get64(base + z64 + 48);
+        }
+
+        // offsets and sizes come from the file : compared as `x > size - y`, never summed past size
+        if (cd_offset > size) return "bad central directory";
+        size_t at = size_t(cd_offset);
+        for (uint64_t e = 0; e < entries; ++e) {
+            if (at > size || size - at < 46 || get32(base + at) != ZIP_CENTRAL) return "bad central directory";
+            NpzMember m;
+            m.method = get16(base + at + 10);
+            m.compressed = get32(base + at + 20);
+            m.size = get32(base + at + 24);
+            const size_t name_len = get16(base + at + 28);
+            const size_t extra_len = get16(base + at + 30);
+            const size_t comment_len = get16(base + at + 32);
+            m.local_offset = get32(base + at + 42);
+            if (size - at - 46 < name_len + extra_len) return "bad central directory";
+            m.name.assign(base + at + 46, name_len);
+
+            // zip64 extra field : the 8-byte values of the fields saturated above, in order
+            const size_t extra_end = at + 46 + name_len + extra_len;
+            for (size_t x = at + 46 + name_len; x + 4 <= extra_end;) {
+                const uint16_t id = get16(base + x);
+                const uint16_t len = get16(base + x + 2);
+                if (len > extra_end - x - 4) return "bad central directory";
+                if (id == 0x0001) {
+                    const size_t wide = 8 * (size_t(m.size == 0xffffffffu) + size_t(m.compressed == 0xffffffffu) +
+                                             size_t(m.local_offset == 0xffffffffu));
+                    if (len < wide) return "bad zip64 field";
+                    const char* v = base + x + 4;
+                    if (m.size == 0xffffffffu) { m.size = get64(v); v += 8; }
+                    if (m.compressed == 0xffffffffu) { m.compressed = get64(v); v += 8; }
+                    if (m.local_offset == 0xffffffffu) m.local_offset = get64(v);
+                }
+                x += 4 + len;
+            }
+
+            if (m.name.size() > 4 && m.name.compare(m.name.size() - 4, 4, ".npy") == 0) m.name.resize(m.name.size() - 4);
+            members_.push_back(std::move(m));
+            at += 46 + name_len + extra_len + comment_len;
+        }
+        return nullptr;
+    }
+
+    const std::vector<NpzMember>& members() const { return members_; }
+
+    std::vector<std::string> names() const
+    {
+        std::vector<std::string> out;
+        for (const NpzMember& m : members_) out.push_back(m.name);
+        return out;
+    }
+
+    const NpzMember* find(const std::string& name) const
+    {
+        for (const NpzMember& m : members_) {
+            if (m.name == name) return &m;
+        }
+        return nullptr;
+    }
+
+    // header of a member (its dtype before choosing the Tensor type), nullptr on success
+    const char* info(const std::string& name, ArrayInfo& out)
+    {
+        std::shared_ptr<void> holder;
+        const char* stream;
+        size_t avail;
+        if (const char* err = member_stream(name, holder, stream, avail)) return err;
+        return parse_header(stream, avail, out);
+    }
+
+    // stored members are views of the mapping, deflated members are inflated into a new tensor
+    template<typename T>
+    const char* get(const std::string& name, Tensor<T>& out)
+    {
+        std::shared_ptr<void> holder;
+        const char* stream;
+        size_t avail;
+        if (const char* err = member_stream(name, holder, stream, avail)) return err;
+        return view_array<T>(stream, avail, std::move(holder), out);
+    }
+
+    // the dtype of the member picks the tensor type
+    const char* get_any(const std::string& name, AnyTensor& out)
+    {
+        std::shared_ptr<void> holder;
+        const char* stream;
+        size_t avail;
+        if (const char* err = member_stream(name, holder, stream, avail)) return err;
+
+        ArrayInfo info;
+        if (const char* err = parse_header(stream, avail, info)) return err;
+        return visit_dtype_of(info, [&](auto tag) -> const char* {
+            using T = decltype(tag);
+            Tensor<T> t;
+            if (const char* err = view_array<T>(stream, avail, holder, t)) return err;
+            out = std::move(t);
+            return nullptr;
+        });
+    }
+
+private:
+    // the bytes of a .npy member : in the mapping when stored, in an inflated buffer otherwise
+    const char* member_stream(const std::string& name, std::shared_ptr<void>& holder, const char*& stream, size_t& avail)
+    {
+        const NpzMember* m = find(name);
+        if (!m) return "no such member";
+
+        const char* base = file_->data();
+        const size_t size = file_->size();
+        const uint64_t lo = m->local_offset;
+        if (lo > size || size - lo < 30 || get32(base + lo) != ZIP_LOCAL) return "bad local header";
+        const uint64_t data = lo + 30 + get16(base + lo + 26) + get16(base + lo + 28);
+        if (data > size || m->compressed > size - data) return "truncated member";
+
+        if (m->method == ZIP_STORED) {
+            if (m->size > m->compressed) return "truncated member";
+            holder = file_;
+            stream = base + data;
+            avail = size_t(m->size);
+            return nullptr;
+        }
+        if (m->method != ZIP_DEFLATED) return "unsupported compression method";
+
+#if defined(VECTRA_WITH_ZLIB)
+        // deflate expands at most 1032 : 1, a larger size is a damaged directory (not a huge allocation)
+        if (m->size / 1032 > m->compressed) return "bad member size";
+        auto buf = std::make_shared<std::vector<char>>(size_t(m->size));
+        z_stream z{};
+        if (inflateInit2(&z, -MAX_WBITS) != Z_OK) return "inflate failed";
+
+        // zlib counts in uInt : large members are inflated in pieces
+        const char* src = base + data;
+        uint64_t in_left = m->compressed;
+        uint64_t out_done = 0;
+        int rc = Z_OK;
+        while (rc == Z_OK) {
+            if (z.avail_in == 0 && in_left) {
+                const uInt n = uInt(std::min<uint64_t>(in_left, 1u << 30));
+                z.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(src));
+                z.avail_in = n;
+                src += n;
+                in_left -= n;
+            }
+            const uInt room = uInt(std::min<uint64_t>(m->size - out_done, 1u << 30));
+            z.next_out = reinterpret_cast<Bytef*>(buf->data() + out_done);
+            z.avail_out = room;
+            rc = inflate(&z, Z_NO_FLUSH);
+            out_done += room - z.avail_out;
+            if (rc == Z_BUF_ERROR && out_done == m->size) rc = Z_STREAM_END;
+        }
+        inflateEnd(&z);
+        if (rc != Z_STREAM_END || out_done != m->size) return "inflate failed";
+
+        stream = buf->data();
+        avail = buf->size();
+        holder = std::move(buf);
+        return nullptr;
+#else
+        return "deflated member : build with zlib (VECTRA_WITH_ZLIB)";
+#endif
+    }
+
+    std::shared_ptr<io::MappedFile> file_;
+    std::vector<NpzMember> members_;
+};
+
+// stored archive written member by member : begin(name, shape), write() the elements, end()
+class NpzWriter {
+public:
+    explicit NpzWriter(const std::string& path)
+    {
+        file_ = fopen(path.c_str(), "wb");
+        if (!file_) {
+            fprintf(stderr, "vectra npy::NpzWriter() : cannot create %s!\n", path.c_str());
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    NpzWriter(const NpzWriter&) = delete;
+    NpzWriter& operator=(const NpzWriter&) = delete;
+
+    ~NpzWriter()
+    {
+        if (file_) close();
+    }
+
+    template<typename T>
+    void begin(const std::string& name, const Shape& shape)
+    {
+        if (open_) {
+            fprintf(stderr, "vectra npy::NpzWriter::begin() : member %s is still open!\n", current_.name.c_str());
+            exit(EXIT_FAILURE);
+        }
+        const std::string header = make_header<T>(shape);
+        const uint64_t bytes = header.size() + uint64_t(shape_numel(shape)) * sizeof(T);
+
+        current_ = Member{ name + ".npy", 0, bytes, offset_ };
+        remaining_ = bytes - header.size();
+        crc_ = 0;
+        open_ = true;
+
+        // local header, the crc is patched by end() ; the extra field pads the member to 64 bytes
+        const bool zip64 = bytes >= 0xffffffffu;
+        std::string local;
+        put32(local, ZIP_LOCAL);
+        put16(local, zip64 ? 45 : 20);
+        put16(local, 0);
+        put16(local, ZIP_STORED);
+        put32(local, 0x00210000);            // 1980-01-01 00:00
+        put32(local, 0);
+        put32(local, zip64 ? 0xffffffffu : uint32_t(bytes));
+        put32(local, zip64 ? 0xffffffffu : uint32_t(bytes));
+        put16(local, uint16_t(current_.name.size()));
+
+        std::string extra;
+        if (zip64) {
+            put16(extra, 0x0001);
+            put16(extra, 16);
+            put64(extra, bytes);
+            put64(extra, bytes);
+        }
+        const size_t head = 30 + current_.name.size() + extra.size() + 4;
+        const size_t pad = (NPY_ALIGNMENT - (offset_ + head) % NPY_ALIGNMENT) % NPY_ALIGNMENT;
+        put16(extra, 0xD935);                // alignment padding (the id zipalign uses)
+        put16(extra, uint16_t(pad));
+        extra.append(pad, '\0');
+
+        put16(local, uint16_t(extra.size()));
+        local += current_.name;
+        local += extra;
+        put(local.data(), local.size());
+        member(header.data(), header.size());
+    }
+
+    template<typename T>
+    void write(const T* data, size_t n)
+    {
+        const uint64_t bytes = uint64_t(n) * sizeof(T);
+        if (!open_ || bytes > remaining_) {
+            fprintf(stderr, "vectra npy::NpzWriter::write() : elements past the end of the member!\n");
+            exit(EXIT_FAILURE);
+        }
+        member(data, size_t(bytes));
+        remaining_ -= bytes;
+    }
+
+    void end()
+    {
+        if (!open_ || remaining_ != 0) {
+            fprintf(stderr, "vectra npy::NpzWriter::end() : member %s is incomplete!\n", current_.name.c_str());
+            exit(EXIT_FAILURE);
+        }
+        std::string crc;
+        put32(crc, crc_);
+        seek(current_.local_offset + 14);
+        if (fwrite(crc.data(), 1, crc.size(), file_) != crc.size()) {
+            fprintf(stderr, "vectra npy::NpzWriter : write error!\n");
+            exit(EXIT_FAILURE);
+        }
+        seek(offset_);
+
+        current_.crc = crc_;
+        members_.push_back(current_);
+        open_ = false;
+    }
+
+    // whole tensor as one member (strided views are written in row-major order)
+    template<typename T>
+    void add(const std::string& name, const Tensor<T>& t)
+    {
+        begin<T>(name, t.shape);
+        io::for_each_block(t, [&](const T* block, size_t n) { write(block, n); });
+        end();
+    }
+
+    void close()
+    {
+        if (!file_) return;
+        if (open_) end();
+
+        const uint64_t cd_offset = offset_;
+        for (const Member& m : members_) {
+            const bool zip64 = m.size >= 0xffffffffu || m.local_offset >= 0xffffffffu;
+            std::string extra;
+            if (zip64) {
+                put16(extra, 0x0001);
+                put16(extra, uint16_t((m.size >= 0xffffffffu ? 16 : 0) + (m.local_offset >= 0xffffffffu ? 8 : 0)));
+                if (m.size >= 0xffffffffu) {
+                    put64(extra, m.size);
+                    put64(extra, m.size);
+                }
+                if (m.local_offset >= 0xffffffffu) put64(extra, m.local_offset);
+            }
+
+            std::string c;
+            put32(c, ZIP_CENTRAL);
+            put16(c, zip64 ? 45 : 20);
+            put16(c, zip64 ? 45 : 20);
+            put16(c, 0);
+            put16(c, ZIP_STORED);
+            put32(c, 0x00210000);
+            put32(c, m.crc);
+            put32(c, m.size >= 0xffffffffu ? 0xffffffffu : uint32_t(m.size));
+            put32(c, m.size >= 0xffffffffu ? 0xffffffffu : uint32_t(m.size));
+            put16(c, uint16_t(m.name.size()));
+            put16(c, uint16_t(extra.size()));
+            put16(c, 0);
+            put16(c, 0);
+            put16(c, 0);
+            put32(c, 0);
+            put32(c, m.local_offset >= 0xffffffffu ? 0xffffffffu : uint32_t(m.local_offset));
+            c += m.name;
+            c += extra;
+            put(c.data(), c.size());
+        }
+        const uint64_t cd_size = offset_ - cd_offset;
+        const uint64_t entries = members_.size();
+        const bool zip64 = cd_offset >= 0xffffffffu || entries >= 0xffff;
+
+        std::string e;
+        if (zip64) {
+            const uint64_t z64 = offset_;
+            put32(e, ZIP64_END);
+            put64(e, 44);
+            put16(e, 45);
+            put16(e, 45);
+            put32(e, 0);
+            put32(e, 0);
+            put64(e, entries);
+            put64(e, entries);
+            put64(e, cd_size);
+            put64(e, cd_offset);
+            put32(e, ZIP64_LOCATOR);
+            put32(e, 0);
+            put64(e, z64);
+            put32(e, 1);
+        }
+        put32(e, ZIP_END);
+        put16(e, 0);
+        put16(e, 0);
+        put16(e, uint16_t(zip64 ? 0xffff : entries));
+        put16(e, uint16_t(zip64 ? 0xffff : entries));
+        put32(e, cd_size >= 0xffffffffu ? 0xffffffffu : uint32_t(cd_size));
+        put32(e, zip64 ? 0xffffffffu : uint32_t(cd_offset));
+        put16(e, 0);
+        put(e.data(), e.size());
+
+        if (fclose(file_) != 0) {
+            fprintf(stderr, "vectra npy::NpzWriter::close() : write error!\n");
+            exit(EXIT_FAILURE);
+        }
+        file_ = nullptr;
+    }
+
+private:
+    struct Member {
+        std::string name;
+        uint32_t crc;
+        uint64_t size;
+        uint64_t local_offset;
+    };
+
+    void put(const void* data, size_t bytes)
+    {
+        if (bytes && fwrite(data, 1, bytes, file_) != bytes) {
+            fprintf(stderr, "vectra npy::NpzWriter : write error!\n");
+            exit(EXIT_FAILURE);
+        }
+        offset_ += bytes;
+    }
+
+    // 64-bit position (archives may pass 2 GiB)
+    void seek(uint64_t pos)
+    {
+#if defined(_WIN32)
+        const int rc = _fseeki64(file_, int64_t(pos), SEEK_SET);
+#else
+        const int rc = fseeko(file_, off_t(pos), SEEK_SET);
+#endif
+        if (rc != 0) {
+            fprintf(stderr, "vectra npy::NpzWriter : seek error!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // bytes of the open member (counted in its crc)
+    void member(const void* data, size_t bytes)
+    {
+        crc_ = crc32_update(crc_, data, bytes);
+        put(data, bytes);
+    }
+
+    FILE* file_ = nullptr;
+    uint64_t offset_ = 0;
+    std::vector<Member> members_;
+    Member current_{};
+    uint64_t remaining_ = 0;
+    uint32_t crc_ = 0;
+    bool open_ = false;
+};
+
+/*
+ *
+ * Entry points
+ *
+*/
+
+template<typename T>
+Tensor<T> load(const std::string& path)
+{
+    Tensor<T> t;
+    if (const char* err = read_npy<T>(path, t)) {
+        fprintf(stderr, "vectra npy::load() : %s : %s!\n", path.c_str(), err);
+        exit(EXIT_FAILURE);
+    }
+    return t;
+}
+
+template<typename T>
+Tensor<T> mmap(const std::string& path)
+{
+    Tensor<T> t;
+    if (const char* err = map_npy<T>(path, t)) {
+        fprintf(stderr, "vectra npy::mmap() : %s : %s!\n", path.c_str(), err);
+        exit(EXIT_FAILURE);
+    }
+    return t;
+}
+
+template<typename T>
+void save(const std::string& path, const Tensor<T>& t)
+{
+    Writer<T> writer(path, t.shape);
+    io::for_each_block(t, [&](const T* block, size_t n) { writer.write(block, n); });
+    writer.close();
+}
+
+// dtype of the file picks the tensor type : read (mapped = false) or zero-copy view (mapped = true)
+inline const char* load_any(const std::string& path, bool mapped, AnyTensor& out)
+{
+    ArrayInfo info;
+    {
+        FILE* f = fopen(path.c_str(), "rb");
+        if (!f) return "cannot open the file";
+        const char* err = read_header(f, info);
+        fclose(f);
+        if (err) return err;
+    }
+
+    return visit_dtype_of(info, [&](auto tag) -> const char* {
+        using T = decltype(tag);
+        Tensor<T> t;
+        if (const char* err = mapped ? map_npy<T>(path, t) : read_npy<T>(path, t)) return err;
+        out = std::move(t);
+        return nullptr;
+    });
+}
+
+inline void save(const std::string& path, const AnyTensor& t)
+{
+    t.visit([&](const auto& x) { save(path, x); });
+}
+
+} // namespace npy
+} // namespace vectra
+
+#endif // __cplusplus
+
+#endif // NPY_H
@@ -0,0 +1,691 @@
+/*
+ *
+ * Profiler.h (v1.2)
+ *
+ * v1.2 updated : * the op scope charges the allocations of the op to it when utils::track_ops() is on (memory.h)
+ *
+ * v1.1 updated : * the op scope also records the timeline events of Trace.h
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Opt-in hardware counters of the TensorOps kernels (HEADER).
+ * Every op of TensorOps.h opens a Scope : when the profiler is enabled the scope reads the
+ * perf_event_open counters of the calling thread and of every pool worker before and after the
+ * op, and adds the difference to the row of (op, dtype, size bucket). An op called by another
+ * op (mean -> sum, flatten -> contiguous) is counted in the outer one only.
+ *
+ *   counter        event
+ *   task-clock     CPU time of the threads (software, always available on Linux)
+ *   cycles         core cycles, user space
+ *   instructions   retired instructions, user space
+ *   L1D misses     L1 data cache read misses
+ *   LLC misses     last level cache misses
+ *   branch misses  mispredicted branches
+ *
+ * A hardware event the machine (or a VM, or perf_event_paranoid) doesn't give is left out of
+ * the report, cycles are then estimated from the CPU time and the calibrated frequency.
+ *
+ *   vectra::profiler::enable();
+ *   ... ops ...
+ *   vectra::profiler::report();     // IPC, bytes / cycle, FLOPs / cycle against the roofline
+ *
+ * The roofline is an estimate : peak FLOPs / cycle of one core from the active ISA (two vector
+ * ports, FMA from avx2), peak bytes / cycle from a single thread 64 MiB copy at the frequency
+ * measured on a dependent add chain. set_roofline() replaces it with known figures.
+ * Elementwise math counts one FLOP per element, whatever the length of its polynomial.
+ *
+ * Environment :
+ *   VECTRA_PROFILE   1 : enabled from the start, the report is printed to stderr at exit
+ *
+ * Defining VECTRA_NO_PROFILER removes the scopes from the ops. Off, a scope costs three relaxed loads.
+ *
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#pragma once
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#ifdef __cplusplus
+
+#include <ScalarType/ScalarType.h>
+#include <Dispatch/Dispatch.h>
+#include <ThreadPool/ThreadPool.h>
+#include <VectorUtility/memory.h>
+#include <cpu/Shape.h>
+#include <cpu/Trace.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace vectra {
+namespace profiler {
+
+enum Counter {
+    TaskClock = 0,      // nanoseconds
+    Cycles,
+    Instructions,
+    L1DMisses,
+    LLCMisses,
+    BranchMisses,
+    COUNTER_COUNT
+};
+
+inline const char* counter_name(Counter c)
+{
+    switch (c) {
+        case TaskClock:    return "task-clock";
+        case Cycles:       return "cycles";
+        case Instructions: return "instructions";
+        case L1DMisses:    return "L1D-misses";
+        case LLCMisses:    return "LLC-misses";
+        case BranchMisses: return "branch-misses";
+        default:           return "unknown";
+    }
+}
+
+template<typename T>
+const char* type_name()
+{
+    if constexpr (std::is_same_v<T, vectra::int8>)         return "int8";
+    else if constexpr (std::is_same_v<T, vectra::int16>)   return "int16";
+    else if constexpr (std::is_same_v<T, vectra::int32>)   return "int32";
+    else if constexpr (std::is_same_v<T, vectra::float32>) return "float32";
+    else if constexpr (std::is_same_v<T, vectra::float64>) return "float64";
+    else                                                   return "other";
+}
+
+// sums of one (op, dtype, size bucket)
+struct Entry {
+    std::string op;
+    std::string dtype;
+    size_t bucket = 0;                  // the largest operand holds at most 2^bucket elements
+    size_t itemsize = 0;
+    bool floating = false;
+    size_t calls = 0;
+    double seconds = 0;                 // wall time
+    double bytes = 0;                   // bytes read and written (lazy constants read nothing)
+    double flops = 0;
+    double counter[COUNTER_COUNT] = {};
+    bool counted = false;               // the counters below hold values (Linux, profiler enabled)
+};
+
+// peak of one core
+struct Roofline {
+    double hz = 0;                      // core frequency
+    double bytes_per_second = 0;        // memory bandwidth of one thread
+    size_t vector_bytes = 8;            // register width of the active ISA
+    bool fma = false;
+
+    double bytes_per_cycle() const { return hz > 0 ? bytes_per_second / hz : 0; }
+
+    // two vector ports, a fused multiply-add counts twice
+    double flops_per_cycle(size_t itemsize, bool floating) const
+    {
+        const double lanes = double(std::max<size_t>(1, vector_bytes / std::max<size_t>(1, itemsize)));
+        return lanes * 2 * (floating && fma ? 2 : 1);
+    }
+};
+
+namespace detail {
+
+inline size_t size_bucket(size_t n)
+{
+    size_t b = 0;
+    while (b < 63 && (size_t(1) << b) < n) ++b;
+    return b;
+}
+
+#if defined(__linux__)
+
+// perf_event_open group of one thread : task-clock leads, the hardware events are members
+class CounterGroup {
+public:
+    explicit CounterGroup(long tid) : tid_(tid)
+    {
+        std::fill(slot_, slot_ + COUNTER_COUNT, -1);
+
+        leader_ = open_event(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, -1);
+        if (leader_ < 0) return;
+        slot_[TaskClock] = members_++;
+
+        const uint64_t l1d = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                             (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        add(Cycles,       PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        add(Instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        add(L1DMisses,    PERF_TYPE_HW_CACHE, l1d);
+        add(LLCMisses,    PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        add(BranchMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    }
+
+    ~CounterGroup()
+    {
+        for (int fd : fds_) ::close(fd);
+        if (leader_ >= 0) ::close(leader_);
+    }
+
+    CounterGroup(const CounterGroup&) = delete;
+    CounterGroup& operator=(const CounterGroup&) = delete;
+
+    long tid() const { return tid_; }
+    bool ok() const { return leader_ >= 0; }
+    bool has(Counter c) const { return slot_[c] >= 0; }
+
+    // adds the running totals to `sum`, scaled when the kernel multiplexed the group
+    bool read(double* sum) const
+    {
+        if (leader_ < 0) return false;
+
+        uint64_t buf[3 + COUNTER_COUNT];
+        const ssize_t want = ssize_t((3 + members_) * sizeof(uint64_t));
+        if (::read(leader_, buf, sizeof(buf)) < want) return false;
+
+        const double enabled = double(buf[1]);
+        const double running = double(buf[2]);
+        const double scale = running > 0 ? enabled / running : 1.0;
+        for (int c = 0; c < COUNTER_COUNT; ++c) {
+            if (slot_[c] >= 0) sum[c] += double(buf[3 + slot_[c]]) * scale;
+        }
+        return true;
+    }
+
+private:
+    long tid_;
+    int leader_ = -1;
+    int members_ = 0;
+    int slot_[COUNTER_COUNT];
+    std::vector<int> fds_;
+
+    int open_event(uint32_t type, uint64_t config, int group)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return int(syscall(SYS_perf_event_open, &attr, pid_t(tid_), -1, group, PERF_FLAG_FD_CLOEXEC));
+    }
+
+    void add(Counter c, uint32_t type, uint64_t config)
+    {
+        const int fd = open_event(type, config, leader_);
+        if (fd < 0) return;
+        fds_.push_back(fd);
+        slot_[c] = members_++;
+    }
+};
+
+inline long current_tid() { return long(syscall(SYS_gettid)); }
+
+#else
+
+class CounterGroup {
+public:
+    explicit CounterGroup(long tid) : tid_(tid) {}
+    long tid() const { return tid_; }
+    bool ok() const { return false; }
+    bool has(Counter) const { return false; }
+    bool read(double*) const { return false; }
+private:
+    long tid_;
+};
+
+inline long current_tid() { return 0; }
+
+#endif
+
+// fastest of a few dependent add chains : one add per cycle on every x86 core. The addend is a
+// register, recent cores fold chains of immediate adds at rename
+inline double measure_hz()
+{
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    constexpr uint64_t ADDS = uint64_t(1) << 26;
+    const uint64_t one = 1;
+    double best = 0;
+    for (int rep = 0; rep < 3; ++rep) {
+        uint64_t x = 0;
+        const auto t0 = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < ADDS; i += 8) {
+            __asm__ volatile("add %1, %0\n\tadd %1, %0\n\tadd %1, %0\n\tadd %1, %0\n\t"
+                             "add %1, %0\n\tadd %1, %0\n\tadd %1, %0\n\tadd %1, %0" : "+r"(x) : "r"(one));
+        }
+        const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (s > 0) best = std::max(best, double(ADDS) / s);
+    }
+    return best;
+#else
+    return 0;
+#endif
+}
+
+// best of a few single thread copies of 64 MiB, read + write bytes per second
+inline double measure_bandwidth()
+{
+    constexpr size_t BYTES = size_t(64) << 20;
+    std::unique_ptr<char[]> src(new char[BYTES]);
+    std::unique_ptr<char[]> dst(new char[BYTES]);
+    std::memset(src.get(), 1, BYTES);
+    std::memset(dst.get(), 0, BYTES);
+
+    double best = 0;
+    for (int rep = 0; rep < 3; ++rep) {
+        const auto t0 = std::chrono::steady_clock::now();
+        std::memcpy(dst.get(), src.get(), BYTES);
+        const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (s > 0) best = std::max(best, 2.0 * double(BYTES) / s);
+    }
+    return best;
+}
+
+class Profiler {
+public:
+    static Profiler& instance()
+    {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    ~Profiler()
+    {
+        if (report_at_exit_) fputs(report().c_str(), stderr);
+    }
+
+    static std::atomic<bool>& enabled_flag()
+    {
+        static std::atomic<bool> flag{ false };
+        return flag;
+    }
+
+    bool enabled() const { return enabled_flag().load(std::memory_order_relaxed); }
+
+    void enable(bool on) { enabled_flag().store(on, std::memory_order_relaxed); }
+
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        table_.clear();
+    }
+
+    // summed counters of the current thread and of every pool worker
+    bool read(double* sum)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::fill(sum, sum + COUNTER_COUNT, 0.0);
+        refresh_workers();
+
+        const long self = current_tid();
+        bool any = false;
+        bool self_counted = false;
+        for (const auto& g : workers_) {
+            any |= g->read(sum);
+            self_counted |= g->tid() == self;
+        }
+        if (!self_counted) {
+            // thread_local : closed with the thread
+            static thread_local std::unique_ptr<CounterGroup> own;
+            if (!own) own.reset(new CounterGroup(self));
+            any |= own->read(sum);
+            if (own->ok()) available_ |= own_mask(*own);
+        }
+        return any;
+    }
+
+    void add(const char* op, const char* dtype, size_t itemsize, bool floating, size_t size, double bytes,
+             double flops, double seconds, const double* delta, bool counted)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const size_t bucket = size_bucket(size);
+        Entry& e = table_[std::make_tuple(std::string(op), std::string(dtype), bucket)];
+        if (e.calls == 0) {
+            e.op = op;
+            e.dtype = dtype;
+            e.bucket = bucket;
+            e.itemsize = itemsize;
+            e.floating = floating;
+        }
+        e.calls += 1;
+        e.seconds += seconds;
+        e.bytes += bytes;
+        e.flops += flops;
+        if (counted) {
+            e.counted = true;
+            for (int c = 0; c < COUNTER_COUNT; ++c) e.counter[c] += std::max(0.0, delta[c]);
+        }
+    }
+
+    std::vector<Entry> entries()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<Entry> out;
+        for (const auto& kv : table_) out.push_back(kv.second);
+        std::sort(out.begin(), out.end(), [](const Entry& a, const Entry& b) { return a.seconds > b.seconds; });
+        return out;
+    }
+
+    // counters opened on this machine (bit per Counter)
+    unsigned available() const { return available_.load(); }
+
+    Roofline roofline()
+    {
+        std::lock_guard<std::mutex> lock(roof_mutex_);
+        if (!roof_set_) {
+            const vectra::kernel::Isa isa = vectra::kernel::active_isa();
+            roof_.vector_bytes = isa == vectra::kernel::Isa::AVX512 ? 64 :
+                                 isa == vectra::kernel::Isa::AVX2   ? 32 :
+                                 isa == vectra::kernel::Isa::SSE42  ? 16 : 8;
+            roof_.fma = isa >= vectra::kernel::Isa::AVX2;
+            roof_.hz = measure_hz();
+            roof_.bytes_per_second = measure_bandwidth();
+            roof_set_ = true;
+        }
+        return roof_;
+    }
+
+    void set_roofline(const Roofline& roof)
+    {
+        std::lock_guard<std::mutex> lock(roof_mutex_);
+        roof_ = roof;
+        roof_set_ = true;
+    }
+
+    std::string report();
+
+private:
+    using Key = std::tuple<std::string, std::string, size_t>;
+
+    std::atomic<unsigned> available_{0};
+    bool report_at_exit_ = false;
+
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<CounterGroup>> workers_;
+    size_t generation_ = 0;
+    std::map<Key, Entry> table_;
+
+    std::mutex roof_mutex_;
+    Roofline roof_;
+    bool roof_set_ = false;
+
+    Profiler()
+    {
+        if (const char* env = std::getenv("VECTRA_PROFILE")) {
+            if (std::strcmp(env, "1") == 0) {
+                enabled_flag().store(true);
+                report_at_exit_ = true;
+            }
+        }
+    }
+
+    static unsigned own_mask(const CounterGroup& g)
+    {
+        unsigned mask = 0;
+        for (int c = 0; c < COUNTER_COUNT; ++c) {
+            if (g.has(Counter(c))) mask |= 1u << c;
+        }
+        return mask;
+    }
+
+    // groups of the pool workers, reopened when the pool restarts them
+    void refresh_workers()
+    {
+        utils::ThreadPool& pool = utils::ThreadPool::instance();
+        if (pool.generation() == generation_) return;
+
+        generation_ = pool.generation();
+        workers_.clear();
+        for (long tid : pool.thread_ids()) {
+            if (tid <= 0) continue;
+            workers_.emplace_back(new CounterGroup(tid));
+            if (workers_.back()->ok()) available_ |= own_mask(*workers_.back());
+        }
+    }
+};
+
+// reads VECTRA_PROFILE before main
+inline const bool env_read = (Profiler::instance(), true);
+
+inline std::string Profiler::report()
+{
+    const std::vector<Entry> rows = entries();
+    const Roofline roof = roofline();
+    const unsigned avail = available();
+    const bool hw_cycles = (avail >> Cycles) & 1;
+
+    std::string out;
+    char line[512];
+    auto emit = [&](const char* fmt, auto... args) {
+        std::snprintf(line, sizeof(line), fmt, args...);
+        out += line;
+    };
+
+    emit("vectra profiler : isa %s, threads %zu, %.2f GHz (%s), %.1f GB/s = %.2f B/cycle per core\n",
+         vectra::kernel::isa_name(vectra::kernel::active_isa()), utils::get_num_threads(), roof.hz * 1e-9,
+         hw_cycles ? "cycles counted" : "cycles estimated from CPU time", roof.bytes_per_second * 1e-9,
+         roof.bytes_per_cycle());
+
+    out += "counters :";
+    for (int c = 0; c < COUNTER_COUNT; ++c) {
+        if ((avail >> c) & 1) { out += ' '; out += counter_name(Counter(c)); }
+    }
+    out += avail ? "\n" : " none (perf_event_open unavailable)\n";
+
+    emit("%-12s %-8s %6s %8s %10s %6s %7s %7s %7s %8s %8s %8s %-7s %6s\n",
+         "op", "dtype", "size", "calls", "time(ms)", "IPC", "B/cyc", "F/cyc", "F/B",
+         "L1D/ki", "LLC/ki", "br/ki", "bound", "roof%");
+
+    for (const Entry& e : rows) {
+        const double task_s = e.counted && ((avail >> TaskClock) & 1) ? e.counter[TaskClock] * 1e-9 : e.seconds;
+        const double cycles = hw_cycles ? e.counter[Cycles] : task_s * roof.hz;
+        const double kinstr = e.counter[Instructions] * 1e-3;
+        const bool has_instr = ((avail >> Instructions) & 1) && kinstr > 0;
+
+        const double bpc = cycles > 0 ? e.bytes / cycles : 0;
+        const double fpc = cycles > 0 ? e.flops / cycles : 0;
+        const double ai = e.bytes > 0 ? e.flops / e.bytes : 0;
+
+        // roofline of one core : min(peak FLOPs, intensity * peak bandwidth)
+        const double peak_f = roof.flops_per_cycle(e.itemsize, e.floating);
+        const double peak_b = roof.bytes_per_cycle();
+        const bool memory_bound = e.flops == 0 || (peak_b > 0 && ai < peak_f / peak_b);
+        double roof_pct = 0;
+        if (e.flops == 0) roof_pct = peak_b > 0 ? 100 * bpc / peak_b : 0;
+        else {
+            const double attainable = peak_b > 0 ? std::min(peak_f, ai * peak_b) : peak_f;
+            roof_pct = attainable > 0 ? 100 * fpc / attainable : 0;
+        }
+
+        char size[16];
+        std::snprintf(size, sizeof(size), "2^%zu", e.bucket);
+        char ipc[16] = "-", l1[16] = "-", llc[16] = "-", br[16] = "-";
+        if (has_instr) {
+            if (hw_cycles && cycles > 0) std::snprintf(ipc, sizeof(ipc), "%.2f", e.counter[Instructions] / cycles);
+            if ((avail >> L1DMisses) & 1)    std::snprintf(l1, sizeof(l1), "%.2f", e.counter[L1DMisses] / kinstr);
+            if ((avail >> LLCMisses) & 1)    std::snprintf(llc, sizeof(llc), "%.2f", e.counter[LLCMisses] / kinstr);
+            if ((avail >> BranchMisses) & 1) std::snprintf(br, sizeof(br), "%.2f", e.counter[BranchMisses] / kinstr);
+        }
+
+        emit("%-12s %-8s %6s %8zu %10.3f %6s %7.2f %7.2f %7.3f %8s %8s %8s %-7s %6.1f\n",
+             e.op.c_str(), e.dtype.c_str(), size, e.calls, e.seconds * 1e3, ipc, bpc, fpc, ai,
+             l1, llc, br, memory_bound ? "memory" : "compute", roof_pct);
+    }
+    return out;
+}
+
+} // namespace detail
+
+/*
+ *
+ * Interface
+ *
+*/
+
+inline void enable(bool on = true) { detail::Profiler::instance().enable(on); }
+
+inline void disable() { detail::Profiler::instance().enable(false); }
+
+inline bool enabled() { return detail::Profiler::enabled_flag().load(std::memory_order_relaxed); }
+
+// profiler, trace or per op memory on : the op scopes record something
+inline bool active() { return enabled() || trace::enabled() || utils::tracking_ops(); }
+
+// drops every row, the profiler stays enabled or not
+inline void reset() { detail::Profiler::instance().reset(); }
+
+// rows sorted by time, the slowest first
+inline std::vector<Entry> entries() { return detail::Profiler::instance().entries(); }
+
+inline Roofline roofline() { return detail::Profiler::instance().roofline(); }
+
+inline void set_roofline(const Roofline& roof) { detail::Profiler::instance().set_roofline(roof); }
+
+// table of every (op, dtype, size) : IPC, bytes / cycle, FLOPs / cycle, misses per 1000
+// instructions, the side of the roofline and the fraction of it reached
+inline std::string report_string() { return detail::Profiler::instance().report(); }
+
+inline void report(FILE* out = stdout) { fputs(report_string().c_str(), out); }
+
+// counters (profiler), timeline event (Trace.h) and allocation tag (memory.h) of one op, inactive
+// when all are off. The profiler skips a scope inside another one, allocations go to the innermost. `op`, `dtype` and the shapes must outlive the scope
+class Scope {
+public:
+    Scope() = default;
+
+    Scope(const char* op, const char* dtype, size_t itemsize, bool floating, size_t size, double bytes, double flops,
+          const Shape* shape_a, const Shape* shape_b)
+    {
+#ifndef VECTRA_NO_PROFILER
+        const bool tracing = trace::enabled();
+        const bool profiling = enabled();
+        const bool tagging = utils::tracking_ops();
+        if (!tracing && !profiling && !tagging) return;
+
+        op_ = op;
+        dtype_ = dtype;
+        bytes_ = bytes;
+        if (profiling) {
+            if (depth()++ > 0) nested_ = true;
+            else {
+                active_ = true;
+                itemsize_ = itemsize;
+                floating_ = floating;
+                size_ = size;
+                flops_ = flops;
+                counted_ = detail::Profiler::instance().read(begin_);
+                start_ = std::chrono::steady_clock::now();
+            }
+        }
+        if (tracing) {
+            traced_ = true;
+            shape_a_ = shape_a;
+            shape_b_ = shape_b;
+            trace_start_ = trace::now();
+        }
+        if (tagging) {
+            tagged_ = true;
+            prev_tag_ = utils::alloc_tag();
+            utils::alloc_tag() = op;
+        }
+#else
+        (void)op; (void)dtype; (void)itemsize; (void)floating; (void)size; (void)bytes; (void)flops;
+        (void)shape_a; (void)shape_b;
+#endif
+    }
+
+    ~Scope()
+    {
+        if (traced_ || nested_ || active_ || tagged_) finish();
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    bool active_ = false;
+    bool nested_ = false;
+    bool traced_ = false;
+    bool tagged_ = false;
+    bool counted_ = false;
+    bool floating_ = false;
+    const char* op_;
+    const char* dtype_;
+    size_t itemsize_;
+    size_t size_;
+    double bytes_;
+    double flops_;
+    double begin_[COUNTER_COUNT];
+    std::chrono::steady_clock::time_point start_;
+    const Shape* shape_a_;
+    const Shape* shape_b_;
+    uint64_t trace_start_;
+    const char* prev_tag_;
+
+    static size_t& depth()
+    {
+        static thread_local size_t d = 0;
+        return d;
+    }
+
+    void finish()
+    {
+#ifndef VECTRA_NO_PROFILER
+        if (tagged_) utils::alloc_tag() = prev_tag_;
+        if (traced_) trace::record(op_, dtype_, trace_start_, uint64_t(bytes_), shape_a_, shape_b_);
+        if (nested_) depth() -= 1;
+        if (!active_) return;
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+        double end[COUNTER_COUNT];
+        const bool counted = counted_ && detail::Profiler::instance().read(end);
+        for (int c = 0; c < COUNTER_COUNT; ++c) end[c] = counted ? end[c] - begin_[c] : 0;
+
+        depth() -= 1;
+        detail::Profiler::instance().add(op_, dtype_, itemsize_, floating_, size_, bytes_, flops_, seconds, end, counted);
+#endif
+    }
+};
+
+// scope of an op over elements of T : `size` is the element count of the largest operand,
+// shape_a and shape_b the shapes shown in the trace (nullptr : none)
+template<typename T>
+Scope scope(const char* op, size_t size, double bytes, double flops,
+            const Shape* shape_a = nullptr, const Shape* shape_b = nullptr)
+{
+    return Scope(op, type_name<T>(), sizeof(T), std::is_floating_point_v<T>, size, bytes, flops, shape_a, shape_b);
+}
+
+// scope of an op of TensorOps.h : the arguments of scope<T>() are not evaluated while the profiler
+// and the trace are off
+#define VECTRA_OP_SCOPE(T, ...) \
+    const vectra::profiler::Scope vectra_op_scope_ = vectra::profiler::active() ? vectra::profiler::scope<T>(__VA_ARGS__) \
+                                                                                : vectra::profiler::Scope()
+
+} // namespace profiler
+} // namespace vectra
+
+#endif // __cplusplus
+#endif // PROFILER_H
@@ -0,0 +1,282 @@
+/*
+ *
+ * Shape.h (v1.0)
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Shape and stride metadata of Tensor (HEADER).
+ * A Shape holds up to 8 dimensions inline (no heap allocation, copied with the tensor) and spills
+ * to the heap past that. It has the std::vector<size_t> interface the ops use and converts to and
+ * from std::vector<size_t>.
+ *
+ * The element count is cached : the methods that resize keep it up to date, a reference handed
+ * out by a non-const accessor (operator[], back(), data(), begin()) drops it and the next
+ * non-const numel() recomputes it. const methods never write, a const Shape is safe to read from
+ * any thread. Every change also raises changed(), which Tensor uses to know when its cached
+ * contiguity is stale.
+ *
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#pragma once
+#ifndef SHAPE_H
+#define SHAPE_H
+
+#ifdef __cplusplus
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+class Shape {
+public:
+    using value_type = size_t;
+    using size_type = size_t;
+    using reference = size_t&;
+    using const_reference = const size_t&;
+    using iterator = size_t*;
+    using const_iterator = const size_t*;
+
+    static constexpr size_t INLINE_DIMS = 8;
+
+    Shape() noexcept : data_(inline_) {}
+
+    explicit Shape(const size_t n, const size_t value = 0) : Shape() { assign(n, value); }
+
+    Shape(std::initializer_list<size_t> dims) : Shape() { assign(dims.begin(), dims.end()); }
+
+    Shape(const std::vector<size_t>& dims) : Shape() { assign(dims.begin(), dims.end()); }
+
+    template<typename It, typename = std::enable_if_t<!std::is_integral<It>::value>>
+    Shape(It first, It last) : Shape() { assign(first, last); }
+
+    Shape(const Shape& other) : Shape()
+    {
+        assign(other.begin(), other.end());
+        numel_ = other.numel_;
+        flags_ = other.flags_;
+    }
+
+    Shape(Shape&& other) noexcept : Shape()
+    {
+        take(other);
+        flags_ = other.flags_;
+        other.flags_ = NUMEL_VALID;
+    }
+
+    Shape& operator=(const Shape& other)
+    {
+        if (this != &other) {
+            assign(other.begin(), other.end());
+            numel_ = other.numel_;
+            flags_ = uint8_t((other.flags_ & NUMEL_VALID) | CHANGED);
+        }
+        return *this;
+    }
+
+    Shape& operator=(Shape&& other) noexcept
+    {
+        if (this != &other) {
+            release();
+            take(other);
+            flags_ = uint8_t((other.flags_ & NUMEL_VALID) | CHANGED);
+            other.flags_ = NUMEL_VALID | CHANGED;
+        }
+        return *this;
+    }
+
+    ~Shape() { release(); }
+
+    operator std::vector<size_t>() const { return std::vector<size_t>(begin(), end()); }
+
+    size_t size() const { return size_; }
+
+    bool empty() const { return size_ == 0; }
+
+    size_t capacity() const { return capacity_; }
+
+    // false while the dimensions fit inline
+    bool spilled() const { return data_ != inline_; }
+
+    const size_t& operator[](const size_t d) const { return data_[d]; }
+    size_t& operator[](const size_t d) { touch(); return data_[d]; }
+
+    const size_t* data() const { return data_; }
+    size_t* data() { touch(); return data_; }
+
+    const size_t* begin() const { return data_; }
+    const size_t* end() const { return data_ + size_; }
+    size_t* begin() { touch(); return data_; }
+    size_t* end() { touch(); return data_ + size_; }
+
+    const size_t& front() const { return data_[0]; }
+    const size_t& back() const { return data_[size_ - 1]; }
+    size_t& front() { touch(); return data_[0]; }
+    size_t& back() { touch(); return data_[size_ - 1]; }
+
+    // product of the dimensions (1 for a 0-d shape)
+    size_t numel() const { return (flags_ & NUMEL_VALID) ? numel_ : product(); }
+
+    size_t numel()
+    {
+        if (!(flags_ & NUMEL_VALID)) {
+            numel_ = product();
+            flags_ |= NUMEL_VALID;
+        }
+        return numel_;
+    }
+
+    // the dimensions may have changed since the last mark()
+    bool changed() const { return flags_ & CHANGED; }
+
+    void mark() { flags_ &= uint8_t(~CHANGED); }
+
+    void reserve(const size_t n)
+    {
+        if (n <= capacity_) return;
+
+        size_t* fresh = new size_t[n];
+        std::copy(data_, data_ + size_, fresh);
+        release();
+        data_ = fresh;
+        capacity_ = n;
+    }
+
+    void assign(const size_t n, const size_t value)
+    {
+        size_ = 0;
+        reserve(n);
+        std::fill(data_, data_ + n, value);
+        size_ = n;
+        refresh();
+    }
+
+    template<typename It, typename = std::enable_if_t<!std::is_integral<It>::value>>
+    void assign(It first, It last)
+    {
+        size_ = 0;
+        reserve(size_t(std::distance(first, last)));
+        for (; first != last; ++first) data_[size_++] = size_t(*first);
+        refresh();
+    }
+
+    void resize(const size_t n, const size_t value = 0)
+    {
+        reserve(n);
+        if (n > size_) std::fill(data_ + size_, data_ + n, value);
+        size_ = n;
+        refresh();
+    }
+
+    void clear()
+    {
+        size_ = 0;
+        refresh();
+    }
+
+    void push_back(const size_t value)
+    {
+        if (size_ == capacity_) reserve(capacity_ * 2);
+        data_[size_++] = value;
+        numel_ *= value;
+        flags_ |= CHANGED;
+    }
+
+    void pop_back()
+    {
+        --size_;
+        refresh();
+    }
+
+    size_t* insert(const size_t* pos, const size_t value)
+    {
+        const size_t at = size_t(pos - data_);
+        if (size_ == capacity_) reserve(capacity_ * 2);
+        std::copy_backward(data_ + at, data_ + size_, data_ + size_ + 1);
+        data_[at] = value;
+        ++size_;
+        refresh();
+        return data_ + at;
+    }
+
+    size_t* erase(const size_t* pos)
+    {
+        const size_t at = size_t(pos - data_);
+        std::copy(data_ + at + 1, data_ + size_, data_ + at);
+        --size_;
+        refresh();
+        return data_ + at;
+    }
+
+    friend bool operator==(const Shape& a, const Shape& b)
+    {
+        return a.size_ == b.size_ && std::equal(a.begin(), a.end(), b.begin());
+    }
+
+    friend bool operator!=(const Shape& a, const Shape& b) { return !(a == b); }
+
+private:
+    static constexpr uint8_t NUMEL_VALID = 1;
+    static constexpr uint8_t CHANGED = 2;
+
+    size_t* data_;
+    size_t size_ = 0;
+    size_t capacity_ = INLINE_DIMS;
+    size_t numel_ = 1;
+    uint8_t flags_ = NUMEL_VALID;
+    size_t inline_[INLINE_DIMS];
+
+    size_t product() const
+    {
+        size_t total = 1;
+        for (size_t d = 0; d < size_; ++d) total *= data_[d];
+        return total;
+    }
+
+    // the caller may write through the returned reference
+    void touch() { flags_ = CHANGED; }
+
+    void refresh()
+    {
+        numel_ = product();
+        flags_ = NUMEL_VALID | CHANGED;
+    }
+
+    void release()
+    {
+        if (data_ != inline_) delete[] data_;
+        data_ = inline_;
+        capacity_ = INLINE_DIMS;
+    }
+
+    // the dimensions of `other` (whose heap buffer is stolen), `other` is left empty and inline
+    void take(Shape& other) noexcept
+    {
+        if (other.data_ != other.inline_) {
+            data_ = other.data_;
+            capacity_ = other.capacity_;
+        }
+        else {
+            std::copy(other.inline_, other.inline_ + other.size_, inline_);
+        }
+        size_ = other.size_;
+        numel_ = other.numel_;
+        other.data_ = other.inline_;
+        other.capacity_ = INLINE_DIMS;
+        other.size_ = 0;
+        other.numel_ = 1;
+    }
+};
+
+#endif // __cplusplus
+#endif // SHAPE_H
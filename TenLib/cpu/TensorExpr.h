@@ -0,0 +1,525 @@
+/*
+ *
+ * TensorExpr.h (v1.3)
+ *
+ * v1.3 updated : * a leaf reading out through another view (transpose, shifted slice) is evaluated
+ *                  through a packed temporary, only the view of out itself is read in place
+ *
+ * v1.2 updated : * node shapes and bound strides are Shape (Shape.h), no heap allocation up to 8 dimensions
+ *
+ * v1.1 updated : * a pass is one "expr" row of the profiler (Profiler.h), one FLOP per node and element
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Lazy element-wise expressions over Tensor<T>.
+ * A + B, A * 2, -A, vectra::expr::exp(A) ... build a compile-time expression tree instead of
+ * a tensor. Nothing runs until the tree is assigned to a Tensor :
+ *
+ *   auto e = A * B + C;          // no work, no allocation
+ *   Tensor<float> r = e;         // one pass over A, B, C and r
+ *
+ * The pass walks the broadcast shape row by row (StridedLoop) and every row in blocks of
+ * EXPR_BLOCK_BYTES : each node runs its SIMD kernel (ElementWise.h, VecMath.h) on the block,
+ * intermediates live in a per-thread scratch block that stays in L1. Only the leaves are read
+ * from memory and only the destination is written.
+ * vectra::expr::assign(out, e) evaluates into an existing tensor (no allocation, out may be a
+ * leaf of e : x = x * a + b). A leaf that reads the memory of out through another view
+ * (transpose(x), a slice of x) makes the pass go through a temporary.
+ * Operands broadcast like add() (NumPy rules), leaves may be any view. A leaf keeps a reference
+ * on the storage of its tensor, an expression can outlive the tensors it was built from.
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#pragma once
+#ifndef TENSOREXPR_H
+#define TENSOREXPR_H
+
+#ifdef __cplusplus
+
+#include <cpu/TensorOps.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace vectra {
+namespace expr {
+
+using vectra::kernel::BinaryOp;
+using vectra::kernel::UnaryOp;
+
+// block of a row evaluated by every node at once (bytes)
+static constexpr size_t EXPR_BLOCK_BYTES = 2048;
+
+template<typename T>
+constexpr size_t block_size() { return EXPR_BLOCK_BYTES / sizeof(T); }
+
+// result of a node over a block : n values at p, or one value at p repeated (splat)
+template<typename T>
+struct Operand {
+    const T* p;
+    bool splat;
+};
+
+// leaves of the current row : first element and inner stride of every leaf
+template<typename T, size_t N>
+struct Row {
+    std::array<const T*, N> ptr;
+    std::array<size_t, N> stride;
+    mutable bool zero_divisor = false;  // a div node met a zero divisor
+};
+
+template<typename Derived, typename T>
+struct TensorExpr {
+    using expr_tag = void;
+    using value_type = T;
+
+    const Derived& self() const { return static_cast<const Derived&>(*this); }
+
+    void eval_into(Tensor<T>& out) const;
+};
+
+/*
+ *
+ * Nodes
+ * leaves   : tensors in the tree, numbered from left to right (K is the number of the first
+ *            leaf of a subtree)
+ * scratch  : blocks a subtree needs besides its destination block
+ * ops      : binary and unary nodes of a subtree (FLOPs per element)
+ *
+*/
+
+template<typename T>
+struct Leaf : TensorExpr<Leaf<T>, T> {
+    static constexpr size_t leaves = 1;
+    static constexpr size_t scratch = 0;
+    static constexpr size_t ops = 0;
+
+    Tensor<T> t;
+
+    explicit Leaf(const Tensor<T>& t_) : t(t_) {}
+
+    const Shape& shape() const { return t.shape; }
+
+    template<size_t K, size_t N>
+    void bind(const Shape& out_shape, std::array<Shape, N + 1>& strides,
+              std::array<const T*, N>& base) const
+    {
+        strides[K] = broadcast_strides(t.shape, t.strides, out_shape);
+        base[K] = t.data();
+    }
+
+    template<size_t K, size_t N>
+    Operand<T> eval(const Row<T, N>& row, size_t i, size_t n, T* dst, T*) const
+    {
+        const T* p = row.ptr[K];
+        const size_t s = row.stride[K];
+
+        if (s == 1) return { p + i, false };
+        if (s == 0) return { p, true };
+
+        // strided view : gathered into the destination block
+        for (size_t j = 0; j < n; ++j) dst[j] = p[(i + j) * s];
+        return { dst, false };
+    }
+};
+
+template<typename T>
+struct Scalar : TensorExpr<Scalar<T>, T> {
+    static constexpr size_t leaves = 0;
+    static constexpr size_t scratch = 0;
+    static constexpr size_t ops = 0;
+
+    T value;
+    Shape dims;           // 0-d
+
+    explicit Scalar(T value_) : value(value_) {}
+
+    const Shape& shape() const { return dims; }
+
+    template<size_t K, size_t N>
+    void bind(const Shape&, std::array<Shape, N + 1>&, std::array<const T*, N>&) const {}
+
+    template<size_t K, size_t N>
+    Operand<T> eval(const Row<T, N>&, size_t, size_t, T*, T*) const { return { &value, true }; }
+};
+
+template<BinaryOp Op, typename L, typename R>
+struct Binary : TensorExpr<Binary<Op, L, R>, typename L::value_type> {
+    using T = typename L::value_type;
+    static constexpr size_t leaves = L::leaves + R::leaves;
+    static constexpr size_t scratch = std::max(L::scratch, R::scratch + 1);
+    static constexpr size_t ops = L::ops + R::ops + 1;
+
+    L lhs;
+    R rhs;
+    Shape dims;
+
+    Binary(const L& lhs_, const R& rhs_, const char* name)
+    : lhs(lhs_), rhs(rhs_)
+    {
+        if(!broadcast_shape(lhs.shape(), rhs.shape(), dims)){
+            fprintf(stderr, "vectra %s() : Shapes can't be broadcast together!\n", name);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    const Shape& shape() const { return dims; }
+
+    template<size_t K, size_t N>
+    void bind(const Shape& out_shape, std::array<Shape, N + 1>& strides,
+              std::array<const T*, N>& base) const
+    {
+        lhs.template bind<K, N>(out_shape, strides, base);
+        rhs.template bind<K + L::leaves, N>(out_shape, strides, base);
+    }
+
+    template<size_t K, size_t N>
+    Operand<T> eval(const Row<T, N>& row, size_t i, size_t n, T* dst, T* scratch) const
+    {
+        // the left operand may land in dst : the right one is kept apart, the kernels may write
+        // over their first operand
+        const Operand<T> a = lhs.template eval<K, N>(row, i, n, dst, scratch);
+        const Operand<T> b = rhs.template eval<K + L::leaves, N>(row, i, n, scratch, scratch + block_size<T>());
+
+        // a splat may sit in dst[0]
+        const T sa = *a.p;
+        const T sb = *b.p;
+
+        bool ok;
+        if (a.splat && b.splat) {
+            ok = vectra::kernel::scalar::binary<Op>(&sa, &sb, dst, 1);
+            if (!ok) *dst = T{0};
+        }
+        else if (b.splat) ok = vectra::kernel::binary_scalar<Op, true>(a.p, &sb, dst, n);
+        else if (a.splat) ok = vectra::kernel::binary_scalar<Op, false>(&sa, b.p, dst, n);
+        else              ok = vectra::kernel::binary<Op>(a.p, b.p, dst, n);
+
+        if (!ok) row.zero_divisor = true;
+        return { dst, a.splat && b.splat };
+    }
+};
+
+template<UnaryOp Op, typename E>
+struct Unary : TensorExpr<Unary<Op, E>, typename E::value_type> {
+    using T = typename E::value_type;
+    static constexpr size_t leaves = E::leaves;
+    static constexpr size_t scratch = E::scratch;
+    static constexpr size_t ops = E::ops + 1;
+
+    E arg;
+
+    explicit Unary(const E& arg_) : arg(arg_) {}
+
+    const Shape& shape() const { return arg.shape(); }
+
+    template<size_t K, size_t N>
+    void bind(const Shape& out_shape, std::array<Shape, N + 1>& strides,
+              std::array<const T*, N>& base) const
+    {
+        arg.template bind<K, N>(out_shape, strides, base);
+    }
+
+    template<size_t K, size_t N>
+    Operand<T> eval(const Row<T, N>& row, size_t i, size_t n, T* dst, T* scratch) const
+    {
+        const Operand<T> a = arg.template eval<K, N>(row, i, n, dst, scratch);
+
+        vectra::kernel::unary<Op>(a.p, dst, a.splat ? 1 : n);
+        return { dst, a.splat };
+    }
+};
+
+/*
+ *
+ * Operands : a Tensor becomes a Leaf, a node stays itself
+ *
+*/
+
+template<typename X, typename = void>
+struct traits {};
+
+template<typename T>
+struct traits<Tensor<T>> {
+    using value_type = T;
+    using node = Leaf<T>;
+    static node make(const Tensor<T>& t) { return node(t); }
+};
+
+template<typename X>
+struct traits<X, std::void_t<typename X::expr_tag>> {
+    using value_type = typename X::value_type;
+    using node = X;
+    static const node& make(const X& x) { return x; }
+};
+
+template<typename X, typename = void>
+struct is_operand : std::false_type {};
+
+template<typename X>
+struct is_operand<X, std::void_t<typename traits<X>::node>> : std::true_type {};
+
+template<typename X>
+using value_t = typename traits<X>::value_type;
+
+template<typename X>
+using node_t = typename traits<X>::node;
+
+// both operands are expressions or tensors of the same element type
+template<typename L, typename R>
+using enable_binary_t = std::enable_if_t<is_operand<L>::value && is_operand<R>::value &&
+                                         std::is_same_v<value_t<L>, value_t<R>>>;
+
+template<BinaryOp Op, typename L, typename R>
+Binary<Op, node_t<L>, node_t<R>> make_binary(const L& l, const R& r, const char* name)
+{
+    return Binary<Op, node_t<L>, node_t<R>>(traits<L>::make(l), traits<R>::make(r), name);
+}
+
+template<BinaryOp Op, typename L>
+Binary<Op, node_t<L>, Scalar<value_t<L>>> make_binary(const L& l, value_t<L> s, const char* name)
+{
+    return Binary<Op, node_t<L>, Scalar<value_t<L>>>(traits<L>::make(l), Scalar<value_t<L>>(s), name);
+}
+
+template<BinaryOp Op, typename R>
+Binary<Op, Scalar<value_t<R>>, node_t<R>> make_binary(value_t<R> s, const R& r, const char* name)
+{
+    return Binary<Op, Scalar<value_t<R>>, node_t<R>>(Scalar<value_t<R>>(s), traits<R>::make(r), name);
+}
+
+/*
+ *
+ * Evaluation
+ *
+*/
+
+// scratch blocks of the calling thread, kept between passes and grown on demand
+template<typename T>
+T* thread_scratch(size_t count)
+{
+    static thread_local utils::vector<T> buffer;
+
+    buffer.resize(count);
+    return buffer.data;
+}
+
+// address range [first, last element] of a view of `shape`
+template<typename T>
+std::pair<uintptr_t, uintptr_t> view_span(const T* p, const Shape& shape, const Shape& strides)
+{
+    size_t last = 0;
+    for (size_t d = 0; d < shape.size(); ++d) last += (shape[d] - 1) * strides[d];
+    return { uintptr_t(p), uintptr_t(p + last) };
+}
+
+// same elements in the same order (dimensions of size 1 may have any stride)
+inline bool same_view(const Shape& shape, const Shape& a, const Shape& b)
+{
+    for (size_t d = 0; d < shape.size(); ++d) {
+        if (shape[d] != 1 && a[d] != b[d]) return false;
+    }
+    return true;
+}
+
+// out (of the shape of e, any layout) = e, in one pass
+template<typename T, typename E>
+void evaluate(const E& e, Tensor<T>& out)
+{
+    constexpr size_t N = E::leaves;
+    constexpr size_t BLOCK = block_size<T>();
+    static_assert(N > 0, "an expression needs at least one tensor");
+
+    const size_t count = out.numel();
+    VECTRA_OP_SCOPE(T, "expr", count, double((N + 1) * count) * sizeof(T), double(E::ops * count),
+                    &out.shape);
+
+    std::array<Shape, N + 1> strides;
+    std::array<const T*, N> base;
+    e.template bind<0, N>(out.shape, strides, base);
+    strides[N] = out.strides;
+
+    const StridedLoop<N + 1> loop(out.shape, strides);
+    std::array<size_t, N> inner;
+    for (size_t k = 0; k < N; ++k) inner[k] = loop.inner_stride(k);
+    const size_t so = loop.inner_stride(N);
+
+    // a leaf over the memory of out : the very view of out (x = x * a + b) is read block by block
+    // before the block is stored (staged). Any other overlap (transpose(x), a shifted slice, a
+    // broadcast row of x) reads elements already written : the pass goes to a temporary
+    bool aliased = false;
+    if (count) {
+        const auto dst = view_span(out.data(), out.shape, out.strides);
+        for (size_t k = 0; k < N; ++k) {
+            const auto src = view_span(base[k], out.shape, strides[k]);
+            if (src.second < dst.first || dst.second < src.first) continue;
+            if (base[k] == out.data() && same_view(out.shape, strides[k], out.strides)) {
+                aliased = true;
+                continue;
+            }
+            Tensor<T> tmp(out.shape);
+            evaluate(e, tmp);
+            unaryStridedTemplate(tmp, out, 2 * sizeof(T), [](T x) { return x; });
+            return;
+        }
+    }
+    const bool staged = so != 1 || aliased;
+
+    std::atomic<bool> zero_divisor{ false };
+
+    // elements [lo, hi) of the row at offsets off
+    auto run = [&](const std::array<size_t, N + 1>& off, size_t lo, size_t hi) {
+        Row<T, N> row;
+        for (size_t k = 0; k < N; ++k) {
+            row.ptr[k] = base[k] + off[k];
+            row.stride[k] = inner[k];
+        }
+        T* dst = out.data() + off[N];
+        T* scratch = thread_scratch<T>((std::max<size_t>(1, E::scratch) + 1) * BLOCK);
+        T* stage = scratch + std::max<size_t>(1, E::scratch) * BLOCK;
+
+        for (size_t i = lo; i < hi; i += BLOCK) {
+            const size_t n = std::min(BLOCK, hi - i);
+            T* block = staged ? stage : dst + i;
+            const Operand<T> r = e.template eval<0, N>(row, i, n, block, scratch);
+
+            if (r.splat)          std::fill(block, block + n, *r.p);
+            else if (r.p != block) std::copy(r.p, r.p + n, block);
+
+            if (staged) for (size_t j = 0; j < n; ++j) dst[(i + j) * so] = block[j];
+        }
+        if (row.zero_divisor) zero_divisor.store(true, std::memory_order_relaxed);
+    };
+
+    const size_t bytes_per_item = (N + 1) * sizeof(T);
+    if (loop.rows() == 1) {
+        // one long row (every operand packed) : the row itself is shared by the threads
+        const std::array<size_t, N + 1> off{};
+        utils::parallel_for(0, loop.inner(), utils::grain_size(bytes_per_item), [&](size_t lo, size_t hi) {
+            run(off, lo, hi);
+        });
+    }
+    else {
+        loop.for_each_row(utils::grain_size(bytes_per_item * loop.inner()), [&](const std::array<size_t, N + 1>& off, size_t n) {
+            run(off, 0, n);
+        });
+    }
+
+    if (zero_divisor.load()) {
+        fprintf(stderr, "vectra operator/() : cannot divide by zero!\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+// out = x : out has the shape of x (any layout). It may be a leaf of x without allocating, any
+// other view of the memory of out in x is evaluated through a temporary
+template<typename T, typename X, typename = std::enable_if_t<is_operand<X>::value>>
+Tensor<T>& assign(Tensor<T>& out, const X& x)
+{
+    static_assert(std::is_same_v<T, value_t<X>>, "assign() : element types differ");
+
+    const node_t<X>& node = traits<X>::make(x);
+    check_out("assign", node.shape(), out, false);
+    evaluate(node, out);
+    return out;
+}
+
+template<typename Derived, typename T>
+void TensorExpr<Derived, T>::eval_into(Tensor<T>& out) const
+{
+    evaluate(self(), out);
+}
+
+/*
+ *
+ * Math functions (lazy counterparts of exp_tensor, log_tensor ...)
+ *
+*/
+
+template<typename X, typename = std::enable_if_t<is_operand<X>::value>>
+Unary<UnaryOp::Exp, node_t<X>> exp(const X& x) { return Unary<UnaryOp::Exp, node_t<X>>(traits<X>::make(x)); }
+
+template<typename X, typename = std::enable_if_t<is_operand<X>::value>>
+Unary<UnaryOp::Log, node_t<X>> log(const X& x) { return Unary<UnaryOp::Log, node_t<X>>(traits<X>::make(x)); }
+
+template<typename X, typename = std::enable_if_t<is_operand<X>::value>>
+Unary<UnaryOp::Log1p, node_t<X>> log1p(const X& x) { return Unary<UnaryOp::Log1p, node_t<X>>(traits<X>::make(x)); }
+
+template<typename X, typename = std::enable_if_t<is_operand<X>::value>>
+Unary<UnaryOp::Tanh, node_t<X>> tanh(const X& x) { return Unary<UnaryOp::Tanh, node_t<X>>(traits<X>::make(x)); }
+
+template<typename X, typename = std::enable_if_t<is_operand<X>::value>>
+Unary<UnaryOp::Sigmoid, node_t<X>> sigmoid(const X& x) { return Unary<UnaryOp::Sigmoid, node_t<X>>(traits<X>::make(x)); }
+
+template<typename X, typename = std::enable_if_t<is_operand<X>::value>>
+Unary<UnaryOp::Erf, node_t<X>> erf(const X& x) { return Unary<UnaryOp::Erf, node_t<X>>(traits<X>::make(x)); }
+
+template<typename X, typename = std::enable_if_t<is_operand<X>::value>>
+Unary<UnaryOp::Sqrt, node_t<X>> sqrt(const X& x) { return Unary<UnaryOp::Sqrt, node_t<X>>(traits<X>::make(x)); }
+
+template<typename X, typename = std::enable_if_t<is_operand<X>::value>>
+Unary<UnaryOp::Rsqrt, node_t<X>> rsqrt(const X& x) { return Unary<UnaryOp::Rsqrt, node_t<X>>(traits<X>::make(x)); }
+
+// materializes an expression (a Tensor converts from it too)
+template<typename X, typename = std::enable_if_t<is_operand<X>::value>>
+Tensor<value_t<X>> eval(const X& x) { return Tensor<value_t<X>>(traits<X>::make(x)); }
+
+} // namespace expr
+} // namespace vectra
+
+/*
+ *
+ * Operators : Tensor and expression operands, a scalar on either side
+ *
+*/
+
+template<typename L, typename R, typename = vectra::expr::enable_binary_t<L, R>>
+auto operator+(const L& l, const R& r) { return vectra::expr::make_binary<vectra::kernel::BinaryOp::Add>(l, r, "operator+"); }
+
+template<typename L, typename R, typename = vectra::expr::enable_binary_t<L, R>>
+auto operator-(const L& l, const R& r) { return vectra::expr::make_binary<vectra::kernel::BinaryOp::Sub>(l, r, "operator-"); }
+
+template<typename L, typename R, typename = vectra::expr::enable_binary_t<L, R>>
+auto operator*(const L& l, const R& r) { return vectra::expr::make_binary<vectra::kernel::BinaryOp::Mul>(l, r, "operator*"); }
+
+template<typename L, typename R, typename = vectra::expr::enable_binary_t<L, R>>
+auto operator/(const L& l, const R& r) { return vectra::expr::make_binary<vectra::kernel::BinaryOp::Div>(l, r, "operator/"); }
+
+template<typename L, typename = std::enable_if_t<vectra::expr::is_operand<L>::value>>
+auto operator+(const L& l, vectra::expr::value_t<L> s) { return vectra::expr::make_binary<vectra::kernel::BinaryOp::Add>(l, s, "operator+"); }
+
+template<typename L, typename = std::enable_if_t<vectra::expr::is_operand<L>::value>>
+auto operator-(const L& l, vectra::expr::value_t<L> s) { return vectra::expr::make_binary<vectra::kernel::BinaryOp::Sub>(l, s, "operator-"); }
+
+template<typename L, typename = std::enable_if_t<vectra::expr::is_operand<L>::value>>
+auto operator*(const L& l, vectra::expr::value_t<L> s) { return vectra::expr::make_binary<vectra::kernel::BinaryOp::Mul>(l, s, "operator*"); }
+
+template<typename L, typename = std::enable_if_t<vectra::expr::is_operand<L>::value>>
+auto operator/(const L& l, vectra::expr::value_t<L> s) { return vectra::expr::make_binary<vectra::kernel::BinaryOp::Div>(l, s, "operator/"); }
+
+template<typename R, typename = std::enable_if_t<vectra::expr::is_operand<R>::value>>
+auto operator+(vectra::expr::value_t<R> s, const R& r) { return vectra::expr::make_binary<vectra::kernel::BinaryOp::Add>(s, r, "operator+"); }
+
+template<typename R, typename = std::enable_if_t<vectra::expr::is_operand<R>::value>>
+auto operator-(vectra::expr::value_t<R> s, const R& r) { return vectra::expr::make_binary<vectra::kernel::BinaryOp::Sub>(s, r, "operator-"); }
+
+template<typename R, typename = std::enable_if_t<vectra::expr::is_operand<R>::value>>
+auto operator*(vectra::expr::value_t<R> s, const R& r) { return vectra::expr::make_binary<vectra::kernel::BinaryOp::Mul>(s, r, "operator*"); }
+
+template<typename R, typename = std::enable_if_t<vectra::expr::is_operand<R>::value>>
+auto operator/(vectra::expr::value_t<R> s, const R& r) { return vectra::expr::make_binary<vectra::kernel::BinaryOp::Div>(s, r, "operator/"); }
+
+template<typename X, typename = std::enable_if_t<vectra::expr::is_operand<X>::value>>
+auto operator-(const X& x) { return vectra::expr::make_binary<vectra::kernel::BinaryOp::Sub>(vectra::expr::value_t<X>(0), x, "operator-"); }
+
+#endif // __cplusplus
+#endif // TENSOREXPR_H
@@ -0,0 +1,413 @@
+/*
+ *
+ * TensorFile.h (v1.1)
+ *
+ * v1.1 updated : * the element count and the extent of the strides are computed with overflow checks :
+ *                  a header whose products wrap around (to 0 included) is refused
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * On-disk tensor format (.vt) and its memory-mapped loader.
+ *
+ *   offset  0 : char[8]   magic "VTENSOR\0"
+ *           8 : uint32    format version (1)
+ *          12 : uint8     element kind (0 signed integer, 2 floating point, the DLPack codes)
+ *          13 : uint8     element bits
+ *          14 : uint16    ndim (at most TENSOR_FILE_MAX_DIMS)
+ *          16 : uint64    data offset (multiple of 64)
+ *          24 : uint64    data bytes
+ *          32 : uint64    shape[ndim], then uint64 strides[ndim] (in elements)
+ *         ... : zero padding up to the data offset, then the raw elements (native little-endian)
+ *
+ * Tensor<T>::load(path) maps the file copy-on-write : nothing is read up front, the pages come in
+ * from the page cache when an op touches them, and a write goes to a private copy of the page
+ * (the file never changes). The mapping lives as long as a tensor shares its storage.
+ * TensorWriter streams the elements in any number of pieces, so a tensor larger than memory (or
+ * produced in chunks) is written without a full buffer. Tensor<T>::save(path) writes a view through
+ * it in row-major order.
+ * Included at the end of TensorOps.h, do not include it before.
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#pragma once
+#ifndef TENSORFILE_H
+#define TENSORFILE_H
+
+#ifdef __cplusplus
+
+#include <cpu/TensorOps.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vectra {
+namespace io {
+
+constexpr char TENSOR_FILE_MAGIC[8] = { 'V', 'T', 'E', 'N', 'S', 'O', 'R', '\0' };
+constexpr uint32_t TENSOR_FILE_VERSION = 1;
+constexpr size_t TENSOR_FILE_ALIGNMENT = 64;
+constexpr size_t TENSOR_FILE_MAX_DIMS = 32;
+constexpr uint8_t KIND_INT = 0;
+constexpr uint8_t KIND_FLOAT = 2;
+
+// rows of a strided view gathered per write of save()
+constexpr size_t SAVE_BLOCK_BYTES = size_t(1) << 20;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint8_t kind;
+    uint8_t bits;
+    uint16_t ndim;
+    uint64_t data_offset;
+    uint64_t data_bytes;
+};
+static_assert(sizeof(FileHeader) == 32, "vectra tensor file header must be 32 bytes");
+
+template<typename T>
+constexpr uint8_t element_kind() { return std::is_floating_point<T>::value ? KIND_FLOAT : KIND_INT; }
+
+inline size_t header_bytes(size_t ndim)
+{
+    const size_t raw = sizeof(FileHeader) + 2 * ndim * sizeof(uint64_t);
+    return (raw + TENSOR_FILE_ALIGNMENT - 1) / TENSOR_FILE_ALIGNMENT * TENSOR_FILE_ALIGNMENT;
+}
+
+// header of a file : the element type is still open (AnyTensor picks it from kind / bits)
+struct FileInfo {
+    uint8_t kind = 0;
+    uint8_t bits = 0;
+    Shape shape;
+    Shape strides;
+    uint64_t data_offset = 0;
+    uint64_t data_bytes = 0;
+};
+
+/*
+ *
+ * Read-only mapping of a whole file (copy-on-write pages), unmapped by the destructor
+ *
+*/
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile()
+    {
+#if defined(_WIN32)
+        if (base_) UnmapViewOfFile(base_);
+        if (mapping_) CloseHandle(mapping_);
+#else
+        if (base_) munmap(base_, size_);
+#endif
+    }
+
+    // nullptr on success, the reason otherwise
+    const char* open(const std::string& path)
+    {
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return "cannot open the file";
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            CloseHandle(file);
+            return "cannot read the file size";
+        }
+        size_ = size_t(size.QuadPart);
+        if (size_ == 0) {
+            CloseHandle(file);
+            return "empty file";
+        }
+
+        mapping_ = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping_) return "cannot map the file";
+        base_ = MapViewOfFile(mapping_, FILE_MAP_COPY, 0, 0, 0);
+        if (!base_) return "cannot map the file";
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return "cannot open the file";
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return "cannot read the file size";
+        }
+        size_ = size_t(st.st_size);
+        if (size_ == 0) {
+            ::close(fd);
+            return "empty file";
+        }
+
+        // the mapping keeps its own reference on the file
+        void* ptr = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (ptr == MAP_FAILED) return "cannot map the file";
+        base_ = ptr;
+#endif
+        return nullptr;
+    }
+
+    char* data() const { return static_cast<char*>(base_); }
+    size_t size() const { return size_; }
+
+private:
+    void* base_ = nullptr;
+    size_t size_ = 0;
+#if defined(_WIN32)
+    HANDLE mapping_ = nullptr;
+#endif
+};
+
+// header of the `avail` bytes at base, checked against the file size, nullptr on success
+inline const char* parse_header(const char* base, size_t avail, size_t size, FileInfo& info)
+{
+    if (avail < sizeof(FileHeader)) return "truncated header";
+
+    FileHeader h;
+    std::memcpy(&h, base, sizeof(h));
+    if (std::memcmp(h.magic, TENSOR_FILE_MAGIC, sizeof(h.magic)) != 0) return "not a vectra tensor file";
+    if (h.version != TENSOR_FILE_VERSION) return "unsupported format version";
+    if (h.ndim > TENSOR_FILE_MAX_DIMS) return "too many dimensions";
+    if (h.bits == 0 || h.bits % 8) return "bad element size";
+    if (avail < header_bytes(h.ndim)) return "truncated header";
+    if (h.data_offset % TENSOR_FILE_ALIGNMENT || h.data_offset < header_bytes(h.ndim)) return "misaligned data";
+    if (h.data_offset > size || h.data_bytes > size - h.data_offset) return "truncated data";
+
+    std::vector<uint64_t> dims(2 * size_t(h.ndim));
+    std::memcpy(dims.data(), base + sizeof(FileHeader), dims.size() * sizeof(uint64_t));
+
+    info.kind = h.kind;
+    info.bits = h.bits;
+    info.shape.assign(dims.begin(), dims.begin() + h.ndim);
+    info.strides.assign(dims.begin() + h.ndim, dims.end());
+    info.data_offset = h.data_offset;
+    info.data_bytes = h.data_bytes;
+
+    // the last element of the view must lie inside the data, every step checked for overflow
+    const size_t item = h.bits / 8;
+    size_t bytes = 0;
+    if (!shape_bytes(info.shape, item, bytes)) return "shape too large";
+    if (bytes != 0) {
+        size_t last = 0, step = 0;
+        for (size_t d = 0; d < info.shape.size(); ++d) {
+            if (__builtin_mul_overflow(info.shape[d] - 1, info.strides[d], &step) || __builtin_add_overflow(last, step, &last))
+                return "strides reach past the data";
+        }
+        if (__builtin_add_overflow(last, size_t(1), &last) || __builtin_mul_overflow(last, item, &last) || last > h.data_bytes)
+            return "strides reach past the data";
+    }
+    return nullptr;
+}
+
+// maps a file and checks its header, nullptr on success
+inline const char* map_file(const std::string& path, std::shared_ptr<MappedFile>& file, FileInfo& info)
+{
+    file = std::make_shared<MappedFile>();
+    if (const char* err = file->open(path)) return err;
+    return parse_header(file->data(), file->size(), file->size(), info);
+}
+
+// zero-copy tensor over a mapped file of element type T (the view keeps the mapping alive)
+template<typename T>
+Tensor<T> file_tensor(std::shared_ptr<MappedFile> file, const FileInfo& info)
+{
+    T* data = reinterpret_cast<T*>(file->data() + info.data_offset);
+    return from_blob<T>(data, info.shape, info.strides, std::move(file));
+}
+
+template<typename T>
+bool holds_element(const FileInfo& info)
+{
+    return info.kind == element_kind<T>() && info.bits == 8 * sizeof(T);
+}
+
+/*
+ *
+ * Streaming writer : the header goes first (the shape is known), the elements follow in any
+ * number of write() calls, close() checks that exactly numel elements were written
+ *
+*/
+
+template<typename T>
+class TensorWriter {
+public:
+    TensorWriter(const std::string& path, const Shape& shape)
+    : shape_(shape), remaining_(shape_numel(shape))
+    {
+        if (shape.size() > TENSOR_FILE_MAX_DIMS) {
+            fprintf(stderr, "vectra TensorWriter() : at most %zu dimensions!\n", TENSOR_FILE_MAX_DIMS);
+            exit(EXIT_FAILURE);
+        }
+
+        file_ = fopen(path.c_str(), "wb");
+        if (!file_) {
+            fprintf(stderr, "vectra TensorWriter() : cannot create %s!\n", path.c_str());
+            exit(EXIT_FAILURE);
+        }
+
+        const size_t ndim = shape.size();
+        std::vector<char> head(header_bytes(ndim), 0);
+
+        FileHeader h;
+        std::memcpy(h.magic, TENSOR_FILE_MAGIC, sizeof(h.magic));
+        h.version = TENSOR_FILE_VERSION;
+        h.kind = element_kind<T>();
+        h.bits = uint8_t(8 * sizeof(T));
+        h.ndim = uint16_t(ndim);
+        h.data_offset = head.size();
+        h.data_bytes = uint64_t(remaining_) * sizeof(T);
+        std::memcpy(head.data(), &h, sizeof(h));
+
+        const Shape strides = contiguous_strides(shape);
+        std::vector<uint64_t> dims(2 * ndim);
+        for (size_t d = 0; d < ndim; ++d) {
+            dims[d] = shape[d];
+            dims[ndim + d] = strides[d];
+        }
+        std::memcpy(head.data() + sizeof(FileHeader), dims.data(), dims.size() * sizeof(uint64_t));
+
+        put(head.data(), head.size());
+    }
+
+    TensorWriter(const TensorWriter&) = delete;
+    TensorWriter& operator=(const TensorWriter&) = delete;
+
+    ~TensorWriter()
+    {
+        if (file_) close();
+    }
+
+    // the next n elements in row-major order
+    void write(const T* data, size_t n)
+    {
+        if (n > remaining_) {
+            fprintf(stderr, "vectra TensorWriter::write() : %zu elements past the end of the tensor!\n", n - remaining_);
+            exit(EXIT_FAILURE);
+        }
+        put(data, n * sizeof(T));
+        remaining_ -= n;
+    }
+
+    void close()
+    {
+        if (!file_) return;
+        if (remaining_ != 0) {
+            fprintf(stderr, "vectra TensorWriter::close() : %zu elements were never written!\n", remaining_);
+            exit(EXIT_FAILURE);
+        }
+        if (fclose(file_) != 0) {
+            fprintf(stderr, "vectra TensorWriter::close() : write error!\n");
+            exit(EXIT_FAILURE);
+        }
+        file_ = nullptr;
+    }
+
+private:
+    void put(const void* data, size_t bytes)
+    {
+        if (bytes && fwrite(data, 1, bytes, file_) != bytes) {
+            fprintf(stderr, "vectra TensorWriter::write() : write error!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    Shape shape_;
+    size_t remaining_;
+    FILE* file_ = nullptr;
+};
+
+// fn(block, n) over the elements of a view in row-major order : a contiguous tensor is passed
+// in one piece, a strided view (or a lazy constant) in rows gathered into a bounded buffer
+template<typename T, typename F>
+void for_each_block(const Tensor<T>& t, F&& fn)
+{
+    const size_t count = t.numel();
+    if (count == 0) return;
+
+    if (t.is_contiguous() && !t.is_lazy()) {
+        fn(t.data(), count);
+        return;
+    }
+
+    const size_t ndim = t.ndim();
+    const size_t inner = ndim ? t.shape[ndim - 1] : 1;
+    const size_t step = ndim ? t.strides[ndim - 1] : 0;
+    const size_t rows = count / inner;
+    std::vector<T> buf(std::max(inner, std::min(count, SAVE_BLOCK_BYTES / sizeof(T))));
+    Shape idx(ndim ? ndim - 1 : 0, 0);
+    const T* base = t.data();
+    size_t pos = 0;
+
+    for (size_t r = 0; r < rows; ++r) {
+        size_t off = 0;
+        for (size_t d = 0; d < idx.size(); ++d) off += idx[d] * t.strides[d];
+
+        if (pos + inner > buf.size()) {
+            fn(static_cast<const T*>(buf.data()), pos);
+            pos = 0;
+        }
+        for (size_t i = 0; i < inner; ++i) buf[pos + i] = base[off + i * step];
+        pos += inner;
+
+        for (size_t d = idx.size(); d-- > 0;) {
+            if (++idx[d] < t.shape[d]) break;
+            idx[d] = 0;
+        }
+    }
+    if (pos) fn(static_cast<const T*>(buf.data()), pos);
+}
+
+} // namespace io
+} // namespace vectra
+
+template<typename T>
+Tensor<T> Tensor<T>::load(const std::string& path)
+{
+    std::shared_ptr<vectra::io::MappedFile> file;
+    vectra::io::FileInfo info;
+    const char* err = vectra::io::map_file(path, file, info);
+    if (!err && !vectra::io::holds_element<T>(info)) err = "element type does not match the tensor";
+    if (err) {
+        fprintf(stderr, "vectra Tensor::load() : %s : %s!\n", path.c_str(), err);
+        exit(EXIT_FAILURE);
+    }
+    return vectra::io::file_tensor<T>(std::move(file), info);
+}
+
+template<typename T>
+void Tensor<T>::save(const std::string& path) const
+{
+    vectra::io::TensorWriter<T> writer(path, shape);
+    vectra::io::for_each_block(*this, [&](const T* block, size_t n) { writer.write(block, n); });
+    writer.close();
+}
+
+#endif // __cplusplus
+
+#endif // TENSORFILE_H
@@ -1,7 +1,65 @@
 
 /*
  *
- * TensorOps.h (v1.2)
+ * TensorOps.h (v1.22)
+ * 
+ * v1.22 updated : * shape_bytes() : byte size of a shape with overflow checks, for the shapes read from files
+ * 
+ * v1.21 updated : * mean divides in int64_t / double : integer counts past the range of T (256 int8 elements)
+ * 
+ * v1.20 updated : * an out that reaches an element twice (expand(), zero strides) is refused
+ *                 * pow_tensor walks broadcast and strided operands by rows, nothing is expanded
+ * 
+ * v1.19 updated : * shape and strides are Shape (Shape.h) : inline up to 8 dimensions, cached element count,
+ *                   contiguity cached in the tensor (update_layout() after editing them in place)
+ * 
+ * v1.18 updated : * the result buffers are charged to their op in the memory tracker (utils::track_ops)
+ * 
+ * v1.17 updated : * every op opens a profiler scope (Profiler.h) : perf_event_open counters per op,
+ *                   dtype and size when vectra::profiler is enabled, timeline events (Trace.h) when
+ *                   vectra::trace is enabled
+ * 
+ * v1.16 updated : * Tensor::load maps a tensor file (TensorFile.h) without reading it, Tensor::save
+ *                   streams a view to disk
+ * 
+ * v1.15 updated : * from_blob() : tensor over memory owned elsewhere (NumPy, DLPack), no copy
+ * 
+ * v1.14 updated : * rand, randn run on the Philox4x32 kernels of Random.h : seeded (vectra::manual_seed,
+ *                   vectra::Generator), the same values for any number of threads
+ * 
+ * v1.13 updated : * full, zeros, ones, twos are lazy constants (one element, zero strides) : folded by
+ *                   the binary ops, reductions and math, materialized on the first write
+ * 
+ * v1.12 updated : * out-parameter overloads (add(A, B, out), dot, math, axis reductions) and in-place
+ *                   variants (add_, exp_, pow_ ...), no zero fill of the outputs (dot included)
+ * 
+ * v1.11 updated : * lazy expressions (TensorExpr.h) : A * B + C over tensors and scalars is evaluated
+ *                   in one pass when assigned to a Tensor
+ * 
+ * v1.10 updated : * exp_tensor runs on SIMD range reduction + polynomial kernels (VecMath.h)
+ *                 * log, log1p, tanh, sigmoid, erf, sqrt, rsqrt and pow tensors
+ * 
+ * v1.9 updated : * sum, prod, max, min, mean along any axes with keepdims, argmax and argmin
+ *                * Reductions run on the multi-accumulator SIMD kernels of Reduce.h
+ * 
+ * v1.8 updated : * add, sub, mul, div broadcast their operands (NumPy rules) through zero strides,
+ *                  the smaller operand is never expanded in memory
+ *                * expand() view, row and column broadcast run on the SIMD kernels
+ * 
+ * v1.7 updated : * Tensor is a strided view (shape, strides, offset) over shared reference-counted storage
+ *                * reshape, flatten, transpose, permute, slice, squeeze, unsqueeze are O(1) views
+ *                * Operations take a contiguous fast path or walk strided operands row by row
+ * 
+ * v1.6 updated : * Every operation runs on the work-stealing thread pool (ThreadPool.h)
+ *                  through parallel_for / parallel_reduce, small tensors stay serial
+ * 
+ * v1.5 updated : * dot() matrix * matrix runs on the blocked GEMM engine of Gemm.h (float32, float64)
+ *                * dot() checks the inner dimension, fixed accumulator of matrix * matrix
+ * 
+ * v1.4 updated : * add, sub, mul, div run on the strip-mined SIMD kernels of ElementWise.h
+ * 
+ * v1.3 updated : * Tensor keeps packed T elements (sizeof(T) bytes per element) instead of ScalarType
+ *                * ScalarType is only used as register-level helper inside the operations
  * 
  * v1.2 updated : * Add tuple operation for Python
  *                * full, zeros, ones, twos. These function might has chance to constant folding      
@@ -25,14 +83,27 @@
 #ifdef __cplusplus
 
 #include <ScalarType/ScalarType.h>
+#include <ElementWise/ElementWise.h>
+#include <Gemm/Gemm.h>
+#include <Reduce/Reduce.h>
+#include <VecMath/VecMath.h>
+#include <Random/Random.h>
+#include <ThreadPool/ThreadPool.h>
 #include <VectorUtility/vector.h>
+#include <cpu/Shape.h>
+#include <cpu/Profiler.h>
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <iostream>
+#include <memory>
 #include <cassert>
 #include <fstream>
 #include <vector>
 #include <random>
 #include <cmath>
+#include <cstring>
+#include <string>
 
 enum class TensorInit{
     None,
@@ -44,375 +115,1980 @@ enum class TensorInit{
     Randomu
 };
 
+inline size_t shape_numel(const Shape& shape) { return shape.numel(); }
+
+// byte size of `shape` elements of `item` bytes, false when it does not fit in size_t (a product
+// that wraps, to 0 included) : shapes read from files are checked with it before any allocation
+inline bool shape_bytes(const Shape& shape, size_t item, size_t& bytes)
+{
+    bytes = 0;
+    for (size_t d = 0; d < shape.size(); ++d) {
+        if (shape[d] == 0) return true;
+    }
+    size_t n = item;
+    for (size_t d = 0; d < shape.size(); ++d) {
+        if (__builtin_mul_overflow(n, shape[d], &n)) return false;
+    }
+    bytes = n;
+    return true;
+}
+
+// row-major element strides of a shape
+inline Shape contiguous_strides(const Shape& shape)
+{
+    Shape strides(shape.size());
+    size_t step = 1;
+    for (size_t d = shape.size(); d-- > 0;) {
+        strides[d] = step;
+        step *= shape[d];
+    }
+    return strides;
+}
+
+// NumPy broadcasting : shapes are aligned on the right, a dimension of size 1 (or a missing one)
+// is repeated over the other operand. Return false when the shapes are not compatible.
+inline bool broadcast_shape(const Shape& a, const Shape& b, Shape& out)
+{
+    const size_t ndim = std::max(a.size(), b.size());
+    out.assign(ndim, 1);
+
+    for (size_t d = 0; d < ndim; ++d) {
+        const size_t da = d < a.size() ? a[a.size() - 1 - d] : 1;
+        const size_t db = d < b.size() ? b[b.size() - 1 - d] : 1;
+        if (da != db && da != 1 && db != 1) return false;
+        out[ndim - 1 - d] = da == 1 ? db : da;
+    }
+    return true;
+}
+
+// strides that read an operand of `shape` over the broadcast `out_shape`, repeated dimensions get stride 0
+inline Shape broadcast_strides(const Shape& shape, const Shape& strides, const Shape& out_shape)
+{
+    Shape out(out_shape.size(), 0);
+    const size_t lead = out_shape.size() - shape.size();
+
+    for (size_t d = 0; d < shape.size(); ++d) {
+        out[lead + d] = shape[d] == 1 ? 0 : strides[d];
+    }
+    return out;
+}
+
 template<typename T>
 class Tensor {
 public:
-    std::vector<size_t> shape;
-    utils::vector<ScalarType<T>> data;
+    Shape shape;                                    // inline up to 8 dimensions (Shape.h)
+    Shape strides;                                  // element strides of every dimension
+    size_t offset = 0;                              // first element of this view inside the storage
+    std::shared_ptr<utils::vector<T>> storage;      // packed elements, shared (reference counted) by every view
     TensorInit init = TensorInit::None;
     T init_value{};
 
     Tensor() = default;
 
-    Tensor(const std::vector<size_t>& shape_)
-    : shape(std::move(shape_))
+    Tensor(const Shape& shape_)
+    : shape(shape_),
+      strides(contiguous_strides(shape_)),
+      storage(std::make_shared<utils::vector<T>>(shape_numel(shape_)))
+    {
+        shape.mark();
+        strides.mark();
+        contiguous_ = true;
+        layout_known_ = true;
+    }
+
+    Tensor(const Tensor&) = default;
+    Tensor(Tensor&&) noexcept = default;
+
+    // the cached layout comes along with shape and strides
+    Tensor& operator=(const Tensor& other)
+    {
+        if (this != &other) {
+            const bool known = other.layout_known();
+            shape = other.shape;
+            strides = other.strides;
+            offset = other.offset;
+            storage = other.storage;
+            init = other.init;
+            init_value = other.init_value;
+            keep_layout(known, other.contiguous_);
+        }
+        return *this;
+    }
+
+    Tensor& operator=(Tensor&& other) noexcept
+    {
+        if (this != &other) {
+            const bool known = other.layout_known();
+            shape = std::move(other.shape);
+            strides = std::move(other.strides);
+            offset = other.offset;
+            storage = std::move(other.storage);
+            init = other.init;
+            init_value = other.init_value;
+            keep_layout(known, other.contiguous_);
+        }
+        return *this;
+    }
+
+    Tensor(const Shape& shape_, const T value)
+    : Tensor(shape_)
+    {
+        T* dst = data();
+        const size_t count = numel();
+
+        for (size_t i = 0; i < count; ++i) {
+            dst[i] = value;
+        }
+    }
+
+    // evaluates a lazy expression (TensorExpr.h) in one pass
+    template<typename E, typename = typename E::expr_tag>
+    Tensor(const E& expr)
+    : Tensor(expr.shape())
+    {
+        expr.eval_into(*this);
+    }
+
+    // rebinds to a new tensor holding the expression (the old storage may be one of its leaves)
+    template<typename E, typename = typename E::expr_tag>
+    Tensor& operator=(const E& expr)
+    {
+        return *this = Tensor(expr);
+    }
+
+    // first element of the view, a lazy constant is materialized before it can be written
+    T* data()
     {
-        size_t total = 1;
-        for (auto dim : shape_) total *= dim;
-        data.resize(total);
+        if (init != TensorInit::None) materialize();
+        return storage ? storage->data + offset : nullptr;
+    }
+    const T* data() const { return storage ? storage->data + offset : nullptr; }
+
+    // every element is the one at data() (zero strides, or a single element)
+    bool is_constant() const
+    {
+        if (!storage) return false;
+        for (size_t d = 0; d < shape.size(); ++d) {
+            if (shape[d] != 1 && strides[d] != 0) return false;
+        }
+        return true;
+    }
+
+    // constant of full / zeros / ones / twos : one stored element, never materialized by the
+    // operations that read it (they fold it or run their scalar kernels)
+    bool is_lazy() const
+    {
+        return (init == TensorInit::Full || init == TensorInit::Zeros ||
+                init == TensorInit::Ones || init == TensorInit::Twos) && is_constant();
+    }
+
+    // dense storage of a lazy constant (zero from fresh zero pages), no-op for other tensors
+    void materialize()
+    {
+        if (!is_lazy()) {
+            init = TensorInit::None;
+            return;
+        }
+
+        const T value = *static_cast<const Tensor&>(*this).data();
+        const size_t count = numel();
+        const T zero{};
+
+        if (std::memcmp(&value, &zero, sizeof(T)) == 0) {
+            storage = std::make_shared<utils::vector<T>>(count, utils::zero_init);
+        }
+        else {
+            storage = std::make_shared<utils::vector<T>>(count);
+            T* dst = storage->data;
+            utils::parallel_for(0, count, utils::grain_size(sizeof(T)), [&](size_t lo, size_t hi) {
+                std::fill(dst + lo, dst + hi, value);
+            });
+        }
+        strides = contiguous_strides(shape);
+        offset = 0;
+        init = TensorInit::None;
+        update_layout();
+    }
+
+    // memory-mapped tensor file (TensorFile.h) : zero-copy, pages are read on first touch
+    static Tensor load(const std::string& path);
+
+    // tensor file of the view (row-major, streamed)
+    void save(const std::string& path) const;
+
+    size_t numel() const { return shape.numel(); }
+
+    size_t ndim() const { return shape.size(); }
+
+    // row-major dense layout (dimensions of size 1 may have any stride), read from the cache
+    // unless shape or strides changed since update_layout()
+    bool is_contiguous() const
+    {
+        return layout_known() ? contiguous_ : dense_layout();
+    }
+
+    // caches the element count and the contiguity after shape / strides were edited
+    void update_layout()
+    {
+        shape.numel();
+        contiguous_ = dense_layout();
+        layout_known_ = true;
+        shape.mark();
+        strides.mark();
+    }
+
+private:
+    bool contiguous_ = false;
+    bool layout_known_ = false;
+
+    bool layout_known() const { return layout_known_ && !shape.changed() && !strides.changed(); }
+
+    void keep_layout(const bool known, const bool contiguous)
+    {
+        contiguous_ = contiguous;
+        layout_known_ = known;
+        if (known) {
+            shape.mark();
+            strides.mark();
+        }
+    }
+
+    bool dense_layout() const
+    {
+        size_t step = 1;
+        for (size_t d = shape.size(); d-- > 0;) {
+            if (shape[d] != 1 && strides[d] != step) return false;
+            step *= shape[d];
+        }
+        return true;
+    }
+};
+
+static constexpr size_t TENSOR_PRINT_LIMIT = 100;
+
+template<typename T>
+void print_tensor_recursive(std::ostream& os, const Tensor<T>& t, size_t dim, size_t offset, size_t indent, size_t& printed)
+{
+    if (printed >= TENSOR_PRINT_LIMIT) {
+        os << "...";
+        return;
+    }
+
+    size_t ndim = t.shape.size();
+
+    if (dim == ndim - 1) {
+        os << "[";
+
+        size_t n = t.shape[dim];
+        for (size_t i = 0; i < n; ++i) {
+
+            if (printed >= TENSOR_PRINT_LIMIT) {
+                os << ", ...";
+                break;
+            }
+
+            if (i > 0) os << ", ";
+
+            os << t.data()[offset + i * t.strides[dim]];
+            printed++;
+        }
+
+        os << "]";
+        return;
+    }
+
+    os << "[\n";
+
+    size_t n = t.shape[dim];
+    for (size_t i = 0; i < n; ++i) {
+        os << std::string(indent + 2, ' ');
+
+        if (printed >= TENSOR_PRINT_LIMIT) {
+            os << "...";
+            break;
+        }
+
+        print_tensor_recursive(os, t, dim + 1, offset + i * t.strides[dim], indent + 2, printed);
+
+        if (i + 1 < n)
+            os << ",\n";
+    }
+
+    os << "\n" << std::string(indent, ' ') << "]";
+}
+
+template<typename T>
+std::ostream& operator<<(std::ostream& os, const Tensor<T>& t)
+{
+    os << "tensor([";
+
+    // print shape
+    for(size_t i = 0; i < t.shape.size(); ++i){
+        if (i > 0) os << ", ";
+        os << t.shape[i];
+    }
+    os << "]\n";
+
+    // scalar case
+    if(t.shape.empty()){
+        os << t.data()[0] << ")";
+        return os;
     }
 
-    Tensor(const std::vector<size_t>& shape_, const T value)
-    : shape(shape_.begin(), shape_.end())
+    size_t printed = 0;
+
+    print_tensor_recursive(os, t, 0, 0, 0, printed);
+
+    os << "\n)";
+    return os;
+}
+
+/*
+ *
+ * TEMPLATE FOR TENSOR OPERATION
+ * 
+*/
+
+// fold of a whole packed buffer, chunks of the thread pool each run the SIMD kernel
+template<vectra::kernel::ReduceOp Op, typename T>
+T reduceArrayTemplate(const T* array, size_t n)
+{
+    return utils::parallel_reduce(0, n, utils::grain_size(sizeof(T)), vectra::kernel::reduce_identity<Op, T>(),
+        [&](size_t lo, size_t hi) { return vectra::kernel::reduce<Op>(array + lo, hi - lo); },
+        [](T a, T b) { return vectra::kernel::reduce_combine<Op>(a, b); });
+}
+
+// element-wise kernel split over the thread pool, false when div meets a zero divisor
+template<vectra::kernel::BinaryOp Op, typename T>
+bool binaryParallelTemplate(const T* a, const T* b, T* out, size_t n)
+{
+    std::atomic<bool> ok{ true };
+
+    utils::parallel_for(0, n, utils::grain_size(3 * sizeof(T)), [&](size_t lo, size_t hi) {
+        if (!vectra::kernel::binary<Op>(a + lo, b + lo, out + lo, hi - lo))
+            ok.store(false, std::memory_order_relaxed);
+    });
+
+    return ok.load();
+}
+
+// element-wise kernel between `x` and the single value `*s` (x op s when RhsScalar, s op x
+// otherwise), split over the thread pool
+template<vectra::kernel::BinaryOp Op, bool RhsScalar, typename T>
+bool binaryScalarParallelTemplate(const T* x, const T* s, T* out, size_t n)
+{
+    const T value = *s;
+    std::atomic<bool> ok{ true };
+
+    utils::parallel_for(0, n, utils::grain_size(2 * sizeof(T)), [&](size_t lo, size_t hi) {
+        const bool done = RhsScalar ? vectra::kernel::binary_scalar<Op, true>(x + lo, &value, out + lo, hi - lo)
+                                    : vectra::kernel::binary_scalar<Op, false>(&value, x + lo, out + lo, hi - lo);
+        if (!done) ok.store(false, std::memory_order_relaxed);
+    });
+
+    return ok.load();
+}
+
+/*
+ *
+ * Strided iteration
+ * The iteration shape is walked row by row (innermost dimension), every operand has its own
+ * element strides. Dimensions of size 1 are dropped and dimensions that are contiguous for
+ * every operand are merged, so the rows are as long as possible.
+ *
+*/
+
+template<size_t N>
+struct StridedLoop {
+    Shape shape;
+    std::array<Shape, N> strides;
+
+    StridedLoop(const Shape& shape_, const std::array<Shape, N>& strides_)
     {
-        size_t total = 1;
-        for (auto dim : shape) {
-            total *= dim;
+        for (size_t d = 0; d < shape_.size(); ++d) {
+            if (shape_[d] == 1) continue;
+
+            bool merge = !shape.empty();
+            for (size_t k = 0; k < N && merge; ++k)
+                merge = strides[k].back() == shape_[d] * strides_[k][d];
+
+            if (merge) {
+                shape.back() *= shape_[d];
+                for (size_t k = 0; k < N; ++k) strides[k].back() = strides_[k][d];
+            }
+            else {
+                shape.push_back(shape_[d]);
+                for (size_t k = 0; k < N; ++k) strides[k].push_back(strides_[k][d]);
+            }
         }
+    }
+
+    size_t inner() const { return shape.empty() ? 1 : shape.back(); }
+
+    size_t inner_stride(size_t k) const { return shape.empty() ? 1 : strides[k][shape.size() - 1]; }
+
+    size_t rows() const { return shape.empty() ? 1 : shape_numel(shape) / shape.back(); }
+
+    // fn(offsets, length) once per row, offsets are element offsets of every operand
+    template<typename F>
+    void for_each_row(size_t grain_rows, F&& fn) const
+    {
+        const size_t outer = shape.empty() ? 0 : shape.size() - 1;
+        const size_t n = inner();
+        if (n == 0) return;
+
+        utils::parallel_for(0, rows(), grain_rows, [&](size_t lo, size_t hi) {
+            Shape idx(outer, 0);
+            std::array<size_t, N> off{};
+
+            size_t r = lo;
+            for (size_t d = outer; d-- > 0;) {
+                idx[d] = r % shape[d];
+                r /= shape[d];
+                for (size_t k = 0; k < N; ++k) off[k] += idx[d] * strides[k][d];
+            }
+
+            for (size_t row = lo; row < hi; ++row) {
+                fn(off, n);
+
+                for (size_t d = outer; d-- > 0;) {
+                    ++idx[d];
+                    for (size_t k = 0; k < N; ++k) off[k] += strides[k][d];
+                    if (idx[d] < shape[d]) break;
+                    for (size_t k = 0; k < N; ++k) off[k] -= idx[d] * strides[k][d];
+                    idx[d] = 0;
+                }
+            }
+        });
+    }
+};
+
+// element-wise op of two broadcastable tensors into `out` (of the broadcast shape), any operand layout
+template<vectra::kernel::BinaryOp Op, typename T>
+bool binaryStridedTemplate(const Tensor<T>& A, const Tensor<T>& B, Tensor<T>& out)
+{
+    if (A.shape == out.shape && B.shape == out.shape &&
+        A.is_contiguous() && B.is_contiguous() && out.is_contiguous()) {
+        return binaryParallelTemplate<Op>(A.data(), B.data(), out.data(), out.numel());
+    }
+
+    // one operand is a single value (lazy constant, expanded scalar) : scalar kernel over the other
+    if (out.is_contiguous()) {
+        if (B.is_constant() && A.shape == out.shape && A.is_contiguous())
+            return binaryScalarParallelTemplate<Op, true>(A.data(), B.data(), out.data(), out.numel());
+        if (A.is_constant() && B.shape == out.shape && B.is_contiguous())
+            return binaryScalarParallelTemplate<Op, false>(B.data(), A.data(), out.data(), out.numel());
+    }
+
+    const StridedLoop<3> loop(out.shape, { broadcast_strides(A.shape, A.strides, out.shape),
+                                           broadcast_strides(B.shape, B.strides, out.shape),
+                                           out.strides });
+    const size_t sa = loop.inner_stride(0);
+    const size_t sb = loop.inner_stride(1);
+    const size_t so = loop.inner_stride(2);
+    std::atomic<bool> ok{ true };
+
+    // rows of unit stride run the SIMD kernels : a row-broadcast operand only has a zero outer
+    // stride, a column-broadcast (or scalar) operand has a zero inner stride and is splatted
+    loop.for_each_row(utils::grain_size(3 * sizeof(T) * loop.inner()), [&](const std::array<size_t, 3>& off, size_t n) {
+        const T* a = A.data() + off[0];
+        const T* b = B.data() + off[1];
+        T* o = out.data() + off[2];
+
+        bool row_ok;
+        if (so == 1 && sa == 1 && sb == 1)      row_ok = vectra::kernel::binary<Op>(a, b, o, n);
+        else if (so == 1 && sa == 1 && sb == 0) row_ok = vectra::kernel::binary_scalar<Op, true>(a, b, o, n);
+        else if (so == 1 && sa == 0 && sb == 1) row_ok = vectra::kernel::binary_scalar<Op, false>(a, b, o, n);
+        else                                    row_ok = vectra::kernel::scalar::binary_strided<Op>(a, sa, b, sb, o, so, n);
+        if (!row_ok) ok.store(false, std::memory_order_relaxed);
+    });
+
+    return ok.load();
+}
+
+// out[i] = fn(in[i]) element by element, `in` may be strided, `out` is contiguous
+template<typename T, typename U, typename F>
+void unaryStridedTemplate(const Tensor<T>& in, Tensor<U>& out, size_t bytes_per_item, F&& fn)
+{
+    const StridedLoop<2> loop(out.shape, { in.strides, out.strides });
+    const size_t si = loop.inner_stride(0);
+    const size_t so = loop.inner_stride(1);
+
+    loop.for_each_row(utils::grain_size(bytes_per_item * loop.inner()), [&](const std::array<size_t, 2>& off, size_t n) {
+        const T* src = in.data() + off[0];
+        U* dst = out.data() + off[1];
+        for (size_t i = 0; i < n; ++i) dst[i * so] = fn(src[i * si]);
+    });
+}
+
+/*
+ *
+ * Output tensors (out-parameter and in-place variants)
+ * out is written through its strides (any view that doesn't overlap the operands, or the
+ * first operand itself), nothing is allocated for the result and nothing is zero-filled.
+ * A view that reaches an element twice (expand(), zero strides) is refused as out.
+ *
+*/
+
+// bytes an op reads from (or writes to) t, one element for a lazy constant
+template<typename T>
+double tensor_bytes(const Tensor<T>& t)
+{
+    return double(t.is_lazy() ? 1 : t.numel()) * sizeof(T);
+}
+
+// true when no two indices of the view reach the same element : with the dimensions ordered by
+// stride, each stride must step past everything the smaller ones span (a zero stride never does)
+template<typename T>
+bool writes_once(const Tensor<T>& t)
+{
+    std::vector<std::pair<size_t, size_t>> dims;     // (stride, size) of the dims larger than 1
+    for (size_t d = 0; d < t.shape.size(); ++d) {
+        if (t.shape[d] > 1) dims.push_back({ t.strides[d], t.shape[d] });
+    }
+    std::sort(dims.begin(), dims.end());
+
+    size_t span = 0;                                  // last offset reached by the smaller dims
+    for (const auto& dim : dims) {
+        if (dim.first <= span) return false;
+        span += (dim.second - 1) * dim.first;
+    }
+    return true;
+}
+
+// exits unless `out` has storage of the result `shape` in a layout that writes every element
+// once (and a packed layout when `packed`), a lazy constant out is materialized
+template<typename T>
+void check_out(const char* name, const Shape& shape, Tensor<T>& out, bool packed)
+{
+    if (!out.storage || out.shape != shape) {
+        fprintf(stderr, "vectra %s() : out doesn't have the shape of the result!\n", name);
+        exit(EXIT_FAILURE);
+    }
+    out.materialize();
+    if (packed && !out.is_contiguous()) {
+        fprintf(stderr, "vectra %s() : out must be contiguous!\n", name);
+        exit(EXIT_FAILURE);
+    }
+    if (!out.is_contiguous() && !writes_once(out)) {
+        fprintf(stderr, "vectra %s() : out overlaps itself (broadcast or zero strides)!\n", name);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// init tag of a constant of `value`
+template<typename T>
+TensorInit constant_init(const T value)
+{
+    if (value == T{0}) return TensorInit::Zeros;
+    if (value == T{1}) return TensorInit::Ones;
+    if (value == T{2}) return TensorInit::Twos;
+    return TensorInit::Full;
+}
+
+// lazy constant : one stored element read through zero strides, materialized on first write
+template<typename T>
+Tensor<T> constant_tensor(const Shape& shape, const T value, TensorInit init)
+{
+    Tensor<T> t;
+    t.shape = shape;
+    t.strides.assign(shape.size(), 0);
+    t.storage = std::make_shared<utils::vector<T>>(1);
+    t.storage->data[0] = value;
+    t.init = init;
+    t.init_value = value;
+    t.update_layout();
+    return t;
+}
+
+// Sum / Prod / Max / Min of `n` copies of `value` in O(1), integers wrap like the kernels
+template<vectra::kernel::ReduceOp Op, typename T>
+T constant_reduce(const T value, size_t n)
+{
+    if constexpr (Op == vectra::kernel::ReduceOp::Sum) {
+        if constexpr (std::is_integral_v<T>) return T(uint64_t(value) * uint64_t(n));
+        else return T(value * T(n));
+    }
+    else if constexpr (Op == vectra::kernel::ReduceOp::Prod) {
+        if constexpr (std::is_integral_v<T>) {
+            // power by squaring
+            uint64_t r = 1, b = uint64_t(value);
+            for (; n; n >>= 1, b *= b)
+                if (n & 1) r *= b;
+            return T(r);
+        }
+        else return T(std::pow(value, T(n)));
+    }
+    else return value;
+}
+
+// A op B without touching memory when the result is known : both operands lazy constants
+// (new constant) or one of them the identity of Op over the result shape (the other operand).
+// The identity fold returns a view of that operand : add(X, zeros) shares the storage of X and
+// an in-place op on the result writes to X too (the out overloads never fold)
+template<vectra::kernel::BinaryOp Op, typename T>
+bool foldBinaryTemplate(const Tensor<T>& A, const Tensor<T>& B, const Shape& shape, Tensor<T>& out)
+{
+    using vectra::kernel::BinaryOp;
+
+    const bool lazy_a = A.is_lazy();
+    const bool lazy_b = B.is_lazy();
+
+    if (lazy_a && lazy_b) {
+        T value;
+        if (!vectra::kernel::scalar::binary<Op>(A.data(), B.data(), &value, 1)) return false;
+        out = constant_tensor(shape, value, constant_init(value));
+        return true;
+    }
+
+    // x + 0, x - 0, x * 1, x / 1 (x * 0 is not folded : 0 * inf is NaN)
+    if (lazy_b && A.shape == shape) {
+        const T b = *B.data();
+        const bool identity = (Op == BinaryOp::Add || Op == BinaryOp::Sub) ? b == T{0} : b == T{1};
+        if (identity) { out = A; return true; }
+    }
+    // 0 + x, 1 * x
+    if (lazy_a && B.shape == shape) {
+        const T a = *A.data();
+        const bool identity = Op == BinaryOp::Add ? a == T{0} : Op == BinaryOp::Mul && a == T{1};
+        if (identity) { out = B; return true; }
+    }
+    return false;
+}
+
+// A op B of the broadcast shape, in a new tensor
+template<vectra::kernel::BinaryOp Op, typename T>
+Tensor<T> binaryTemplate(const char* name, const Tensor<T>& A, const Tensor<T>& B)
+{
+    Shape shape;
+    if(!broadcast_shape(A.shape, B.shape, shape)){
+        fprintf(stderr, "vectra %s() : Shapes can't be broadcast together!\n", name);
+        exit(EXIT_FAILURE);
+    }
+    // two constants fold to a constant
+    const size_t n = shape_numel(shape);
+    const double written = double(A.is_lazy() && B.is_lazy() ? 1 : n) * sizeof(T);
+    VECTRA_OP_SCOPE(T, name, n, tensor_bytes(A) + tensor_bytes(B) + written, double(n),
+                    &A.shape, &B.shape);
+
+    Tensor<T> out;
+    if (foldBinaryTemplate<Op>(A, B, shape, out)) return out;
+
+    out = Tensor<T>(shape);
+    if(!binaryStridedTemplate<Op>(A, B, out)){
+        fprintf(stderr, "vectra %s() : cannot divide by zero!\n", name);
+        exit(EXIT_FAILURE);
+    }
+    return out;
+}
+
+// out = A op B (broadcast), out may be A itself
+template<vectra::kernel::BinaryOp Op, typename T>
+Tensor<T>& binaryOutTemplate(const char* name, const Tensor<T>& A, const Tensor<T>& B, Tensor<T>& out)
+{
+    Shape shape;
+    if(!broadcast_shape(A.shape, B.shape, shape)){
+        fprintf(stderr, "vectra %s() : Shapes can't be broadcast together!\n", name);
+        exit(EXIT_FAILURE);
+    }
+    check_out(name, shape, out, false);
+    const size_t n = shape_numel(shape);
+    VECTRA_OP_SCOPE(T, name, n, tensor_bytes(A) + tensor_bytes(B) + double(n) * sizeof(T), double(n),
+                    &A.shape, &B.shape);
+
+    if(!binaryStridedTemplate<Op>(A, B, out)){
+        fprintf(stderr, "vectra %s() : cannot divide by zero!\n", name);
+        exit(EXIT_FAILURE);
+    }
+    return out;
+}
+
+/*
+ *
+ * Axis reduction
+ * The reduced axes are brought to one block of a packed layout : src is [P, R, K] with R the
+ * reduced extent. K == 1 folds contiguous runs (inner axis), K > 1 folds whole rows of K
+ * elements column-wise (outer / middle axis).
+ *
+*/
+
+struct ReducePlan {
+    Shape out_shape;
+    std::vector<size_t> order;          // kept axes then reduced axes
+    size_t P = 1, R = 1, K = 1;
+    bool packed_block = false;          // reduced axes already form the middle block of a packed tensor
+};
+
+// false when an axis is out of range or repeated, an empty `axes` reduces every axis
+inline bool make_reduce_plan(const Shape& shape, const std::vector<size_t>& axes, bool keepdims,
+                             bool contiguous, ReducePlan& plan)
+{
+    const size_t ndim = shape.size();
+    std::vector<bool> reduced(ndim, axes.empty());
+
+    for (size_t axis : axes) {
+        if (axis >= ndim || reduced[axis]) return false;
+        reduced[axis] = true;
+    }
+
+    size_t first = ndim, last = 0;
+    for (size_t d = 0; d < ndim; ++d) {
+        if (reduced[d]) {
+            plan.R *= shape[d];
+            first = std::min(first, d);
+            last = d;
+            if (keepdims) plan.out_shape.push_back(1);
+        }
+        else {
+            plan.order.push_back(d);
+            plan.out_shape.push_back(shape[d]);
+            plan.P *= shape[d];
+        }
+    }
+    for (size_t d = 0; d < ndim; ++d) {
+        if (reduced[d]) plan.order.push_back(d);
+    }
+
+    // packed input whose reduced axes have no kept axis in between : read in place
+    plan.packed_block = contiguous && first < ndim;
+    for (size_t d = first; d <= last && d < ndim; ++d) {
+        if (!reduced[d]) plan.packed_block = false;
+    }
+
+    if (plan.packed_block) {
+        plan.P = 1;
+        for (size_t d = 0; d < first; ++d) plan.P *= shape[d];
+        for (size_t d = last + 1; d < ndim; ++d) plan.K *= shape[d];
+    }
+    return true;
+}
+
+template<vectra::kernel::ReduceOp Op, typename T>
+void reduceBlockTemplate(const T* src, size_t P, size_t R, size_t K, T* dst)
+{
+    using namespace vectra::kernel;
+
+    if (P == 0 || K == 0) return;
+
+    if (K == 1) {
+        // few long runs : split every run over the pool, otherwise one run per task
+        if (P < utils::get_num_threads()) {
+            for (size_t p = 0; p < P; ++p) dst[p] = reduceArrayTemplate<Op>(src + p * R, R);
+        }
+        else {
+            utils::parallel_for(0, P, utils::grain_size(R * sizeof(T)), [&](size_t lo, size_t hi) {
+                for (size_t p = lo; p < hi; ++p) dst[p] = reduce<Op>(src + p * R, R);
+            });
+        }
+        return;
+    }
+
+    // tasks own a column block of one p : R rows of `cols` elements (1 KiB row segments at least)
+    const size_t cols = std::min(K, std::max<size_t>(1024 / sizeof(T), utils::grain_size(R * sizeof(T))));
+    const size_t blocks = (K + cols - 1) / cols;
+
+    utils::parallel_for(0, P * blocks, utils::grain_size(R * cols * sizeof(T)), [&](size_t lo, size_t hi) {
+        for (size_t t = lo; t < hi; ++t) {
+            const size_t p = t / blocks;
+            const size_t j = (t % blocks) * cols;
+            reduce_rows<Op>(src + p * R * K + j, R, K, dst + p * K + j, std::min(cols, K - j));
+        }
+    });
+}
+
+template<vectra::kernel::ReduceOp Op, typename T>
+ReducePlan reducePlanTemplate(const char* name, const Tensor<T>& t1, const std::vector<size_t>& axes, bool keepdims)
+{
+    ReducePlan plan;
+    if (!make_reduce_plan(t1.shape, axes, keepdims, t1.is_contiguous(), plan)) {
+        fprintf(stderr, "vectra %s() : invalid reduction axes!\n", name);
+        exit(EXIT_FAILURE);
+    }
+    if (plan.R == 0 && (Op == vectra::kernel::ReduceOp::Max || Op == vectra::kernel::ReduceOp::Min)) {
+        fprintf(stderr, "vectra %s() : zero-size reduction!\n", name);
+        exit(EXIT_FAILURE);
+    }
+    return plan;
+}
+
+// packed result of the plan into dst
+template<vectra::kernel::ReduceOp Op, typename T>
+void reduceAxesRun(const Tensor<T>& t1, const ReducePlan& plan, T* dst)
+{
+    if (plan.packed_block) {
+        reduceBlockTemplate<Op>(t1.data(), plan.P, plan.R, plan.K, dst);
+    }
+    else {
+        // gather the reduced axes innermost first
+        const Tensor<T> src = contiguous(permute(t1, plan.order));
+        reduceBlockTemplate<Op>(src.data(), plan.P, plan.R, 1, dst);
+    }
+}
+
+template<vectra::kernel::ReduceOp Op, typename T>
+Tensor<T> reduceAxesTemplate(const char* name, const Tensor<T>& t1, const std::vector<size_t>& axes, bool keepdims)
+{
+    const ReducePlan plan = reducePlanTemplate<Op>(name, t1, axes, keepdims);
+    VECTRA_OP_SCOPE(T, name, t1.numel(),
+                    tensor_bytes(t1) + double(shape_numel(plan.out_shape)) * sizeof(T), double(t1.numel()),
+                    &t1.shape);
+
+    if (t1.is_lazy()) {
+        const T value = constant_reduce<Op>(*t1.data(), plan.R);
+        return constant_tensor(plan.out_shape, value, constant_init(value));
+    }
+
+    Tensor<T> out(plan.out_shape);
+    reduceAxesRun<Op>(t1, plan, out.data());
+    return out;
+}
+
+// into a caller tensor : contiguous, of the reduced shape, not overlapping t1
+template<vectra::kernel::ReduceOp Op, typename T>
+Tensor<T>& reduceAxesTemplate(const char* name, const Tensor<T>& t1, const std::vector<size_t>& axes, bool keepdims,
+                              Tensor<T>& out)
+{
+    const ReducePlan plan = reducePlanTemplate<Op>(name, t1, axes, keepdims);
+    VECTRA_OP_SCOPE(T, name, t1.numel(),
+                    tensor_bytes(t1) + double(shape_numel(plan.out_shape)) * sizeof(T), double(t1.numel()),
+                    &t1.shape);
+
+    check_out(name, plan.out_shape, out, true);
+    if (t1.is_lazy()) {
+        std::fill(out.data(), out.data() + out.numel(), constant_reduce<Op>(*t1.data(), plan.R));
+        return out;
+    }
+    reduceAxesRun<Op>(t1, plan, out.data());
+    return out;
+}
+
+// index (along one axis) of the first max / min, as int32
+template<vectra::kernel::ReduceOp Op, typename T>
+Tensor<vectra::int32> argReduceTemplate(const char* name, const Tensor<T>& t1, size_t axis, bool keepdims)
+{
+    ReducePlan plan;
+    if (!make_reduce_plan(t1.shape, { axis }, keepdims, t1.is_contiguous(), plan)) {
+        fprintf(stderr, "vectra %s() : invalid reduction axis!\n", name);
+        exit(EXIT_FAILURE);
+    }
+    if (plan.R == 0 || plan.R > size_t(INT32_MAX)) {
+        fprintf(stderr, "vectra %s() : axis length must be in [1, INT32_MAX]!\n", name);
+        exit(EXIT_FAILURE);
+    }
+    VECTRA_OP_SCOPE(T, name, t1.numel(),
+                    tensor_bytes(t1) + double(shape_numel(plan.out_shape)) * sizeof(vectra::int32),
+                    double(t1.numel()), &t1.shape);
+
+    // every element of a constant ties with the first one
+    if (t1.is_lazy()) return constant_tensor(plan.out_shape, vectra::int32{0}, TensorInit::Zeros);
+
+    const Tensor<T> src = plan.packed_block ? t1 : contiguous(permute(t1, plan.order));
+    const size_t P = plan.P;
+    const size_t R = plan.R;
+    const size_t K = plan.packed_block ? plan.K : 1;
+
+    Tensor<vectra::int32> out(plan.out_shape);
+    vectra::int32* dst = out.data();
+    const T* base = src.data();
+
+    if (K == 1) {
+        utils::parallel_for(0, P, utils::grain_size(R * sizeof(T)), [&](size_t lo, size_t hi) {
+            for (size_t p = lo; p < hi; ++p) dst[p] = vectra::int32(vectra::kernel::arg_reduce<Op>(base + p * R, R));
+        });
+    }
+    else {
+        utils::parallel_for(0, P, utils::grain_size(R * K * sizeof(T)), [&](size_t lo, size_t hi) {
+            std::vector<T> best(K);
+            for (size_t p = lo; p < hi; ++p)
+                vectra::kernel::arg_reduce_rows<Op>(base + p * R * K, R, K, dst + p * K, best.data(), K);
+        });
+    }
+    return out;
+}
+
+/*==============================|
+ *                              |
+ *                              |
+ *                              |
+ * The entire Tensor operation  |
+ *                              |
+ *                              |
+ *==============================|                            
+*/
+
+template<typename T>
+Tensor<T> full(const Shape& shape, const T value)
+{
+    return constant_tensor(shape, value, TensorInit::Full);
+}
+
+template<typename T>
+Tensor<T> zeros(const Shape& shape)
+{
+    return constant_tensor(shape, T{0}, TensorInit::Zeros);
+}
+
+template<typename T>
+Tensor<T> ones(const Shape& shape)
+{
+    return constant_tensor(shape, T{1}, TensorInit::Ones);
+}
+
+template<typename T>
+Tensor<T> twos(const Shape& shape)
+{   
+    return constant_tensor(shape, T{2}, TensorInit::Twos);
+}
+
+namespace vectra {
+
+// Philox stream of rand() / randn() : a 64-bit seed (the key) and the next unused block. Every
+// call reserves the blocks it fills, so its values depend on the seed and the calls made before
+// it, never on the number of threads
+class Generator {
+public:
+    explicit Generator(uint64_t seed) : key(seed), next(0) {}
+
+    uint64_t seed() const { return key; }
+
+    // restarts the stream of `seed`
+    void manual_seed(uint64_t seed)
+    {
+        key = seed;
+        next.store(0);
+    }
+
+    // position in the stream, in blocks (saved / restored to replay a sequence of calls)
+    uint64_t offset() const { return next.load(); }
+    void set_offset(uint64_t block) { next.store(block); }
+
+    // first of `blocks` consecutive blocks owned by the caller
+    uint64_t reserve(uint64_t blocks) { return next.fetch_add(blocks); }
+
+private:
+    uint64_t key;
+    std::atomic<uint64_t> next;
+};
+
+// generator of rand() / randn() without an explicit one, seeded from std::random_device
+inline Generator& default_generator()
+{
+    static Generator gen([] {
+        std::random_device rd;
+        return (uint64_t(rd()) << 32) | rd();
+    }());
+    return gen;
+}
+
+inline void manual_seed(uint64_t seed)
+{
+    default_generator().manual_seed(seed);
+}
+
+} // namespace vectra
+
+// fills `out` with a fresh range of the stream of `gen`, block-aligned chunks over the thread pool
+template<typename T, typename F>
+void randomFillTemplate(const char* name, Tensor<T>& out, vectra::Generator& gen, size_t bytes_per_item, F&& kernel)
+{
+    constexpr size_t PB = vectra::kernel::random_per_block<T>();
+    const size_t n = out.numel();
+    const size_t blocks = (n + PB - 1) / PB;
+    const uint64_t first = gen.reserve(blocks);
+    const uint64_t key = gen.seed();
+    T* dst = out.data();
+    VECTRA_OP_SCOPE(T, name, n, double(n) * sizeof(T), double(n), &out.shape);
+
+    utils::parallel_for(0, blocks, utils::grain_size(PB * bytes_per_item), [&](size_t lo, size_t hi) {
+        const size_t begin = lo * PB;
+        kernel(key, first + lo, dst + begin, std::min(hi * PB, n) - begin);
+    });
+}
+
+// uniform in [0, 1)
+template<typename T>
+Tensor<T> rand(const Shape& shape, vectra::Generator& gen)
+{
+    static_assert(std::is_floating_point<T>::value, "rand() only supports floating-point types");
+
+    const utils::AllocTag tag("rand");
+    Tensor<T> out(shape);
+    randomFillTemplate("rand", out, gen, 2 * sizeof(T), [](uint64_t key, uint64_t block, T* dst, size_t n) {
+        vectra::kernel::random_uniform<T>(key, block, dst, n);
+    });
+    return out;
+}
+
+template<typename T>
+Tensor<T> rand(const Shape& shape)
+{
+    return rand<T>(shape, vectra::default_generator());
+}
+
+// standard normal
+template<typename T>
+Tensor<T> randn(const Shape& shape, vectra::Generator& gen)
+{
+    static_assert(std::is_floating_point<T>::value,
+                  "randn() only supports floating-point types");
+
+    const utils::AllocTag tag("randn");
+    Tensor<T> out(shape);
+    randomFillTemplate("randn", out, gen, 8 * sizeof(T), [](uint64_t key, uint64_t block, T* dst, size_t n) {
+        vectra::kernel::random_normal<T>(key, block, dst, n);
+    });
+    return out;
+}
+
+template<typename T>
+Tensor<T> randn(const Shape& shape)
+{
+    return randn<T>(shape, vectra::default_generator());
+}
+
+// view of memory owned elsewhere (NumPy, DLPack, a mapped file), nothing is copied : `strides`
+// are in elements, `owner` is released with the last tensor sharing the storage
+template<typename T>
+Tensor<T> from_blob(T* data, const Shape& shape, const Shape& strides,
+                    std::shared_ptr<void> owner)
+{
+    if (strides.size() != shape.size()) {
+        fprintf(stderr, "vectra from_blob() : strides and shape must have the same length!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // elements spanned by the view
+    size_t extent = shape_numel(shape) == 0 ? 0 : 1;
+    if (extent) {
+        for (size_t d = 0; d < shape.size(); ++d) extent += (shape[d] - 1) * strides[d];
+    }
+
+    Tensor<T> t;
+    t.shape = shape;
+    t.strides = strides;
+    t.storage = std::make_shared<utils::vector<T>>(data, extent, std::move(owner));
+    t.update_layout();
+    return t;
+}
+
+/*
+ *
+ * Views : the result shares the storage of the input, no element is copied
+ *
+*/
+
+// dense copy when the layout is strided, the same view otherwise
+template<typename T>
+Tensor<T> contiguous(const Tensor<T>& t1)
+{
+    if (t1.is_contiguous()) return t1;
+
+    if (t1.is_lazy()) {
+        const utils::AllocTag tag("contiguous");
+        Tensor<T> out = t1;
+        out.materialize();
+        return out;
+    }
+
+    VECTRA_OP_SCOPE(T, "contiguous", t1.numel(), 2.0 * t1.numel() * sizeof(T), 0, &t1.shape);
+    Tensor<T> out(t1.shape);
+    unaryStridedTemplate(t1, out, 2 * sizeof(T), [](T x) { return x; });
+    return out;
+}
+
+template<typename T>
+Tensor<T> reshape(const Tensor<T>& t1, const Shape& shape)
+{
+    if (shape_numel(shape) != t1.numel()) {
+        fprintf(stderr, "vectra reshape() : Shape doesn't match!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (t1.is_lazy()) return constant_tensor(shape, *t1.data(), t1.init);
+
+    // strided input : the elements have to be packed first
+    Tensor<T> out = contiguous(t1);
+    out.shape = shape;
+    out.strides = contiguous_strides(shape);
+    out.update_layout();
+    return out;
+}
+
+template<typename T>
+Tensor<T> flatten(const Tensor<T>& t1)
+{
+    // a copy only for a strided view
+    VECTRA_OP_SCOPE(T, "flatten", t1.numel(), t1.is_contiguous() ? 0.0 : 2.0 * t1.numel() * sizeof(T), 0,
+                    &t1.shape);
+    return reshape(t1, { t1.numel() });
+}
+
+template<typename T>
+Tensor<T> permute(const Tensor<T>& t1, const std::vector<size_t>& dims)
+{
+    const size_t ndim = t1.shape.size();
+    std::vector<bool> seen(ndim, false);
+
+    if (dims.size() != ndim) {
+        fprintf(stderr, "vectra permute() : number of dimensions doesn't match!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    Tensor<T> out = t1;
+    for (size_t d = 0; d < ndim; ++d) {
+        if (dims[d] >= ndim || seen[dims[d]]) {
+            fprintf(stderr, "vectra permute() : invalid dimension order!\n");
+            exit(EXIT_FAILURE);
+        }
+        seen[dims[d]] = true;
+        out.shape[d] = t1.shape[dims[d]];
+        out.strides[d] = t1.strides[dims[d]];
+    }
+    out.update_layout();
+    return out;
+}
+
+template<typename T>
+Tensor<T> transpose(const Tensor<T>& t1, size_t dim0, size_t dim1)
+{
+    if (dim0 >= t1.shape.size() || dim1 >= t1.shape.size()) {
+        fprintf(stderr, "vectra transpose() : dimension out of range!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    Tensor<T> out = t1;
+    std::swap(out.shape[dim0], out.shape[dim1]);
+    std::swap(out.strides[dim0], out.strides[dim1]);
+    out.update_layout();
+    return out;
+}
+
+// matrix transpose (last two dimensions)
+template<typename T>
+Tensor<T> transpose(const Tensor<T>& t1)
+{
+    if (t1.shape.size() < 2) return t1;
+    return transpose(t1, t1.shape.size() - 2, t1.shape.size() - 1);
+}
+
+// elements [start, end) of `dim` taking every `step`-th one
+template<typename T>
+Tensor<T> slice(const Tensor<T>& t1, size_t dim, size_t start, size_t end, size_t step = 1)
+{
+    if (dim >= t1.shape.size() || step == 0) {
+        fprintf(stderr, "vectra slice() : invalid dimension or step!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    end = std::min(end, t1.shape[dim]);
+    start = std::min(start, end);
+
+    Tensor<T> out = t1;
+    out.offset += start * t1.strides[dim];
+    out.shape[dim] = (end - start + step - 1) / step;
+    out.strides[dim] *= step;
+    out.update_layout();
+    return out;
+}
+
+// broadcast view to `shape` : repeated dimensions read the same elements through stride 0
+template<typename T>
+Tensor<T> expand(const Tensor<T>& t1, const Shape& shape)
+{
+    Shape out_shape;
+    if (!broadcast_shape(t1.shape, shape, out_shape) || out_shape != shape) {
+        fprintf(stderr, "vectra expand() : Shape can't be broadcast!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    Tensor<T> out = t1;
+    out.strides = broadcast_strides(t1.shape, t1.strides, shape);
+    out.shape = shape;
+    out.update_layout();
+    return out;
+}
+
+// drop every dimension of size 1
+template<typename T>
+Tensor<T> squeeze(const Tensor<T>& t1)
+{
+    Tensor<T> out = t1;
+    out.shape.clear();
+    out.strides.clear();
+
+    for (size_t d = 0; d < t1.shape.size(); ++d) {
+        if (t1.shape[d] == 1) continue;
+        out.shape.push_back(t1.shape[d]);
+        out.strides.push_back(t1.strides[d]);
+    }
+    out.update_layout();
+    return out;
+}
+
+template<typename T>
+Tensor<T> squeeze(const Tensor<T>& t1, size_t dim)
+{
+    if (dim >= t1.shape.size() || t1.shape[dim] != 1) {
+        fprintf(stderr, "vectra squeeze() : dimension is not of size 1!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    Tensor<T> out = t1;
+    out.shape.erase(out.shape.begin() + dim);
+    out.strides.erase(out.strides.begin() + dim);
+    out.update_layout();
+    return out;
+}
+
+// insert a dimension of size 1 before `dim`
+template<typename T>
+Tensor<T> unsqueeze(const Tensor<T>& t1, size_t dim)
+{
+    if (dim > t1.shape.size()) {
+        fprintf(stderr, "vectra unsqueeze() : dimension out of range!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    const size_t stride = dim < t1.shape.size() ? t1.shape[dim] * t1.strides[dim] : 1;
+
+    Tensor<T> out = t1;
+    out.shape.insert(out.shape.begin() + dim, 1);
+    out.strides.insert(out.strides.begin() + dim, stride);
+    out.update_layout();
+    return out;
+}
+
+template<typename T>
+Tensor<T> add(const Tensor<T>& A, const Tensor<T>& B)
+{
+    return binaryTemplate<vectra::kernel::BinaryOp::Add>("add", A, B);
+}
+
+template<typename T>
+Tensor<T> sub(const Tensor<T>& A, const Tensor<T>& B)
+{
+    return binaryTemplate<vectra::kernel::BinaryOp::Sub>("sub", A, B);
+}
+
+template<typename T>
+Tensor<T> mul(const Tensor<T>& A, const Tensor<T>& B)
+{
+    return binaryTemplate<vectra::kernel::BinaryOp::Mul>("mul", A, B);
+}
+
+template<typename T>
+Tensor<T> div(const Tensor<T>& A, const Tensor<T>& B)
+{
+    return binaryTemplate<vectra::kernel::BinaryOp::Div>("div", A, B);
+}
+
+// out = A op B, written into a caller tensor of the broadcast shape
+template<typename T>
+Tensor<T>& add(const Tensor<T>& A, const Tensor<T>& B, Tensor<T>& out)
+{
+    return binaryOutTemplate<vectra::kernel::BinaryOp::Add>("add", A, B, out);
+}
+
+template<typename T>
+Tensor<T>& sub(const Tensor<T>& A, const Tensor<T>& B, Tensor<T>& out)
+{
+    return binaryOutTemplate<vectra::kernel::BinaryOp::Sub>("sub", A, B, out);
+}
+
+template<typename T>
+Tensor<T>& mul(const Tensor<T>& A, const Tensor<T>& B, Tensor<T>& out)
+{
+    return binaryOutTemplate<vectra::kernel::BinaryOp::Mul>("mul", A, B, out);
+}
+
+template<typename T>
+Tensor<T>& div(const Tensor<T>& A, const Tensor<T>& B, Tensor<T>& out)
+{
+    return binaryOutTemplate<vectra::kernel::BinaryOp::Div>("div", A, B, out);
+}
+
+// A = A op B in place, B broadcast to the shape of A (A must not be an expanded view). Views
+// and folded results (add(X, zeros) is X) share storage : writing to A writes to them as well
+template<typename T>
+Tensor<T>& add_(Tensor<T>& A, const Tensor<T>& B)
+{
+    return binaryOutTemplate<vectra::kernel::BinaryOp::Add>("add_", A, B, A);
+}
+
+template<typename T>
+Tensor<T>& sub_(Tensor<T>& A, const Tensor<T>& B)
+{
+    return binaryOutTemplate<vectra::kernel::BinaryOp::Sub>("sub_", A, B, A);
+}
+
+template<typename T>
+Tensor<T>& mul_(Tensor<T>& A, const Tensor<T>& B)
+{
+    return binaryOutTemplate<vectra::kernel::BinaryOp::Mul>("mul_", A, B, A);
+}
+
+template<typename T>
+Tensor<T>& div_(Tensor<T>& A, const Tensor<T>& B)
+{
+    return binaryOutTemplate<vectra::kernel::BinaryOp::Div>("div_", A, B, A);
+}
+
+// shape of dot(A, B), false when the operands don't fit (message in `why`)
+template<typename T>
+bool dot_shape(const Tensor<T>& A, const Tensor<T>& B, Shape& shape, const char*& why)
+{
+    why = "Shape doesn't match!";
+
+    if (A.shape.size() == 1 && B.shape.size() == 2) {
+        shape = { B.shape[1] };
+        return B.shape[0] == A.shape[0];
+    }
+    if (A.shape.size() == 2 && B.shape.size() == 1) {
+        shape = { A.shape[0] };
+        return B.shape[0] == A.shape[1];
+    }
+    if (A.shape.size() == 2 && B.shape.size() == 2) {
+        shape = { A.shape[0], B.shape[1] };
+        return B.shape[0] == A.shape[1];
+    }
+
+    why = "only vector * matrix, matrix * vector and matrix * matrix are supported!";
+    return false;
+}
+
+// out = A . B, out is contiguous and must not overlap A or B
+template<typename T>
+Tensor<T>& dot(const Tensor<T>& A, const Tensor<T>& B, Tensor<T>& out)
+{
+    Shape shape;
+    const char* why;
+    if(!dot_shape(A, B, shape, why)){
+        fprintf(stderr, "vectra dot() : %s\n", why);
+        exit(EXIT_FAILURE);
+    }
+    check_out("dot", shape, out, true);
+    // one multiply-add per element of A times the columns of B (vector * matrix : per element of B)
+    const double flops = A.shape.size() == 1 ? 2.0 * B.numel() : 2.0 * A.numel() * (B.shape.size() == 2 ? B.shape[1] : 1);
+    VECTRA_OP_SCOPE(T, "dot", std::max({ A.numel(), B.numel(), out.numel() }),
+                    tensor_bytes(A) + tensor_bytes(B) + double(out.numel()) * sizeof(T), flops,
+                    &A.shape, &B.shape);
+
+    T* dst = out.data();
+
+    // Vector * Matrix
+    if(A.shape.size() == 1){
+        size_t L = A.shape[0];
+        size_t M = B.shape[1];
+
+        const Tensor<T> a = contiguous(A);
+        const Tensor<T> b = contiguous(B);
+
+        // walk B row by row (contiguous) and accumulate into the output row, threads own columns.
+        // The first row initializes the output (no zero fill)
+        utils::parallel_for(0, M, utils::grain_size(L * sizeof(T)), [&](size_t lo, size_t hi) {
+            if (L == 0) { std::fill(dst + lo, dst + hi, T{0}); return; }
+            for(size_t i = 0; i < L; ++i){
+                const T x = a.data()[i];
+                const T* b_row = b.data() + i * M;
+                if (i == 0) for (size_t j = lo; j < hi; ++j) dst[j] = x * b_row[j];
+                else        for (size_t j = lo; j < hi; ++j) dst[j] += x * b_row[j];
+            }
+        });
+        return out;
+    }
+    // Matrix * vector
+    else if(B.shape.size() == 1){
+        size_t N = A.shape[0];
+        size_t K = A.shape[1];
+
+        const Tensor<T> a = contiguous(A);
+        const Tensor<T> b = contiguous(B);
+
+        utils::parallel_for(0, N, utils::grain_size(K * sizeof(T)), [&](size_t lo, size_t hi) {
+            for(size_t i = lo; i < hi; ++i){
+                T sum = T{0};
+                for(size_t j = 0; j < K; ++j) sum += a.data()[i * K + j] * b.data()[j];
+
+                dst[i] = sum;
+            }
+        });
+
+        return out;
+    }
+    // Matrix * Matrix
+    else {
+        size_t N = A.shape[0];
+        size_t K = A.shape[1];
+        size_t M = B.shape[1];
+
+        if constexpr (std::is_floating_point_v<T>) {
+            // strided operands (e.g. transposed views) are read directly by the packing routines
+            vectra::kernel::gemm::gemm<T>(N, M, K, A.data(), A.strides[0], A.strides[1],
+                                          B.data(), B.strides[0], B.strides[1], dst, M);
+            return out;
+        }
+        else {
+            // integer types : i-k-j order so B and the output are streamed row by row,
+            // k = 0 initializes the output row (no zero fill)
+            const Tensor<T> a = contiguous(A);
+            const Tensor<T> b = contiguous(B);
+
+            utils::parallel_for(0, N, utils::grain_size(K * M * sizeof(T)), [&](size_t lo, size_t hi) {
+                for(size_t i = lo; i < hi; ++i){
+                    T* c_row = dst + i * M;
+                    if (K == 0) std::fill(c_row, c_row + M, T{0});
+                    for(size_t k = 0; k < K; ++k){
+                        const T x = a.data()[i * K + k];
+                        const T* b_row = b.data() + k * M;
+                        if (k == 0) for (size_t j = 0; j < M; ++j) c_row[j] = x * b_row[j];
+                        else        for (size_t j = 0; j < M; ++j) c_row[j] += x * b_row[j];
+                    }
+                }
+            });
+
+            return out;
+        }
+    }
+}
+
+template<typename T>
+Tensor<T> dot(const Tensor<T>& A, const Tensor<T>& B)
+{
+    Shape shape;
+    const char* why;
+    if(!dot_shape(A, B, shape, why)){
+        fprintf(stderr, "vectra dot() : %s\n", why);
+        exit(EXIT_FAILURE);
+    }
+
+    const utils::AllocTag tag("dot");
+    Tensor<T> out(shape);
+    dot(A, B, out);
+    return out;
+}
+
+// fold of every element, O(1) on a lazy constant
+template<vectra::kernel::ReduceOp Op, typename T>
+T reduceTensorTemplate(const char* name, const Tensor<T>& t1)
+{
+    VECTRA_OP_SCOPE(T, name, t1.numel(), tensor_bytes(t1) + sizeof(T), double(t1.numel()), &t1.shape);
+    if (t1.is_lazy()) return constant_reduce<Op>(*t1.data(), t1.numel());
+
+    const Tensor<T> src = contiguous(t1);
+    return reduceArrayTemplate<Op>(src.data(), src.numel());
+}
+
+template<typename T>
+Tensor<T> max(const Tensor<T>& t1)
+{
+    if (t1.numel() == 0) {
+        fprintf(stderr, "vectra max() : zero-size reduction!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return Tensor<T>({1}, reduceTensorTemplate<vectra::kernel::ReduceOp::Max>("max", t1));
+}
+
+template<typename T>
+Tensor<T> min(const Tensor<T>& t1)
+{
+    if (t1.numel() == 0) {
+        fprintf(stderr, "vectra min() : zero-size reduction!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return Tensor<T>({1}, reduceTensorTemplate<vectra::kernel::ReduceOp::Min>("min", t1));
+}
+
+template<typename T>
+Tensor<T> sum(const Tensor<T>& t1)
+{
+    return Tensor<T>({1}, reduceTensorTemplate<vectra::kernel::ReduceOp::Sum>("sum", t1));
+}
+
+template<typename T>
+Tensor<T> prod(const Tensor<T>& t1)
+{
+    return Tensor<T>({1}, reduceTensorTemplate<vectra::kernel::ReduceOp::Prod>("prod", t1));
+}
+
+// sum / count in a wide type, only the quotient is cast back : the count need not fit in T
+// (256 int8 elements), integer tensors take the truncated quotient
+template<typename T>
+inline T mean_divide(T sum, size_t count)
+{
+    if constexpr (std::is_integral_v<T>) return static_cast<T>(int64_t(sum) / int64_t(count));
+    else return static_cast<T>(double(sum) / double(count));
+}
+
+template<typename T>
+Tensor<T> mean(const Tensor<T>& t1)
+{
+    VECTRA_OP_SCOPE(T, "mean", t1.numel(), tensor_bytes(t1) + sizeof(T), double(t1.numel()), &t1.shape);
+    Tensor<T> out = sum(t1);
+    out.data()[0] = mean_divide(out.data()[0], std::max<size_t>(1, t1.numel()));
+    return out;
+}
 
-        size_t count = total;
+// reductions along `axes`, keepdims leaves every reduced axis with size 1
+template<typename T>
+Tensor<T> max(const Tensor<T>& t1, const std::vector<size_t>& axes, bool keepdims = false)
+{
+    return reduceAxesTemplate<vectra::kernel::ReduceOp::Max>("max", t1, axes, keepdims);
+}
 
-        data.resize(count);
+template<typename T>
+Tensor<T> min(const Tensor<T>& t1, const std::vector<size_t>& axes, bool keepdims = false)
+{
+    return reduceAxesTemplate<vectra::kernel::ReduceOp::Min>("min", t1, axes, keepdims);
+}
 
-        for (size_t i = 0; i < count; ++i) {
-            data.data[i] = value;
-        }
-    }
-};
+template<typename T>
+Tensor<T> sum(const Tensor<T>& t1, const std::vector<size_t>& axes, bool keepdims = false)
+{
+    return reduceAxesTemplate<vectra::kernel::ReduceOp::Sum>("sum", t1, axes, keepdims);
+}
 
-static constexpr size_t TENSOR_PRINT_LIMIT = 100;
+template<typename T>
+Tensor<T> prod(const Tensor<T>& t1, const std::vector<size_t>& axes, bool keepdims = false)
+{
+    return reduceAxesTemplate<vectra::kernel::ReduceOp::Prod>("prod", t1, axes, keepdims);
+}
 
+// sums of `out` divided by the number of reduced elements
 template<typename T>
-void print_tensor_recursive(std::ostream& os, const Tensor<T>& t, size_t dim, size_t& index, size_t indent, size_t& printed)
+void mean_scale(const Tensor<T>& t1, Tensor<T>& out)
 {
-    if (printed >= TENSOR_PRINT_LIMIT) {
-        os << "...";
+    const size_t count = std::max<size_t>(1, t1.numel() / std::max<size_t>(1, out.numel()));
+    if (out.is_lazy()) {
+        const T value = mean_divide(*static_cast<const Tensor<T>&>(out).data(), count);
+        out = constant_tensor(out.shape, value, constant_init(value));
         return;
     }
+    T* dst = out.data();
 
-    size_t ndim = t.shape.size();
+    for (size_t i = 0; i < out.numel(); ++i) dst[i] = mean_divide(dst[i], count);
+}
 
-    if (dim == ndim - 1) {
-        os << "[";
+template<typename T>
+Tensor<T> mean(const Tensor<T>& t1, const std::vector<size_t>& axes, bool keepdims = false)
+{
+    VECTRA_OP_SCOPE(T, "mean", t1.numel(), tensor_bytes(t1), double(t1.numel()), &t1.shape);
+    Tensor<T> out = reduceAxesTemplate<vectra::kernel::ReduceOp::Sum>("mean", t1, axes, keepdims);
+    mean_scale(t1, out);
+    return out;
+}
 
-        size_t n = t.shape[dim];
-        for (size_t i = 0; i < n; ++i) {
+// axis reductions into a caller tensor (contiguous, of the reduced shape)
+template<typename T>
+Tensor<T>& max(const Tensor<T>& t1, const std::vector<size_t>& axes, bool keepdims, Tensor<T>& out)
+{
+    return reduceAxesTemplate<vectra::kernel::ReduceOp::Max>("max", t1, axes, keepdims, out);
+}
 
-            if (printed >= TENSOR_PRINT_LIMIT) {
-                os << ", ...";
-                break;
-            }
+template<typename T>
+Tensor<T>& min(const Tensor<T>& t1, const std::vector<size_t>& axes, bool keepdims, Tensor<T>& out)
+{
+    return reduceAxesTemplate<vectra::kernel::ReduceOp::Min>("min", t1, axes, keepdims, out);
+}
 
-            if (i > 0) os << ", ";
+template<typename T>
+Tensor<T>& sum(const Tensor<T>& t1, const std::vector<size_t>& axes, bool keepdims, Tensor<T>& out)
+{
+    return reduceAxesTemplate<vectra::kernel::ReduceOp::Sum>("sum", t1, axes, keepdims, out);
+}
 
-            os << t.data.data[index++].get_scalar();
-            printed++;
-        }
+template<typename T>
+Tensor<T>& prod(const Tensor<T>& t1, const std::vector<size_t>& axes, bool keepdims, Tensor<T>& out)
+{
+    return reduceAxesTemplate<vectra::kernel::ReduceOp::Prod>("prod", t1, axes, keepdims, out);
+}
 
-        os << "]";
-        return;
-    }
+template<typename T>
+Tensor<T>& mean(const Tensor<T>& t1, const std::vector<size_t>& axes, bool keepdims, Tensor<T>& out)
+{
+    reduceAxesTemplate<vectra::kernel::ReduceOp::Sum>("mean", t1, axes, keepdims, out);
+    mean_scale(t1, out);
+    return out;
+}
 
-    os << "[\n";
+// flat index of the first max / min
+template<typename T>
+Tensor<vectra::int32> argmax(const Tensor<T>& t1)
+{
+    return argReduceTemplate<vectra::kernel::ReduceOp::Max>("argmax", reshape(t1, { t1.numel() }), 0, false);
+}
 
-    size_t n = t.shape[dim];
-    for (size_t i = 0; i < n; ++i) {
-        os << std::string(indent + 2, ' ');
+template<typename T>
+Tensor<vectra::int32> argmin(const Tensor<T>& t1)
+{
+    return argReduceTemplate<vectra::kernel::ReduceOp::Min>("argmin", reshape(t1, { t1.numel() }), 0, false);
+}
 
-        if (printed >= TENSOR_PRINT_LIMIT) {
-            os << "...";
-            break;
-        }
+template<typename T>
+Tensor<vectra::int32> argmax(const Tensor<T>& t1, size_t axis, bool keepdims = false)
+{
+    return argReduceTemplate<vectra::kernel::ReduceOp::Max>("argmax", t1, axis, keepdims);
+}
 
-        print_tensor_recursive(os, t, dim + 1, index, indent + 2, printed);
+template<typename T>
+Tensor<vectra::int32> argmin(const Tensor<T>& t1, size_t axis, bool keepdims = false)
+{
+    return argReduceTemplate<vectra::kernel::ReduceOp::Min>("argmin", t1, axis, keepdims);
+}
 
-        if (i + 1 < n)
-            os << ",\n";
-    }
+/*
+ *
+ * Elementwise math (SIMD polynomial kernels of VecMath.h, error bounds documented there)
+ *
+*/
 
-    os << "\n" << std::string(indent, ' ') << "]";
+// out = Op(t1), any layout of t1 and out (out may be t1 itself)
+inline const char* unary_op_name(vectra::kernel::UnaryOp op)
+{
+    using vectra::kernel::UnaryOp;
+    switch (op) {
+        case UnaryOp::Exp:     return "exp_tensor";
+        case UnaryOp::Log:     return "log_tensor";
+        case UnaryOp::Log1p:   return "log1p_tensor";
+        case UnaryOp::Tanh:    return "tanh_tensor";
+        case UnaryOp::Sigmoid: return "sigmoid_tensor";
+        case UnaryOp::Erf:     return "erf_tensor";
+        case UnaryOp::Sqrt:    return "sqrt_tensor";
+        default:               return "rsqrt_tensor";
+    }
 }
 
-template<typename T>
-std::ostream& operator<<(std::ostream& os, const Tensor<T>& t)
+template<vectra::kernel::UnaryOp Op, typename T>
+void unaryMathIntoTemplate(const Tensor<T>& t1, Tensor<T>& out)
 {
-    os << "tensor([";
+    VECTRA_OP_SCOPE(T, unary_op_name(Op), out.numel(), tensor_bytes(t1) + double(out.numel()) * sizeof(T),
+                    double(out.numel()), &t1.shape);
 
-    // print shape
-    for(size_t i = 0; i < t.shape.size(); ++i){
-        if (i > 0) os << ", ";
-        os << t.shape[i];
-    }
-    os << "]\n";
+    if (t1.is_contiguous() && out.is_contiguous()) {
+        const T* a = t1.data();
+        T* dst = out.data();
 
-    // scalar case
-    if(t.shape.empty()){
-        os << t.data.data[0].get_scalar() << ")";
-        return os;
+        utils::parallel_for(0, out.numel(), utils::grain_size(16 * sizeof(T)), [&](size_t lo, size_t hi) {
+            vectra::kernel::unary<Op>(a + lo, dst + lo, hi - lo);
+        });
+        return;
     }
 
-    size_t index = 0;
-    size_t printed = 0;
+    const StridedLoop<2> loop(out.shape, { t1.strides, out.strides });
+    const size_t si = loop.inner_stride(0);
+    const size_t so = loop.inner_stride(1);
 
-    print_tensor_recursive(os, t, 0, index, 0, printed);
+    loop.for_each_row(utils::grain_size(16 * sizeof(T) * loop.inner()), [&](const std::array<size_t, 2>& off, size_t n) {
+        const T* a = t1.data() + off[0];
+        T* dst = out.data() + off[1];
 
-    os << "\n)";
-    return os;
-}
+        if (si == 1 && so == 1) {
+            vectra::kernel::unary<Op>(a, dst, n);
+            return;
+        }
 
-/*
- *
- * TEMPLATE FOR TENSOR OPERATION
- * 
-*/
+        // strided row : gathered and scattered through a block
+        constexpr size_t BLOCK = 256;
+        alignas(64) T buf[BLOCK];
+        for (size_t i = 0; i < n; i += BLOCK) {
+            const size_t m = std::min(BLOCK, n - i);
+            for (size_t j = 0; j < m; ++j) buf[j] = a[(i + j) * si];
+            vectra::kernel::unary<Op>(buf, buf, m);
+            for (size_t j = 0; j < m; ++j) dst[(i + j) * so] = buf[j];
+        }
+    });
+}
 
-template<typename T>
-T maxArrayTemplate(const ScalarType<T>* array, size_t n)
+template<vectra::kernel::UnaryOp Op, typename T>
+Tensor<T> unaryMathTemplate(const Tensor<T>& t1)
 {
-    T mx = array[0].get_scalar();
-
-    for (size_t i = 1; i < n; i++) {
-        T val = array[i].get_scalar();
-        if (val > mx)
-            mx = val;
+    // f(constant) is a constant
+    if (t1.is_lazy()) {
+        T value;
+        vectra::kernel::unary<Op>(t1.data(), &value, 1);
+        return constant_tensor(t1.shape, value, constant_init(value));
     }
-    return mx;
+
+    const utils::AllocTag tag(unary_op_name(Op));
+    Tensor<T> out(t1.shape);
+    unaryMathIntoTemplate<Op>(t1, out);
+    return out;
 }
 
-/*==============================|
- *                              |
- *                              |
- *                              |
- * The entire Tensor operation  |
- *                              |
- *                              |
- *==============================|                            
-*/
+template<vectra::kernel::UnaryOp Op, typename T>
+Tensor<T>& unaryMathTemplate(const char* name, const Tensor<T>& t1, Tensor<T>& out)
+{
+    check_out(name, t1.shape, out, false);
+    unaryMathIntoTemplate<Op>(t1, out);
+    return out;
+}
 
 template<typename T>
-Tensor<T> full(const std::vector<size_t>& shape, const T value)
+Tensor<T> exp_tensor(const Tensor<T>& t1)
 {
-    Tensor<T> t(shape, value);
-    t.init = TensorInit::Full;
-    return t;
+    return unaryMathTemplate<vectra::kernel::UnaryOp::Exp>(t1);
 }
 
 template<typename T>
-Tensor<T> zeros(const std::vector<size_t>& shape)
+Tensor<T> log_tensor(const Tensor<T>& t1)
 {
-    Tensor<T> t(shape, T{0});
-    t.init = TensorInit::Zeros;
-    return t;
+    return unaryMathTemplate<vectra::kernel::UnaryOp::Log>(t1);
 }
 
 template<typename T>
-Tensor<T> ones(const std::vector<size_t>& shape)
+Tensor<T> log1p_tensor(const Tensor<T>& t1)
 {
-    Tensor<T> t(shape, T{1});
-    t.init = TensorInit::Ones;
-    return t;
+    return unaryMathTemplate<vectra::kernel::UnaryOp::Log1p>(t1);
 }
 
 template<typename T>
-Tensor<T> twos(const std::vector<size_t>& shape)
-{   
-    Tensor<T> t(shape, T{2});
-    t.init = TensorInit::Twos;
-    return t;
+Tensor<T> tanh_tensor(const Tensor<T>& t1)
+{
+    return unaryMathTemplate<vectra::kernel::UnaryOp::Tanh>(t1);
 }
 
 template<typename T>
-Tensor<T> rand(const std::vector<size_t>& shape)
+Tensor<T> sigmoid_tensor(const Tensor<T>& t1)
 {
-    static_assert(std::is_floating_point<T>::value, "rand() only supports floating-point types");
-
-    Tensor<T> out(shape);
+    return unaryMathTemplate<vectra::kernel::UnaryOp::Sigmoid>(t1);
+}
 
-    static thread_local std::random_device rd;
-    static thread_local std::mt19937 gen(rd());
-    static thread_local std::uniform_real_distribution<T> dist(0.0, 1.0);
+template<typename T>
+Tensor<T> erf_tensor(const Tensor<T>& t1)
+{
+    return unaryMathTemplate<vectra::kernel::UnaryOp::Erf>(t1);
+}
 
-    for (size_t i = 0; i < out.data.size(); i++)
-        out.data.data[i] = dist(gen);
+template<typename T>
+Tensor<T> sqrt_tensor(const Tensor<T>& t1)
+{
+    return unaryMathTemplate<vectra::kernel::UnaryOp::Sqrt>(t1);
+}
 
-    return out;
+template<typename T>
+Tensor<T> rsqrt_tensor(const Tensor<T>& t1)
+{
+    return unaryMathTemplate<vectra::kernel::UnaryOp::Rsqrt>(t1);
 }
 
+// out-parameter (out of the shape of t1) and in-place variants
 template<typename T>
-Tensor<T> randn(const std::vector<size_t>& shape)
+Tensor<T>& exp_tensor(const Tensor<T>& t1, Tensor<T>& out)
 {
-    static_assert(std::is_floating_point<T>::value,
-                  "randn() only supports floating-point types");
+    return unaryMathTemplate<vectra::kernel::UnaryOp::Exp>("exp_tensor", t1, out);
+}
 
-    Tensor<T> out(shape);
+template<typename T>
+Tensor<T>& exp_(Tensor<T>& t1)
+{
+    return unaryMathTemplate<vectra::kernel::UnaryOp::Exp>("exp_", t1, t1);
+}
 
-    static thread_local std::random_device rd;
-    static thread_local std::mt19937 gen(rd());
-    static thread_local std::normal_distribution<T> dist(0.0, 1.0);
+template<typename T>
+Tensor<T>& log_tensor(const Tensor<T>& t1, Tensor<T>& out)
+{
+    return unaryMathTemplate<vectra::kernel::UnaryOp::Log>("log_tensor", t1, out);
+}
 
-    for (size_t i = 0; i < out.data.size(); i++)
-        out.data.data[i] = dist(gen);
+template<typename T>
+Tensor<T>& log_(Tensor<T>& t1)
+{
+    return unaryMathTemplate<vectra::kernel::UnaryOp::Log>("log_", t1, t1);
+}
 
-    return out;
+template<typename T>
+Tensor<T>& log1p_tensor(const Tensor<T>& t1, Tensor<T>& out)
+{
+    return unaryMathTemplate<vectra::kernel::UnaryOp::Log1p>("log1p_tensor", t1, out);
 }
 
 template<typename T>
-Tensor<T> add(const Tensor<T>& A, const Tensor<T>& B)
+Tensor<T>& log1p_(Tensor<T>& t1)
 {
-    if(A.data.size() != B.data.size() || A.shape != B.shape){
-        fprintf(stderr, "vectra add() : Shape doesn't match!\n");
-    }
-    Tensor<T> out(A.shape, T{0});
-    for (size_t i = 0; i < A.data.size(); ++i) out.data.data[i] = A.data.data[i] + B.data.data[i];
-    return out;
+    return unaryMathTemplate<vectra::kernel::UnaryOp::Log1p>("log1p_", t1, t1);
 }
 
 template<typename T>
-Tensor<T> sub(const Tensor<T>& A, const Tensor<T>& B)
+Tensor<T>& tanh_tensor(const Tensor<T>& t1, Tensor<T>& out)
 {
-    if(A.data.size() != B.data.size() || A.shape != B.shape){
-        fprintf(stderr, "vectra sub() : Shape doesn't match!\n");
-        exit(EXIT_FAILURE);
-    }
-    Tensor<T> out(A.shape, T{0});
-    for (size_t i = 0; i < A.data.size(); ++i) out.data.data[i] = A.data[i] - B.data.data[i];
-    return out;
+    return unaryMathTemplate<vectra::kernel::UnaryOp::Tanh>("tanh_tensor", t1, out);
 }
 
 template<typename T>
-Tensor<T> mul(const Tensor<T>& A, const Tensor<T>& B)
+Tensor<T>& tanh_(Tensor<T>& t1)
 {
-    if(A.data.size() != B.data.size() || A.shape != B.shape){
-        fprintf(stderr, "vectra mul() : Shape doesn't match!\n");
-        exit(EXIT_FAILURE);
-    }
-    Tensor<T> out(A.shape, T{0});
-    for (size_t i = 0; i < A.data.size(); ++i) out.data[i] = A.data.data[i] * B.data.data[i];
-    return out;
+    return unaryMathTemplate<vectra::kernel::UnaryOp::Tanh>("tanh_", t1, t1);
 }
 
 template<typename T>
-Tensor<T> div(const Tensor<T>& A, const Tensor<T>& B)
+Tensor<T>& sigmoid_tensor(const Tensor<T>& t1, Tensor<T>& out)
 {
-    if(A.data.size() != B.data.size() || A.shape != B.shape){
-        fprintf(stderr, "vectra div() : Shape doesn't match!\n");
-        exit(EXIT_FAILURE);
-    }
-    Tensor<T> out(A.shape, T{0});
-    for (size_t i = 0; i < A.data.size(); ++i) {
-        if(B.data.data[i] == T{0}){
-            fprintf(stderr, "vectra div() : cannot divide by zero!\n");
-            exit(EXIT_FAILURE);
-        }
-        out.data.data[i] = A.data.data[i] / B.data.data[i];
-    }
-    return out;
+    return unaryMathTemplate<vectra::kernel::UnaryOp::Sigmoid>("sigmoid_tensor", t1, out);
 }
 
 template<typename T>
-Tensor<T> dot(const Tensor<T>& A, const Tensor<T>& B)
-{   
-    // Vector * Matrix
-    if(A.shape.size() == 1 && B.shape.size() == 2){
-        size_t L = A.shape[0];
-        size_t M = B.shape[1];
+Tensor<T>& sigmoid_(Tensor<T>& t1)
+{
+    return unaryMathTemplate<vectra::kernel::UnaryOp::Sigmoid>("sigmoid_", t1, t1);
+}
 
-        Tensor<T> out({M}, T{0});
+template<typename T>
+Tensor<T>& erf_tensor(const Tensor<T>& t1, Tensor<T>& out)
+{
+    return unaryMathTemplate<vectra::kernel::UnaryOp::Erf>("erf_tensor", t1, out);
+}
 
-        for(size_t j = 0; j < M; ++j){
-            T sum = T{0};
-            for (size_t i = 0; i < L; ++i) sum += A.data.data[i].get_scalar() * B.data.data[i * M + j].get_scalar();
+template<typename T>
+Tensor<T>& erf_(Tensor<T>& t1)
+{
+    return unaryMathTemplate<vectra::kernel::UnaryOp::Erf>("erf_", t1, t1);
+}
 
-            out.data.data[j] = sum;
-        }
-        return out;
-    }
-    // Matrix * vector
-    else if(A.shape.size() == 2 && B.shape.size() == 1){
-        size_t N = A.shape[0];
-        size_t K = A.shape[1];
+template<typename T>
+Tensor<T>& sqrt_tensor(const Tensor<T>& t1, Tensor<T>& out)
+{
+    return unaryMathTemplate<vectra::kernel::UnaryOp::Sqrt>("sqrt_tensor", t1, out);
+}
 
-        Tensor<T> out({N}, T{0});
+template<typename T>
+Tensor<T>& sqrt_(Tensor<T>& t1)
+{
+    return unaryMathTemplate<vectra::kernel::UnaryOp::Sqrt>("sqrt_", t1, t1);
+}
 
-        for(size_t i = 0; i < N; ++i){
-            T sum = T{0};
-            for(size_t j = 0; j < K; ++j) sum += A.data.data[i * K + j].get_scalar() * B.data.data[j].get_scalar();
+template<typename T>
+Tensor<T>& rsqrt_tensor(const Tensor<T>& t1, Tensor<T>& out)
+{
+    return unaryMathTemplate<vectra::kernel::UnaryOp::Rsqrt>("rsqrt_tensor", t1, out);
+}
 
-            out.data.data[i] = sum;
-        }
+template<typename T>
+Tensor<T>& rsqrt_(Tensor<T>& t1)
+{
+    return unaryMathTemplate<vectra::kernel::UnaryOp::Rsqrt>("rsqrt_", t1, t1);
+}
 
-        return out;
+// A ^ B elementwise into a caller tensor of the broadcast shape, out may be A itself
+template<typename T>
+Tensor<T>& pow_tensor(const Tensor<T>& A, const Tensor<T>& B, Tensor<T>& out)
+{
+    Shape shape;
+    if(!broadcast_shape(A.shape, B.shape, shape)){
+        fprintf(stderr, "vectra pow_tensor() : Shapes can't be broadcast together!\n");
+        exit(EXIT_FAILURE);
     }
-    // Matrix * Matrix
-    if(A.shape.size() == 2 && B.shape.size() == 2){
-        size_t N = A.shape[0];
-        size_t K = A.shape[1];
-        size_t M = B.shape[1];
-
-        Tensor<T> out({N, M}, T{0});
-
-        for(size_t i = 0; i < N; ++i){
-            T sum = T{0};
-            for(size_t j = 0; j < M; ++j){
-                for (size_t k = 0; k < K; ++k) sum += A.data.data[i * K + k].get_scalar() * B.data.data[k * M + j].get_scalar();
+    check_out("pow_tensor", shape, out, false);
+    VECTRA_OP_SCOPE(T, "pow_tensor", out.numel(),
+                    tensor_bytes(A) + tensor_bytes(B) + double(out.numel()) * sizeof(T), double(out.numel()),
+                    &A.shape, &B.shape);
+
+    const StridedLoop<3> loop(shape, { broadcast_strides(A.shape, A.strides, shape),
+                                       broadcast_strides(B.shape, B.strides, shape),
+                                       out.strides });
+    const size_t sa = loop.inner_stride(0);
+    const size_t sb = loop.inner_stride(1);
+    const size_t so = loop.inner_stride(2);
+
+    // rows of unit stride run the kernel in place, broadcast or strided rows are gathered a block
+    // at a time (nothing is expanded in memory)
+    loop.for_each_row(utils::grain_size(32 * sizeof(T) * loop.inner()), [&](const std::array<size_t, 3>& off, size_t n) {
+        const T* a = A.data() + off[0];
+        const T* b = B.data() + off[1];
+        T* o = out.data() + off[2];
+
+        if (sa == 1 && sb == 1 && so == 1) {
+            vectra::kernel::pow(a, b, o, n);
+            return;
+        }
 
-                out.data.data[i * M + j] = sum;
+        constexpr size_t BLOCK = 256;
+        std::array<T, BLOCK> xa, xb, xo;
+        for (size_t i = 0; i < n; i += BLOCK) {
+            const size_t m = std::min(BLOCK, n - i);
+            for (size_t j = 0; j < m; ++j) {
+                xa[j] = a[(i + j) * sa];
+                xb[j] = b[(i + j) * sb];
             }
+            vectra::kernel::pow(xa.data(), xb.data(), xo.data(), m);
+            for (size_t j = 0; j < m; ++j) o[(i + j) * so] = xo[j];
         }
-
-        return out;
-    }
+    });
+    return out;
 }
 
+// A ^ B elementwise, operands broadcast like add()
 template<typename T>
-Tensor<T> max(const Tensor<T>& t1)
+Tensor<T> pow_tensor(const Tensor<T>& A, const Tensor<T>& B)
 {
-    Tensor<T> out({1}, T{0});
+    Shape shape;
+    if(!broadcast_shape(A.shape, B.shape, shape)){
+        fprintf(stderr, "vectra pow_tensor() : Shapes can't be broadcast together!\n");
+        exit(EXIT_FAILURE);
+    }
 
-    T mx = maxArrayTemplate(t1.data.data, t1.data.size());
+    if (A.is_lazy() && B.is_lazy()) {
+        T value;
+        vectra::kernel::pow(A.data(), B.data(), &value, 1);
+        return constant_tensor(shape, value, constant_init(value));
+    }
 
-    out.data.data[0] = ScalarType<T>(mx);
+    const utils::AllocTag tag("pow_tensor");
+    Tensor<T> out(shape);
+    pow_tensor(A, B, out);
     return out;
 }
 
 template<typename T>
-Tensor<T> flatten(const Tensor<T>& t1)
+Tensor<T>& pow_tensor(const Tensor<T>& A, const T exponent, Tensor<T>& out)
 {
-    size_t total = 1;
-    for (size_t dim : t1.shape)
-        total *= dim;
-
-    Tensor<T> out({ total }, T{0 });
-
-    for (size_t i = 0; i < total; ++i) out.data.data[i] = t1.data.data[i];
-
+    check_out("pow_tensor", A.shape, out, false);
+    VECTRA_OP_SCOPE(T, "pow_tensor", out.numel(), tensor_bytes(A) + double(out.numel()) * sizeof(T),
+                    double(out.numel()), &A.shape);
+
+    const Tensor<T> a = contiguous(A);
+    Tensor<T> dense = out.is_contiguous() ? out : Tensor<T>(A.shape);
+    const T* pa = a.data();
+    T* dst = dense.data();
+
+    utils::parallel_for(0, dense.numel(), utils::grain_size(32 * sizeof(T)), [&](size_t lo, size_t hi) {
+        // exponent replicated over one block at a time
+        constexpr size_t BLOCK = 1024;
+        std::array<T, BLOCK> e;
+        e.fill(exponent);
+        for (size_t i = lo; i < hi; i += BLOCK)
+            vectra::kernel::pow(pa + i, e.data(), dst + i, std::min(BLOCK, hi - i));
+    });
+
+    if (dense.storage != out.storage) unaryStridedTemplate(dense, out, 2 * sizeof(T), [](T x) { return x; });
     return out;
 }
 
 template<typename T>
-Tensor<T> sum(const Tensor<T>& t1)
+Tensor<T> pow_tensor(const Tensor<T>& A, const T exponent)
 {
-    size_t total = 1;
-    for(auto dim : t1.shape) total *= dim;
-
-    Tensor<T> out({1}, 0);
-
-    for(size_t i = 0; i < total; i++)
-        out.data.data[0] += t1.data.data[i];
+    if (A.is_lazy()) {
+        T value;
+        vectra::kernel::pow(A.data(), &exponent, &value, 1);
+        return constant_tensor(A.shape, value, constant_init(value));
+    }
 
+    const utils::AllocTag tag("pow_tensor");
+    Tensor<T> out(A.shape);
+    pow_tensor(A, exponent, out);
     return out;
 }
 
 template<typename T>
-Tensor<T> exp_tensor(const Tensor<T>& t1)
+Tensor<T>& pow_(Tensor<T>& A, const Tensor<T>& B)
 {
-    Tensor<T> out(t1.shape, T{0});
-
-    for(size_t i=0; i<t1.data.size(); ++i){
-        out.data.data[i] = t1.data.data[i].exp();
-    }
+    return pow_tensor(A, B, A);
+}
 
-    return out;
+template<typename T>
+Tensor<T>& pow_(Tensor<T>& A, const T exponent)
+{
+    return pow_tensor(A, exponent, A);
 }
 
 /*
@@ -424,7 +2100,7 @@ Tensor<T> exp_tensor(const Tensor<T>& t1)
 template<typename T>
 struct TensorTuple {
     Tensor<T> tensor;
-    const std::vector<size_t>* shape;
+    const Shape* shape;
 };
 
 template<typename T, typename F>
@@ -450,67 +2126,49 @@ binary_tuple_op(const TensorTuple<T>& A,
 
 template<typename T>
 TensorTuple<T>
-full_tuple(const std::vector<size_t>& shape, T value)
+full_tuple(const Shape& shape, T value)
 {
-    Tensor<T> t(shape, value);
-    t.init = TensorInit::Full;
+    Tensor<T> t = full(shape, value);
     return { std::move(t), &t.shape };
 }
 
 template<typename T>
 TensorTuple<T>
-ones_tuple(const std::vector<size_t>& shape)
+ones_tuple(const Shape& shape)
 {
-    Tensor<T> t(shape, T{1});
-    t.init = TensorInit::Ones;
+    Tensor<T> t = ones<T>(shape);
     return { std::move(t), &t.shape };
 }
 
 template<typename T>
 TensorTuple<T>
-twos_tuple(const std::vector<size_t>& shape)
+twos_tuple(const Shape& shape)
 {
-    Tensor<T> t(shape, T{2});
-    t.init = TensorInit::Twos;
+    Tensor<T> t = twos<T>(shape);
     return { std::move(t), &t.shape };
 }
 
 template<typename T>
 TensorTuple<T>
-zeros_tuple(const std::vector<size_t>& shape)
+zeros_tuple(const Shape& shape)
 {
-    Tensor<T> t(shape, T{0});
-    t.init = TensorInit::Zeros;
+    Tensor<T> t = zeros<T>(shape);
     return { std::move(t), &t.shape };
 }
 
 template<typename T>
 TensorTuple<T>
-rand_tuple(const std::vector<size_t>& shape)
+rand_tuple(const Shape& shape)
 {
-    Tensor<T> out(shape);
-
-    static thread_local std::mt19937 gen{ std::random_device{}() };
-    static thread_local std::uniform_real_distribution<T> dist(0.0, 1.0);
-
-    for (size_t i = 0; i < out.data.size(); ++i)
-        out.data.data[i] = dist(gen);
-
+    Tensor<T> out = rand<T>(shape);
     return { std::move(out), &out.shape };
 }
 
 template<typename T>
 TensorTuple<T>
-randn_tuple(const std::vector<size_t>& shape)
+randn_tuple(const Shape& shape)
 {
-    Tensor<T> out(shape);
-
-    static thread_local std::mt19937 gen{ std::random_device{}() };
-    static thread_local std::normal_distribution<T> dist(0.0, 1.0);
-
-    for (size_t i = 0; i < out.data.size(); ++i)
-        out.data.data[i] = dist(gen);
-
+    Tensor<T> out = randn<T>(shape);
     return { std::move(out), &out.shape };
 }
 
@@ -547,7 +2205,7 @@ TensorTuple<T> dot_tuple(const TensorTuple<T>& A, const TensorTuple<T>& B)
 template<typename T>
 TensorTuple<T> max_tuple(const TensorTuple<T>& t)
 {
-    return unary_tuple_op<T>(t, max<T>);
+    return unary_tuple_op<T>(t, [](const Tensor<T>& x) { return max(x); });
 }
 
 template<typename T>
@@ -559,7 +2217,7 @@ TensorTuple<T> flatten_tuple(const TensorTuple<T>& t)
 template<typename T>
 TensorTuple<T> sum_tuple(const TensorTuple<T>& t)
 {
-    return unary_tuple_op<T>(t, sum<T>);
+    return unary_tuple_op<T>(t, [](const Tensor<T>& x) { return sum(x); });
 }
 
 template<typename T>
@@ -568,6 +2226,9 @@ TensorTuple<T> exp_tuple(const TensorTuple<T>& t)
     return unary_tuple_op<T>(t, exp_tensor<T>);
 }
 
+#include <cpu/TensorExpr.h>
+#include <cpu/TensorFile.h>
+
 #endif // __cplusplus
 
 #endif // TENSOROPS_H
\ No newline at end of file
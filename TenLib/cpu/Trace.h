@@ -0,0 +1,403 @@
+/*
+ *
+ * Trace.h (v1.2)
+ *
+ * v1.2 updated : * a ring snapshot drops the slot the owner may be writing while it copies (torn event)
+ *
+ * v1.1 updated : * operand shapes are read from Shape (Shape.h)
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Timeline of the TensorOps ops in Chrome Trace Event JSON (HEADER), opens in Perfetto
+ * (ui.perfetto.dev) and chrome://tracing.
+ * The op scope of Profiler.h records one event per op while tracing is enabled : name, dtype,
+ * shapes of two operands, start and end and bytes touched. Events go to a ring buffer owned by
+ * the calling thread : the owner is the only writer (no lock, no atomic read-modify-write),
+ * the oldest events are overwritten when the ring is full. An op called by another op is a
+ * nested slice of it. Ops run on the thread that called them, the pool workers only show the
+ * ops of submit() tasks.
+ *
+ *   vectra::trace::enable();
+ *   ... ops ...
+ *   vectra::trace::dump("ops.json");
+ *
+ * Disabled, an op pays one relaxed load. Enabled, two time stamp counter reads (rdtsc, the
+ * invariant TSC of x86-64 : converted to ns against steady_clock when the trace is written) and a
+ * 128-byte store.
+ *
+ * Environment :
+ *   VECTRA_TRACE          path : enabled from the start, the trace is written there at exit
+ *   VECTRA_TRACE_EVENTS   events per thread ring (default 16384, rounded up to a power of two)
+ *
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#pragma once
+#ifndef TRACE_H
+#define TRACE_H
+
+#ifdef __cplusplus
+
+#include <cpu/Shape.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define VECTRA_TRACE_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define VECTRA_TRACE_TSC 1
+#endif
+
+namespace vectra {
+namespace trace {
+
+// dimensions kept per operand shape, a longer shape ends with "..."
+static constexpr size_t TRACE_MAX_DIMS = 5;
+
+struct Event {
+    const char* name;                   // string literals : the pointers stay valid
+    const char* dtype;
+    uint64_t start;                     // ticks of trace::now()
+    uint64_t end;
+    uint64_t bytes;
+    uint8_t ndim[2];                    // operand shapes, 0xff when the op has no such operand
+    uint64_t dims[2][TRACE_MAX_DIMS];
+};
+
+namespace detail {
+
+inline std::atomic<bool>& enabled_flag()
+{
+    static std::atomic<bool> flag{ false };
+    return flag;
+}
+
+inline uint64_t ticks()
+{
+#if defined(VECTRA_TRACE_TSC)
+    return uint64_t(__rdtsc());
+#else
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// ticks and steady_clock at the start of the trace, the scale of the ticks comes from a second pair
+struct Clock {
+    uint64_t tick0;
+    std::chrono::steady_clock::time_point t0;
+
+    double ns_per_tick() const
+    {
+#if defined(VECTRA_TRACE_TSC)
+        const uint64_t tick1 = ticks();
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+        return tick1 > tick0 && ns > 0 ? ns / double(tick1 - tick0) : 1.0;
+#else
+        return 1.0;
+#endif
+    }
+};
+
+inline const Clock& epoch()
+{
+    static const Clock clock{ ticks(), std::chrono::steady_clock::now() };
+    return clock;
+}
+
+inline long current_tid()
+{
+#if defined(__linux__)
+    return long(syscall(SYS_gettid));
+#else
+    return long(std::hash<std::thread::id>()(std::this_thread::get_id()) & 0x7fffffff);
+#endif
+}
+
+// single writer (the owner thread) ring of the last `capacity` events
+struct Ring {
+    std::unique_ptr<Event[]> slots;
+    size_t mask;
+    long tid;
+    std::atomic<uint64_t> head{ 0 };    // events ever written, published after the slot
+    std::atomic<uint64_t> start{ 0 };   // first event kept by clear()
+    std::atomic<bool> alive{ true };
+
+    Ring(size_t capacity, long tid_) : slots(new Event[capacity]), mask(capacity - 1), tid(tid_) {}
+
+    Event& next() { return slots[head.load(std::memory_order_relaxed) & mask]; }
+
+    void publish() { head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // copy of the events still held, those overwritten during the copy are dropped : the owner
+    // may be writing event h2 into the slot of event h2 - cap (torn), so that one goes too
+    std::vector<Event> snapshot() const
+    {
+        const uint64_t cap = mask + 1;
+        const uint64_t h1 = head.load(std::memory_order_acquire);
+        const uint64_t lo = std::max(start.load(std::memory_order_acquire), h1 > cap ? h1 - cap : 0);
+
+        std::vector<Event> out;
+        out.reserve(size_t(h1 - lo));
+        for (uint64_t i = lo; i < h1; ++i) out.push_back(slots[i & mask]);
+
+        const uint64_t h2 = head.load(std::memory_order_acquire);
+        const uint64_t valid = h2 + 1 > cap ? h2 + 1 - cap : 0;
+        if (valid > lo) out.erase(out.begin(), out.begin() + ptrdiff_t(std::min(valid, h1) - lo));
+        return out;
+    }
+};
+
+class Registry {
+public:
+    static Registry& instance()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    ~Registry()
+    {
+        if (!exit_path_.empty()) {
+            if (const char* err = dump(exit_path_)) fprintf(stderr, "vectra trace : %s\n", err);
+        }
+    }
+
+    size_t capacity() const { return capacity_.load(); }
+
+    void set_capacity(size_t events)
+    {
+        size_t cap = 64;
+        while (cap < events && cap < (size_t(1) << 30)) cap <<= 1;
+        capacity_.store(cap);
+    }
+
+    std::shared_ptr<Ring> add_ring()
+    {
+        auto ring = std::make_shared<Ring>(capacity_.load(), current_tid());
+        std::lock_guard<std::mutex> lock(mutex_);
+        rings_.push_back(ring);
+        return ring;
+    }
+
+    // empties every ring, the rings of exited threads are released
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                    [](const std::shared_ptr<Ring>& r) { return !r->alive.load(); }),
+                     rings_.end());
+        for (auto& r : rings_) r->start.store(r->head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    std::string json();
+
+    const char* dump(const std::string& path)
+    {
+        const std::string text = json();
+        FILE* f = std::fopen(path.c_str(), "wb");
+        if (!f) return "cannot open the trace file";
+        const bool ok = std::fwrite(text.data(), 1, text.size(), f) == text.size();
+        return std::fclose(f) == 0 && ok ? nullptr : "cannot write the trace file";
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::shared_ptr<Ring>> rings_;
+    std::atomic<size_t> capacity_{ 16384 };
+    std::string exit_path_;
+
+    Registry()
+    {
+        if (const char* env = std::getenv("VECTRA_TRACE_EVENTS")) {
+            const long v = std::strtol(env, nullptr, 10);
+            if (v > 0) set_capacity(size_t(v));
+        }
+        if (const char* env = std::getenv("VECTRA_TRACE")) {
+            if (*env) {
+                exit_path_ = env;
+                epoch();
+                enabled_flag().store(true);
+            }
+        }
+    }
+};
+
+// ring of the calling thread, created on its first event
+inline Ring& thread_ring()
+{
+    struct Owner {
+        std::shared_ptr<Ring> ring = Registry::instance().add_ring();
+        ~Owner() { ring->alive.store(false); }
+    };
+    static thread_local Owner owner;
+    return *owner.ring;
+}
+
+inline void append_json_string(std::string& out, const char* s)
+{
+    out += '"';
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') out += '\\';
+        out += *s;
+    }
+    out += '"';
+}
+
+inline void append_shape(std::string& out, const Event& e, int k)
+{
+    out += '[';
+    const size_t kept = std::min<size_t>(e.ndim[k], TRACE_MAX_DIMS);
+    for (size_t d = 0; d < kept; ++d) {
+        if (d) out += ", ";
+        out += std::to_string(e.dims[k][d]);
+    }
+    if (e.ndim[k] > TRACE_MAX_DIMS) out += ", ...";
+    out += ']';
+}
+
+inline std::string Registry::json()
+{
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rings = rings_;
+    }
+
+#if defined(__linux__)
+    const long pid = long(getpid());
+#else
+    const long pid = 1;
+#endif
+
+    const Clock& clock = epoch();
+    const double scale = clock.ns_per_tick();
+    // ns since the start of the trace
+    auto ns = [&](uint64_t t) { return t > clock.tick0 ? double(t - clock.tick0) * scale : 0.0; };
+
+    std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool first = true;
+    char buf[160];
+
+    for (const auto& ring : rings) {
+        std::snprintf(buf, sizeof(buf), "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%ld,\"tid\":%ld,"
+                      "\"args\":{\"name\":\"vectra %ld\"}}", first ? "" : ",\n", pid, ring->tid, ring->tid);
+        out += buf;
+        first = false;
+
+        for (const Event& e : ring->snapshot()) {
+            // microseconds with ns digits
+            std::snprintf(buf, sizeof(buf), ",\n{\"ph\":\"X\",\"cat\":\"vectra\",\"pid\":%ld,\"tid\":%ld,\"ts\":%.3f,\"dur\":%.3f,\"name\":",
+                          pid, ring->tid, ns(e.start) * 1e-3, (ns(e.end) - ns(e.start)) * 1e-3);
+            out += buf;
+            append_json_string(out, e.name);
+            out += ",\"args\":{\"dtype\":";
+            append_json_string(out, e.dtype);
+            for (int k = 0; k < 2; ++k) {
+                if (e.ndim[k] == 0xff) continue;
+                out += k == 0 ? ",\"shape\":\"" : ",\"shape_b\":\"";
+                append_shape(out, e, k);
+                out += '"';
+            }
+            out += ",\"bytes\":";
+            out += std::to_string(e.bytes);
+            out += "}}";
+        }
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+// reads VECTRA_TRACE before main
+inline const bool env_read = (Registry::instance(), true);
+
+inline void fill_shape(Event& e, int k, const Shape* shape)
+{
+    if (!shape) {
+        e.ndim[k] = 0xff;
+        return;
+    }
+    e.ndim[k] = uint8_t(std::min<size_t>(shape->size(), 0xfe));
+    const size_t kept = std::min(shape->size(), TRACE_MAX_DIMS);
+    for (size_t d = 0; d < kept; ++d) e.dims[k][d] = (*shape)[d];
+}
+
+} // namespace detail
+
+/*
+ *
+ * Interface
+ *
+*/
+
+inline bool enabled() { return detail::enabled_flag().load(std::memory_order_relaxed); }
+
+inline void enable(bool on = true)
+{
+    detail::epoch();
+    detail::Registry::instance();
+    detail::enabled_flag().store(on, std::memory_order_relaxed);
+}
+
+inline void disable() { detail::enabled_flag().store(false, std::memory_order_relaxed); }
+
+// time stamp of an event (TSC ticks on x86, ns elsewhere)
+inline uint64_t now() { return detail::ticks(); }
+
+// events per thread ring, for the rings created afterwards (rounded up to a power of two)
+inline void set_capacity(size_t events) { detail::Registry::instance().set_capacity(events); }
+
+// forgets every recorded event
+inline void clear() { detail::Registry::instance().clear(); }
+
+// Chrome Trace Event JSON of the events held by the rings
+inline std::string json() { return detail::Registry::instance().json(); }
+
+// nullptr on success, the reason otherwise
+inline const char* dump(const std::string& path) { return detail::Registry::instance().dump(path); }
+
+// event of an op that ran over [start, now)
+inline void record(const char* name, const char* dtype, uint64_t start, uint64_t bytes,
+                   const Shape* shape_a, const Shape* shape_b)
+{
+    detail::Ring& ring = detail::thread_ring();
+    Event& e = ring.next();
+    e.name = name;
+    e.dtype = dtype;
+    e.start = start;
+    e.end = now();
+    e.bytes = bytes;
+    detail::fill_shape(e, 0, shape_a);
+    detail::fill_shape(e, 1, shape_b);
+    ring.publish();
+}
+
+} // namespace trace
+} // namespace vectra
+
+#endif // __cplusplus
+#endif // TRACE_H
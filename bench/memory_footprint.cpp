@@ -0,0 +1,78 @@
+/*
+ *
+ * memory_footprint.cpp (v1.0)
+ * 
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ * 
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ * 
+ * 
+ * Memory footprint benchmark of Tensor storage.
+ * Measure the bytes that one Tensor element requests from the allocator for every data type,
+ * it must be equal to sizeof(T) (packed storage).
+ * This file is a part of VECTRA framework
+ * 
+*/
+
+#include <cpu/TensorOps.h>
+#include <cstdio>
+#include <cstdlib>
+
+static constexpr size_t BENCH_ELEMENTS = size_t(1) << 24;   // 16M elements
+
+// Pass-through allocator that records the bytes requested by the Tensor storage
+class CountingAllocator : public utils::Allocator {
+public:
+    size_t live_bytes = 0;
+
+    void* allocate(size_t bytes, size_t alignment) override
+    {
+        live_bytes += bytes;
+        return utils::system_allocator().allocate(bytes, alignment);
+    }
+
+    void deallocate(void* ptr, size_t bytes, size_t alignment) override
+    {
+        live_bytes -= bytes;
+        utils::system_allocator().deallocate(ptr, bytes, alignment);
+    }
+};
+
+static CountingAllocator counter;
+
+template<typename T>
+static bool bench_footprint(const char* name)
+{
+    const size_t before = counter.live_bytes;
+
+    Tensor<T> t({ BENCH_ELEMENTS });
+
+    const size_t after = counter.live_bytes;
+
+    const double bytes_per_element = double(after - before) / double(t.numel());
+    const bool ok = bytes_per_element == double(sizeof(T));
+
+    printf("%-8s elements=%zu  sizeof(T)=%zu  bytes/element=%.4f  %s\n",
+           name, t.numel(), sizeof(T), bytes_per_element, ok ? "OK" : "FAIL");
+
+    return ok;
+}
+
+int main()
+{
+    bool ok = true;
+
+    utils::set_default_allocator(&counter);
+
+    ok &= bench_footprint<vectra::int8>("int8");
+    ok &= bench_footprint<vectra::int16>("int16");
+    ok &= bench_footprint<vectra::int32>("int32");
+    ok &= bench_footprint<vectra::float32>("float32");
+    ok &= bench_footprint<vectra::float64>("float64");
+
+    utils::set_default_allocator(nullptr);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,366 @@
+/*
+ *
+ * vectra_bench.cpp (v1.0)
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Throughput benchmark of the TensorOps kernels.
+ * Every op runs for every data type it supports, at working sets from L1-resident to DRAM-sized
+ * and at every requested thread count. A case reports the median time of one call, GB/s of the
+ * memory it must move (operands read + result written) and GFLOP/s (one operation per element,
+ * 2 n^3 for dot). flatten runs on a transposed view : the copy is the work.
+ *
+ *   vectra_bench [--json FILE] [--baseline FILE] [--threshold 0.10] [--threads 1,4]
+ *                [--filter OP] [--min-time SECONDS] [--quick]
+ *
+ * --json writes the results (one case per line), --baseline compares against an earlier --json
+ * file : a case slower than the baseline by more than the threshold is a regression and the
+ * exit status is 1.
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#include <cpu/TensorOps.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct BenchCase {
+    std::string op;
+    std::string dtype;
+    std::string level;          // working set : L1, L2, L3, DRAM
+    size_t numel = 0;
+    size_t threads = 1;
+    double ns = 0;              // median time of one call
+    double gflops = 0;
+    double gbps = 0;
+};
+
+struct BenchConfig {
+    std::vector<size_t> threads;
+    std::string filter;
+    std::string json;
+    std::string baseline;
+    double threshold = 0.10;
+    double min_time = 0.2;
+    bool quick = false;
+};
+
+// operand sizes of the working-set levels
+struct Level {
+    const char* name;
+    size_t bytes;
+};
+
+static const Level LEVELS[] = {
+    { "L1",   size_t(16) << 10 },
+    { "L2",   size_t(256) << 10 },
+    { "L3",   size_t(4) << 20 },
+    { "DRAM", size_t(64) << 20 },
+};
+
+static double now_ns()
+{
+    using clock = std::chrono::steady_clock;
+    return double(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count());
+}
+
+// median over batches of calls : a batch lasts about min_time / 8, there are at least 5 batches
+static double time_call(const std::function<void()>& fn, double min_time)
+{
+    fn();   // warm-up (page faults, dispatch)
+
+    double t0 = now_ns();
+    fn();
+    const double once = std::max(1.0, now_ns() - t0);
+    const size_t per_batch = std::max<size_t>(1, size_t(min_time * 1e9 / 8 / once));
+
+    std::vector<double> samples;
+    const double start = now_ns();
+    while (samples.size() < 5 || now_ns() - start < min_time * 1e9) {
+        t0 = now_ns();
+        for (size_t i = 0; i < per_batch; ++i) fn();
+        samples.push_back((now_ns() - t0) / double(per_batch));
+        if (samples.size() >= 1000) break;
+    }
+    std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+    return samples[samples.size() / 2];
+}
+
+template<typename T> const char* dtype_name();
+template<> const char* dtype_name<vectra::int16>()   { return "int16"; }
+template<> const char* dtype_name<vectra::int32>()   { return "int32"; }
+template<> const char* dtype_name<vectra::float32>() { return "float32"; }
+template<> const char* dtype_name<vectra::float64>() { return "float64"; }
+
+// values in [1, 2) : no overflow, no division by zero, exp stays finite
+template<typename T>
+static Tensor<T> operand(const Shape& shape)
+{
+    Tensor<T> t(shape);
+    T* dst = t.data();
+    for (size_t i = 0; i < t.numel(); ++i) dst[i] = static_cast<T>(1 + (i % 7) / 8.0);
+    return t;
+}
+
+class Bench {
+public:
+    explicit Bench(const BenchConfig& config) : config_(config) {}
+
+    std::vector<BenchCase> results;
+
+    template<typename T>
+    void run_dtype()
+    {
+        const bool is_float = std::is_floating_point<T>::value;
+
+        for (const Level& level : LEVELS) {
+            if (config_.quick && std::strcmp(level.name, "DRAM") == 0) continue;
+            const size_t n = level.bytes / sizeof(T);
+            const size_t sz = sizeof(T);
+            const Tensor<T> A = operand<T>({ n });
+            const Tensor<T> B = operand<T>({ n });
+
+            run<T>("add", level, n, 3 * n * sz, n, [&] { Tensor<T> r = add(A, B); });
+            run<T>("sub", level, n, 3 * n * sz, n, [&] { Tensor<T> r = sub(A, B); });
+            run<T>("mul", level, n, 3 * n * sz, n, [&] { Tensor<T> r = mul(A, B); });
+            run<T>("div", level, n, 3 * n * sz, n, [&] { Tensor<T> r = div(A, B); });
+            run<T>("sum", level, n, n * sz, n, [&] { Tensor<T> r = sum(A); });
+            run<T>("max", level, n, n * sz, n, [&] { Tensor<T> r = max(A); });
+
+            // rows x 64 viewed as 64 x rows : flatten gathers the transpose
+            const size_t rows = std::max<size_t>(1, n / 64);
+            const Tensor<T> M = operand<T>({ rows, 64 });
+            const Tensor<T> Mt = transpose(M, 0, 1);
+            run<T>("flatten", level, rows * 64, 2 * rows * 64 * sz, rows * 64, [&] { Tensor<T> r = flatten(Mt); });
+
+            if constexpr (std::is_floating_point<T>::value) {
+                run<T>("exp_tensor", level, n, 2 * n * sz, n, [&] { Tensor<T> r = exp_tensor(A); });
+                run<T>("rand", level, n, n * sz, n, [&] { Tensor<T> r = rand<T>({ n }); });
+                run<T>("randn", level, n, n * sz, n, [&] { Tensor<T> r = randn<T>({ n }); });
+            }
+
+            // square matrices with operands of the level size
+            size_t d = 8;
+            while ((d * 2) * (d * 2) * sz <= level.bytes) d *= 2;
+            d = std::min<size_t>(d, config_.quick ? 256 : is_float ? 2048 : 512);
+            const Tensor<T> X = operand<T>({ d, d });
+            const Tensor<T> Y = operand<T>({ d, d });
+            run<T>("dot", level, d * d, 3 * d * d * sz, 2 * d * d * d, [&] { Tensor<T> r = dot(X, Y); });
+        }
+    }
+
+private:
+    template<typename T, typename F>
+    void run(const char* op, const Level& level, size_t numel, size_t bytes, size_t flops, F&& fn)
+    {
+        if (!config_.filter.empty() && config_.filter != op) return;
+
+        for (size_t threads : config_.threads) {
+            utils::ThreadPool::instance().set_num_threads(threads);
+
+            BenchCase c;
+            c.op = op;
+            c.dtype = dtype_name<T>();
+            c.level = level.name;
+            c.numel = numel;
+            c.threads = threads;
+            c.ns = time_call(fn, config_.min_time);
+            c.gbps = double(bytes) / c.ns;
+            c.gflops = double(flops) / c.ns;
+
+            printf("%-10s %-8s %-5s n=%-10zu threads=%-3zu %12.1f ns %9.2f GB/s %9.2f GFLOP/s\n",
+                   c.op.c_str(), c.dtype.c_str(), c.level.c_str(), c.numel, c.threads, c.ns, c.gbps, c.gflops);
+            fflush(stdout);
+            results.push_back(c);
+        }
+    }
+
+    const BenchConfig& config_;
+};
+
+/*
+ *
+ * JSON : one case per line, so that the baseline reader only has to look up keys in a line
+ *
+*/
+
+static std::string case_key(const BenchCase& c)
+{
+    return c.op + "/" + c.dtype + "/" + c.level + "/" + std::to_string(c.threads);
+}
+
+static bool write_json(const std::string& path, const std::vector<BenchCase>& results)
+{
+    FILE* f = fopen(path.c_str(), "w");
+    if (!f) return false;
+
+    fprintf(f, "{\n  \"isa\": \"%s\",\n  \"hardware_threads\": %u,\n  \"results\": [\n",
+            vectra::kernel::isa_name(vectra::kernel::active_isa()), std::thread::hardware_concurrency());
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchCase& c = results[i];
+        fprintf(f, "    {\"op\": \"%s\", \"dtype\": \"%s\", \"level\": \"%s\", \"numel\": %zu, \"threads\": %zu, "
+                   "\"ns\": %.1f, \"gbps\": %.3f, \"gflops\": %.3f}%s\n",
+                c.op.c_str(), c.dtype.c_str(), c.level.c_str(), c.numel, c.threads, c.ns, c.gbps, c.gflops,
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    return fclose(f) == 0;
+}
+
+// "key": "text" or "key": number inside one line
+static bool json_field(const std::string& line, const char* key, std::string& value)
+{
+    const std::string k = std::string("\"") + key + "\"";
+    size_t at = line.find(k);
+    if (at == std::string::npos) return false;
+    at = line.find(':', at + k.size());
+    if (at == std::string::npos) return false;
+    ++at;
+    while (at < line.size() && line[at] == ' ') ++at;
+
+    if (at < line.size() && line[at] == '"') {
+        const size_t end = line.find('"', at + 1);
+        if (end == std::string::npos) return false;
+        value = line.substr(at + 1, end - at - 1);
+        return true;
+    }
+    const size_t end = line.find_first_of(",}", at);
+    value = line.substr(at, end == std::string::npos ? std::string::npos : end - at);
+    return true;
+}
+
+static bool read_json(const std::string& path, std::vector<BenchCase>& out)
+{
+    std::ifstream in(path);
+    if (!in) return false;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        BenchCase c;
+        std::string ns, threads;
+        if (!json_field(line, "op", c.op) || !json_field(line, "dtype", c.dtype) || !json_field(line, "level", c.level) ||
+            !json_field(line, "threads", threads) || !json_field(line, "ns", ns))
+            continue;
+        c.threads = size_t(std::strtoul(threads.c_str(), nullptr, 10));
+        c.ns = std::strtod(ns.c_str(), nullptr);
+        out.push_back(c);
+    }
+    return true;
+}
+
+// number of regressions (cases missing from the baseline are reported, not counted)
+static size_t compare(const std::vector<BenchCase>& results, const std::vector<BenchCase>& baseline, double threshold)
+{
+    size_t regressions = 0, improvements = 0, missing = 0;
+
+    printf("\n%-36s %12s %12s %8s\n", "case", "baseline ns", "ns", "change");
+    for (const BenchCase& c : results) {
+        const std::string key = case_key(c);
+        const BenchCase* base = nullptr;
+        for (const BenchCase& b : baseline) {
+            if (case_key(b) == key) {
+                base = &b;
+                break;
+            }
+        }
+        if (!base || base->ns <= 0) {
+            ++missing;
+            continue;
+        }
+
+        const double change = c.ns / base->ns - 1;
+        const char* flag = "";
+        if (change > threshold) {
+            flag = "  REGRESSION";
+            ++regressions;
+        }
+        else if (change < -threshold) {
+            flag = "  faster";
+            ++improvements;
+        }
+        printf("%-36s %12.1f %12.1f %+7.1f%%%s\n", key.c_str(), base->ns, c.ns, 100 * change, flag);
+    }
+
+    printf("\n%zu regressions, %zu improvements beyond %.0f%%, %zu cases not in the baseline\n",
+           regressions, improvements, 100 * threshold, missing);
+    return regressions;
+}
+
+static std::vector<size_t> parse_threads(const char* list)
+{
+    std::vector<size_t> out;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        const size_t n = size_t(std::strtoul(item.c_str(), nullptr, 10));
+        if (n) out.push_back(n);
+    }
+    return out;
+}
+
+int main(int argc, char** argv)
+{
+    BenchConfig config;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+
+        if (arg == "--json" && has_value) config.json = argv[++i];
+        else if (arg == "--baseline" && has_value) config.baseline = argv[++i];
+        else if (arg == "--threshold" && has_value) config.threshold = std::strtod(argv[++i], nullptr);
+        else if (arg == "--threads" && has_value) config.threads = parse_threads(argv[++i]);
+        else if (arg == "--filter" && has_value) config.filter = argv[++i];
+        else if (arg == "--min-time" && has_value) config.min_time = std::strtod(argv[++i], nullptr);
+        else if (arg == "--quick") config.quick = true;
+        else {
+            fprintf(stderr, "usage : vectra_bench [--json FILE] [--baseline FILE] [--threshold 0.10] [--threads 1,4] "
+                            "[--filter OP] [--min-time SECONDS] [--quick]\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    // one thread and every thread of the pool
+    if (config.threads.empty()) {
+        config.threads.push_back(1);
+        const size_t all = utils::ThreadPool::instance().num_threads();
+        if (all > 1) config.threads.push_back(all);
+    }
+    if (config.quick) config.min_time = std::min(config.min_time, 0.05);
+
+    printf("vectra_bench : isa %s\n", vectra::kernel::isa_name(vectra::kernel::active_isa()));
+
+    Bench bench(config);
+    bench.run_dtype<vectra::int16>();
+    bench.run_dtype<vectra::int32>();
+    bench.run_dtype<vectra::float32>();
+    bench.run_dtype<vectra::float64>();
+
+    if (!config.json.empty() && !write_json(config.json, bench.results)) {
+        fprintf(stderr, "vectra_bench : cannot write %s\n", config.json.c_str());
+        return EXIT_FAILURE;
+    }
+
+    if (!config.baseline.empty()) {
+        std::vector<BenchCase> baseline;
+        if (!read_json(config.baseline, baseline)) {
+            fprintf(stderr, "vectra_bench : cannot read %s\n", config.baseline.c_str());
+            return EXIT_FAILURE;
+        }
+        if (compare(bench.results, baseline, config.threshold) > 0) return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
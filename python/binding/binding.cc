@@ -1,106 +1,675 @@
 // binding.cpp
+#include <string>
 #include <sstream>
 #include <vector>
+#include <map>
 #include <iterator>
+#include <memory>
+#include <cstdint>
+#include <type_traits>
+#include <exception>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
 #include <cpu/TensorOps.h>
+#include <cpu/AnyTensor.h>
+#include <cpu/Npy.h>
 #include <ScalarType/ScalarType.h>
 
 namespace py = pybind11;
 
-template <typename T>
-void bind_tensor(py::module_& m, const char* name)
+// Shape <-> list of ints (a tuple or any sequence is accepted), like std::vector<size_t>
+namespace pybind11 {
+namespace detail {
+template<> struct type_caster<Shape> : list_caster<Shape, size_t> {};
+} // namespace detail
+} // namespace pybind11
+
+/*
+ *
+ * DLPack ABI (the unversioned "dltensor" capsule of __dlpack__ / from_dlpack)
+ *
+*/
+
+namespace dlpack {
+
+constexpr int32_t kDLCPU = 1;
+constexpr uint8_t kDLInt = 0;
+constexpr uint8_t kDLFloat = 2;
+
+struct DLDevice {
+    int32_t device_type;
+    int32_t device_id;
+};
+
+struct DLDataType {
+    uint8_t code;
+    uint8_t bits;
+    uint16_t lanes;
+};
+
+struct DLTensor {
+    void* data;
+    DLDevice device;
+    int32_t ndim;
+    DLDataType dtype;
+    int64_t* shape;
+    int64_t* strides;          // in elements, null for a compact row-major tensor
+    uint64_t byte_offset;
+};
+
+struct DLManagedTensor {
+    DLTensor dl_tensor;
+    void* manager_ctx;
+    void (*deleter)(DLManagedTensor* self);
+};
+
+} // namespace dlpack
+
+/*
+ *
+ * Zero-copy exchange : a Tensor exports its storage (buffer protocol, __dlpack__), an imported
+ * array becomes the adopted storage of a Tensor (from_blob) that keeps the producer alive
+ *
+*/
+
+// buffer of a Tensor : lazy constants are materialized first, so the memory never moves later
+template<typename T>
+py::buffer_info tensor_buffer(Tensor<T>& t)
+{
+    T* data = t.data();
+    std::vector<py::ssize_t> shape(t.shape.begin(), t.shape.end());
+    std::vector<py::ssize_t> strides;
+    for (size_t s : t.strides) strides.push_back(py::ssize_t(s * sizeof(T)));
+
+    return py::buffer_info(data, sizeof(T), py::format_descriptor<T>::format(), py::ssize_t(t.ndim()), shape, strides);
+}
+
+// a capsule owns the export until a consumer renames it, then the consumer calls the deleter
+template<typename T>
+struct DLExport {
+    dlpack::DLManagedTensor managed;
+    Tensor<T> tensor;
+    std::vector<int64_t> shape;
+    std::vector<int64_t> strides;
+};
+
+template<typename T>
+py::capsule tensor_dlpack(Tensor<T>& t)
 {
-    using TensorT = Tensor<T>;
+    T* data = t.data();
+    auto* ex = new DLExport<T>{};
+    ex->tensor = t;
+    ex->shape.assign(t.shape.begin(), t.shape.end());
+    ex->strides.assign(t.strides.begin(), t.strides.end());
 
-    py::class_<TensorT>(m, name)
-        .def(py::init<const std::vector<size_t>&>(), py::arg("shape"))
+    dlpack::DLTensor& dl = ex->managed.dl_tensor;
+    dl.data = data;
+    dl.device = { dlpack::kDLCPU, 0 };
+    dl.ndim = int32_t(t.ndim());
+    dl.dtype = { std::is_floating_point_v<T> ? dlpack::kDLFloat : dlpack::kDLInt, uint8_t(8 * sizeof(T)), 1 };
+    dl.shape = ex->shape.data();
+    dl.strides = ex->strides.data();
+    dl.byte_offset = 0;
+    ex->managed.manager_ctx = ex;
+    ex->managed.deleter = [](dlpack::DLManagedTensor* self) { delete static_cast<DLExport<T>*>(self->manager_ctx); };
 
-        .def_property_readonly("shape", [](const TensorT& t) {
-            return t.shape;
-        })
+    PyObject* cap = PyCapsule_New(&ex->managed, "dltensor", [](PyObject* c) {
+        if (!PyCapsule_IsValid(c, "dltensor")) return;    // consumed
+        auto* m = static_cast<dlpack::DLManagedTensor*>(PyCapsule_GetPointer(c, "dltensor"));
+        m->deleter(m);
+    });
+    if (!cap) {
+        ex->managed.deleter(&ex->managed);
+        throw py::error_already_set();
+    }
+    return py::reinterpret_steal<py::capsule>(cap);
+}
+
+// element strides of a byte-strided buffer, false when one is negative or not a multiple of T
+template<typename T>
+bool element_strides(const py::buffer_info& info, Shape& strides)
+{
+    strides.resize(size_t(info.ndim));
+    for (py::ssize_t d = 0; d < info.ndim; ++d) {
+        if (info.strides[d] < 0 || info.strides[d] % py::ssize_t(sizeof(T))) return false;
+        strides[d] = size_t(info.strides[d]) / sizeof(T);
+    }
+    return true;
+}
+
+// packed copy of any buffer layout (read-only or negative-strided arrays)
+template<typename T>
+Tensor<T> copy_buffer(const py::buffer_info& info, const Shape& shape)
+{
+    Tensor<T> out(shape);
+    T* dst = out.data();
+    const size_t n = out.numel();
+    Shape idx(shape.size(), 0);
+
+    for (size_t i = 0; i < n; ++i) {
+        const char* src = static_cast<const char*>(info.ptr);
+        for (size_t d = 0; d < shape.size(); ++d) src += py::ssize_t(idx[d]) * info.strides[d];
+        std::memcpy(dst + i, src, sizeof(T));
+
+        for (size_t d = shape.size(); d-- > 0;) {
+            if (++idx[d] < shape[d]) break;
+            idx[d] = 0;
+        }
+    }
+    return out;
+}
+
+template<typename T>
+py::object buffer_tensor(py::buffer_info info, bool writable)
+{
+    const Shape shape(info.shape.begin(), info.shape.end());
+    Shape strides;
+    if (!writable || !element_strides<T>(info, strides)) return py::cast(vectra::AnyTensor(copy_buffer<T>(info, shape)));
+
+    // the view (and so the exporting array) is released with the last tensor sharing the storage
+    T* data = static_cast<T*>(info.ptr);
+    std::shared_ptr<void> owner(new py::buffer_info(std::move(info)), [](py::buffer_info* view) {
+        py::gil_scoped_acquire gil;
+        delete view;
+    });
+    return py::cast(vectra::AnyTensor(from_blob<T>(data, shape, strides, std::move(owner))));
+}
+
+// native little-endian item of the size of T
+template<typename T>
+bool buffer_holds(const py::buffer_info& info)
+{
+    if (info.itemsize != py::ssize_t(sizeof(T))) return false;
+
+    std::string f = info.format;
+    if (!f.empty() && (f[0] == '<' || f[0] == '=' || f[0] == '@')) f.erase(0, 1);
+    if (f.size() != 1) return false;
+
+    if constexpr (std::is_floating_point_v<T>) return f[0] == 'f' || f[0] == 'd';
+    else return f[0] == 'h' || f[0] == 'i' || f[0] == 'l' || f[0] == 'q';
+}
+
+// Tensor over a NumPy array (or any buffer) : shared when writable with element strides, copied otherwise
+py::object from_buffer(const py::buffer& b)
+{
+    py::buffer_info info;
+    bool writable = true;
+    try {
+        info = b.request(true);
+    }
+    catch (py::error_already_set&) {
+        info = b.request();
+        writable = false;
+    }
+
+    if (buffer_holds<vectra::float32>(info)) return buffer_tensor<vectra::float32>(std::move(info), writable);
+    if (buffer_holds<vectra::float64>(info)) return buffer_tensor<vectra::float64>(std::move(info), writable);
+    if (buffer_holds<vectra::int32>(info))   return buffer_tensor<vectra::int32>(std::move(info), writable);
+    if (buffer_holds<vectra::int16>(info))   return buffer_tensor<vectra::int16>(std::move(info), writable);
+    throw py::type_error("vectra from_numpy() : unsupported item format \"" + info.format +
+                         "\" (int16, int32, float32, float64)");
+}
+
+template<typename T>
+py::object dlpack_tensor(dlpack::DLManagedTensor* m, PyObject* cap)
+{
+    const dlpack::DLTensor& dl = m->dl_tensor;
+    Shape shape(size_t(dl.ndim));
+    Shape strides(size_t(dl.ndim));
+
+    size_t step = 1;
+    for (int32_t d = dl.ndim; d-- > 0;) {
+        const int64_t s = dl.strides ? dl.strides[d] : int64_t(step);
+        if (s < 0) throw py::value_error("vectra from_dlpack() : negative strides are not supported");
+        shape[d] = size_t(dl.shape[d]);
+        strides[d] = size_t(s);
+        step *= shape[d];
+    }
+
+    // consumed : the producer's deleter runs with the last tensor sharing the memory
+    PyCapsule_SetName(cap, "used_dltensor");
+    std::shared_ptr<void> owner(m, [](dlpack::DLManagedTensor* p) {
+        py::gil_scoped_acquire gil;
+        if (p->deleter) p->deleter(p);
+    });
+
+    T* data = reinterpret_cast<T*>(static_cast<char*>(dl.data) + dl.byte_offset);
+    return py::cast(vectra::AnyTensor(from_blob<T>(data, shape, strides, std::move(owner))));
+}
 
-        .def("to_list", [](const TensorT& t) {
-            std::vector<T> out;
-            out.reserve(t.data.size());
-            for (size_t i = 0; i < t.data.size(); ++i)
-                out.push_back(t.data.data[i].get_scalar());
-            return out;
+// Tensor sharing the memory of an object with __dlpack__ (or of a "dltensor" capsule)
+py::object from_dlpack(const py::object& obj)
+{
+    const py::object cap = py::hasattr(obj, "__dlpack__") ? obj.attr("__dlpack__")() : obj;
+    if (!PyCapsule_IsValid(cap.ptr(), "dltensor"))
+        throw py::type_error("vectra from_dlpack() : expected an object with __dlpack__ or a \"dltensor\" capsule");
+
+    auto* m = static_cast<dlpack::DLManagedTensor*>(PyCapsule_GetPointer(cap.ptr(), "dltensor"));
+    const dlpack::DLTensor& dl = m->dl_tensor;
+    if (dl.device.device_type != dlpack::kDLCPU)
+        throw py::value_error("vectra from_dlpack() : only CPU memory can be shared");
+
+    const uint8_t code = dl.dtype.code;
+    const uint8_t bits = dl.dtype.bits;
+    if (dl.dtype.lanes == 1) {
+        if (code == dlpack::kDLFloat && bits == 32) return dlpack_tensor<vectra::float32>(m, cap.ptr());
+        if (code == dlpack::kDLFloat && bits == 64) return dlpack_tensor<vectra::float64>(m, cap.ptr());
+        if (code == dlpack::kDLInt && bits == 32)   return dlpack_tensor<vectra::int32>(m, cap.ptr());
+        if (code == dlpack::kDLInt && bits == 16)   return dlpack_tensor<vectra::int16>(m, cap.ptr());
+    }
+    throw py::type_error("vectra from_dlpack() : unsupported dtype (int16, int32, float32, float64)");
+}
+
+/*
+ *
+ * Python Tensor : one class over vectra::AnyTensor, the dtype is a runtime tag and every call
+ * switches on it once in C++ (AnyTensor.h). Ops on large tensors release the GIL
+ *
+*/
+
+using vectra::AnyTensor;
+using vectra::DType;
+
+// below this many elements the op costs less than handing the GIL over
+constexpr size_t NOGIL_MIN_NUMEL = size_t(1) << 14;
+
+class nogil_if {
+public:
+    explicit nogil_if(size_t numel)
+    {
+        if (numel >= NOGIL_MIN_NUMEL) state_ = PyEval_SaveThread();
+    }
+    ~nogil_if()
+    {
+        if (state_) PyEval_RestoreThread(state_);
+    }
+    nogil_if(const nogil_if&) = delete;
+    nogil_if& operator=(const nogil_if&) = delete;
+
+private:
+    PyThreadState* state_ = nullptr;
+};
+
+// the dispatcher of AnyTensor.h exits on these, Python gets an exception instead
+void check_same_dtype(const char* name, const AnyTensor& a, const AnyTensor& b)
+{
+    if (a.dtype() != b.dtype())
+        throw py::type_error(std::string("vectra ") + name + "() : dtype mismatch (" +
+                             vectra::dtype_name(a.dtype()) + " and " + vectra::dtype_name(b.dtype()) + ")");
+}
+
+void check_floating(const char* name, DType dtype)
+{
+    if (!vectra::is_floating(dtype))
+        throw py::type_error(std::string("vectra ") + name + "() : only float32 and float64 are supported, got " +
+                             vectra::dtype_name(dtype));
+}
+
+template<AnyTensor (*Op)(const AnyTensor&, const AnyTensor&)>
+AnyTensor binary_op(const char* name, const AnyTensor& a, const AnyTensor& b)
+{
+    check_same_dtype(name, a, b);
+    nogil_if nogil(std::max(a.numel(), b.numel()));
+    return Op(a, b);
+}
+
+py::buffer_info any_buffer(AnyTensor& t)
+{
+    return t.visit([](auto& x) { return tensor_buffer(x); });
+}
+
+/*
+ *
+ * Asynchronous ops : the op runs on a worker of the thread pool without the GIL and completes a
+ * concurrent.futures.Future (asyncio.wrap_future() makes it awaitable). The operands are copied
+ * into the task, so they stay alive until the op is done
+ *
+*/
+
+template<AnyTensor (*Op)(const AnyTensor&, const AnyTensor&)>
+py::object binary_async(const char* name, const AnyTensor& a, const AnyTensor& b)
+{
+    check_same_dtype(name, a, b);
+
+    py::object future = py::module_::import("concurrent.futures").attr("Future")();
+    future.attr("set_running_or_notify_cancel")();
+
+    // released by the task, under the GIL
+    auto* pending = new py::object(future);
+    {
+        py::gil_scoped_release release;
+        utils::submit([a, b, pending] {
+            AnyTensor result;
+            std::string error;
+            const char* kind = "RuntimeError";
+            try { result = Op(a, b); }
+            catch (const std::bad_alloc& e) { error = e.what(); kind = "MemoryError"; }
+            catch (const std::exception& e) { error = e.what(); }
+
+            py::gil_scoped_acquire acquire;
+            if (error.empty()) pending->attr("set_result")(py::cast(std::move(result)));
+            else pending->attr("set_exception")(py::module_::import("builtins").attr(kind)(error));
+            delete pending;
+        });
+    }
+    return future;
+}
+
+void bind_tensor(py::module_& m)
+{
+    py::class_<AnyTensor>(m, "Tensor", py::buffer_protocol())
+        // np.asarray(t) shares the storage, writes are seen on both sides
+        .def_buffer(&any_buffer)
+        .def("numpy", [](py::object self) {
+            return py::module_::import("numpy").attr("asarray")(self);
+        })
+        // stream / max_version / copy of the consumer are accepted, the export is always a CPU view
+        .def("__dlpack__", [](AnyTensor& t, py::args, py::kwargs) {
+            return t.visit([](auto& x) { return tensor_dlpack(x); });
+        })
+        .def("__dlpack_device__", [](const AnyTensor&) {
+            return py::make_tuple(dlpack::kDLCPU, 0);
         })
 
-        .def("__add__", [](const TensorT& a, const TensorT& b) {
-            return add<T>(a, b);
+        .def_property_readonly("dtype", &AnyTensor::dtype)
+        .def_property_readonly("shape", &AnyTensor::shape)
+        .def_property_readonly("strides", &AnyTensor::strides)
+        .def_property_readonly("ndim", &AnyTensor::ndim)
+        .def_property_readonly("itemsize", &AnyTensor::itemsize)
+        .def("numel", &AnyTensor::numel)
+        .def("__len__", [](const AnyTensor& t) {
+            return t.ndim() ? t.shape()[0] : size_t(0);
         })
-        .def("__sub__", [](const TensorT& a, const TensorT& b) {
-            return sub<T>(a, b);
+
+        .def("to_list", [](const AnyTensor& t) {
+            return t.visit([](const auto& x) {
+                using T = decltype(vectra::detail::element_of(x));
+                std::vector<T> values;
+                {
+                    nogil_if nogil(x.numel());
+                    const Tensor<T> src = contiguous(x);
+                    values.assign(src.data(), src.data() + src.numel());
+                }
+                return py::cast(values);
+            });
         })
-        .def("__mul__", [](const TensorT& a, const TensorT& b) {
-            return mul<T>(a, b);
+
+        .def("is_contiguous", &AnyTensor::is_contiguous)
+        .def("contiguous", [](const AnyTensor& t) {
+            nogil_if nogil(t.numel());
+            return contiguous(t);
         })
-        .def("__divide__", [](const TensorT& a, const TensorT& b) {
-            return div<T>(a, b);
+        .def("reshape", [](const AnyTensor& t, const Shape& shape) {
+            nogil_if nogil(t.is_contiguous() ? 0 : t.numel());
+            return reshape(t, shape);
+        }, py::arg("shape"))
+        .def("flatten", [](const AnyTensor& t) {
+            nogil_if nogil(t.is_contiguous() ? 0 : t.numel());
+            return flatten(t);
         })
+        .def("transpose", [](const AnyTensor& t, size_t dim0, size_t dim1) {
+            return transpose(t, dim0, dim1);
+        }, py::arg("dim0"), py::arg("dim1"))
+        .def("permute", [](const AnyTensor& t, const std::vector<size_t>& dims) {
+            return permute(t, dims);
+        }, py::arg("dims"))
+        .def("slice", [](const AnyTensor& t, size_t dim, size_t start, size_t end, size_t step) {
+            return slice(t, dim, start, end, step);
+        }, py::arg("dim"), py::arg("start"), py::arg("end"), py::arg("step") = 1)
+        .def("expand", [](const AnyTensor& t, const Shape& shape) {
+            return expand(t, shape);
+        }, py::arg("shape"))
+        .def("unsqueeze", [](const AnyTensor& t, size_t dim) {
+            return unsqueeze(t, dim);
+        }, py::arg("dim"))
+        .def("squeeze", [](const AnyTensor& t, py::object dim) {
+            return dim.is_none() ? squeeze(t) : squeeze(t, dim.cast<size_t>());
+        }, py::arg("dim") = py::none())
+
+        .def("save", [](const AnyTensor& t, const std::string& path) {
+            py::gil_scoped_release release;
+            vectra::save(path, t);
+        }, py::arg("path"))
 
-        .def("__repr__", [](const TensorT& t) {
+        .def("__add__", [](const AnyTensor& a, const AnyTensor& b) { return binary_op<&add>("add", a, b); })
+        .def("__sub__", [](const AnyTensor& a, const AnyTensor& b) { return binary_op<&sub>("sub", a, b); })
+        .def("__mul__", [](const AnyTensor& a, const AnyTensor& b) { return binary_op<&mul>("mul", a, b); })
+        .def("__truediv__", [](const AnyTensor& a, const AnyTensor& b) { return binary_op<&div>("div", a, b); })
+        .def("__matmul__", [](const AnyTensor& a, const AnyTensor& b) { return binary_op<&dot>("dot", a, b); })
+
+        .def("__repr__", [](const AnyTensor& t) {
             std::ostringstream oss;
-            oss << t;
+            t.visit([&](const auto& x) { oss << x; });
             return oss.str();
         });
 }
 
+// f(t) of any dtype, the GIL is released for large tensors
+#define VECTRA_DEF_UNARY(name, op)                                          \
+    m.def(name, [](const AnyTensor& t) {                                    \
+        nogil_if nogil(t.numel());                                          \
+        return op(t);                                                       \
+    }, py::arg("t"))
+
+// whole-tensor reduction (axes empty) or along axes
+#define VECTRA_DEF_REDUCE(name, op)                                         \
+    m.def(name, [](const AnyTensor& t, const std::vector<size_t>& axes, bool keepdims) { \
+        nogil_if nogil(t.numel());                                          \
+        return axes.empty() ? op(t) : op(t, axes, keepdims);                \
+    }, py::arg("t"), py::arg("axes") = std::vector<size_t>{}, py::arg("keepdims") = false)
 
 PYBIND11_MODULE(tensor_ops, m)
 {
-    m.doc() = "Tensor operations";
+    py::enum_<DType>(m, "DType")
+        .value("int16", DType::Int16)
+        .value("int32", DType::Int32)
+        .value("float32", DType::Float32)
+        .value("float64", DType::Float64);
+
+    bind_tensor(m);
 
-    bind_tensor<vectra::int16>(m, "TensorInt16");
-    bind_tensor<vectra::int32>(m, "TensorInt32");
-    bind_tensor<vectra::float32>(m, "TensorFloat32");
-    bind_tensor<vectra::float64>(m, "TensorFloat64");
+    // factories : lazy constants cost nothing, rand / randn fill without the GIL
+    m.def("full", [](const Shape& shape, double value, DType dtype) {
+        return full(shape, value, dtype);
+    }, py::arg("shape"), py::arg("value"), py::arg("dtype") = DType::Float32);
+    m.def("zeros", [](const Shape& shape, DType dtype) {
+        return zeros(shape, dtype);
+    }, py::arg("shape"), py::arg("dtype") = DType::Float32);
+    m.def("ones", [](const Shape& shape, DType dtype) {
+        return ones(shape, dtype);
+    }, py::arg("shape"), py::arg("dtype") = DType::Float32);
+    m.def("twos", [](const Shape& shape, DType dtype) {
+        return twos(shape, dtype);
+    }, py::arg("shape"), py::arg("dtype") = DType::Float32);
+    m.def("rand", [](const Shape& shape, DType dtype) {
+        check_floating("rand", dtype);
+        nogil_if nogil(shape_numel(shape));
+        return rand(shape, dtype);
+    }, py::arg("shape"), py::arg("dtype") = DType::Float32);
+    m.def("randn", [](const Shape& shape, DType dtype) {
+        check_floating("randn", dtype);
+        nogil_if nogil(shape_numel(shape));
+        return randn(shape, dtype);
+    }, py::arg("shape"), py::arg("dtype") = DType::Float32);
 
-    m.def("vectra_full_int16",   &full<vectra::int16>);
-    m.def("vectra_full_int32",   &full<vectra::int32>);
-    m.def("vectra_full_float32", &full<vectra::float32>);
-    m.def("vectra_full_float64", &full<vectra::float64>);
+    m.def("add", [](const AnyTensor& a, const AnyTensor& b) { return binary_op<&add>("add", a, b); });
+    m.def("sub", [](const AnyTensor& a, const AnyTensor& b) { return binary_op<&sub>("sub", a, b); });
+    m.def("mul", [](const AnyTensor& a, const AnyTensor& b) { return binary_op<&mul>("mul", a, b); });
+    m.def("div", [](const AnyTensor& a, const AnyTensor& b) { return binary_op<&div>("div", a, b); });
+    m.def("dot", [](const AnyTensor& a, const AnyTensor& b) {
+        check_same_dtype("dot", a, b);
+        nogil_if nogil(a.numel() * (b.ndim() ? b.shape().back() : 1));
+        return dot(a, b);
+    });
+    m.def("pow", [](const AnyTensor& a, const AnyTensor& b) {
+        return binary_op<static_cast<AnyTensor (*)(const AnyTensor&, const AnyTensor&)>(&pow_tensor)>("pow", a, b);
+    });
+    m.def("pow", [](const AnyTensor& a, double exponent) {
+        nogil_if nogil(a.numel());
+        return pow_tensor(a, exponent);
+    });
 
-    m.def("vectra_zeros_int16",   &zeros<vectra::int16>);
-    m.def("vectra_zeros_int32",   &zeros<vectra::int32>);
-    m.def("vectra_zeros_float32", &zeros<vectra::float32>);
-    m.def("vectra_zeros_float64", &zeros<vectra::float64>);
+    VECTRA_DEF_REDUCE("sum", sum);
+    VECTRA_DEF_REDUCE("prod", prod);
+    VECTRA_DEF_REDUCE("max", max);
+    VECTRA_DEF_REDUCE("min", min);
+    VECTRA_DEF_REDUCE("mean", mean);
 
-    m.def("vectra_ones_int16",   &ones<vectra::int16>);
-    m.def("vectra_ones_int32",   &ones<vectra::int32>);
-    m.def("vectra_ones_float32", &ones<vectra::float32>);
-    m.def("vectra_ones_float64", &ones<vectra::float64>);
+    m.def("argmax", [](const AnyTensor& t, py::object axis, bool keepdims) {
+        const bool whole = axis.is_none();
+        const size_t ax = whole ? 0 : axis.cast<size_t>();
+        nogil_if nogil(t.numel());
+        return whole ? argmax(t) : argmax(t, ax, keepdims);
+    }, py::arg("t"), py::arg("axis") = py::none(), py::arg("keepdims") = false);
+    m.def("argmin", [](const AnyTensor& t, py::object axis, bool keepdims) {
+        const bool whole = axis.is_none();
+        const size_t ax = whole ? 0 : axis.cast<size_t>();
+        nogil_if nogil(t.numel());
+        return whole ? argmin(t) : argmin(t, ax, keepdims);
+    }, py::arg("t"), py::arg("axis") = py::none(), py::arg("keepdims") = false);
 
-    m.def("vectra_rand_float32", &rand<vectra::float32>);
-    m.def("vectra_rand_float64", &rand<vectra::float64>);
+    VECTRA_DEF_UNARY("exp", exp_tensor);
+    VECTRA_DEF_UNARY("log", log_tensor);
+    VECTRA_DEF_UNARY("log1p", log1p_tensor);
+    VECTRA_DEF_UNARY("tanh", tanh_tensor);
+    VECTRA_DEF_UNARY("sigmoid", sigmoid_tensor);
+    VECTRA_DEF_UNARY("erf", erf_tensor);
+    VECTRA_DEF_UNARY("sqrt", sqrt_tensor);
+    VECTRA_DEF_UNARY("rsqrt", rsqrt_tensor);
+    VECTRA_DEF_UNARY("flatten", flatten);
 
-    m.def("vectra_randn_float32", &randn<vectra::float32>);
-    m.def("vectra_randn_float64", &randn<vectra::float64>);
+    // asynchronous variants : return a concurrent.futures.Future of the result
+    m.def("add_async", [](const AnyTensor& a, const AnyTensor& b) { return binary_async<&add>("add", a, b); });
+    m.def("sub_async", [](const AnyTensor& a, const AnyTensor& b) { return binary_async<&sub>("sub", a, b); });
+    m.def("mul_async", [](const AnyTensor& a, const AnyTensor& b) { return binary_async<&mul>("mul", a, b); });
+    m.def("div_async", [](const AnyTensor& a, const AnyTensor& b) { return binary_async<&div>("div", a, b); });
+    m.def("dot_async", [](const AnyTensor& a, const AnyTensor& b) { return binary_async<&dot>("dot", a, b); });
 
-    m.def("vectra_add_int16",   &add<vectra::int16>);
-    m.def("vectra_add_int32",   &add<vectra::int32>);
-    m.def("vectra_add_float32", &add<vectra::float32>);
-    m.def("vectra_add_float64", &add<vectra::float64>);
+    // zero-copy import (the dtype follows the array)
+    m.def("from_buffer", &from_buffer, py::arg("array"));
+    m.def("from_dlpack", &from_dlpack, py::arg("obj"));
 
-    m.def("vectra_sub_int16",   &sub<vectra::int16>);
-    m.def("vectra_sub_int32",   &sub<vectra::int32>);
-    m.def("vectra_sub_float32", &sub<vectra::float32>);
-    m.def("vectra_sub_float64", &sub<vectra::float64>);
+    // tensor files (TensorFile.h) : load maps the file, nothing is read until an op touches it
+    m.def("load", [](const std::string& path) {
+        AnyTensor t;
+        const char* err;
+        {
+            py::gil_scoped_release release;
+            err = vectra::load_tensor(path, t);
+        }
+        if (err) throw py::value_error("vectra load() : " + path + " : " + err);
+        return t;
+    }, py::arg("path"));
+    m.def("save", [](const std::string& path, const AnyTensor& t) {
+        py::gil_scoped_release release;
+        vectra::save(path, t);
+    }, py::arg("path"), py::arg("t"));
 
-    m.def("vectra_mul_int16",   &mul<vectra::int16>);
-    m.def("vectra_mul_int32",   &mul<vectra::int32>);
-    m.def("vectra_mul_float32", &mul<vectra::float32>);
-    m.def("vectra_mul_float64", &mul<vectra::float64>);
+    // NumPy files without NumPy (Npy.h) : mmap=True and stored .npz members share the file pages
+    m.def("load_npy", [](const std::string& path, bool mmap) {
+        AnyTensor t;
+        const char* err;
+        {
+            py::gil_scoped_release release;
+            err = vectra::npy::load_any(path, mmap, t);
+        }
+        if (err) throw py::value_error("vectra load_npy() : " + path + " : " + err);
+        return t;
+    }, py::arg("path"), py::arg("mmap") = false);
+    m.def("save_npy", [](const std::string& path, const AnyTensor& t) {
+        py::gil_scoped_release release;
+        vectra::npy::save(path, t);
+    }, py::arg("path"), py::arg("t"));
+    m.def("load_npz", [](const std::string& path) {
+        vectra::npy::NpzFile z;
+        if (const char* err = z.open(path)) throw py::value_error("vectra load_npz() : " + path + " : " + err);
 
-    m.def("vectra_div_float32", &div<vectra::float32>);
-    m.def("vectra_div_float64", &div<vectra::float64>);
+        py::dict out;
+        for (const std::string& name : z.names()) {
+            AnyTensor t;
+            const char* err;
+            {
+                py::gil_scoped_release release;
+                err = z.get_any(name, t);
+            }
+            if (err) throw py::value_error("vectra load_npz() : " + path + " : " + name + " : " + err);
+            out[py::str(name)] = py::cast(std::move(t));
+        }
+        return out;
+    }, py::arg("path"));
+    m.def("save_npz", [](const std::string& path, const std::map<std::string, AnyTensor>& arrays) {
+        py::gil_scoped_release release;
+        vectra::npy::NpzWriter z(path);
+        for (const auto& kv : arrays) kv.second.visit([&](const auto& x) { z.add(kv.first, x); });
+        z.close();
+    }, py::arg("path"), py::arg("arrays"));
 
-    m.def("vectra_dot_int16",   &dot<vectra::int16>);
-    m.def("vectra_dot_int32",   &dot<vectra::int32>);
-    m.def("vectra_dot_float32", &dot<vectra::float32>);
-    m.def("vectra_dot_float64", &dot<vectra::float64>);
+    // seed of rand / randn (restarts the default Philox stream)
+    m.def("manual_seed", &vectra::manual_seed);
+
+    // instruction set the kernels run with (VECTRA_ISA lowers it)
+    m.def("isa", [] { return std::string(vectra::kernel::isa_name(vectra::kernel::active_isa())); });
+
+    // hardware counters per op (Profiler.h), off until enabled
+    m.def("profiler_enable", [](bool on) { vectra::profiler::enable(on); }, py::arg("on") = true);
+    m.def("profiler_enabled", [] { return vectra::profiler::enabled(); });
+    m.def("profiler_reset", [] { vectra::profiler::reset(); });
+    m.def("profiler_report", [] {
+        // the first report calibrates the roofline (about a second)
+        py::gil_scoped_release release;
+        return vectra::profiler::report_string();
+    });
+
+    // timeline of the ops (Trace.h), Chrome Trace Event JSON for Perfetto
+    m.def("trace_enable", [](bool on) { vectra::trace::enable(on); }, py::arg("on") = true);
+    m.def("trace_enabled", [] { return vectra::trace::enabled(); });
+    m.def("trace_clear", [] { vectra::trace::clear(); });
+    m.def("trace_json", [] { return vectra::trace::json(); });
+    m.def("trace_dump", [](const std::string& path) {
+        const char* err;
+        {
+            py::gil_scoped_release release;
+            err = vectra::trace::dump(path);
+        }
+        if (err) throw py::value_error("vectra trace_dump() : " + path + " : " + err);
+    }, py::arg("path"));
+
+    // memory of the tensors (memory.h) : an allocation past the soft limit raises MemoryError
+    m.def("memory_stats", [] {
+        const utils::MemoryStats s = utils::memory_stats();
+        py::dict classes;       // largest size of the class in bytes -> allocations
+        for (size_t c = 0; c < utils::MEMORY_SIZE_CLASSES; ++c) {
+            if (s.by_class[c]) classes[py::int_(size_t(1) << c)] = s.by_class[c];
+        }
+        py::dict d;
+        d["live_bytes"] = s.live_bytes;
+        d["peak_bytes"] = s.peak_bytes;
+        d["cached_bytes"] = s.cached_bytes;
+        d["allocations"] = s.allocations;
+        d["frees"] = s.frees;
+        d["limit_bytes"] = s.limit_bytes;
+        d["refused"] = s.refused;
+        d["size_classes"] = classes;
+        return d;
+    });
+    m.def("set_memory_limit", [](size_t bytes) { utils::set_memory_limit(bytes); }, py::arg("bytes"));
+    m.def("memory_limit", [] { return utils::memory_limit(); });
+    m.def("reset_peak_memory", [] { utils::reset_peak_memory(); });
+    m.def("track_memory_by_op", [](bool on) { utils::track_ops(on); }, py::arg("on") = true);
+    m.def("memory_by_op", [] {
+        py::dict d;
+        for (const utils::OpMemory& op : utils::memory_by_op()) {
+            py::dict row;
+            row["allocations"] = op.allocations;
+            row["bytes"] = op.bytes;
+            row["live_bytes"] = op.live_bytes;
+            row["peak_bytes"] = op.peak_bytes;
+            d[py::str(op.op)] = row;
+        }
+        return d;
+    });
 }
+
+#undef VECTRA_DEF_UNARY
+#undef VECTRA_DEF_REDUCE
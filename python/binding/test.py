@@ -1,12 +1,58 @@
 import sys
 sys.path.append("./")
+sys.path.append("./build")
 
+import numpy as np
 import tensor_ops as to
 
-if to.SSE:
-    t_sse = to.SSE.TenFloat32_SSE([3, 3], 1.5)
-    print("SSE Tensor:\n", t_sse)
+# np.asarray shares the storage : writes are seen on both sides
+t = to.rand([3, 4])
+a = np.asarray(t)
+assert a.shape == (3, 4) and a.dtype == np.float32
+a[0, 0] = 42.0
+assert np.asarray(t)[0, 0] == 42.0
 
-if to.AVX:
-    t_avx = to.AVX.TenFloat32_AVX([3, 3], 1.5)
-    print("AVX Tensor:\n", t_avx)
\ No newline at end of file
+# a lazy constant is materialized before it is exported
+z = to.zeros([2, 2], to.DType.float64)
+assert np.asarray(z).dtype == np.float64 and not np.asarray(z).any()
+
+# from_buffer (pyvectra.from_numpy) : writable arrays are shared, read-only ones copied
+x = np.arange(12, dtype=np.float32).reshape(3, 4)
+tx = to.from_buffer(x)
+x[1, 1] = -1.0
+assert np.asarray(tx)[1, 1] == -1.0
+ro = np.arange(6, dtype=np.int32)
+ro.flags.writeable = False
+tr = to.from_buffer(ro)
+assert np.array_equal(np.asarray(tr), ro)
+assert np.array_equal(np.asarray(to.from_buffer(x[:, ::2])), x[:, ::2])
+assert np.array_equal(np.asarray(to.from_buffer(x[::-1])), x[::-1])
+
+# DLPack both ways
+d = to.from_dlpack(x)
+x[2, 3] = 7.0
+assert np.asarray(d)[2, 3] == 7.0
+back = np.from_dlpack(t)
+assert np.array_equal(back, np.asarray(t))
+
+# add_async completes a concurrent.futures.Future
+b = to.ones([3, 4])
+f = to.add_async(t, b)
+assert np.allclose(np.asarray(f.result()), np.asarray(t) + 1.0)
+
+# an allocation past the soft limit raises MemoryError, synchronously or through the future
+p = to.rand([512, 512])
+q = to.rand([512, 512])
+to.set_memory_limit(to.memory_stats()["live_bytes"] + (512 << 10))
+try:
+    to.rand([1024, 1024])
+    raise AssertionError("rand() past the limit didn't raise")
+except MemoryError:
+    pass
+f = to.add_async(p, q)
+assert isinstance(f.exception(), MemoryError)
+assert to.memory_stats()["refused"] >= 2
+to.set_memory_limit(0)
+assert to.add(p, q).numel() == 512 * 512
+
+print("ok")
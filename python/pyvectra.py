@@ -2,16 +2,11 @@
 import sys
 sys.path.append("./python/binding/build")
 
-from typing import Optional
 from .python import tensor_ops as to
-from enum import Enum
-import warnings
 
-class DType(Enum):
-    int16 = "int16"
-    int32 = "int32"
-    float32 = "float32"
-    float64 = "float64"
+# The dtype is a runtime tag of the native Tensor : every op dispatches on it in C++ (AnyTensor.h)
+DType = to.DType
+Tensor = to.Tensor
 
 
 class vectra:
@@ -20,134 +15,18 @@ class vectra:
     float32 = DType.float32
     float64 = DType.float64
 
-class dispatcher:
-    @staticmethod
-    def _dispatch_add(a, b):
-        if a.DType is DType.int16 and b.DType is DType.int16:
-            return to.vectra_add_int16(a, b)
-        elif a.DType is DType.int32 and b.DType is DType.int32:
-            return to.vectra_add_int32(a, b)
-        elif a.DType is DType.float32 and b.DType is DType.float32:
-            return to.vectra_add_float32(a, b)
-        elif a.DType is DType.float64 and b.DType is DType.float64:
-            return to.vectra_add_float64(a, b)
-        else:
-            raise TypeError(f"pyvectra : add() Unsupported DType: {a.DType}")
-        
-    @staticmethod
-    def _dispatch_sub(a, b):
-        if a.DType is DType.int16 and b.DType is DType.int16:
-            return to.vectra_sub_int16(a, b)
-        elif a.DType is DType.int32 and b.DType is DType.int32:
-            return to.vectra_sub_int32(a, b)
-        elif a.DType is DType.float32 and b.DType is DType.float32:
-            return to.vectra_sub_float32(a, b)
-        elif a.DType is DType.float64 and b.DType is DType.float64:
-            return to.vectra_sub_float64(a, b)
-        else:
-            raise TypeError(f"pyvectra : sub() Unsupported DType: {a.DType}")
-        
-    @staticmethod
-    def _dispatch_mul(a, b):
-        if a.DType is DType.int16 and b.DType is DType.int16:
-            return to.vectra_mul_int16(a, b)
-        elif a.DType is DType.int32 and b.DType is DType.int32:
-            return to.vectra_mul_int32(a, b)
-        elif a.DType is DType.float32 and b.DType is DType.float32:
-            return to.vectra_mul_float32(a, b)
-        elif a.DType is DType.float64 and b.DType is DType.float64:
-            return to.vectra_mul_float64(a, b)
-        else:
-            raise TypeError(f"pyvectra : mul() Unsupported DType: {a.DType}")
-        
-    @staticmethod
-    def _dispatch_div(a, b):
-        if a.DType is DType.float32 and b.DType is DType.float32:
-            return to.vectra_div_float32(a, b)
-        elif a.DType is DType.float64 and b.DType is DType.float64:
-            return to.vectra_div_float64(a, b)
-        else:
-            raise TypeError(f"pyvectra : div() Unsupported DType: {a.DType}")
-        
-    @staticmethod
-    def _dispatch_dot(a, b):
-        if a.DType is DType.int16 and b.DType is DType.int16:
-            return to.vectra_dot_int16(a, b)
-        elif a.DType is DType.int32 and b.DType is DType.int32:
-            return to.vectra_dot_int32(a, b)
-        elif a.DType is DType.float32 and b.DType is DType.float32:
-            return to.vectra_dot_float32(a, b)
-        elif a.DType is DType.float64 and b.DType is DType.float64:
-            return to.vectra_dot_float64(a, b)
-        else:
-            raise TypeError(f"pyvectra : dot() Unsupported DType: {a.DType}")
-        
-    @staticmethod
-    def _dispatch_max(x):
-        if x.DType is DType.int16:
-            return to.vectra_max_int16(x)
-        elif x.DType is DType.int32:
-            return to.vectra_max_int32(x)
-        elif x.DType is DType.float32:
-            return to.vectra_max_float32(x)
-        elif x.DType is DType.float64:
-            return to.vectra_max_float64(x)
-        else:
-            raise TypeError(f"pyvectra : dot() Unsupported DType: {x.DType}")
-        
-    @staticmethod
-    def _dispatch_flatten(x):
-        if x.DType is DType.int16:
-            return to.vectra_flatten_int16(x)
-        elif x.DType is DType.int32:
-            return to.vectra_flatten_int32(x)
-        elif x.DType is DType.float32:
-            return to.vectra_flatten_float32(x)
-        elif x.DType is DType.float64:
-            return to.vectra_flatten_float64(x)
-        else:
-            raise TypeError(f"pyvectra : flatten() Unsupported DType: {x.DType}")
-        
-    @staticmethod
-    def _dispatch_sum(x):
-        if x.DType is DType.int16:
-            return to.vectra_sum_int16(x)
-        elif x.DType is DType.int32:
-            return to.vectra_sum_int32(x)
-        elif x.DType is DType.float32:
-            return to.vectra_sum_float32(x)
-        elif x.DType is DType.float64:
-            return to.vectra_sum_float64(x)
-        else:
-            raise TypeError(f"pyvectra : sum() Unsupported DType: {x.DType}")
-        
-    @staticmethod
-    def _dispatch_exp(x):
-        if x.DType is DType.int16:
-            return to.vectra_exp_int16(x)
-        elif x.DType is DType.int32:
-            return to.vectra_exp_int32(x)
-        elif x.DType is DType.float32:
-            return to.vectra_exp_float32(x)
-        elif x.DType is DType.float64:
-            return to.vectra_exp_float64(x)
-        else:
-            raise TypeError(f"pyvectra : exp() Unsupported DType: {x.DType}")
-
-    
-
 
+def _check_shape(name, shape):
+    if isinstance(shape, (list, int, float)):
+        raise TypeError(f"pyvectra : {name}() shape must be a tuple, not int, float, or list")
+    if not isinstance(shape, tuple):
+        raise TypeError(f"pyvectra : {name}() shape must be a tuple, got {type(shape).__name__}")
+    if len(shape) > 32:
+        raise ValueError(f"pyvectra : {name}() maximum supported dimension is 32")
 
 
 def full(shape, value, dtype=None):
-    if isinstance(shape, list):
-        raise TypeError("pyvectra : full() shape must be a tuple, not a list")
-    if not isinstance(shape, tuple):
-        raise TypeError(
-            f"pyvectra : full() shape must be a tuple, got {DType(shape).__name__}"
-        )
-    if len(shape) > 32:
-        raise ValueError("pyvectra : full() maximum supported dimension is 32")
+    _check_shape("full", shape)
 
     if dtype is None:
         if isinstance(value, int):
@@ -157,180 +36,159 @@ def full(shape, value, dtype=None):
         else:
             raise TypeError(
                 "pyvectra : full() cannot infer DType from value "
-                f"of DType {DType(value).__name__}"
+                f"of type {type(value).__name__}"
             )
+    return to.full(shape, value, dtype)
 
-    if dtype is DType.int16:
-        return to.vectra_full_int16(shape, value)
-    elif dtype is DType.float32:
-        return to.vectra_full_int32(shape, value)
-    elif dtype is DType.float32:
-        return to.vectra_full_float32(shape, value) 
-    elif dtype is DType.float64:
-        return to.vectra_full_float64(shape, value)
-    else:
-        raise TypeError(f"pyvectra : full() Unsupported DType: {dtype}")
-
-
-def zeros(shape, dtype: str = None):
-    if isinstance(shape, list):
-        raise TypeError("pyvectra : zeros() shape must be tuple, not a list")
-    if not isinstance(shape, tuple):
-        raise TypeError(f"pyvectra : zeros() shape must be a tuple, got {DType(shape).__name__}")
-    if len(shape) > 32:
-        raise ValueError("pyvectra : zeros() maximum supported dimension is 32")
+def zeros(shape, dtype=DType.float32):
+    _check_shape("zeros", shape)
+    return to.zeros(shape, dtype)
 
-    if dtype is None:
-        dtype = DType.float32
-
-    if dtype == DType.int16:
-        return to.vectra_zeros_int16(shape)
-    elif dtype == DType.int32:
-        return to.vectra_zeros_int32(shape)
-    elif dtype == DType.float32:
-        return to.vectra_zeros_float32(shape)
-    elif dtype == DType.float64:
-        return to.vectra_zeros_float64(shape)
-    else:
-        raise TypeError(f"pyvectra : zeros() Unsupported DType: {dtype}")
-
-def ones(shape, dtype: str = None):
-    if isinstance(shape, list):
-        raise TypeError("pyvectra : ones() shape must be tuple, not a list")
-    if not isinstance(shape, tuple):
-        raise TypeError(f"pyvectra : ones() shape must be a tuple, got {DType(shape).__name__}")
-    if len(shape) > 32:
-        raise ValueError("pyvectra : ones() maximum supported dimension is 32")
+def ones(shape, dtype=DType.float32):
+    _check_shape("ones", shape)
+    return to.ones(shape, dtype)
 
-    if dtype is None:
-        dtype = DType.float32
-
-    if dtype == DType.int16:
-        return to.vectra_ones_int16(shape)
-    elif dtype == DType.int32:
-        return to.vectra_ones_int32(shape)
-    elif dtype == DType.float32:
-        return to.vectra_ones_float32(shape)
-    elif dtype == DType.float64:
-        return to.vectra_ones_float64(shape)
-    else:
-        raise TypeError(f"pyvectra : ones() Unsupported DType: {dtype}")
-
-def twos(shape, dtype: str = None):
-    if isinstance(shape, list):
-        raise TypeError("pyvectra : twos() shape must be tuple, not a list")
-    if not isinstance(shape, tuple):
-        raise TypeError(f"pyvectra : twos() shape must be a tuple, got {DType(shape).__name__}")
-    if len(shape) > 32:
-        raise ValueError("pyvectra : twos() maximum supported dimension is 32")
+def twos(shape, dtype=DType.float32):
+    _check_shape("twos", shape)
+    return to.twos(shape, dtype)
 
-    if dtype is None:
-        dtype = DType.float32
-
-    if dtype == DType.int16:
-        return to.vectra_twos_int16(shape)
-    elif dtype == DType.int32:
-        return to.vectra_twos_int32(shape)
-    elif dtype == DType.float32:
-        return to.vectra_twos_float32(shape)
-    elif dtype == DType.float64:
-        return to.vectra_twos_float64(shape)
-    else:
-        raise TypeError(f"pyvectra : twos() Unsupported DType: {dtype}")
-
-def rand(shape, dtype: str = None):
-    if isinstance(shape, (list, int, float)):
-        raise TypeError("pyvectra : rand() shape must be tuple, not int, float, or list")
-    if not isinstance(shape, tuple):
-        raise TypeError(f"pyvectra : rand() shape must be a tuple, got {DType(shape).__name__}")
-    if len(shape) > 32:
-        raise ValueError("pyvectra : rand() maximum supported dimension is 32")
+def rand(shape, dtype=DType.float32):
+    _check_shape("rand", shape)
+    return to.rand(shape, dtype)
 
-    if dtype is None:
-        dtype = DType.float32
-
-    if dtype in (DType.int16, DType.int32):
-        raise TypeError("pyvectra : rand() does not support int types right now!")
-    elif dtype == DType.float32:
-        return to.vectra_rand_float32(shape)
-    elif dtype == DType.float64:
-        return to.vectra_rand_float64(shape)
-    else:
-        raise TypeError(f"pyvectra : rand() Unsupported DType: {dtype}")
-
-def randn(shape, dtype: str = None):
-    if isinstance(shape, (list, int, float)):
-        raise TypeError("pyvectra : randn() shape must be tuple, not int, float, or list")
-    if not isinstance(shape, tuple):
-        raise TypeError(f"pyvectra : randn() shape must be a tuple, got {DType(shape).__name__}")
-    if len(shape) > 32:
-        raise ValueError("pyvectra : randn() maximum supported dimension is 32")
+def randn(shape, dtype=DType.float32):
+    _check_shape("randn", shape)
+    return to.randn(shape, dtype)
 
-    if dtype is None:
-        dtype = DType.float32
-
-    if dtype in (DType.int16, DType.int32):
-        raise TypeError("pyvectra : randn() does not support int types right now!")
-    elif dtype == DType.float32:
-        return to.vectra_randn_float32(shape)
-    elif dtype == DType.float64:
-        return to.vectra_randn_float64(shape)
-    else:
-        raise TypeError(f"pyvectra : randn() Unsupported DType: {dtype}")
-    
-def add(a, b):
-    if isinstance(a, list) or isinstance(b, list):
-        raise TypeError("pyvectra : add() Shape not supported it was a list. Must be a tuple")
-    if not isinstance(a, tuple) or not isinstance(b, tuple):
-        raise TypeError("pyvectra : add() func only support tuple!")
-    return dispatcher._dispatch_add(a, b)
-
-def sub(a, b):
-    if isinstance(a, list) or isinstance(b, list):
-        raise TypeError("pyvectra : sub() Shape not supported it was a list. Must be a tuple")
-    if not isinstance(a, tuple) or not isinstance(b, tuple):
-        raise TypeError("pyvectra : sub() func only support tuple!")
-    return dispatcher._dispatch_sub(a, b)
-
-def mul(a, b):
-    if isinstance(a, list) or isinstance(b, list):
-        raise TypeError("pyvectra : mul() Shape not supported it was a list. Must be a tuple")
-    if not isinstance(a, tuple) or not isinstance(b, tuple):
-        raise TypeError("pyvectra : mul() func only support tuple!")
-    return dispatcher._dispatch_mul(a, b)
-
-def div(a, b):
-    if b == 0:
-        raise ValueError("pyvectra : div() cannot divide by zero")
-    if isinstance(a, list) or isinstance(b, list):
-        raise TypeError("pyvectra : div() Shape not supported it was a list. Must be a tuple")
-    if not isinstance(a, tuple) or not isinstance(b, tuple):
-        raise TypeError("pyvectra : div() func only support tuple!")
-    return dispatcher._dispatch_div(a, b)
-
-def dot(a, b):
-    if isinstance(a, list) or isinstance(b, list):
-        raise TypeError("pyvectra : dot() Shape not supported for list. Must be a tuple")
-    if not isinstance(a, tuple) or not isinstance(b, tuple):
-        raise TypeError("pyvectra : dot() must be a tuple")
-    return dispatcher._dispatch_dot(a, b)
-
-def max(x):
-    if isinstance(x, list) or not isinstance(x, tuple):
-        raise TypeError("pyvectra : max() Shape must be a tuple")
-    return dispatcher._dispatch_max(x)
-
-def flatten(x):
-    if isinstance(x, list) or not isinstance(x, tuple):
-        raise TypeError("pyvectra : flatten() Shape must be a tuple")
-    return dispatcher._dispatch_flatten(x)
-
-def sum(x):
-    if isinstance(x, list) or not isinstance(x, tuple):
-        raise TypeError("pyvectra : sum() Shape must be a tuple")
-    return dispatcher._dispatch_sum(x)
-
-def exp(x):
-    if isinstance(x, list) or not isinstance(x, tuple):
-        raise TypeError("pyvectra : exp() Shape must be a tuple")
-    return dispatcher._dispatch_exp(x)
\ No newline at end of file
+def from_numpy(array):
+    # shares the memory of a writable array (int16, int32, float32, float64), copies a read-only one
+    return to.from_buffer(array)
+
+def from_dlpack(obj):
+    # shares the memory of any CPU tensor with __dlpack__ (NumPy, PyTorch, JAX ...)
+    return to.from_dlpack(obj)
+
+def load(path):
+    # zero-copy view of a tensor file : the pages are read when an op first touches them
+    return to.load(str(path))
+
+def save(path, t):
+    to.save(str(path), t)
+
+def load_npy(path, mmap=False):
+    # .npy read natively (no NumPy) : mmap=True returns a zero-copy view of the file
+    return to.load_npy(str(path), mmap)
+
+def save_npy(path, t):
+    to.save_npy(str(path), t)
+
+def load_npz(path):
+    # dict of name -> Tensor, stored members are views of the mapped archive
+    return to.load_npz(str(path))
+
+def save_npz(path, arrays):
+    to.save_npz(str(path), dict(arrays))
+
+class profiler:
+    # perf_event_open counters of every op : IPC, bytes / cycle and FLOPs / cycle per op, dtype and size
+    @staticmethod
+    def enable(on=True):
+        to.profiler_enable(bool(on))
+
+    @staticmethod
+    def disable():
+        to.profiler_enable(False)
+
+    @staticmethod
+    def reset():
+        to.profiler_reset()
+
+    @staticmethod
+    def report():
+        return to.profiler_report()
+
+class trace:
+    # timeline of every op (name, shapes, dtype, bytes, thread) : dump() writes Chrome Trace JSON for Perfetto
+    @staticmethod
+    def enable(on=True):
+        to.trace_enable(bool(on))
+
+    @staticmethod
+    def disable():
+        to.trace_enable(False)
+
+    @staticmethod
+    def clear():
+        to.trace_clear()
+
+    @staticmethod
+    def dump(path):
+        to.trace_dump(str(path))
+
+class memory:
+    # bytes held by the tensors : live, peak, cached by the pool and per op, with an optional soft limit (MemoryError past it)
+    @staticmethod
+    def stats():
+        return to.memory_stats()
+
+    @staticmethod
+    def set_limit(nbytes):
+        # None or 0 removes the limit
+        to.set_memory_limit(int(nbytes or 0))
+
+    @staticmethod
+    def limit():
+        return to.memory_limit()
+
+    @staticmethod
+    def reset_peak():
+        to.reset_peak_memory()
+
+    @staticmethod
+    def track_by_op(on=True):
+        to.track_memory_by_op(bool(on))
+
+    @staticmethod
+    def by_op():
+        return to.memory_by_op()
+
+def manual_seed(seed):
+    if not isinstance(seed, int) or seed < 0 or seed >= 2 ** 64:
+        raise ValueError("pyvectra : manual_seed() seed must be an int in [0, 2**64)")
+    to.manual_seed(seed)
+
+
+# Tensor ops are the native functions themselves (no Python frame per call) : a dtype mismatch
+# raises TypeError, div / pow / math accept every dtype (integer results are truncated)
+add = to.add
+sub = to.sub
+mul = to.mul
+div = to.div
+dot = to.dot
+pow = to.pow
+
+sum = to.sum
+prod = to.prod
+max = to.max
+min = to.min
+mean = to.mean
+argmax = to.argmax
+argmin = to.argmin
+
+exp = to.exp
+log = to.log
+log1p = to.log1p
+tanh = to.tanh
+sigmoid = to.sigmoid
+erf = to.erf
+sqrt = to.sqrt
+rsqrt = to.rsqrt
+flatten = to.flatten
+
+# Asynchronous ops : the op runs on the vectra thread pool without the GIL and the call returns a
+# concurrent.futures.Future at once (await it with asyncio.wrap_future(fut))
+add_async = to.add_async
+sub_async = to.sub_async
+mul_async = to.mul_async
+div_async = to.div_async
+dot_async = to.dot_async
@@ -0,0 +1,93 @@
+/*
+ *
+ * check.h (v1.0)
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Checks of the regression tests (HEADER).
+ * A failed CHECK prints its file, line and condition and the test goes on, test_result() is the
+ * exit status of main (0 when every check passed). exits_with_failure() runs a call that is
+ * expected to print an error and exit (the library reports misuse with exit(EXIT_FAILURE)).
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#pragma once
+#ifndef VECTRA_TEST_CHECK_H
+#define VECTRA_TEST_CHECK_H
+
+#ifdef __cplusplus
+
+#include <ThreadPool/ThreadPool.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#if !defined(_WIN32)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+inline int& test_failures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+// variadic : the condition may hold template argument lists
+#define CHECK(...)                                                                     \
+    do {                                                                               \
+        if (!(__VA_ARGS__)) {                                                          \
+            fprintf(stderr, "%s:%d : CHECK(%s) failed\n", __FILE__, __LINE__, #__VA_ARGS__); \
+            ++test_failures();                                                         \
+        }                                                                              \
+    } while (0)
+
+// |a - b| <= tol, NaN never passes
+#define CHECK_NEAR(a, b, tol)                                                          \
+    do {                                                                               \
+        const double check_a_ = double(a), check_b_ = double(b);                       \
+        if (!(std::fabs(check_a_ - check_b_) <= double(tol))) {                        \
+            fprintf(stderr, "%s:%d : CHECK_NEAR(%s, %s) failed : %.17g vs %.17g\n",    \
+                    __FILE__, __LINE__, #a, #b, check_a_, check_b_);                   \
+            ++test_failures();                                                         \
+        }                                                                              \
+    } while (0)
+
+inline int test_result(const char* name)
+{
+    const int failures = test_failures();
+    printf("%s : %s (%d failed checks)\n", name, failures ? "FAIL" : "OK", failures);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+#if !defined(_WIN32)
+// fn() in a child process : true when it exits with EXIT_FAILURE (its message goes to stderr).
+// The pool runs without workers meanwhile : a forked child has no copy of them to join at exit
+template<typename F>
+bool exits_with_failure(F&& fn)
+{
+    const size_t threads = utils::get_num_threads();
+    utils::set_num_threads(1);
+    fflush(stdout);
+    fflush(stderr);
+
+    const pid_t pid = fork();
+    if (pid == 0) {
+        fn();
+        _exit(EXIT_SUCCESS);
+    }
+    int status = 0;
+    const bool waited = pid > 0 && waitpid(pid, &status, 0) == pid;
+    utils::set_num_threads(threads);
+    return waited && WIFEXITED(status) && WEXITSTATUS(status) == EXIT_FAILURE;
+}
+#endif
+
+#endif // __cplusplus
+#endif // VECTRA_TEST_CHECK_H
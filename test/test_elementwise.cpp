@@ -0,0 +1,152 @@
+/*
+ *
+ * test_elementwise.cpp (v1.0)
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Regression test of the element-wise kernels (ElementWise.h) and of the binary Tensor ops.
+ * Every ISA level the CPU has must give the results of the scalar level bit for bit, for every
+ * length around the vector widths and misaligned pointers, and must not write past the end.
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#include "check.h"
+#include <cpu/TensorOps.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace vectra::kernel;
+
+static const size_t LENGTHS[] = { 0, 1, 2, 3, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 1000, 4099 };
+
+template<typename T>
+using BinaryFn = bool (*)(const T*, const T*, T*, size_t);
+
+// small values : integer products stay in range, divisors are never zero
+template<typename T>
+static void fill(std::vector<T>& v, uint32_t seed, bool divisor)
+{
+    for (size_t i = 0; i < v.size(); ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        int x = int(seed >> 24) % 23 - 11;
+        if (divisor && x == 0) x = 3;
+        v[i] = std::is_floating_point<T>::value ? T(x) / T(4) : T(x);
+    }
+}
+
+template<typename T>
+static bool same_bits(const T* a, const T* b, size_t n)
+{
+    return std::memcmp(a, b, n * sizeof(T)) == 0;
+}
+
+template<BinaryOp Op, typename T>
+static void check_binary(const char* level, BinaryFn<T> fn, BinaryFn<T> lhs_scalar, BinaryFn<T> rhs_scalar)
+{
+    const T sentinel = T(77);
+    for (size_t n : LENGTHS) {
+        for (size_t off = 0; off < 2; ++off) {
+            std::vector<T> a(n + 2), b(n + 2), out(n + 2, sentinel), ref(n + 2, sentinel);
+            fill(a, uint32_t(n * 7 + 1), false);
+            fill(b, uint32_t(n * 13 + 5), true);
+
+            CHECK(scalar::binary<Op>(a.data() + off, b.data() + off, ref.data() + off, n));
+            CHECK(fn(a.data() + off, b.data() + off, out.data() + off, n));
+            if (!same_bits(out.data(), ref.data(), n + 2))
+                fprintf(stderr, "  %s binary, n = %zu, offset %zu\n", level, n, off);
+            CHECK(same_bits(out.data(), ref.data(), n + 2));
+
+            // one operand broadcast
+            std::fill(out.begin(), out.end(), sentinel);
+            std::fill(ref.begin(), ref.end(), sentinel);
+            CHECK(scalar::binary_scalar<Op, true>(a.data() + off, b.data(), ref.data() + off, n));
+            CHECK(rhs_scalar(a.data() + off, b.data(), out.data() + off, n));
+            CHECK(same_bits(out.data(), ref.data(), n + 2));
+
+            std::fill(out.begin(), out.end(), sentinel);
+            std::fill(ref.begin(), ref.end(), sentinel);
+            CHECK(scalar::binary_scalar<Op, false>(a.data(), b.data() + off, ref.data() + off, n));
+            CHECK(lhs_scalar(a.data(), b.data() + off, out.data() + off, n));
+            CHECK(same_bits(out.data(), ref.data(), n + 2));
+        }
+    }
+
+    // a zero divisor anywhere is reported
+    if constexpr (Op == BinaryOp::Div) {
+        std::vector<T> a(100), b(100), out(100);
+        fill(a, 3, false);
+        fill(b, 4, true);
+        b[61] = T(0);
+        CHECK(!fn(a.data(), b.data(), out.data(), b.size()));
+        CHECK(!lhs_scalar(a.data(), b.data(), out.data(), b.size()));
+        CHECK(!rhs_scalar(a.data(), b.data() + 61, out.data(), a.size()));
+    }
+}
+
+#define VECTRA_CHECK_LEVEL(ns, T)                                                                              \
+    do {                                                                                                       \
+        check_binary<BinaryOp::Add, T>(#ns, &ns::binary<BinaryOp::Add, T>,                                     \
+                                       &ns::binary_scalar<BinaryOp::Add, false, T>, &ns::binary_scalar<BinaryOp::Add, true, T>); \
+        check_binary<BinaryOp::Sub, T>(#ns, &ns::binary<BinaryOp::Sub, T>,                                     \
+                                       &ns::binary_scalar<BinaryOp::Sub, false, T>, &ns::binary_scalar<BinaryOp::Sub, true, T>); \
+        check_binary<BinaryOp::Mul, T>(#ns, &ns::binary<BinaryOp::Mul, T>,                                     \
+                                       &ns::binary_scalar<BinaryOp::Mul, false, T>, &ns::binary_scalar<BinaryOp::Mul, true, T>); \
+        check_binary<BinaryOp::Div, T>(#ns, &ns::binary<BinaryOp::Div, T>,                                     \
+                                       &ns::binary_scalar<BinaryOp::Div, false, T>, &ns::binary_scalar<BinaryOp::Div, true, T>); \
+    } while (0)
+
+template<typename T>
+static void check_levels()
+{
+    const Isa cpu = cpu_isa();
+    if (cpu >= Isa::SSE42)  VECTRA_CHECK_LEVEL(sse42, T);
+    if (cpu >= Isa::AVX2)   VECTRA_CHECK_LEVEL(avx2, T);
+    if (cpu >= Isa::AVX512) VECTRA_CHECK_LEVEL(avx512, T);
+    VECTRA_CHECK_LEVEL(vectra::kernel, T);      // dispatched entry point
+}
+
+// Tensor ops : contiguous, broadcast rows / columns and strided operands
+static void check_tensor_ops()
+{
+    Tensor<float> A({ 37, 19 });
+    Tensor<float> row({ 19 });
+    Tensor<float> col({ 37, 1 });
+    for (size_t i = 0; i < A.numel(); ++i) A.data()[i] = float(i % 29) - 14.0f;
+    for (size_t j = 0; j < 19; ++j) row.data()[j] = float(j) + 0.5f;
+    for (size_t i = 0; i < 37; ++i) col.data()[i] = float(i % 5) - 2.0f;
+
+    const Tensor<float> r = add(A, row);
+    const Tensor<float> c = mul(A, col);
+    const Tensor<float> At = transpose(A);
+    const Tensor<float> t = sub(At, transpose(r));
+    CHECK(r.shape == Shape({ 37, 19 }));
+    CHECK(t.shape == Shape({ 19, 37 }));
+    for (size_t i = 0; i < 37; ++i) {
+        for (size_t j = 0; j < 19; ++j) {
+            const float a = A.data()[i * 19 + j];
+            CHECK(r.data()[i * 19 + j] == a + row.data()[j]);
+            CHECK(c.data()[i * 19 + j] == a * col.data()[i]);
+            CHECK(t.data()[t.offset + j * t.strides[0] + i * t.strides[1]] == -row.data()[j]);
+        }
+    }
+
+    // division by a tensor holding a zero exits
+    CHECK(exits_with_failure([&] { div(A, zeros<float>({ 37, 19 })); }));
+}
+
+int main()
+{
+    check_levels<vectra::float32>();
+    check_levels<vectra::float64>();
+    check_levels<vectra::int32>();
+    check_levels<vectra::int16>();
+    check_tensor_ops();
+    return test_result("test_elementwise");
+}
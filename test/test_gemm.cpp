@@ -0,0 +1,142 @@
+/*
+ *
+ * test_gemm.cpp (v1.0)
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Regression test of the blocked GEMM engine (Gemm.h) and dot().
+ * Every micro-kernel the CPU has is checked against a long double product on shapes around its
+ * tiles (MR, NR) and blocks (MC, KC), with transposed operands, K = 0 and a padded C whose
+ * padding must stay untouched, serial and on several threads.
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#include "check.h"
+#include <cpu/TensorOps.h>
+#include <cstdint>
+#include <vector>
+
+using namespace vectra::kernel;
+
+template<typename T>
+static void fill(std::vector<T>& v, uint32_t seed)
+{
+    for (T& x : v) {
+        seed = seed * 1664525u + 1013904223u;
+        x = T(int(seed >> 20) % 2001 - 1000) / T(1000);
+    }
+}
+
+template<typename Kernel, typename T>
+static void check_shape(const char* level, size_t M, size_t N, size_t K, bool trans_a, bool trans_b)
+{
+    std::vector<T> A(M * K), B(K * N);
+    fill(A, uint32_t(M * 31 + K));
+    fill(B, uint32_t(N * 17 + K));
+
+    // A is M x K : row-major, or the transpose of a K x M array
+    const size_t rsa = trans_a ? 1 : K, csa = trans_a ? M : 1;
+    const size_t rsb = trans_b ? 1 : N, csb = trans_b ? K : 1;
+
+    const size_t ldc = N + 3;
+    const T sentinel = T(-7.25);
+    std::vector<T> C(M * ldc, sentinel);
+    gemm::gemm_blocked<Kernel, T>(M, N, K, A.data(), rsa, csa, B.data(), rsb, csb, C.data(), ldc);
+
+    const long double eps = std::numeric_limits<T>::epsilon();
+    size_t bad = 0;
+    for (size_t i = 0; i < M; ++i) {
+        for (size_t j = 0; j < N; ++j) {
+            long double ref = 0, mag = 0;
+            for (size_t k = 0; k < K; ++k) {
+                const long double p = (long double)A[i * rsa + k * csa] * B[k * rsb + j * csb];
+                ref += p;
+                mag += p < 0 ? -p : p;
+            }
+            const long double err = C[i * ldc + j] - ref;
+            if ((err < 0 ? -err : err) > 2 * (K + 2) * eps * mag) ++bad;
+        }
+        for (size_t j = N; j < ldc; ++j) bad += C[i * ldc + j] != sentinel;
+    }
+    if (bad) fprintf(stderr, "  %s %zu x %zu x %zu (trans %d %d) : %zu wrong\n", level, M, N, K, trans_a, trans_b, bad);
+    CHECK(bad == 0);
+}
+
+template<typename Kernel, typename T>
+static void check_kernel(const char* level)
+{
+    const size_t MR = Kernel::MR, NR = Kernel::NR, MC = Kernel::MC, KC = Kernel::KC;
+    const size_t ms[] = { 1, MR - 1, MR, MR + 1, 2 * MR + 3, MC + MR + 1 };
+    const size_t ns[] = { 1, NR - 1, NR, NR + 1, 3 * NR + 5 };
+    const size_t ks[] = { 0, 1, 7, KC, KC + 3 };
+
+    for (size_t m : ms)
+        for (size_t n : ns)
+            for (size_t k : ks) check_shape<Kernel, T>(level, m, n, k, false, false);
+
+    check_shape<Kernel, T>(level, MC + 5, 3 * NR + 1, KC + 9, true, false);
+    check_shape<Kernel, T>(level, 2 * MR + 1, 2 * NR + 3, 33, false, true);
+    check_shape<Kernel, T>(level, 2 * MR + 1, 2 * NR + 3, KC + 1, true, true);
+    // large enough for the parallel path
+    check_shape<Kernel, T>(level, 2 * MC + 7, 5 * NR + 3, KC + 17, false, false);
+}
+
+template<typename T>
+static void check_levels()
+{
+    const Isa cpu = cpu_isa();
+    check_kernel<gemm::ScalarKernel<T>, T>("scalar");
+    if (cpu >= Isa::SSE42)  check_kernel<gemm::Sse42Kernel<T>, T>("sse4.2");
+    if (cpu >= Isa::AVX2)   check_kernel<gemm::Avx2Kernel<T>, T>("avx2");
+    if (cpu >= Isa::AVX512) check_kernel<gemm::Avx512Kernel<T>, T>("avx512");
+}
+
+// dot() : vector * matrix, matrix * vector, matrix * matrix of a transposed view, integers
+static void check_dot()
+{
+    Tensor<float> A({ 5, 3 });
+    Tensor<float> B({ 3, 4 });
+    for (size_t i = 0; i < A.numel(); ++i) A.data()[i] = float(i) - 6.0f;
+    for (size_t i = 0; i < B.numel(); ++i) B.data()[i] = float(i % 5) * 0.5f;
+
+    const Tensor<float> C = dot(A, B);
+    const Tensor<float> Ct = dot(transpose(B), transpose(A));
+    CHECK(C.shape == Shape({ 5, 4 }));
+    for (size_t i = 0; i < 5; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            float ref = 0;
+            for (size_t k = 0; k < 3; ++k) ref += A.data()[i * 3 + k] * B.data()[k * 4 + j];
+            CHECK_NEAR(C.data()[i * 4 + j], ref, 1e-5);
+            CHECK_NEAR(Ct.data()[j * 5 + i], ref, 1e-5);
+        }
+    }
+
+    Tensor<vectra::int32> v({ 3 });
+    Tensor<vectra::int32> M({ 3, 2 });
+    for (size_t i = 0; i < 3; ++i) v.data()[i] = vectra::int32(i + 1);
+    for (size_t i = 0; i < 6; ++i) M.data()[i] = vectra::int32(i);
+    const Tensor<vectra::int32> vm = dot(v, M);
+    CHECK(vm.shape == Shape({ 2 }));
+    CHECK(vm.data()[0] == 0 * 1 + 2 * 2 + 4 * 3);
+    CHECK(vm.data()[1] == 1 * 1 + 3 * 2 + 5 * 3);
+
+    // inner dimensions must agree
+    CHECK(exits_with_failure([&] { dot(A, A); }));
+}
+
+int main()
+{
+    for (size_t threads : { size_t(1), size_t(3) }) {
+        utils::set_num_threads(threads);
+        check_levels<vectra::float32>();
+        check_levels<vectra::float64>();
+    }
+    check_dot();
+    return test_result("test_gemm");
+}
@@ -0,0 +1,122 @@
+/*
+ *
+ * test_memory.cpp (v1.0)
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Regression test of the memory accounting of utils::vector (memory.h) and of the pool cache
+ * (allocator.h).
+ * A vector is charged the class size the pool reserves for it, the soft limit refuses what would
+ * pass it, and the pool cache is trimmed by the excess only, the largest blocks first.
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#include "check.h"
+#include <VectorUtility/vector.h>
+#include <vector>
+
+using utils::PoolAllocator;
+
+static size_t live() { return utils::memory_stats().live_bytes; }
+static size_t cached() { return utils::default_pool().cached_bytes(); }
+
+// trim() frees whole blocks, the largest classes first, until the bytes asked for are freed
+static void check_trim()
+{
+    PoolAllocator pool(size_t(1) << 24);
+    const size_t sizes[] = { 100, 5000, 5000, 70000 };
+    std::vector<void*> blocks;
+    for (size_t s : sizes) blocks.push_back(pool.allocate(s, utils::DEFAULT_ALIGNMENT));
+    for (size_t i = 0; i < blocks.size(); ++i) pool.deallocate(blocks[i], sizes[i], utils::DEFAULT_ALIGNMENT);
+
+    const size_t c100 = PoolAllocator::class_size(100), c5000 = PoolAllocator::class_size(5000);
+    const size_t c70000 = PoolAllocator::class_size(70000);
+    CHECK(c5000 >= 5000 && c5000 <= 5000 + 5000 / 4 + 64);
+    CHECK(pool.cached_bytes() == c100 + 2 * c5000 + c70000);
+
+    CHECK(pool.trim(1) == c70000);
+    CHECK(pool.trim(c5000 + 1) == 2 * c5000);
+    CHECK(pool.cached_bytes() == c100);
+    CHECK(pool.trim(size_t(1) << 30) == c100);
+    CHECK(pool.cached_bytes() == 0 && pool.trim(1) == 0);
+
+    // a lower maximum trims the excess only
+    for (size_t i = 0; i < 4; ++i) blocks[i] = pool.allocate(5000, utils::DEFAULT_ALIGNMENT);
+    for (size_t i = 0; i < 4; ++i) pool.deallocate(blocks[i], 5000, utils::DEFAULT_ALIGNMENT);
+    pool.set_max_cached_bytes(3 * c5000);
+    CHECK(pool.cached_bytes() == 3 * c5000);
+}
+
+// live bytes are class sizes, consistent between allocation and free
+static void check_charged()
+{
+    const size_t before = live();
+    {
+        utils::vector<float> v(1000);                   // 4000 bytes requested
+        CHECK(live() - before == PoolAllocator::class_size(4000));
+        CHECK(PoolAllocator::class_size(4000) == 4096);
+        v.resize(1500);
+        CHECK(live() - before == PoolAllocator::class_size(6000));
+    }
+    CHECK(live() == before);
+}
+
+// the soft limit : only the excess of the cache is handed back, refused allocations change nothing
+static void check_limit()
+{
+    const size_t block = 65536;
+    CHECK(PoolAllocator::class_size(block) == block);
+    utils::default_pool().release();
+
+    {
+        std::vector<utils::vector<float>> held;
+        for (size_t i = 0; i < 8; ++i) held.emplace_back(block / sizeof(float));
+    }
+    CHECK(cached() == 8 * block);
+
+    // 100 KiB over : two blocks go back, six stay
+    const size_t base = live();
+    const size_t limit = base + 8 * block - 100 * 1024;
+    utils::set_memory_limit(limit);
+    CHECK(cached() == 6 * block);
+
+    // one block over once charged : one block is trimmed, the allocation takes another from the cache
+    {
+        utils::vector<float> v(block / sizeof(float));
+        CHECK(live() == base + block);
+        CHECK(cached() == 4 * block);
+        CHECK(live() + cached() <= limit);
+    }
+
+    // past the limit : refused, the live bytes unchanged and the whole cache handed back
+    const size_t refused = utils::memory_stats().refused;
+    bool threw = false;
+    try {
+        utils::vector<float> big(size_t(1) << 20);
+    }
+    catch (const utils::MemoryLimitError&) {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK(utils::memory_stats().refused == refused + 1);
+    CHECK(live() == base);
+    CHECK(cached() == 0);
+
+    utils::set_memory_limit(0);
+    utils::vector<float> big(size_t(1) << 20);
+    CHECK(live() == base + PoolAllocator::class_size(sizeof(float) << 20));
+}
+
+int main()
+{
+    check_trim();
+    check_charged();
+    check_limit();
+    return test_result("test_memory");
+}
@@ -0,0 +1,299 @@
+/*
+ *
+ * test_npy.cpp (v1.0)
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Regression test of the .npy / .npz reader and writer (Npy.h).
+ * Arrays are written and read back (load, mmap, chunked Reader, .npz members), hand-made files
+ * check the big-endian, Fortran-order and version 2.0 headers, and damaged files (short or
+ * truncated headers, a wrong magic, missing data, shapes and zip offsets that wrap around) must be
+ * refused without reading past a buffer.
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#include "check.h"
+#include <cpu/Npy.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace vectra;
+
+static std::vector<std::string>& temp_files()
+{
+    static std::vector<std::string> files;
+    return files;
+}
+
+// file of the working directory, removed at the end of the test
+static std::string temp_path(const char* name)
+{
+    std::string path = std::string("test_npy_") + name;
+    temp_files().push_back(path);
+    return path;
+}
+
+static void write_bytes(const std::string& path, const std::string& bytes)
+{
+    FILE* f = fopen(path.c_str(), "wb");
+    CHECK(f != nullptr);
+    if (!f) return;
+    fwrite(bytes.data(), 1, bytes.size(), f);
+    fclose(f);
+}
+
+// magic, version, the header length `len` (little-endian) and `dict`
+static std::string npy_header(int major, const std::string& dict, size_t len)
+{
+    std::string h("\x93NUMPY", 6);
+    h += char(major);
+    h += char(0);
+    h += char(len & 0xff);
+    h += char((len >> 8) & 0xff);
+    if (major >= 2) {
+        h += char((len >> 16) & 0xff);
+        h += char((len >> 24) & 0xff);
+    }
+    return h + dict;
+}
+
+// dict padded with spaces so that the data starts on 64 bytes, as NumPy writes it
+static std::string padded_dict(const std::string& dict, size_t prefix)
+{
+    std::string d = dict;
+    while ((prefix + d.size() + 1) % 64) d += ' ';
+    return d + '\n';
+}
+
+template<typename T>
+static bool same_elements(const Tensor<T>& a, const Tensor<T>& b)
+{
+    if (!(a.shape == b.shape)) return false;
+    const Tensor<T> ca = contiguous(a), cb = contiguous(b);
+    return std::memcmp(ca.data(), cb.data(), ca.numel() * sizeof(T)) == 0;
+}
+
+// save then load / mmap / Reader, C order and a transposed view
+static void check_round_trip()
+{
+    vectra::manual_seed(5);
+    const Tensor<float> A = rand<float>({ 7, 13 });
+    Tensor<vectra::int16> B({ 4, 3, 2 });
+    for (size_t i = 0; i < B.numel(); ++i) B.data()[i] = vectra::int16(int(i) * 301 - 3000);
+
+    const std::string pa = temp_path("a.npy"), pb = temp_path("b.npy"), pt = temp_path("t.npy");
+    npy::save(pa, A);
+    npy::save(pb, B);
+    npy::save(pt, transpose(A));
+
+    CHECK(same_elements(npy::load<float>(pa), A));
+    CHECK(same_elements(npy::mmap<float>(pa), A));
+    CHECK(same_elements(npy::load<vectra::int16>(pb), B));
+    CHECK(same_elements(npy::load<float>(pt), transpose(A)));
+
+    npy::Reader<float> reader;
+    CHECK(reader.open(pa) == nullptr);
+    std::vector<float> chunked(A.numel());
+    size_t got = 0;
+    while (size_t n = reader.read(chunked.data() + got, 10)) got += n;
+    CHECK(got == A.numel());
+    CHECK(std::memcmp(chunked.data(), A.data(), got * sizeof(float)) == 0);
+
+    // a file of another dtype is refused
+    Tensor<double> wrong;
+    CHECK(npy::read_npy<double>(pa, wrong) != nullptr);
+
+    AnyTensor any;
+    CHECK(npy::load_any(pb, true, any) == nullptr);
+
+    // .npz members : views of the archive
+    const std::string pz = temp_path("z.npz");
+    {
+        npy::NpzWriter zip(pz);
+        zip.add("a", A);
+        zip.add("b", B);
+        zip.close();
+    }
+    npy::NpzFile npz;
+    CHECK(npz.open(pz) == nullptr);
+    CHECK(npz.names().size() == 2);
+    Tensor<float> za;
+    Tensor<vectra::int16> zb;
+    CHECK(npz.get("a", za) == nullptr && same_elements(za, A));
+    CHECK(npz.get("b", zb) == nullptr && same_elements(zb, B));
+    CHECK(npz.get("c", za) != nullptr);
+}
+
+// hand-made headers : big-endian Fortran-order float64, version 2.0
+static void check_written_by_numpy()
+{
+    // np.array([[1, 2, 3], [4, 5, 6]], '>f8', order='F')
+    const std::string dict = padded_dict("{'descr': '>f8', 'fortran_order': True, 'shape': (2, 3), }", 10);
+    std::string bytes = npy_header(1, dict, dict.size());
+    const double column_major[] = { 1, 4, 2, 5, 3, 6 };
+    for (double v : column_major) {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(v));
+        for (int b = 7; b >= 0; --b) bytes += char((bits >> (8 * b)) & 0xff);
+    }
+    const std::string pf = temp_path("fortran.npy");
+    write_bytes(pf, bytes);
+
+    for (bool mapped : { false, true }) {
+        const Tensor<double> F = mapped ? npy::mmap<double>(pf) : npy::load<double>(pf);
+        CHECK(F.shape == Shape({ 2, 3 }));
+        CHECK(F.strides == Shape({ 1, 2 }));
+        for (size_t i = 0; i < 2; ++i)
+            for (size_t j = 0; j < 3; ++j) CHECK(F.data()[F.offset + i * F.strides[0] + j * F.strides[1]] == double(i * 3 + j + 1));
+    }
+
+    // version 2.0 : 4-byte header length
+    const std::string dict2 = padded_dict("{'descr': '<i4', 'fortran_order': False, 'shape': (3,), }", 12);
+    std::string bytes2 = npy_header(2, dict2, dict2.size());
+    const int32_t values[] = { -1, 70000, 3 };
+    bytes2.append(reinterpret_cast<const char*>(values), sizeof(values));
+    const std::string p2 = temp_path("v2.npy");
+    write_bytes(p2, bytes2);
+    const Tensor<vectra::int32> V = npy::load<vectra::int32>(p2);
+    CHECK(V.shape == Shape({ 3 }));
+    CHECK(V.data()[0] == -1 && V.data()[1] == 70000 && V.data()[2] == 3);
+}
+
+// every reader refuses the file with `reason`
+static void check_refused(const char* name, const std::string& bytes, const char* reason)
+{
+    const std::string path = temp_path(name);
+    write_bytes(path, bytes);
+
+    Tensor<float> t;
+    const char* err = npy::read_npy<float>(path, t);
+    if (!err || std::strcmp(err, reason) != 0) fprintf(stderr, "  %s : %s, expected %s\n", name, err ? err : "accepted", reason);
+    CHECK(err && std::strcmp(err, reason) == 0);
+
+    CHECK(npy::map_npy<float>(path, t) != nullptr);
+    AnyTensor any;
+    CHECK(npy::load_any(path, false, any) != nullptr);
+    npy::ArrayInfo info;
+    CHECK(npy::parse_header(bytes.data(), bytes.size(), info) != nullptr || std::strcmp(reason, "truncated data") == 0);
+    CHECK(exits_with_failure([&] { npy::load<float>(path); }));
+}
+
+static void check_damaged()
+{
+    const std::string dict = padded_dict("{'descr': '<f4', 'fortran_order': False, 'shape': (4,), }", 10);
+    const std::string good = npy_header(1, dict, dict.size()) + std::string(16, '\0');
+
+    // 10 bytes precede the dict in version 1, 12 in versions 2 and 3
+    check_refused("empty.npy", std::string(), "truncated header");
+    check_refused("magic_only.npy", std::string("\x93NUMPY", 6), "truncated header");
+    check_refused("bad_magic.npy", "\x93NUMPZ" + good.substr(6), "not a .npy file");
+    check_refused("version9.npy", good.substr(0, 6) + '\x09' + good.substr(7), "unsupported .npy version");
+    check_refused("len0.npy", npy_header(1, "", 0), "header too short");
+    check_refused("len10.npy", npy_header(1, "{'a': 1} \n", 10), "header too short");
+    check_refused("v2_short.npy", npy_header(1, "", 0).replace(6, 1, 1, '\x02'), "truncated header");
+    check_refused("v2_len0.npy", npy_header(2, "", 0), "header too short");
+    check_refused("long_len.npy", npy_header(1, dict, 4000), "truncated header");
+    check_refused("no_data.npy", good.substr(0, good.size() - 5), "truncated data");
+
+    // 2^62 float32 elements are 2^64 bytes, 2^32 x 2^32 elements wrap to 0
+    const std::string huge = padded_dict("{'descr': '<f4', 'fortran_order': False, 'shape': (4611686018427387904,), }", 10);
+    check_refused("huge.npy", npy_header(1, huge, huge.size()) + std::string(16, '\0'), "shape too large");
+    const std::string wraps = padded_dict("{'descr': '<f4', 'fortran_order': False, 'shape': (4294967296, 4294967296), }", 10);
+    check_refused("wraps.npy", npy_header(1, wraps, wraps.size()) + std::string(16, '\0'), "shape too large");
+}
+
+static void patch32(std::string& s, size_t at, uint32_t v)
+{
+    for (int b = 0; b < 4; ++b) s[at + b] = char((v >> (8 * b)) & 0xff);
+}
+
+// offsets and sizes of the zip directories near 2^32 or 2^64 must not wrap around the mapping
+static void check_damaged_npz()
+{
+    const std::string pz = temp_path("good.npz");
+    {
+        npy::NpzWriter zip(pz);
+        zip.add("a", ones<float>({ 8 }));
+        zip.close();
+    }
+    std::string good;
+    {
+        FILE* f = fopen(pz.c_str(), "rb");
+        CHECK(f != nullptr);
+        if (!f) return;
+        char buf[4096];
+        while (size_t n = fread(buf, 1, sizeof(buf), f)) good.append(buf, n);
+        fclose(f);
+    }
+    const size_t eocd = good.size() - 22;                  // no archive comment
+    const size_t central = size_t(npy::get32(&good[eocd + 16]));
+
+    auto refused = [&](const char* name, const std::string& bytes, bool at_open, const char* reason) {
+        const std::string path = temp_path(name);
+        write_bytes(path, bytes);
+        npy::NpzFile npz;
+        const char* err = npz.open(path);
+        Tensor<float> t;
+        if (!at_open && !err) err = npz.get("a", t);
+        if (!err || std::strcmp(err, reason) != 0) fprintf(stderr, "  %s : %s, expected %s\n", name, err ? err : "accepted", reason);
+        return err && std::strcmp(err, reason) == 0;
+    };
+
+    std::string cd_past = good;
+    patch32(cd_past, eocd + 16, 0xfffffff0u);
+    CHECK(refused("cd_past.npz", cd_past, true, "bad central directory"));
+
+    // zip64 locator pointing 16 bytes below 2^64
+    std::string z64 = good.substr(0, eocd);
+    npy::put32(z64, npy::ZIP64_LOCATOR);
+    npy::put32(z64, 0);
+    npy::put64(z64, ~uint64_t(0) - 15);
+    npy::put32(z64, 1);
+    z64 += good.substr(eocd);
+    patch32(z64, z64.size() - 22 + 16, 0xffffffffu);
+    CHECK(refused("z64_past.npz", z64, true, "bad zip64 directory"));
+
+    std::string local_past = good;
+    patch32(local_past, central + 42, 0xfffffff0u);
+    CHECK(refused("local_past.npz", local_past, false, "bad local header"));
+
+    std::string compressed_past = good;
+    patch32(compressed_past, central + 20, 0xfffffff0u);
+    CHECK(refused("compressed_past.npz", compressed_past, false, "truncated member"));
+
+    std::string size_past = good;
+    patch32(size_past, central + 24, 0xfffffff0u);
+    CHECK(refused("size_past.npz", size_past, false, "truncated member"));
+
+    // a zip64 extra field shorter than the values it must hold
+    std::string extra = good;
+    patch32(extra, central + 24, 0xffffffffu);
+    const size_t name_len = npy::get16(&good[central + 28]);
+    std::string field;
+    npy::put16(field, 0x0001);
+    npy::put16(field, 4);
+    npy::put32(field, 0);
+    extra.insert(central + 46 + name_len, field);
+    extra[central + 30] = char(field.size());
+    patch32(extra, extra.size() - 22 + 12, npy::get32(&extra[extra.size() - 22 + 12]) + uint32_t(field.size()));
+    CHECK(refused("short_zip64.npz", extra, true, "bad zip64 field"));
+}
+
+int main()
+{
+    check_round_trip();
+    check_written_by_numpy();
+    check_damaged();
+    check_damaged_npz();
+    for (const std::string& path : temp_files()) std::remove(path.c_str());
+    return test_result("test_npy");
+}
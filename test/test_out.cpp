@@ -0,0 +1,199 @@
+/*
+ *
+ * test_out.cpp (v1.0)
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Regression test of the out-parameter and in-place ops and of the lazy expressions writing
+ * over their own operands (TensorOps.h, TensorExpr.h).
+ * Strided and in-place outs must give the values of a fresh result and leave the rest of their
+ * storage alone, an out that reaches an element twice (or of the wrong shape or layout) exits, and
+ * an expression reading out through another view (transpose, shifted slice, broadcast row) must
+ * give the result of a pass through a temporary.
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#include "check.h"
+#include <cpu/TensorOps.h>
+#include <cmath>
+#include <vector>
+
+static Tensor<float> filled(const Shape& shape, float scale)
+{
+    Tensor<float> t(shape);
+    for (size_t i = 0; i < t.numel(); ++i) t.data()[i] = float(int(i * 7 % 13) - 6) * scale + 0.25f;
+    return t;
+}
+
+// packed copy with storage of its own : contiguous() of a packed tensor is the tensor itself
+static Tensor<float> copy_of(const Tensor<float>& t)
+{
+    Tensor<float> c(t.shape);
+    for (size_t i = 0; i < t.shape[0]; ++i)
+        for (size_t j = 0; j < t.shape[1]; ++j) c.data()[i * t.shape[1] + j] = t.data()[t.offset + i * t.strides[0] + j * t.strides[1]];
+    return c;
+}
+
+static float at(const Tensor<float>& t, size_t i, size_t j)
+{
+    return t.data()[t.offset + i * t.strides[0] + j * t.strides[1]];
+}
+
+// same shape and same values, whatever the layouts
+static bool same_values(const Tensor<float>& a, const Tensor<float>& b)
+{
+    if (!(a.shape == b.shape) || a.shape.size() != 2) return false;
+    for (size_t i = 0; i < a.shape[0]; ++i)
+        for (size_t j = 0; j < a.shape[1]; ++j)
+            if (at(a, i, j) != at(b, i, j)) return false;
+    return true;
+}
+
+// outs written through their strides, in place and as lazy constants
+static void check_strided_outs()
+{
+    const Tensor<float> A = filled({ 6, 5 }, 1.0f), B = filled({ 6, 5 }, 0.5f), row = filled({ 5 }, 2.0f);
+    const Tensor<float> ref = add(A, B);
+
+    // every other column of a wider buffer : the columns in between keep their values
+    Tensor<float> wide({ 6, 10 }, -9.0f);
+    Tensor<float> half = slice(wide, 1, 0, 10, 2);
+    add(A, B, half);
+    CHECK(same_values(half, ref));
+    for (size_t i = 0; i < 6; ++i)
+        for (size_t j = 1; j < 10; j += 2) CHECK(wide.data()[i * 10 + j] == -9.0f);
+
+    // a transposed out
+    Tensor<float> back({ 5, 6 });
+    Tensor<float> bt = transpose(back);
+    mul(A, row, bt);
+    CHECK(same_values(bt, mul(A, row)));
+
+    // out is the first operand, with a broadcast second operand
+    Tensor<float> a = copy_of(A);
+    add(a, B, a);
+    CHECK(same_values(a, ref));
+    Tensor<float> a2 = copy_of(A);
+    sub_(a2, row);
+    CHECK(same_values(a2, sub(A, row)));
+
+    // a lazy constant out is materialized before it is written
+    Tensor<float> z = zeros<float>({ 6, 5 });
+    div(A, B, z);
+    CHECK(!z.is_lazy() && same_values(z, div(A, B)));
+
+    // unary ops and reductions into outs
+    Tensor<float> e({ 5, 6 });
+    Tensor<float> et = transpose(e);
+    exp_tensor(A, et);
+    CHECK(same_values(et, exp_tensor(A)));
+    Tensor<float> s({ 5 });
+    sum(A, { 0 }, false, s);
+    const Tensor<float> sref = sum(A, { 0 });
+    for (size_t j = 0; j < 5; ++j) CHECK(s.data()[j] == sref.data()[j]);
+}
+
+// outs that cannot be written are refused
+static void check_refused_outs()
+{
+    const Tensor<float> A = filled({ 4, 5 }, 1.0f), B = filled({ 4, 5 }, 0.5f);
+    const Tensor<float> row = filled({ 5 }, 1.0f);
+
+    CHECK(exits_with_failure([&] { Tensor<float> out({ 5, 4 }); add(A, B, out); }));
+    CHECK(exits_with_failure([&] { Tensor<float> out; add(A, B, out); }));
+    // the rows of an expanded out are one row of memory
+    CHECK(exits_with_failure([&] { Tensor<float> out = expand(row, { 4, 5 }); add(A, B, out); }));
+    CHECK(exits_with_failure([&] { Tensor<float> out = expand(row, { 4, 5 }); exp_tensor(A, out); }));
+    CHECK(exits_with_failure([&] { Tensor<float> out = expand(row, { 4, 5 }); pow_tensor(A, B, out); }));
+    CHECK(exits_with_failure([&] { Tensor<float> out = expand(row, { 4, 5 }); vectra::expr::assign(out, A + B); }));
+    // reductions and dot write packed outs
+    CHECK(exits_with_failure([&] { Tensor<float> buf({ 10 }); Tensor<float> out = slice(buf, 0, 0, 10, 2); sum(A, { 0 }, false, out); }));
+    CHECK(exits_with_failure([&] { Tensor<float> buf({ 5, 5 }); Tensor<float> out = transpose(buf); dot(transpose(A), A, out); }));
+}
+
+// expressions assigned over a view of one of their leaves
+static void check_expression_aliasing()
+{
+    using vectra::expr::assign;
+
+    // the very view of out is read block by block in place
+    Tensor<float> x = filled({ 7, 7 }, 1.0f);
+    const Tensor<float> x0 = copy_of(x);
+    assign(x, x * 2.0f + 1.0f);
+    CHECK(same_values(x, add(mul(x0, full<float>({ 7, 7 }, 2.0f)), ones<float>({ 7, 7 }))));
+
+    // x = transpose(x) * 2 + 1 : every element reads one written earlier in the pass
+    Tensor<float> y = copy_of(x0);
+    assign(y, transpose(y) * 2.0f + 1.0f);
+    for (size_t i = 0; i < 7; ++i)
+        for (size_t j = 0; j < 7; ++j) CHECK(at(y, i, j) == at(x0, j, i) * 2.0f + 1.0f);
+
+    // a slice shifted by one row : row i + 1 takes the old row i
+    Tensor<float> s = copy_of(x0);
+    Tensor<float> dst = slice(s, 0, 1, 7);
+    assign(dst, slice(s, 0, 0, 6) + 1.0f);
+    for (size_t j = 0; j < 7; ++j) CHECK(at(s, 0, j) == at(x0, 0, j));
+    for (size_t i = 1; i < 7; ++i)
+        for (size_t j = 0; j < 7; ++j) CHECK(at(s, i, j) == at(x0, i - 1, j) + 1.0f);
+
+    // row 0 of x broadcast over x, row 0 written first
+    Tensor<float> r = copy_of(x0);
+    assign(r, r + slice(r, 0, 0, 1));
+    for (size_t i = 0; i < 7; ++i)
+        for (size_t j = 0; j < 7; ++j) CHECK(at(r, i, j) == at(x0, i, j) + at(x0, 0, j));
+
+    // a tall tensor : more rows than one block, over several threads
+    utils::set_num_threads(3);
+    Tensor<float> big = filled({ 300, 300 }, 0.5f);
+    const Tensor<float> big0 = copy_of(big);
+    assign(big, transpose(big) - big);
+    size_t wrong = 0;
+    for (size_t i = 0; i < 300; ++i)
+        for (size_t j = 0; j < 300; ++j) wrong += at(big, i, j) != at(big0, j, i) - at(big0, i, j);
+    CHECK(wrong == 0);
+    utils::set_num_threads(1);
+}
+
+// pow_tensor over broadcast and strided operands and outs
+static void check_pow()
+{
+    Tensor<float> A = filled({ 5, 6 }, 0.25f);
+    for (size_t i = 0; i < A.numel(); ++i) A.data()[i] = std::fabs(A.data()[i]) + 0.5f;
+    const Tensor<float> col = filled({ 5, 1 }, 0.5f), row = filled({ 6 }, 0.25f);
+
+    const Tensor<float> pc = pow_tensor(A, col);
+    const Tensor<float> pr = pow_tensor(transpose(A), slice(filled({ 5 }, 0.5f), 0, 0, 5));
+    CHECK(pc.shape == Shape({ 5, 6 }));
+    CHECK(pr.shape == Shape({ 6, 5 }));
+    for (size_t i = 0; i < 5; ++i) {
+        for (size_t j = 0; j < 6; ++j) {
+            CHECK_NEAR(at(pc, i, j), std::pow(at(A, i, j), col.data()[i]), 1e-5 * (1 + std::fabs(at(pc, i, j))));
+            CHECK_NEAR(at(pr, j, i), std::pow(at(A, i, j), filled({ 5 }, 0.5f).data()[i]), 1e-5 * (1 + std::fabs(at(pr, j, i))));
+        }
+    }
+
+    // into a transposed out, and in place with a broadcast exponent row
+    Tensor<float> back({ 6, 5 });
+    Tensor<float> out = transpose(back);
+    pow_tensor(A, col, out);
+    CHECK(same_values(out, pc));
+    Tensor<float> a = copy_of(A);
+    pow_(a, row);
+    const Tensor<float> ref = pow_tensor(A, row);
+    CHECK(same_values(a, ref));
+}
+
+int main()
+{
+    check_strided_outs();
+    check_refused_outs();
+    check_expression_aliasing();
+    check_pow();
+    return test_result("test_out");
+}
@@ -0,0 +1,166 @@
+/*
+ *
+ * test_random.cpp (v1.0)
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Regression test of the Philox random number kernels (Random.h) and of rand() / randn().
+ * The block function is checked on the known answers of the Random123 distribution, the uniform
+ * stream must be bit-identical at every ISA level and however a range is split, and a seeded
+ * tensor must hold the same values whatever the number of threads.
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#include "check.h"
+#include <cpu/TensorOps.h>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace vectra::kernel;
+
+template<typename T>
+using RandomFn = void (*)(uint64_t, uint64_t, T*, size_t);
+
+static const size_t LENGTHS[] = { 0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 1000, 4099 };
+
+// Philox4x32-10 known answers (Random123 kat_vectors) : counter, key (k0 in the low word), result
+static void check_known_answers()
+{
+    struct Kat { uint32_t ctr[4]; uint64_t key; uint32_t out[4]; };
+    const Kat kats[] = {
+        { { 0, 0, 0, 0 }, 0,
+          { 0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u } },
+        { { 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu }, 0xffffffffffffffffull,
+          { 0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu } },
+        { { 0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u }, 0x299f31d0a4093822ull,
+          { 0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u } },
+    };
+    for (const Kat& k : kats) {
+        uint32_t c[4] = { k.ctr[0], k.ctr[1], k.ctr[2], k.ctr[3] };
+        scalar::philox4x32(c, k.key);
+        CHECK(std::memcmp(c, k.out, sizeof(c)) == 0);
+    }
+}
+
+// the uniform stream of a level equals the scalar one bit for bit, from any block and for any length
+template<typename T>
+static void check_uniform(const char* level, RandomFn<T> fn)
+{
+    const uint64_t starts[] = { 0, 1, 7, 0xfffffffdull, uint64_t(1) << 40 };
+    const T sentinel = T(-1);
+    for (uint64_t block : starts) {
+        for (size_t n : LENGTHS) {
+            std::vector<T> out(n + 1, sentinel), ref(n + 1, sentinel);
+            scalar::random_uniform<T>(0x1234abcdull, block, ref.data(), n);
+            fn(0x1234abcdull, block, out.data(), n);
+            const bool same = std::memcmp(out.data(), ref.data(), (n + 1) * sizeof(T)) == 0;
+            if (!same) fprintf(stderr, "  %s uniform, block %llu, n = %zu\n", level, (unsigned long long)block, n);
+            CHECK(same);
+            for (size_t i = 0; i < n; ++i) CHECK(ref[i] >= T(0) && ref[i] < T(1));
+        }
+    }
+}
+
+// normal values : avx2 and avx512 agree bit for bit, the scalar level within a few ULP
+template<typename T>
+static void check_normal(const char* level, RandomFn<T> fn, std::vector<T>& simd)
+{
+    const size_t n = 4099;
+    std::vector<T> out(n + 1, T(99)), ref(n + 1, T(99));
+    scalar::random_normal<T>(42, 3, ref.data(), n);
+    fn(42, 3, out.data(), n);
+    CHECK(out[n] == T(99));
+
+    size_t far = 0;
+    for (size_t i = 0; i < n; ++i) far += std::fabs(out[i] - ref[i]) > T(64) * std::numeric_limits<T>::epsilon() * (T(1) + std::fabs(ref[i]));
+    if (far) fprintf(stderr, "  %s normal : %zu values away from the scalar level\n", level, far);
+    CHECK(far == 0);
+
+    if (simd.empty()) simd = out;
+    else CHECK(std::memcmp(simd.data(), out.data(), n * sizeof(T)) == 0);
+}
+
+template<typename T>
+static void check_levels()
+{
+    const Isa cpu = cpu_isa();
+    std::vector<T> simd;
+    if (cpu >= Isa::AVX2) {
+        check_uniform<T>("avx2", &avx2::rng::uniform<T>);
+        check_normal<T>("avx2", &avx2::rng::normal<T>, simd);
+    }
+    if (cpu >= Isa::AVX512) {
+        check_uniform<T>("avx512", &avx512::rng::uniform<T>);
+        check_normal<T>("avx512", &avx512::rng::normal<T>, simd);
+    }
+    check_uniform<T>("vectra::kernel", &vectra::kernel::random_uniform<T>);     // dispatched entry point
+
+    // a range split at any block boundary gives the values of one call
+    constexpr size_t PB = random_per_block<T>();
+    const size_t n = 1001;
+    std::vector<T> whole(n), parts(n);
+    random_normal<T>(9, 100, whole.data(), n);
+    for (size_t lo = 0, b = 100, step = PB; lo < n; lo += step, b += step / PB, step += PB)
+        random_normal<T>(9, b, parts.data() + lo, std::min(step, n - lo));
+    CHECK(std::memcmp(whole.data(), parts.data(), n * sizeof(T)) == 0);
+}
+
+// rand() / randn() : seeded streams, thread counts, generator offsets, moments
+static void check_tensors()
+{
+    std::vector<float> first;
+    for (size_t threads : { size_t(1), size_t(3) }) {
+        utils::set_num_threads(threads);
+        vectra::manual_seed(2025);
+        const Tensor<float> u = rand<float>({ 300, 301 });
+        const Tensor<float> g = randn<float>({ 1, 777 });
+        std::vector<float> values(u.data(), u.data() + u.numel());
+        values.insert(values.end(), g.data(), g.data() + g.numel());
+        if (first.empty()) first = values;
+        else CHECK(first == values);
+    }
+    utils::set_num_threads(1);
+
+    // two calls never overlap, an offset replays them, another seed gives another stream
+    vectra::Generator gen(7);
+    const uint64_t start = gen.offset();
+    const Tensor<double> a = rand<double>({ 1000 }, gen);
+    const Tensor<double> b = rand<double>({ 1000 }, gen);
+    CHECK(std::memcmp(a.data(), b.data(), 1000 * sizeof(double)) != 0);
+    gen.set_offset(start);
+    const Tensor<double> a2 = rand<double>({ 1000 }, gen);
+    CHECK(std::memcmp(a.data(), a2.data(), 1000 * sizeof(double)) == 0);
+    vectra::Generator other(8);
+    CHECK(std::memcmp(a.data(), rand<double>({ 1000 }, other).data(), 1000 * sizeof(double)) != 0);
+
+    // moments of 10^6 draws : 5 standard errors
+    const size_t n = 1000000;
+    const Tensor<double> u = rand<double>({ n }, gen);
+    const Tensor<double> z = randn<double>({ n }, gen);
+    double su = 0, sz = 0, sz2 = 0;
+    for (size_t i = 0; i < n; ++i) {
+        su += u.data()[i];
+        sz += z.data()[i];
+        sz2 += z.data()[i] * z.data()[i];
+    }
+    CHECK_NEAR(su / n, 0.5, 5 * std::sqrt(1.0 / 12 / n));
+    CHECK_NEAR(sz / n, 0.0, 5 * std::sqrt(1.0 / n));
+    CHECK_NEAR(sz2 / n, 1.0, 5 * std::sqrt(2.0 / n));
+}
+
+int main()
+{
+    check_known_answers();
+    check_levels<vectra::float32>();
+    check_levels<vectra::float64>();
+    check_tensors();
+    return test_result("test_random");
+}
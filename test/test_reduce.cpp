@@ -0,0 +1,196 @@
+/*
+ *
+ * test_reduce.cpp (v1.0)
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Regression test of the reduction kernels (Reduce.h) and of the Tensor reductions.
+ * Every ISA level the CPU has is checked against the scalar level (exact for integers, max and min,
+ * within a rounding bound for floating-point sums), then sum / mean / argmax along axes, and the
+ * integer means whose element count does not fit in the element type.
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#include "check.h"
+#include <cpu/TensorOps.h>
+#include <cstdint>
+#include <vector>
+
+using namespace vectra::kernel;
+
+static const size_t LENGTHS[] = { 0, 1, 2, 3, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 128, 129, 1000, 4099 };
+
+// values in [-5, 5] : integer sums of a few thousand stay in range, products are taken on short runs
+template<typename T>
+static void fill(std::vector<T>& v, uint32_t seed)
+{
+    for (T& x : v) {
+        seed = seed * 1664525u + 1013904223u;
+        const int r = int(seed >> 24) % 11 - 5;
+        x = std::is_floating_point<T>::value ? T(r) / T(4) + T(0.125) : T(r);
+    }
+}
+
+// floating-point sums of n values below 1.5 differ by the summation order only
+template<typename T>
+static bool agrees(T got, T ref, size_t n)
+{
+    if constexpr (std::is_floating_point<T>::value)
+        return got == ref || std::fabs(double(got) - double(ref)) <= double(n + 1) * std::numeric_limits<T>::epsilon() * 1.5 * double(n);
+    else
+        return got == ref;
+}
+
+template<ReduceOp Op, typename T>
+static void check_op(const char* level, T (*reduce_fn)(const T*, size_t),
+                     void (*rows_fn)(const T*, size_t, size_t, T*, size_t))
+{
+    for (size_t n : LENGTHS) {
+        // products of more than a few values overflow the integer types
+        if (Op == ReduceOp::Prod && n > 16) continue;
+
+        for (size_t off = 0; off < 2; ++off) {
+            std::vector<T> a(n + 1);
+            fill(a, uint32_t(n * 11 + off));
+            const T ref = scalar::reduce<Op>(a.data() + off, n);
+            const T got = reduce_fn(a.data() + off, n);
+            if (!agrees(got, ref, n)) fprintf(stderr, "  %s reduce, n = %zu, offset %zu\n", level, n, off);
+            CHECK(agrees(got, ref, n));
+        }
+
+        // 5 rows of n columns, rows padded to n + 3
+        const size_t rows = 5, stride = n + 3;
+        const T sentinel = T(99);
+        std::vector<T> a(rows * stride), out(n + 1, sentinel), ref(n + 1, sentinel);
+        fill(a, uint32_t(n * 3 + 7));
+        scalar::reduce_rows<Op>(a.data(), rows, stride, ref.data(), n);
+        rows_fn(a.data(), rows, stride, out.data(), n);
+        for (size_t j = 0; j < n; ++j) CHECK(agrees(out[j], ref[j], rows));
+        CHECK(out[n] == sentinel);
+    }
+}
+
+template<typename T>
+static void check_find(const char* level, size_t (*find_fn)(const T*, size_t, T))
+{
+    for (size_t n : LENGTHS) {
+        std::vector<T> a(n, T(1));
+        CHECK(find_fn(a.data(), n, T(2)) == n);
+        for (size_t at : { size_t(0), n / 2, n - 1 }) {
+            if (n == 0) break;
+            a.assign(n, T(1));
+            a[at] = T(2);
+            if (at + 1 < n) a[n - 1] = T(2);           // the first match wins
+            CHECK(find_fn(a.data(), n, T(2)) == at);
+        }
+    }
+}
+
+#define VECTRA_CHECK_LEVEL(ns, T)                                                                        \
+    do {                                                                                                 \
+        check_op<ReduceOp::Sum, T>(#ns, &ns::reduce<ReduceOp::Sum, T>, &ns::reduce_rows<ReduceOp::Sum, T>);     \
+        check_op<ReduceOp::Prod, T>(#ns, &ns::reduce<ReduceOp::Prod, T>, &ns::reduce_rows<ReduceOp::Prod, T>);  \
+        check_op<ReduceOp::Max, T>(#ns, &ns::reduce<ReduceOp::Max, T>, &ns::reduce_rows<ReduceOp::Max, T>);     \
+        check_op<ReduceOp::Min, T>(#ns, &ns::reduce<ReduceOp::Min, T>, &ns::reduce_rows<ReduceOp::Min, T>);     \
+        check_find<T>(#ns, &ns::find_first<T>);                                                          \
+    } while (0)
+
+template<typename T>
+static void check_levels()
+{
+    const Isa cpu = cpu_isa();
+    if (cpu >= Isa::SSE42)  VECTRA_CHECK_LEVEL(sse42, T);
+    if (cpu >= Isa::AVX2)   VECTRA_CHECK_LEVEL(avx2, T);
+    if (cpu >= Isa::AVX512) VECTRA_CHECK_LEVEL(avx512, T);
+    VECTRA_CHECK_LEVEL(vectra::kernel, T);      // dispatched entry point
+}
+
+// Tensor reductions along axes, keepdims and arg reductions
+static void check_axes()
+{
+    Tensor<float> A({ 4, 6, 5 });
+    for (size_t i = 0; i < A.numel(); ++i) A.data()[i] = float(int(i * 7 % 23) - 11);
+
+    const Tensor<float> s1 = sum(A, { 1 });
+    const Tensor<float> m02 = mean(A, { 0, 2 }, true);
+    CHECK(s1.shape == Shape({ 4, 5 }));
+    CHECK(m02.shape == Shape({ 1, 6, 1 }));
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t k = 0; k < 5; ++k) {
+            float ref = 0;
+            for (size_t j = 0; j < 6; ++j) ref += A.data()[(i * 6 + j) * 5 + k];
+            CHECK(s1.data()[i * 5 + k] == ref);
+        }
+    }
+    for (size_t j = 0; j < 6; ++j) {
+        double ref = 0;
+        for (size_t i = 0; i < 4; ++i)
+            for (size_t k = 0; k < 5; ++k) ref += A.data()[(i * 6 + j) * 5 + k];
+        CHECK_NEAR(m02.data()[j], ref / 20.0, 1e-5);
+    }
+
+    // the first extremum wins, along the whole tensor and along an axis
+    Tensor<vectra::int32> v({ 3, 4 });
+    const vectra::int32 values[] = { 1, 9, 9, 0, 7, -2, 3, -2, 9, 5, -2, 4 };
+    for (size_t i = 0; i < 12; ++i) v.data()[i] = values[i];
+    CHECK(argmax(v).data()[0] == 1);
+    CHECK(argmin(v).data()[0] == 5);
+    const Tensor<vectra::int32> am = argmax(v, 1);
+    CHECK(am.shape == Shape({ 3 }));
+    CHECK(am.data()[0] == 1 && am.data()[1] == 0 && am.data()[2] == 0);
+    const Tensor<vectra::int32> an = argmin(v, 0, true);
+    CHECK(an.shape == Shape({ 1, 4 }));
+    CHECK(an.data()[0] == 0 && an.data()[1] == 1 && an.data()[2] == 2 && an.data()[3] == 1);
+
+    CHECK(exits_with_failure([&] { sum(A, { 3 }); }));
+}
+
+// integer means : the count (256, 200, 65536 elements) does not fit in the element type
+static void check_integer_means()
+{
+    Tensor<vectra::int8> z8({ 256 }, vectra::int8(0));
+    CHECK(mean(z8).data()[0] == 0);
+
+    Tensor<vectra::int8> a8({ 200 }, vectra::int8(0));
+    for (size_t i = 0; i < 120; ++i) a8.data()[i] = vectra::int8(1);
+    CHECK(mean(a8).data()[0] == 0);                 // 120 / 200, not 120 / -56
+
+    Tensor<vectra::int8> r8({ 2, 200 }, vectra::int8(0));
+    r8.data()[0] = vectra::int8(100);
+    r8.data()[200] = vectra::int8(-100);
+    const Tensor<vectra::int8> rm8 = mean(r8, { 1 });
+    CHECK(rm8.data()[0] == 0 && rm8.data()[1] == 0);
+
+    Tensor<vectra::int8> c8({ 300 }, vectra::int8(0));
+    for (size_t i = 0; i < 300; ++i) c8.data()[i] = vectra::int8(i % 2);
+    CHECK(mean(c8, { 0 }).data()[0] == 0);
+
+    Tensor<vectra::int16> z16({ 65536 }, vectra::int16(0));
+    CHECK(mean(z16).data()[0] == 0);
+    CHECK(mean(reshape(z16, { 2, 65536 / 2 }), { 1 }).data()[1] == 0);
+
+    // a lazy constant goes through the same division
+    CHECK(mean(zeros<vectra::int8>({ 16, 16 }), { 0, 1 }).data()[0] == 0);
+
+    Tensor<vectra::int32> big({ 70000 }, vectra::int32(3));
+    CHECK(mean(big).data()[0] == 3);
+    CHECK(mean(big, { 0 }).data()[0] == 3);
+}
+
+int main()
+{
+    check_levels<vectra::float32>();
+    check_levels<vectra::float64>();
+    check_levels<vectra::int32>();
+    check_levels<vectra::int16>();
+    check_levels<vectra::int8>();
+    check_axes();
+    check_integer_means();
+    return test_result("test_reduce");
+}
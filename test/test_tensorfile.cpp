@@ -0,0 +1,150 @@
+/*
+ *
+ * test_tensorfile.cpp (v1.0)
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Regression test of the tensor file format (TensorFile.h).
+ * Tensors are saved and mapped back (contiguous, transposed views, streamed writes), and crafted
+ * headers must be refused : shapes and strides whose products wrap around size_t, strides reaching
+ * past the data, truncated or misaligned files.
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#include "check.h"
+#include <cpu/TensorOps.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace vectra;
+
+static const char* PATH = "test_tensorfile.vt";
+
+// a header for `shape` / `strides` of float32 elements, followed by `data_bytes` of data
+static std::vector<char> crafted(const std::vector<uint64_t>& shape, const std::vector<uint64_t>& strides, uint64_t data_bytes)
+{
+    const size_t ndim = shape.size();
+    std::vector<char> bytes(io::header_bytes(ndim) + size_t(data_bytes), 0);
+
+    io::FileHeader h;
+    std::memcpy(h.magic, io::TENSOR_FILE_MAGIC, sizeof(h.magic));
+    h.version = io::TENSOR_FILE_VERSION;
+    h.kind = io::KIND_FLOAT;
+    h.bits = 32;
+    h.ndim = uint16_t(ndim);
+    h.data_offset = io::header_bytes(ndim);
+    h.data_bytes = data_bytes;
+    std::memcpy(bytes.data(), &h, sizeof(h));
+    std::memcpy(bytes.data() + sizeof(h), shape.data(), ndim * sizeof(uint64_t));
+    std::memcpy(bytes.data() + sizeof(h) + ndim * sizeof(uint64_t), strides.data(), ndim * sizeof(uint64_t));
+    return bytes;
+}
+
+static const char* parse(const std::vector<char>& bytes)
+{
+    io::FileInfo info;
+    return io::parse_header(bytes.data(), bytes.size(), bytes.size(), info);
+}
+
+static bool refused(const std::vector<char>& bytes, const char* reason)
+{
+    const char* err = parse(bytes);
+    if (!err || std::strcmp(err, reason) != 0) fprintf(stderr, "  %s, expected %s\n", err ? err : "accepted", reason);
+    return err && std::strcmp(err, reason) == 0;
+}
+
+static void check_round_trip()
+{
+    vectra::manual_seed(11);
+    const Tensor<float> A = rand<float>({ 9, 17 });
+    A.save(PATH);
+    const Tensor<float> L = Tensor<float>::load(PATH);
+    CHECK(L.shape == A.shape);
+    CHECK(std::memcmp(L.data(), A.data(), A.numel() * sizeof(float)) == 0);
+
+    // a view is written row-major
+    transpose(A).save(PATH);
+    const Tensor<float> T = Tensor<float>::load(PATH);
+    CHECK(T.shape == Shape({ 17, 9 }));
+    for (size_t i = 0; i < 17; ++i)
+        for (size_t j = 0; j < 9; ++j) CHECK(T.data()[i * 9 + j] == A.data()[j * 17 + i]);
+
+    // streamed in pieces, an empty tensor
+    Tensor<vectra::int32> I({ 5, 4 });
+    for (size_t i = 0; i < 20; ++i) I.data()[i] = vectra::int32(i * i) - 50;
+    {
+        io::TensorWriter<vectra::int32> writer(PATH, I.shape);
+        writer.write(I.data(), 7);
+        writer.write(I.data() + 7, 13);
+        writer.close();
+    }
+    const Tensor<vectra::int32> LI = Tensor<vectra::int32>::load(PATH);
+    CHECK(std::memcmp(LI.data(), I.data(), sizeof(vectra::int32) * 20) == 0);
+    Tensor<float>({ 3, 0 }).save(PATH);
+    CHECK(Tensor<float>::load(PATH).numel() == 0);
+
+    // another element type exits
+    CHECK(exits_with_failure([] { Tensor<double>::load(PATH); }));
+}
+
+static void check_crafted()
+{
+    CHECK(parse(crafted({ 4, 3 }, { 3, 1 }, 48)) == nullptr);
+    CHECK(parse(crafted({ 4, 3 }, { 1, 4 }, 48)) == nullptr);         // column-major
+    CHECK(parse(crafted({ 4, 3 }, { 0, 1 }, 12)) == nullptr);         // broadcast rows
+    CHECK(parse(crafted({ 0, 1ull << 62 }, { 1, 1 }, 0)) == nullptr); // empty
+
+    // 2^62 float32 elements are 2^64 bytes
+    CHECK(refused(crafted({ 1ull << 62 }, { 1 }, 16), "shape too large"));
+    // the element count wraps to 0
+    CHECK(refused(crafted({ 1ull << 32, 1ull << 32 }, { 0, 0 }, 16), "shape too large"));
+    // (shape - 1) * stride, the sum of the extents and (last + 1) * item wrap around
+    CHECK(refused(crafted({ 2, 2 }, { 1ull << 63, 1 }, 16), "strides reach past the data"));
+    CHECK(refused(crafted({ 3, 3 }, { 1ull << 62, 1ull << 62 }, 16), "strides reach past the data"));
+    CHECK(refused(crafted({ 2 }, { (1ull << 62) - 1 }, 16), "strides reach past the data"));
+    CHECK(refused(crafted({ 2 }, { ~0ull }, 16), "strides reach past the data"));
+    // plainly past the data
+    CHECK(refused(crafted({ 4 }, { 2 }, 16), "strides reach past the data"));
+    CHECK(refused(crafted({ 4, 3 }, { 3, 1 }, 44), "strides reach past the data"));
+
+    std::vector<char> bytes = crafted({ 4 }, { 1 }, 16);
+    std::vector<char> short_header(bytes.begin(), bytes.begin() + 20);
+    CHECK(refused(short_header, "truncated header"));
+    std::vector<char> no_data(bytes.begin(), bytes.end() - 4);
+    CHECK(refused(no_data, "truncated data"));
+    bytes[0] = 'X';
+    CHECK(refused(bytes, "not a vectra tensor file"));
+
+    // the data size must fit in the file : a wrapping data_offset + data_bytes is refused
+    std::vector<char> huge = crafted({ 4 }, { 1 }, 16);
+    const uint64_t past = ~uint64_t(0) - 8;
+    std::memcpy(huge.data() + 24, &past, sizeof(past));
+    CHECK(refused(huge, "truncated data"));
+
+    // through Tensor::load
+    const std::vector<char> wraps = crafted({ 1ull << 62 }, { 1 }, 16);
+    FILE* f = fopen(PATH, "wb");
+    CHECK(f != nullptr);
+    if (f) {
+        fwrite(wraps.data(), 1, wraps.size(), f);
+        fclose(f);
+    }
+    CHECK(exits_with_failure([] { Tensor<float>::load(PATH); }));
+}
+
+int main()
+{
+    check_round_trip();
+    check_crafted();
+    std::remove(PATH);
+    return test_result("test_tensorfile");
+}
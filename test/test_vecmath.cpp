@@ -0,0 +1,222 @@
+/*
+ *
+ * test_vecmath.cpp (v1.0)
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Regression test of the SIMD transcendental functions (VecMath.h).
+ * Every ISA level the CPU has must stay within the ULP bounds of the VecMath.h table on sampled
+ * inputs (random bit patterns and uniform draws over the domain, denormals included), give the
+ * C99 results on special values (NaN, infinities, signed zeros) and not write past the end.
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#include "check.h"
+#include <VecMath/VecMath.h>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+using namespace vectra::kernel;
+
+template<typename T>
+using UnaryFn = void (*)(const T*, T*, size_t);
+
+template<typename T>
+using PowFn = void (*)(const T*, const T*, T*, size_t);
+
+// float32 is measured against the double libm, float64 against the long double libm
+template<UnaryOp Op>
+static long double reference(long double x)
+{
+    if constexpr (Op == UnaryOp::Exp)     return expl(x);
+    if constexpr (Op == UnaryOp::Log)     return logl(x);
+    if constexpr (Op == UnaryOp::Log1p)   return log1pl(x);
+    if constexpr (Op == UnaryOp::Tanh)    return tanhl(x);
+    if constexpr (Op == UnaryOp::Sigmoid) return 1.0L / (1.0L + expl(-x));
+    if constexpr (Op == UnaryOp::Erf)     return erfl(x);
+    if constexpr (Op == UnaryOp::Sqrt)    return sqrtl(x);
+    if constexpr (Op == UnaryOp::Rsqrt)   return 1.0L / sqrtl(x);
+}
+
+// distance to the exact result in ULP of T (denormal results count in units of the smallest denormal)
+template<typename T>
+static double ulp_error(T got, long double ref)
+{
+    if (std::isinf(ref) || std::fabs(ref) > (long double)std::numeric_limits<T>::max())
+        return got == T(ref) ? 0.0 : 1e9;
+    if (!std::isfinite(got)) return 1e9;
+
+    int e = 0;
+    std::frexp((double)ref, &e);
+    const long double ulp = std::max<long double>(std::ldexp(1.0L, e - std::numeric_limits<T>::digits),
+                                                  std::numeric_limits<T>::denorm_min());
+    return double(std::fabs((long double)got - ref) / ulp);
+}
+
+template<typename T>
+static bool same_value(T a, T b)
+{
+    return (std::isnan(a) && std::isnan(b)) || std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+template<typename T>
+struct Bits;
+template<> struct Bits<float>  { using type = uint32_t; };
+template<> struct Bits<double> { using type = uint64_t; };
+
+// half random bit patterns inside [lo, hi] (every binade, denormals), half uniform draws
+template<typename T>
+static std::vector<T> samples(T lo, T hi, size_t count, uint64_t seed)
+{
+    using U = typename Bits<T>::type;
+    std::vector<T> v;
+    v.reserve(count);
+    while (v.size() < count) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        const uint64_t r = seed ^ (seed >> 29);
+        T x;
+        if (v.size() % 2) {
+            U bits = U(sizeof(U) == 8 ? r : r >> 32);
+            std::memcpy(&x, &bits, sizeof(T));
+        }
+        else {
+            const T u = T(double(r >> 11) * 0x1.0p-53);
+            x = lo * (T(1) - u) + hi * u;               // hi - lo overflows on [-max, max]
+        }
+        if (std::isfinite(x) && x >= lo && x <= hi) v.push_back(x);
+    }
+    return v;
+}
+
+template<UnaryOp Op, typename T>
+static void check_unary(const char* level, const char* name, UnaryFn<T> fn, T lo, T hi, double bound)
+{
+    const size_t n = 20000;
+    std::vector<T> x = samples<T>(lo, hi, n, uint64_t(Op) * 977 + sizeof(T));
+    std::vector<T> out(n + 1, T(-3));
+    fn(x.data(), out.data(), n);
+
+    double worst = 0;
+    T worst_x = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const double err = ulp_error(out[i], reference<Op>(x[i]));
+        if (err > worst) {
+            worst = err;
+            worst_x = x[i];
+        }
+    }
+    if (worst > bound)
+        fprintf(stderr, "  %s %s(%.17g) : %.3g ulp (bound %.3g)\n", level, name, double(worst_x), worst, bound);
+    CHECK(worst <= bound);
+    CHECK(out[n] == T(-3));
+
+    // the ends of the ranges
+    const T edges[] = { T(1), T(-1), std::numeric_limits<T>::denorm_min(), std::numeric_limits<T>::min(),
+                        std::numeric_limits<T>::max(), -std::numeric_limits<T>::max(), lo, hi };
+    for (T e : edges) {
+        if (e < lo || e > hi) continue;
+        T r;
+        fn(&e, &r, 1);
+        if (ulp_error(r, reference<Op>(e)) > bound) fprintf(stderr, "  %s %s(%g) past the bound\n", level, name, double(e));
+        CHECK(ulp_error(r, reference<Op>(e)) <= bound);
+    }
+
+    // special values give what the libm gives (C99)
+    const T inf = std::numeric_limits<T>::infinity();
+    const T special[] = { std::numeric_limits<T>::quiet_NaN(), inf, -inf, T(0), -T(0) };
+    const size_t count = sizeof(special) / sizeof(special[0]);
+    T got[count];
+    fn(special, got, count);
+    for (size_t i = 0; i < count; ++i) {
+        const T ref = scalar::unary_one<Op>(special[i]);
+        if (!same_value(got[i], ref))
+            fprintf(stderr, "  %s %s(%g) = %g, expected %g\n", level, name, double(special[i]), double(got[i]), double(ref));
+        CHECK(same_value(got[i], ref));
+    }
+}
+
+template<typename T>
+static void check_pow(const char* level, PowFn<T> fn)
+{
+    const size_t n = 20000;
+    std::vector<T> x = samples<T>(T(1e-3), T(1e3), n, 5);
+    std::vector<T> y = samples<T>(T(-20), T(20), n, 6);
+    std::vector<T> out(n);
+    fn(x.data(), y.data(), out.data(), n);
+
+    size_t bad = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const long double ref = powl(x[i], y[i]);
+        const double bound = std::is_same<T, float>::value ? 0.51
+                                                           : 1.01 + 2.0 * std::fabs(double(y[i]) * std::log(double(x[i])));
+        bad += ulp_error(out[i], ref) > bound;
+    }
+    if (bad) fprintf(stderr, "  %s pow : %zu results past the bound\n", level, bad);
+    CHECK(bad == 0);
+
+    // C99 special cases, exact results
+    const T inf = std::numeric_limits<T>::infinity(), nan = std::numeric_limits<T>::quiet_NaN();
+    const T xs[] = { T(1), nan, T(0), -T(0), -T(0), -T(0), T(-2), T(-8), T(0.5), T(2), -inf, -inf, T(-1), inf };
+    const T ys[] = { nan, T(0), T(-1), T(-1), T(3), T(2), T(0.5), -inf, inf, -inf, T(3), T(-3), inf, T(-1) };
+    const size_t count = sizeof(xs) / sizeof(xs[0]);
+    T got[count];
+    fn(xs, ys, got, count);
+    for (size_t i = 0; i < count; ++i) {
+        const T ref = static_cast<T>(std::pow(xs[i], ys[i]));
+        if (!same_value(got[i], ref))
+            fprintf(stderr, "  %s pow(%g, %g) = %g, expected %g\n", level, double(xs[i]), double(ys[i]), double(got[i]), double(ref));
+        CHECK(same_value(got[i], ref));
+    }
+}
+
+// the bounds of the VecMath.h table, with 0.01 ULP for the rounding of the reference
+template<typename T>
+static void check_level(const char* level, UnaryFn<T> exp_fn, UnaryFn<T> log_fn, UnaryFn<T> log1p_fn,
+                        UnaryFn<T> tanh_fn, UnaryFn<T> sigmoid_fn, UnaryFn<T> erf_fn, UnaryFn<T> sqrt_fn,
+                        UnaryFn<T> rsqrt_fn, PowFn<T> pow_fn)
+{
+    const bool f32 = std::is_same<T, float>::value;
+    const T max = std::numeric_limits<T>::max();
+    const T exp_hi = f32 ? T(88.7) : T(709.7);
+    const T exp_lo = f32 ? T(-103) : T(-744);
+
+    check_unary<UnaryOp::Exp, T>(level, "exp", exp_fn, exp_lo, exp_hi, f32 ? 1.02 : 1.01);
+    check_unary<UnaryOp::Log, T>(level, "log", log_fn, T(0), max, f32 ? 0.84 : 1.01);
+    check_unary<UnaryOp::Log1p, T>(level, "log1p", log1p_fn, T(-1), max, f32 ? 1.45 : 1.51);
+    check_unary<UnaryOp::Tanh, T>(level, "tanh", tanh_fn, -max, max, f32 ? 1.34 : 1.51);
+    check_unary<UnaryOp::Sigmoid, T>(level, "sigmoid", sigmoid_fn, f32 ? T(-87) : T(-708), max, f32 ? 2.84 : 3.01);
+    check_unary<UnaryOp::Erf, T>(level, "erf", erf_fn, -max, max, f32 ? 2.49 : 3.01);
+    check_unary<UnaryOp::Sqrt, T>(level, "sqrt", sqrt_fn, T(0), max, 0.51);
+    check_unary<UnaryOp::Rsqrt, T>(level, "rsqrt", rsqrt_fn, std::numeric_limits<T>::min(), max, f32 ? 1.0 : 1.51);
+    check_pow<T>(level, pow_fn);
+}
+
+#define VECTRA_CHECK_LEVEL(ns, T)                                                                                  \
+    check_level<T>(#ns, &ns::unary<UnaryOp::Exp, T>, &ns::unary<UnaryOp::Log, T>, &ns::unary<UnaryOp::Log1p, T>,   \
+                   &ns::unary<UnaryOp::Tanh, T>, &ns::unary<UnaryOp::Sigmoid, T>, &ns::unary<UnaryOp::Erf, T>,     \
+                   &ns::unary<UnaryOp::Sqrt, T>, &ns::unary<UnaryOp::Rsqrt, T>, &ns::pow<T>)
+
+template<typename T>
+static void check_levels()
+{
+    const Isa cpu = cpu_isa();
+    if (cpu >= Isa::AVX2)   VECTRA_CHECK_LEVEL(avx2, T);
+    if (cpu >= Isa::AVX512) VECTRA_CHECK_LEVEL(avx512, T);
+    VECTRA_CHECK_LEVEL(vectra::kernel, T);      // dispatched entry point
+}
+
+int main()
+{
+    check_levels<vectra::float32>();
+    check_levels<vectra::float64>();
+    return test_result("test_vecmath");
+}
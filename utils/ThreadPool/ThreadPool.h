@@ -0,0 +1,522 @@
+/*
+ *
+ * ThreadPool.h (v1.4)
+ *
+ * v1.4 updated : * set_num_threads / set_affinity wait for the running parallel_for calls before the
+ *                  workers are replaced
+ *                * submit() tasks sit in their own queue, only the workers run them (a caller waiting
+ *                  on its parallel_for never picks one up)
+ *
+ * v1.3 updated : * parallel_for rethrows on the caller the first exception thrown by a chunk (after every chunk ran)
+ *
+ * v1.2 updated : * thread_ids() and generation() : OS ids of the workers, for the counters of Profiler.h
+ *
+ * v1.1 updated : * submit() : asynchronous task on a worker, result through std::future
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Library owned work-stealing thread pool (HEADER) with parallel_for and parallel_reduce.
+ * Every worker owns a deque : it pops its own tasks from the back and steals from the
+ * front of the other deques when it runs dry. The calling thread takes part in the work.
+ * A submitted task runs on a worker like the root of a parallel loop : the loops it starts
+ * are split over the pool as well.
+ *
+ * Environment :
+ *   VECTRA_NUM_THREADS      number of threads including the caller (default : hardware threads)
+ *   VECTRA_THREAD_AFFINITY  none | compact | scatter (default : none)
+ *
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#pragma once
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#ifdef __cplusplus
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace utils {
+
+enum class ThreadAffinity {
+    None,       // let the OS schedule the workers
+    Compact,    // worker i pinned to cpu i + 1 (the caller keeps cpu 0)
+    Scatter     // workers spread evenly over all cpus
+};
+
+// Minimum amount of memory traffic (bytes) a chunk must carry to be worth a thread
+static constexpr size_t PARALLEL_GRAIN_BYTES = 128 * 1024;
+
+// Grain size (items per chunk) of a loop that touches `bytes_per_item` bytes per item
+inline size_t grain_size(size_t bytes_per_item)
+{
+    return std::max<size_t>(1, PARALLEL_GRAIN_BYTES / std::max<size_t>(1, bytes_per_item));
+}
+
+class ThreadPool {
+public:
+    static ThreadPool& instance()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    ~ThreadPool() { stop_workers(); }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // threads taking part in a parallel loop, the caller included
+    size_t num_threads() const { return num_threads_.load(std::memory_order_relaxed); }
+
+    // waits for the running loops, loops started meanwhile run serially on their caller
+    void set_num_threads(size_t n)
+    {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        drain_jobs();
+        stop_workers();
+        num_threads_.store(std::max<size_t>(1, n));
+        start_workers();
+        reconfiguring_.store(false);
+    }
+
+    // OS thread ids of the workers (the caller is not included), 0 where the OS has none
+    std::vector<long> thread_ids()
+    {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        std::vector<long> ids(workers_.size());
+        for (size_t i = 0; i < ids.size(); ++i) {
+            // a worker writes its id first thing after it starts
+            while ((ids[i] = tids_[i].load(std::memory_order_acquire)) == -1) std::this_thread::yield();
+        }
+        return ids;
+    }
+
+    // bumped every time the workers are restarted (new thread ids)
+    size_t generation() const { return generation_.load(std::memory_order_acquire); }
+
+    ThreadAffinity affinity() const { return affinity_; }
+
+    void set_affinity(ThreadAffinity affinity)
+    {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        drain_jobs();
+        stop_workers();
+        affinity_ = affinity;
+        start_workers();
+        reconfiguring_.store(false);
+    }
+
+    // Run fn(lo, hi) over chunks of [begin, end), each chunk holds at least `grain` items.
+    // Small ranges and nested calls (from inside a task) run serially on the caller.
+    template<typename F>
+    void parallel_for(size_t begin, size_t end, size_t grain, F&& fn)
+    {
+        if (end <= begin) return;
+
+        // registered before the pool is looked at : a reconfiguration waits for the job to end
+        const ActiveJob active(*this);
+        const size_t chunks = active.parallel ? chunk_count(end - begin, grain) : 1;
+        if (chunks <= 1) {
+            fn(begin, end);
+            return;
+        }
+
+        using Fn = std::remove_reference_t<F>;
+        Job job;
+        job.fn = [](void* ctx, size_t lo, size_t hi) { (*static_cast<Fn*>(ctx))(lo, hi); };
+        job.ctx = const_cast<void*>(static_cast<const void*>(&fn));
+
+        run_job(job, begin, end, chunks);
+    }
+
+    // Reduce [begin, end) : map(lo, hi) returns the partial result of a chunk and the
+    // partials are folded with combine() in chunk order.
+    template<typename R, typename Map, typename Combine>
+    R parallel_reduce(size_t begin, size_t end, size_t grain, R identity, Map&& map, Combine&& combine)
+    {
+        if (end <= begin) return identity;
+
+        const size_t chunks = chunk_count(end - begin, grain);
+        if (chunks <= 1) {
+            return combine(identity, map(begin, end));
+        }
+
+        const size_t step = (end - begin + chunks - 1) / chunks;
+        std::vector<R> partial(chunks, identity);
+
+        parallel_for(0, chunks, 1, [&](size_t c_lo, size_t c_hi) {
+            for (size_t c = c_lo; c < c_hi; ++c) {
+                const size_t lo = begin + c * step;
+                const size_t hi = std::min(end, lo + step);
+                if (lo < hi) partial[c] = map(lo, hi);
+            }
+        });
+
+        R result = identity;
+        for (size_t c = 0; c < chunks; ++c) result = combine(result, partial[c]);
+        return result;
+    }
+
+    // Run fn() on a worker and return its result through a future, the caller does not wait.
+    // Without workers (one thread) fn runs on the caller before submit returns.
+    template<typename F>
+    auto submit(F&& fn) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+    {
+        using R = std::invoke_result_t<std::decay_t<F>>;
+        using Packed = std::packaged_task<R()>;
+
+        auto* packed = new Packed(std::forward<F>(fn));
+        std::future<R> result = packed->get_future();
+
+        std::unique_lock<std::mutex> lock(config_mutex_);
+        if (queues_.empty()) {
+            // outside the lock : fn may use the pool itself
+            lock.unlock();
+            (*packed)();
+            delete packed;
+            return result;
+        }
+
+        Job* job = new Job();
+        job->detached = true;
+        job->ctx = packed;
+        job->fn = [](void* ctx, size_t, size_t) {
+            std::unique_ptr<Packed> task(static_cast<Packed*>(ctx));
+            (*task)();
+        };
+        {
+            // a queue of its own : only the workers run it, never a caller waiting for its loop
+            std::lock_guard<std::mutex> queue(detached_.mutex);
+            detached_.tasks.push_back(Task{ job, 0, 0 });
+            queued_.fetch_add(1);
+        }
+        {
+            std::lock_guard<std::mutex> sleep(sleep_mutex_);
+        }
+        sleep_cv_.notify_one();
+        return result;
+    }
+
+private:
+    using RangeFn = void (*)(void* ctx, size_t lo, size_t hi);
+
+    struct Job {
+        RangeFn fn = nullptr;
+        void* ctx = nullptr;
+        std::atomic<size_t> pending{0};
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;   // first exception of a chunk, rethrown by run_job
+        bool detached = false;      // submit() : heap job owning ctx, deleted after its single run
+    };
+
+    // a parallel loop in flight, it keeps the queues alive. Backs off (serial loop) while a
+    // reconfiguration drains : the pool is about to be torn down
+    struct ActiveJob {
+        ThreadPool& pool;
+        bool parallel;
+
+        explicit ActiveJob(ThreadPool& pool_) : pool(pool_)
+        {
+            pool.active_jobs_.fetch_add(1);
+            parallel = !pool.reconfiguring_.load();
+            if (!parallel) pool.active_jobs_.fetch_sub(1);
+        }
+
+        ~ActiveJob()
+        {
+            if (parallel) pool.active_jobs_.fetch_sub(1);
+        }
+    };
+
+    struct Task {
+        Job* job;
+        size_t lo;
+        size_t hi;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::atomic<size_t> num_threads_{1};
+    ThreadAffinity affinity_ = ThreadAffinity::None;
+
+    std::vector<std::thread> workers_;
+    std::unique_ptr<std::atomic<long>[]> tids_;
+    std::atomic<size_t> generation_{0};
+    std::vector<std::unique_ptr<Queue>> queues_;
+    Queue detached_;                    // submit() tasks, drained by the workers only
+    std::atomic<size_t> queued_{0};
+    std::atomic<size_t> next_queue_{0};
+    std::atomic<bool> stop_{false};
+    std::atomic<size_t> active_jobs_{0};
+    std::atomic<bool> reconfiguring_{false};
+
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    std::mutex config_mutex_;
+
+    static bool& inside_task()
+    {
+        static thread_local bool flag = false;
+        return flag;
+    }
+
+    ThreadPool()
+    {
+        size_t n = std::max<unsigned>(1, std::thread::hardware_concurrency());
+        if (const char* env = std::getenv("VECTRA_NUM_THREADS")) {
+            const long v = std::strtol(env, nullptr, 10);
+            if (v > 0) n = size_t(v);
+        }
+        if (const char* env = std::getenv("VECTRA_THREAD_AFFINITY")) {
+            if (std::strcmp(env, "compact") == 0)      affinity_ = ThreadAffinity::Compact;
+            else if (std::strcmp(env, "scatter") == 0) affinity_ = ThreadAffinity::Scatter;
+        }
+        num_threads_.store(n);
+        start_workers();
+    }
+
+    size_t chunk_count(size_t n, size_t grain) const
+    {
+        const size_t threads = num_threads_.load(std::memory_order_relaxed);
+        if (threads <= 1 || inside_task()) return 1;
+        grain = std::max<size_t>(1, grain);
+        const size_t by_grain = (n + grain - 1) / grain;
+        // a few chunks per thread so faster threads can steal from slower ones
+        return std::min(by_grain, threads * 4);
+    }
+
+    // under config_mutex_ : new loops run serially, the running ones finish on the old queues
+    void drain_jobs()
+    {
+        reconfiguring_.store(true);
+        while (active_jobs_.load() > 0) std::this_thread::yield();
+    }
+
+    void start_workers()
+    {
+        stop_.store(false);
+        const size_t workers = num_threads_.load() - 1;
+        queues_.clear();
+        for (size_t i = 0; i < workers; ++i) queues_.emplace_back(new Queue());
+        tids_.reset(new std::atomic<long>[workers]);
+        for (size_t i = 0; i < workers; ++i) tids_[i].store(-1);
+        generation_.fetch_add(1, std::memory_order_acq_rel);
+        for (size_t i = 0; i < workers; ++i) workers_.emplace_back([this, i] { worker_loop(i); });
+    }
+
+    void stop_workers()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            stop_.store(true);
+        }
+        sleep_cv_.notify_all();
+        for (auto& w : workers_) w.join();
+        workers_.clear();
+    }
+
+    void pin_current_thread(size_t worker)
+    {
+#if defined(__linux__)
+        if (affinity_ == ThreadAffinity::None) return;
+
+        const size_t cpus = std::max<unsigned>(1, std::thread::hardware_concurrency());
+        size_t cpu;
+        if (affinity_ == ThreadAffinity::Compact) cpu = (worker + 1) % cpus;
+        else                                      cpu = ((worker + 1) * cpus / num_threads_.load()) % cpus;
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+        (void)worker;
+#endif
+    }
+
+    bool pop_own(size_t q, Task& task)
+    {
+        Queue& queue = *queues_[q];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) return false;
+        task = queue.tasks.back();
+        queue.tasks.pop_back();
+        queued_.fetch_sub(1);
+        return true;
+    }
+
+    bool steal(size_t start, Task& task)
+    {
+        const size_t n = queues_.size();
+        for (size_t k = 0; k < n; ++k) {
+            Queue& queue = *queues_[(start + k) % n];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty()) continue;
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+            queued_.fetch_sub(1);
+            return true;
+        }
+        return false;
+    }
+
+    bool pop_detached(Task& task)
+    {
+        std::lock_guard<std::mutex> lock(detached_.mutex);
+        if (detached_.tasks.empty()) return false;
+        task = detached_.tasks.front();
+        detached_.tasks.pop_front();
+        queued_.fetch_sub(1);
+        return true;
+    }
+
+    void push_task(const Task& task, size_t q)
+    {
+        Queue& queue = *queues_[q];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(task);
+        queued_.fetch_add(1);
+    }
+
+    void execute(const Task& task)
+    {
+        // a submitted task is a root : its own loops are split, not run serially
+        if (task.job->detached) {
+            const bool saved = inside_task();
+            inside_task() = false;
+            task.job->fn(task.job->ctx, 0, 0);
+            inside_task() = saved;
+            delete task.job;
+            return;
+        }
+
+        bool& flag = inside_task();
+        const bool saved = flag;
+        flag = true;
+        try {
+            task.job->fn(task.job->ctx, task.lo, task.hi);
+        }
+        catch (...) {
+            if (!task.job->failed.exchange(true)) task.job->error = std::current_exception();
+        }
+        flag = saved;
+        task.job->pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    void worker_loop(size_t self)
+    {
+#if defined(__linux__)
+        tids_[self].store(long(syscall(SYS_gettid)), std::memory_order_release);
+#else
+        tids_[self].store(0, std::memory_order_release);
+#endif
+        pin_current_thread(self);
+
+        Task task;
+        while (true) {
+            // loop chunks first : a caller is waiting for them
+            if (pop_own(self, task) || steal(self + 1, task) || pop_detached(task)) {
+                execute(task);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            sleep_cv_.wait(lock, [this] { return stop_.load() || queued_.load() > 0; });
+            if (stop_.load() && queued_.load() == 0) return;
+        }
+    }
+
+    void run_job(Job& job, size_t begin, size_t end, size_t chunks)
+    {
+        const size_t step = (end - begin + chunks - 1) / chunks;
+        const size_t count = (end - begin + step - 1) / step;
+        job.pending.store(count);
+
+        // the first chunk stays with the caller, the rest is spread over the worker deques
+        size_t q = next_queue_.fetch_add(1);
+        for (size_t c = 1; c < count; ++c) {
+            const size_t lo = begin + c * step;
+            const size_t hi = std::min(end, lo + step);
+            push_task(Task{ &job, lo, hi }, q++ % queues_.size());
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+        }
+        sleep_cv_.notify_all();
+
+        execute(Task{ &job, begin, std::min(end, begin + step) });
+
+        // help with queued loop chunks (never a submitted task) until every chunk of this job is done
+        Task task;
+        while (job.pending.load(std::memory_order_acquire) > 0) {
+            if (steal(q, task)) execute(task);
+            else std::this_thread::yield();
+        }
+        if (job.error) std::rethrow_exception(job.error);
+    }
+};
+
+/*
+ *
+ * Free function interface
+ *
+*/
+
+inline size_t get_num_threads() { return ThreadPool::instance().num_threads(); }
+
+inline void set_num_threads(size_t n) { ThreadPool::instance().set_num_threads(n); }
+
+inline void set_thread_affinity(ThreadAffinity affinity) { ThreadPool::instance().set_affinity(affinity); }
+
+template<typename F>
+void parallel_for(size_t begin, size_t end, size_t grain, F&& fn)
+{
+    ThreadPool::instance().parallel_for(begin, end, grain, std::forward<F>(fn));
+}
+
+template<typename R, typename Map, typename Combine>
+R parallel_reduce(size_t begin, size_t end, size_t grain, R identity, Map&& map, Combine&& combine)
+{
+    return ThreadPool::instance().parallel_reduce(begin, end, grain, identity,
+                                                  std::forward<Map>(map), std::forward<Combine>(combine));
+}
+
+template<typename F>
+auto submit(F&& fn)
+{
+    return ThreadPool::instance().submit(std::forward<F>(fn));
+}
+
+} // namespace utils
+
+#endif // __cplusplus
+#endif // THREADPOOL_H
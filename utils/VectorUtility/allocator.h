@@ -0,0 +1,379 @@
+/*
+ *
+ * allocator.h (v1.2)
+ *
+ * v1.2 updated : * PoolAllocator::cached_bytes() reads an atomic counter without taking the pool lock
+ *                * PoolAllocator::trim() hands back only the cached bytes asked for, largest blocks first
+ *
+ * v1.1 updated : * allocate_zeroed() : large zero buffers are fresh anonymous mappings, their pages
+ *                  cost nothing until they are touched (lazy constant tensors of TensorOps.h)
+ *                * SystemAllocator maps blocks of MMAP_THRESHOLD_BYTES and more directly
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Aligned memory allocators of vector utility (HEADER).
+ * Allocator is the pluggable interface used by utils::vector, SystemAllocator goes straight
+ * to the OS aligned allocation and PoolAllocator (the default) keeps freed blocks in size
+ * classes so temporaries of the Tensor operations are recycled instead of hitting the system.
+ *
+ * Environment :
+ *   VECTRA_POOL_CACHE_MB   maximum cached bytes of the default pool in MiB (default : 1024)
+ *
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#pragma once
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#ifdef __cplusplus
+
+#include <cstdlib>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+// Default alignment (bytes) of every vector buffer, wide enough for AVX-512 loads
+#ifndef VECTRA_DEFAULT_ALIGNMENT
+#define VECTRA_DEFAULT_ALIGNMENT 64
+#endif
+
+namespace utils {
+
+static constexpr size_t DEFAULT_ALIGNMENT = VECTRA_DEFAULT_ALIGNMENT;
+
+static_assert((DEFAULT_ALIGNMENT & (DEFAULT_ALIGNMENT - 1)) == 0, "VECTRA_DEFAULT_ALIGNMENT must be a power of two");
+
+// Blocks of this size and more are mapped from the OS (page aligned, zero filled on first touch)
+static constexpr size_t MMAP_THRESHOLD_BYTES = size_t(1) << 20;
+static constexpr size_t MMAP_ALIGNMENT = 4096;
+
+/*
+ *
+ * Allocator interface
+ *
+*/
+
+class Allocator {
+public:
+    virtual ~Allocator() = default;
+
+    // return nullptr on failure, `alignment` is a power of two
+    virtual void* allocate(size_t bytes, size_t alignment) = 0;
+
+    // `bytes` and `alignment` are the values given to allocate()
+    virtual void deallocate(void* ptr, size_t bytes, size_t alignment) = 0;
+
+    // zero filled block, released with deallocate()
+    virtual void* allocate_zeroed(size_t bytes, size_t alignment)
+    {
+        void* ptr = allocate(bytes, alignment);
+        if (ptr) std::memset(ptr, 0, bytes);
+        return ptr;
+    }
+};
+
+/*
+ *
+ * System allocator (aligned allocation of the OS)
+ *
+*/
+
+class SystemAllocator : public Allocator {
+public:
+    void* allocate(size_t bytes, size_t alignment) override
+    {
+        if (mapped(bytes, alignment)) return map(bytes);
+
+        if (alignment < sizeof(void*)) alignment = sizeof(void*);
+#if defined(_WIN32)
+        return _aligned_malloc(bytes, alignment);
+#else
+        void* ptr = nullptr;
+        if (posix_memalign(&ptr, alignment, bytes) != 0) return nullptr;
+        return ptr;
+#endif
+    }
+
+    void deallocate(void* ptr, size_t bytes, size_t alignment) override
+    {
+        if (mapped(bytes, alignment)) {
+            unmap(ptr, bytes);
+            return;
+        }
+#if defined(_WIN32)
+        _aligned_free(ptr);
+#else
+        free(ptr);
+#endif
+    }
+
+    // fresh mappings are already zero : nothing is written
+    void* allocate_zeroed(size_t bytes, size_t alignment) override
+    {
+        if (mapped(bytes, alignment)) return map(bytes);
+        return Allocator::allocate_zeroed(bytes, alignment);
+    }
+
+private:
+    static bool mapped(size_t bytes, size_t alignment)
+    {
+        return bytes >= MMAP_THRESHOLD_BYTES && alignment <= MMAP_ALIGNMENT;
+    }
+
+    static void* map(size_t bytes)
+    {
+#if defined(_WIN32)
+        return VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+        void* ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        return ptr == MAP_FAILED ? nullptr : ptr;
+#endif
+    }
+
+    static void unmap(void* ptr, size_t bytes)
+    {
+        if (!ptr) return;
+#if defined(_WIN32)
+        (void)bytes;
+        VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+        munmap(ptr, bytes);
+#endif
+    }
+};
+
+inline SystemAllocator& system_allocator()
+{
+    static SystemAllocator alloc;
+    return alloc;
+}
+
+/*
+ *
+ * Size-class caching pool
+ *
+ * Requests are rounded up to a size class : 4 classes per power of two (at most 25% slack),
+ * freed blocks stay in the free list of their class until `max_cached` bytes are cached.
+ *
+*/
+
+class PoolAllocator : public Allocator {
+public:
+    static constexpr size_t MIN_CLASS_BYTES = 64;
+    static constexpr size_t CLASSES_PER_POW2 = 4;
+    static constexpr size_t CLASS_COUNT = 64 * CLASSES_PER_POW2;
+
+    explicit PoolAllocator(size_t max_cached_bytes, Allocator& upstream = system_allocator())
+        : upstream_(upstream), max_cached_(max_cached_bytes) {}
+
+    ~PoolAllocator() override { release(); }
+
+    PoolAllocator(const PoolAllocator&) = delete;
+    PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+    // bytes actually reserved for a request of `bytes`
+    static size_t class_size(size_t bytes)
+    {
+        if (bytes <= MIN_CLASS_BYTES) return MIN_CLASS_BYTES;
+        const size_t p = floor_log2(bytes - 1);
+        const size_t step = (size_t(1) << p) / CLASSES_PER_POW2;
+        return (bytes + step - 1) / step * step;
+    }
+
+    void* allocate(size_t bytes, size_t alignment) override
+    {
+        if (alignment > DEFAULT_ALIGNMENT) return upstream_.allocate(bytes, alignment);
+
+        const size_t size = class_size(bytes);
+        const size_t c = class_index(size);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::vector<void*>& list = free_[c];
+            if (!list.empty()) {
+                void* ptr = list.back();
+                list.pop_back();
+                cached_.fetch_sub(size, std::memory_order_relaxed);
+                return ptr;
+            }
+        }
+
+        void* ptr = upstream_.allocate(size, DEFAULT_ALIGNMENT);
+        if (!ptr) {
+            // give the cache back to the system and retry once
+            release();
+            ptr = upstream_.allocate(size, DEFAULT_ALIGNMENT);
+        }
+        return ptr;
+    }
+
+    // a cached block would have to be cleared : large requests take a fresh mapping instead
+    void* allocate_zeroed(size_t bytes, size_t alignment) override
+    {
+        if (alignment > DEFAULT_ALIGNMENT) return upstream_.allocate_zeroed(bytes, alignment);
+
+        const size_t size = class_size(bytes);
+        if (size < MMAP_THRESHOLD_BYTES) return Allocator::allocate_zeroed(bytes, alignment);
+
+        void* ptr = upstream_.allocate_zeroed(size, DEFAULT_ALIGNMENT);
+        if (!ptr) {
+            release();
+            ptr = upstream_.allocate_zeroed(size, DEFAULT_ALIGNMENT);
+        }
+        return ptr;
+    }
+
+    void deallocate(void* ptr, size_t bytes, size_t alignment) override
+    {
+        if (!ptr) return;
+        if (alignment > DEFAULT_ALIGNMENT) {
+            upstream_.deallocate(ptr, bytes, alignment);
+            return;
+        }
+
+        const size_t size = class_size(bytes);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (cached_.load(std::memory_order_relaxed) + size <= max_cached_) {
+                free_[class_index(size)].push_back(ptr);
+                cached_.fetch_add(size, std::memory_order_relaxed);
+                return;
+            }
+        }
+        upstream_.deallocate(ptr, size, DEFAULT_ALIGNMENT);
+    }
+
+    // hand every cached block back to the upstream allocator
+    void release()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t c = 0; c < CLASS_COUNT; ++c) {
+            for (void* ptr : free_[c]) upstream_.deallocate(ptr, class_bytes(c), DEFAULT_ALIGNMENT);
+            free_[c].clear();
+        }
+        cached_.store(0, std::memory_order_relaxed);
+    }
+
+    // hand cached blocks back until at least `bytes` are freed (or the cache is empty), the largest
+    // first ; returns the bytes freed
+    size_t trim(size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t freed = 0;
+        for (size_t c = CLASS_COUNT; c-- > 0 && freed < bytes;) {
+            const size_t size = class_bytes(c);
+            std::vector<void*>& list = free_[c];
+            while (!list.empty() && freed < bytes) {
+                upstream_.deallocate(list.back(), size, DEFAULT_ALIGNMENT);
+                list.pop_back();
+                freed += size;
+            }
+        }
+        cached_.fetch_sub(freed, std::memory_order_relaxed);
+        return freed;
+    }
+
+    // updated under the pool lock, read without it (a hint between two calls)
+    size_t cached_bytes() const { return cached_.load(std::memory_order_relaxed); }
+
+    // cached blocks past the new maximum are handed back
+    void set_max_cached_bytes(size_t bytes)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            max_cached_ = bytes;
+        }
+        const size_t cached = cached_bytes();
+        if (cached > bytes) trim(cached - bytes);
+    }
+
+private:
+    Allocator& upstream_;
+    mutable std::mutex mutex_;
+    std::vector<void*> free_[CLASS_COUNT];
+    std::atomic<size_t> cached_{0};
+    size_t max_cached_;
+
+    static size_t floor_log2(size_t v)
+    {
+        size_t p = 0;
+        while (v >>= 1) ++p;
+        return p;
+    }
+
+    static size_t class_index(size_t size)
+    {
+        // size is a class size : 2^p < size <= 2^(p+1) in CLASSES_PER_POW2 steps
+        const size_t p = floor_log2(size - 1);
+        const size_t step = (size_t(1) << p) / CLASSES_PER_POW2;
+        const size_t sub = (size - (size_t(1) << p)) / step - 1;
+        return p * CLASSES_PER_POW2 + sub;
+    }
+
+    // size of class c (inverse of class_index)
+    static size_t class_bytes(size_t c)
+    {
+        const size_t p = c / CLASSES_PER_POW2;
+        const size_t step = (size_t(1) << p) / CLASSES_PER_POW2;
+        return (size_t(1) << p) + (c % CLASSES_PER_POW2 + 1) * step;
+    }
+};
+
+/*
+ *
+ * Default allocator of utils::vector
+ *
+*/
+
+inline PoolAllocator& default_pool()
+{
+    // never destroyed : vectors in static storage may be released after this function's statics
+    static PoolAllocator* pool = [] {
+        size_t mb = 1024;
+        if (const char* env = std::getenv("VECTRA_POOL_CACHE_MB")) mb = size_t(std::strtoull(env, nullptr, 10));
+        return new PoolAllocator(mb * 1024 * 1024);
+    }();
+    return *pool;
+}
+
+inline Allocator*& default_allocator_slot()
+{
+    static Allocator* slot = nullptr;
+    return slot;
+}
+
+inline Allocator& default_allocator()
+{
+    Allocator* alloc = default_allocator_slot();
+    return alloc ? *alloc : default_pool();
+}
+
+// nullptr restores the default pool; the allocator must outlive every vector created with it
+inline void set_default_allocator(Allocator* alloc)
+{
+    default_allocator_slot() = alloc;
+}
+
+} // namespace utils
+
+#endif // __cplusplus
+#endif // ALLOCATOR_H
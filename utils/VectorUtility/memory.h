@@ -0,0 +1,293 @@
+/*
+ *
+ * memory.h (v1.2)
+ *
+ * v1.2 updated : * allocations are charged the size class the pool reserves for them, not the requested bytes
+ *                * past the limit the pool cache is trimmed by the excess only, read without the pool lock
+ *
+ * v1.1 updated : * blocks cached by the default pool count against the soft limit, MemoryStats::cached_bytes
+ *
+ * Copyright(C) 2025 KallXfalcon
+ * GitHub : https://github.com/KallXfalcon
+ *
+ * This program is licensed under the GNU General Public License v3.0 (GPL v3.0)
+ * See <https://www.gnu.org/licenses> for details.
+ *
+ *
+ * Memory accounting of utils::vector (HEADER).
+ * Every buffer a vector allocates or frees goes through the global tracker : live bytes, peak
+ * bytes, allocation and free counts, allocations per size class (powers of two of the requested
+ * bytes). A buffer is charged the class size the pool reserves for it (PoolAllocator::class_size,
+ * up to a quarter more than requested) so the live bytes are the memory actually held. Adopted memory (NumPy, DLPack, mapped files) is not counted, it isn't ours.
+ *
+ * Soft limit : an allocation that would take the live bytes past the limit throws
+ * MemoryLimitError (a std::bad_alloc) and leaves the vector as it was, the program can free
+ * memory and carry on. Without a limit nothing is refused. Freed blocks cached by the default
+ * pool (allocator.h) count too : when live and cached bytes would pass the limit the cache is
+ * trimmed by the excess first, so a refused allocation never leaves a full cache behind.
+ *
+ * Per op : with track_ops(true) every allocation is also charged to the op running on the thread
+ * (set by the op scopes of TenLib through AllocTag) : allocations, bytes, live and peak bytes.
+ *
+ * Environment :
+ *   VECTRA_MEMORY_LIMIT_MB   soft limit in MiB (default : none)
+ *
+ * This file is a part of VECTRA framework
+ *
+*/
+
+#pragma once
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#ifdef __cplusplus
+
+#include <VectorUtility/allocator.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace utils {
+
+// an allocation past the soft limit, recoverable
+class MemoryLimitError : public std::bad_alloc {
+public:
+    MemoryLimitError(size_t bytes, size_t live, size_t limit)
+    {
+        std::snprintf(what_, sizeof(what_), "vectra : allocation of %zu bytes exceeds the memory limit (%zu of %zu bytes live)",
+                      bytes, live, limit);
+    }
+
+    const char* what() const noexcept override { return what_; }
+
+private:
+    char what_[160];
+};
+
+static constexpr size_t MEMORY_SIZE_CLASSES = 64;
+
+struct MemoryStats {
+    size_t live_bytes = 0;
+    size_t peak_bytes = 0;              // since the start or reset_peak()
+    size_t cached_bytes = 0;            // freed blocks kept by the default pool, not in live_bytes
+    size_t allocations = 0;
+    size_t frees = 0;
+    size_t limit_bytes = 0;             // 0 : no limit
+    size_t refused = 0;                 // allocations refused by the limit
+    size_t by_class[MEMORY_SIZE_CLASSES] = {};  // allocations of (2^(c-1), 2^c] bytes
+};
+
+// allocations charged to one op
+struct OpMemory {
+    std::string op;
+    size_t allocations = 0;
+    size_t bytes = 0;                   // allocated in total
+    size_t live_bytes = 0;
+    size_t peak_bytes = 0;
+};
+
+class MemoryTracker {
+public:
+    static MemoryTracker& instance()
+    {
+        // never destroyed : vectors in static storage are freed after the statics of this function
+        static MemoryTracker* tracker = new MemoryTracker();
+        return *tracker;
+    }
+
+    // charges the class size of `bytes` to the live total, throws MemoryLimitError past the limit
+    // (cached blocks of the pool are handed back first, as many as the footprint is over the limit)
+    void on_allocate(size_t bytes)
+    {
+        const size_t charged = PoolAllocator::class_size(bytes);
+        const size_t live = live_.fetch_add(charged, std::memory_order_relaxed) + charged;
+        const size_t limit = limit_.load(std::memory_order_relaxed);
+        if (limit) {
+            const size_t cached = default_pool().cached_bytes();
+            if (live + cached > limit) default_pool().trim(live + cached - limit);
+            if (live > limit) {
+                live_.fetch_sub(charged, std::memory_order_relaxed);
+                refused_.fetch_add(1, std::memory_order_relaxed);
+                throw MemoryLimitError(bytes, live - charged, limit);
+            }
+        }
+
+        size_t peak = peak_.load(std::memory_order_relaxed);
+        while (live > peak && !peak_.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+        by_class_[size_class(bytes)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // a failed allocation gives its bytes back
+    void on_failed(size_t bytes)
+    {
+        live_.fetch_sub(PoolAllocator::class_size(bytes), std::memory_order_relaxed);
+        allocations_.fetch_sub(1, std::memory_order_relaxed);
+        by_class_[size_class(bytes)].fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void on_free(size_t bytes)
+    {
+        live_.fetch_sub(PoolAllocator::class_size(bytes), std::memory_order_relaxed);
+        frees_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // per op accounting of a buffer (track_ops only)
+    void on_allocate_op(const void* ptr, size_t bytes, const char* op)
+    {
+        std::lock_guard<std::mutex> lock(ops_mutex_);
+        OpMemory& m = ops_[op ? op : "(no op)"];
+        m.allocations += 1;
+        m.bytes += bytes;
+        m.live_bytes += bytes;
+        m.peak_bytes = std::max(m.peak_bytes, m.live_bytes);
+        owners_[ptr] = &m;
+    }
+
+    void on_free_op(const void* ptr, size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(ops_mutex_);
+        auto it = owners_.find(ptr);
+        if (it == owners_.end()) return;        // allocated before track_ops(true)
+        it->second->live_bytes -= std::min(bytes, it->second->live_bytes);
+        owners_.erase(it);
+    }
+
+    bool tracking_ops() const { return track_ops_.load(std::memory_order_relaxed); }
+
+    void track_ops(bool on)
+    {
+        std::lock_guard<std::mutex> lock(ops_mutex_);
+        track_ops_.store(on, std::memory_order_relaxed);
+        if (!on) owners_.clear();
+    }
+
+    MemoryStats stats() const
+    {
+        MemoryStats s;
+        s.live_bytes = live_.load();
+        s.peak_bytes = peak_.load();
+        s.cached_bytes = default_pool().cached_bytes();
+        s.allocations = allocations_.load();
+        s.frees = frees_.load();
+        s.limit_bytes = limit_.load();
+        s.refused = refused_.load();
+        for (size_t c = 0; c < MEMORY_SIZE_CLASSES; ++c) s.by_class[c] = by_class_[c].load();
+        return s;
+    }
+
+    std::vector<OpMemory> ops() const
+    {
+        std::lock_guard<std::mutex> lock(ops_mutex_);
+        std::vector<OpMemory> out;
+        for (const auto& kv : ops_) {
+            out.push_back(kv.second);
+            out.back().op = kv.first;
+        }
+        std::sort(out.begin(), out.end(), [](const OpMemory& a, const OpMemory& b) { return a.peak_bytes > b.peak_bytes; });
+        return out;
+    }
+
+    void set_limit(size_t bytes)
+    {
+        limit_.store(bytes);
+        const size_t footprint = live_.load() + default_pool().cached_bytes();
+        if (bytes && footprint > bytes) default_pool().trim(footprint - bytes);
+    }
+
+    // peak back to the live bytes, the per op totals are dropped (live buffers stay charged)
+    void reset_peak()
+    {
+        peak_.store(live_.load());
+        std::lock_guard<std::mutex> lock(ops_mutex_);
+        for (auto& kv : ops_) {
+            kv.second.allocations = 0;
+            kv.second.bytes = 0;
+            kv.second.peak_bytes = kv.second.live_bytes;
+        }
+    }
+
+    static size_t size_class(size_t bytes)
+    {
+        size_t c = 0;
+        while (c + 1 < MEMORY_SIZE_CLASSES && (size_t(1) << c) < bytes) ++c;
+        return c;
+    }
+
+private:
+    std::atomic<size_t> live_{0};
+    std::atomic<size_t> peak_{0};
+    std::atomic<size_t> allocations_{0};
+    std::atomic<size_t> frees_{0};
+    std::atomic<size_t> limit_{0};
+    std::atomic<size_t> refused_{0};
+    std::atomic<size_t> by_class_[MEMORY_SIZE_CLASSES] = {};
+
+    std::atomic<bool> track_ops_{false};
+    mutable std::mutex ops_mutex_;
+    std::map<std::string, OpMemory> ops_;           // node addresses are stable
+    std::unordered_map<const void*, OpMemory*> owners_;
+
+    MemoryTracker()
+    {
+        if (const char* env = std::getenv("VECTRA_MEMORY_LIMIT_MB")) {
+            limit_.store(size_t(std::strtoull(env, nullptr, 10)) * 1024 * 1024);
+        }
+    }
+};
+
+// op charged with the allocations of the calling thread (nullptr : none)
+inline const char*& alloc_tag()
+{
+    static thread_local const char* tag = nullptr;
+    return tag;
+}
+
+// charges the allocations of its lifetime to `op` (a string literal), restores the previous tag
+class AllocTag {
+public:
+    explicit AllocTag(const char* op) : prev_(alloc_tag()) { alloc_tag() = op; }
+    ~AllocTag() { alloc_tag() = prev_; }
+
+    AllocTag(const AllocTag&) = delete;
+    AllocTag& operator=(const AllocTag&) = delete;
+
+private:
+    const char* prev_;
+};
+
+/*
+ *
+ * Interface
+ *
+*/
+
+inline MemoryStats memory_stats() { return MemoryTracker::instance().stats(); }
+
+// per op totals (track_ops), the largest peak first
+inline std::vector<OpMemory> memory_by_op() { return MemoryTracker::instance().ops(); }
+
+// soft limit of the live bytes of every vector, 0 removes it
+inline void set_memory_limit(size_t bytes) { MemoryTracker::instance().set_limit(bytes); }
+
+inline size_t memory_limit() { return MemoryTracker::instance().stats().limit_bytes; }
+
+inline void reset_peak_memory() { MemoryTracker::instance().reset_peak(); }
+
+// charge every allocation to the op that made it (a map entry per live buffer)
+inline void track_ops(bool on = true) { MemoryTracker::instance().track_ops(on); }
+
+inline bool tracking_ops() { return MemoryTracker::instance().tracking_ops(); }
+
+} // namespace utils
+
+#endif // __cplusplus
+#endif // MEMORY_H
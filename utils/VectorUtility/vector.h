@@ -1,7 +1,17 @@
 
 /*
  *
- * vector.h (v1.1)
+ * vector.h (v1.5)
+ * 
+ * v1.5 updated : * Every owned buffer is accounted in the memory tracker (memory.h) : live / peak bytes, soft limit
+ *                * A refused or failed allocation throws (MemoryLimitError / std::bad_alloc) instead of exiting
+ * 
+ * v1.4 updated : * vector(ptr, n, owner) : adopts memory owned elsewhere (NumPy, DLPack, mapped files)
+ * 
+ * v1.3 updated : * vector(n, zero_init) : zero filled buffer from Allocator::allocate_zeroed
+ * 
+ * v1.2 updated : * Aligned allocation (VECTRA_DEFAULT_ALIGNMENT, 64 bytes by default) through a pluggable Allocator
+ *                * Separate capacity and size, resize() only reallocates when growing past the capacity
  * 
  * v1.1 updated : Safe malloc update
  * 
@@ -28,66 +38,157 @@
 
 #ifdef __cplusplus
 
+#include <VectorUtility/allocator.h>
+#include <VectorUtility/memory.h>
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
+#include <memory>
+#include <type_traits>
 
 namespace utils {
 
-template<typename T>
+// tag of the zero filled constructor
+struct zero_init_t {};
+static constexpr zero_init_t zero_init{};
+
+template<typename T, size_t Alignment = DEFAULT_ALIGNMENT>
 class vector {
+    static_assert(std::is_trivially_copyable<T>::value, "utils::vector only holds trivially copyable elements");
+    static_assert((Alignment & (Alignment - 1)) == 0 && Alignment >= alignof(T), "invalid vector alignment");
+
 private:
     size_t size_ = 0;
+    size_t capacity_ = 0;
+    Allocator* alloc_ = nullptr;
+    std::shared_ptr<void> owner_;      // keeps adopted memory alive (may be empty)
+    bool adopted_ = false;             // data is not from alloc_
+
+    // throws MemoryLimitError past the soft limit and std::bad_alloc when the allocator fails,
+    // nothing is changed in either case
+    T* allocate(const size_t count, const bool zeroed = false)
+    {
+        const size_t bytes = count * sizeof(T);
+        MemoryTracker& tracker = MemoryTracker::instance();
+        tracker.on_allocate(bytes);
+
+        T* ptr = static_cast<T*>(zeroed ? alloc_->allocate_zeroed(bytes, Alignment) : alloc_->allocate(bytes, Alignment));
+        if (!ptr) {
+            tracker.on_failed(bytes);
+            throw std::bad_alloc();
+        }
+        if (tracker.tracking_ops()) tracker.on_allocate_op(ptr, bytes, alloc_tag());
+        return ptr;
+    }
+
+    void deallocate(T* ptr, const size_t count)
+    {
+        const size_t bytes = count * sizeof(T);
+        MemoryTracker& tracker = MemoryTracker::instance();
+        if (tracker.tracking_ops()) tracker.on_free_op(ptr, bytes);
+        tracker.on_free(bytes);
+        alloc_->deallocate(ptr, bytes, Alignment);
+    }
+
+    void release()
+    {
+        if (adopted_) {
+            owner_.reset();
+            adopted_ = false;
+            data = nullptr;
+        }
+        else if (data) {
+            deallocate(data, capacity_);
+            data = nullptr;
+        }
+        size_ = 0;
+        capacity_ = 0;
+    }
 
 public:
     T* data = nullptr;
 
-    vector() noexcept : size_(0), data(nullptr) {}
+    static constexpr size_t alignment = Alignment;
 
-    explicit vector(const size_t size_init)
-        : size_(0), data(nullptr)
+    vector() noexcept : size_(0), capacity_(0), alloc_(&default_allocator()), data(nullptr) {}
+
+    explicit vector(Allocator& alloc) noexcept : size_(0), capacity_(0), alloc_(&alloc), data(nullptr) {}
+
+    explicit vector(const size_t size_init, Allocator& alloc = default_allocator())
+        : size_(0), capacity_(0), alloc_(&alloc), data(nullptr)
     {
         if (size_init == 0) {
             return;
         }
 
-        const size_t bytes = size_init * sizeof(T);
-        data = static_cast<T*>(malloc(bytes));
-        if (!data) {
-            fprintf(stderr, "Failed to allocate memory!\n");
-            exit(EXIT_FAILURE);
+        data = allocate(size_init);
+        size_ = size_init;
+        capacity_ = size_init;
+    }
+
+    // every element zero (large buffers are mapped lazily by the system allocator)
+    vector(const size_t size_init, zero_init_t, Allocator& alloc = default_allocator())
+        : size_(0), capacity_(0), alloc_(&alloc), data(nullptr)
+    {
+        if (size_init == 0) {
+            return;
         }
+
+        data = allocate(size_init, true);
         size_ = size_init;
+        capacity_ = size_init;
     }
 
-    void resize(const size_t new_size)
+    // `n` elements at `external`, not copied : the memory stays with `owner` (dropped with the
+    // vector, whatever it is) and may have any alignment. Growing copies it to an own allocation
+    vector(T* external, const size_t n, std::shared_ptr<void> owner) noexcept
+        : size_(n), capacity_(n), alloc_(&default_allocator()), owner_(std::move(owner)), adopted_(true), data(external)
+    {
+    }
+
+    // make room for `new_capacity` elements, the content is kept
+    void reserve(const size_t new_capacity)
     {
-        if (new_size == size_) return;
+        if (new_capacity <= capacity_) return;
 
+        T* fresh = allocate(new_capacity);
         if (data) {
-            free(data);
-            data = nullptr;
+            if (size_) std::memcpy(fresh, data, size_ * sizeof(T));
+            if (adopted_) owner_.reset();
+            else deallocate(data, capacity_);
         }
+        adopted_ = false;
+        data = fresh;
+        capacity_ = new_capacity;
+    }
+
+    // shrinking keeps the buffer, growing past the capacity reallocates (the content is kept)
+    void resize(const size_t new_size)
+    {
+        if (new_size > capacity_) reserve(new_size);
+        size_ = new_size;
+    }
+
+    void shrink_to_fit()
+    {
+        if (size_ == capacity_ || adopted_) return;
 
-        if (new_size == 0) {
-            size_ = 0;
+        if (size_ == 0) {
+            release();
             return;
         }
 
-        const size_t bytes = new_size * sizeof(T);
-        data = static_cast<T*>(malloc(bytes));
-        if (!data) {
-            fprintf(stderr, "Failed to allocate memory!\n");
-            exit(EXIT_FAILURE);
-        }
-        size_ = new_size;
+        T* fresh = allocate(size_);
+        std::memcpy(fresh, data, size_ * sizeof(T));
+        deallocate(data, capacity_);
+        data = fresh;
+        capacity_ = size_;
     }
 
+    void clear() { size_ = 0; }
+
     ~vector() {
-        if (data) {
-            free(data);
-            data = nullptr;
-        }
-        size_ = 0;
+        release();
     }
 
     vector(const vector&) = delete;
@@ -95,21 +196,28 @@ public:
     vector& operator=(const vector&) = delete;
 
     vector(vector&& other) noexcept
-        : size_(other.size_), data(other.data)
+        : size_(other.size_), capacity_(other.capacity_), alloc_(other.alloc_), owner_(std::move(other.owner_)),
+          adopted_(other.adopted_), data(other.data)
     {
+        other.adopted_ = false;
         other.size_ = 0;
+        other.capacity_ = 0;
         other.data = nullptr;
     }
 
     vector& operator=(vector&& other) noexcept
     {
         if (this != &other) {
-            if (data) {
-                free(data);
-            }
+            release();
             size_ = other.size_;
+            capacity_ = other.capacity_;
+            alloc_ = other.alloc_;
+            owner_ = std::move(other.owner_);
+            adopted_ = other.adopted_;
             data = other.data;
+            other.adopted_ = false;
             other.size_ = 0;
+            other.capacity_ = 0;
             other.data = nullptr;
         }
         return *this;
@@ -117,6 +225,13 @@ public:
 
     size_t size() const { return size_; }
 
+    size_t capacity() const { return capacity_; }
+
+    Allocator& allocator() const { return *alloc_; }
+
+    // false for adopted memory
+    bool owns_memory() const { return !adopted_; }
+
     void fill(const T& value) {
         for (size_t i = 0; i < size_; ++i) {
             data[i] = value;